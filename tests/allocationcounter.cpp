@@ -0,0 +1,104 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса AllocationCounter и замещение глобальных operator new/delete.
+ */
+
+#include "allocationcounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+// Тривиальные типы не требуют динамической инициализации и доступны даже во время старта потока
+thread_local qint64 threadAllocations = 0;
+thread_local qint64 threadBytes = 0;
+}
+
+AllocationCounter::Scope::Scope()
+    : start(AllocationCounter::current())
+{
+}
+
+AllocationCounter::Snapshot AllocationCounter::Scope::result() const
+{
+    Snapshot now = AllocationCounter::current();
+    return Snapshot{now.allocations - start.allocations, now.bytes - start.bytes};
+}
+
+AllocationCounter::Snapshot AllocationCounter::current()
+{
+    return Snapshot{threadAllocations, threadBytes};
+}
+
+void AllocationCounter::count(std::size_t size)
+{
+    threadAllocations++;
+    threadBytes += static_cast<qint64>(size);
+}
+
+#if defined(__GLIBC__)
+
+// Контейнеры Qt выделяют память через malloc, поэтому перехватываются функции распределителя C;
+// стандартный operator new также вызывает malloc и учитывается здесь же
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(std::size_t size)
+{
+    AllocationCounter::count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    AllocationCounter::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size)
+{
+    if (size != 0) AllocationCounter::count(size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer)
+{
+    __libc_free(pointer);
+}
+}
+
+#else
+
+// Без перехвата malloc учитываются только выделения через operator new
+namespace {
+void* allocate(std::size_t size)
+{
+    AllocationCounter::count(size);
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void* allocateNoThrow(std::size_t size) noexcept
+{
+    AllocationCounter::count(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+#endif
@@ -0,0 +1,62 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса AllocationCounter для подсчёта выделений памяти в тестах.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Класс для подсчёта выделений динамической памяти текущим потоком.
+ *
+ * Подсчёт ведётся замещёнными функциями malloc/calloc/realloc (glibc) либо глобальными
+ * operator new/delete на остальных платформах. Замещение подключается только в сборку тестов.
+ */
+class AllocationCounter
+{
+public:
+    /*!
+     * \brief Количество выделений и выделенных байт.
+     */
+    struct Snapshot {
+        qint64 allocations = 0;  /*!< Количество выделений */
+        qint64 bytes = 0;        /*!< Количество выделенных байт */
+    };
+
+    /*!
+     * \brief Класс, измеряющий выделения от создания объекта до вызова result().
+     */
+    class Scope
+    {
+    public:
+        /*!
+         * \brief Запоминает текущие значения счётчиков потока.
+         */
+        Scope();
+
+        /*!
+         * \brief Получение выделений с момента создания объекта.
+         * \return Разность текущих и запомненных значений счётчиков.
+         */
+        Snapshot result() const;
+
+    private:
+        Snapshot start; /*!< Значения счётчиков в момент создания объекта */
+    };
+
+    /*!
+     * \brief Получение текущих значений счётчиков потока.
+     * \return Количество выделений и байт с начала работы потока.
+     */
+    static Snapshot current();
+
+    /*!
+     * \brief Учёт одного выделения памяти.
+     * \param[in] size Размер выделенного блока.
+     */
+    static void count(std::size_t size);
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -9,9 +9,29 @@
 #include "test_removeconsecutiveduplicates.h"
 #include "test_toexplanation.h"
 #include "test_isreducibleunaryselfinverse.h"
+#include "test_allocationbudget.h"
+#include "test_normalize.h"
+#include "test_infixtonodes.h"
+#include "test_fixxmlflags.h"
+#include "test_textscanner.h"
+#include "test_declarationlibrary.h"
+#include "test_expressiondocument.h"
+#include "test_expressionbundle.h"
+#include "test_lazydescriptions.h"
+#include "test_xmlschema.h"
+#include "test_declarationindex.h"
+#include "test_teapi.h"
+#include "test_xmltree.h"
+#include "test_directorywatcher.h"
+#include "test_expressionsession.h"
+#include "test_subtreeexplanations.h"
+#include "test_batchrunner.h"
+#include "test_inputbudget.h"
+#include "test_inputpack.h"
 
-int runTest(int argc, char *argv[]) //-- Нужно, чтобы парсер тестов нашёл этот тест, поэтому запускаем мы его из main
+int main(int argc, char *argv[])
 {
+    QCoreApplication app(argc, argv);
 
     int result = 0;
 
@@ -60,8 +80,91 @@ int runTest(int argc, char *argv[]) //-- Нужно, чтобы парсер т
         result |= QTest::qExec(&isReducibleUnarySelfInverse, argc, argv);
     } catch (...) {}
 
+    try {
+        test_allocationBudget allocationBudget;
+        result |= QTest::qExec(&allocationBudget, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_normalize normalize;
+        result |= QTest::qExec(&normalize, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_infixToNodes infixToNodes;
+        result |= QTest::qExec(&infixToNodes, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_fixXmlFlags fixXmlFlags;
+        result |= QTest::qExec(&fixXmlFlags, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_textScanner textScanner;
+        result |= QTest::qExec(&textScanner, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_declarationLibrary declarationLibrary;
+        result |= QTest::qExec(&declarationLibrary, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_expressionDocument expressionDocument;
+        result |= QTest::qExec(&expressionDocument, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_expressionBundle expressionBundle;
+        result |= QTest::qExec(&expressionBundle, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_lazyDescriptions lazyDescriptions;
+        result |= QTest::qExec(&lazyDescriptions, argc, argv);
+    } catch (...) {}
+
+    try {
+        test_xmlSchema xmlSchema;
+        result |= QTest::qExec(&xmlSchema, argc, argv);
+    } catch (...) {}
+    try {
+        test_declarationIndex declarationIndex;
+        result |= QTest::qExec(&declarationIndex, argc, argv);
+    } catch (...) {}
+    try {
+        test_teApi teApi;
+        result |= QTest::qExec(&teApi, argc, argv);
+    } catch (...) {}
+    try {
+        test_xmlTree xmlTree;
+        result |= QTest::qExec(&xmlTree, argc, argv);
+    } catch (...) {}
+    try {
+        test_directoryWatcher directoryWatcher;
+        result |= QTest::qExec(&directoryWatcher, argc, argv);
+    } catch (...) {}
+    try {
+        test_expressionSession expressionSession;
+        result |= QTest::qExec(&expressionSession, argc, argv);
+    } catch (...) {}
+    try {
+        test_subtreeExplanations subtreeExplanations;
+        result |= QTest::qExec(&subtreeExplanations, argc, argv);
+    } catch (...) {}
+    try {
+        test_batchRunner batchRunner;
+        result |= QTest::qExec(&batchRunner, argc, argv);
+    } catch (...) {}
+    try {
+        test_inputBudget inputBudget;
+        result |= QTest::qExec(&inputBudget, argc, argv);
+    } catch (...) {}
+    try {
+        test_inputPack inputPack;
+        result |= QTest::qExec(&inputPack, argc, argv);
+    } catch (...) {}
+
     return result;
 }
-
-#define TESTS
-#include "../textExplanationsInRu/main.cpp"
@@ -0,0 +1,135 @@
+#include "test_allocationbudget.h"
+#include "allocationcounter.h"
+#include <QtTest/QTest>
+#include <expression.h>
+
+test_allocationBudget::test_allocationBudget(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_allocationBudget::allocationBudget()
+{
+    QFETCH(Expression, expression);
+    QFETCH(qint64, treeBudget);
+    QFETCH(qint64, explanationBudget);
+    QFETCH(qint64, duplicatesBudget);
+
+    // Построение дерева
+    AllocationCounter::Scope treeScope;
+    TEResult<ExpressionNode*> tree = expression.tryExpressionToNodes();
+    AllocationCounter::Snapshot treeAllocations = treeScope.result();
+    QVERIFY(tree.isOk());
+
+    // Перевод дерева в текст
+    QHash<Case, QString> intermediateDescription;
+    AllocationCounter::Scope explanationScope;
+    QString explanation = expression.toExplanation(tree.value(), intermediateDescription).value(Case::Nominative);
+    AllocationCounter::Snapshot explanationAllocations = explanationScope.result();
+
+    // Удаление повторяющихся слов
+    AllocationCounter::Scope duplicatesScope;
+    QString result = Expression::removeConsecutiveDuplicates(explanation);
+    AllocationCounter::Snapshot duplicatesAllocations = duplicatesScope.result();
+
+    qDebug() << "Result:" << result;
+    qDebug() << "expression-to-nodes:" << treeAllocations.allocations << "allocations," << treeAllocations.bytes << "bytes";
+    qDebug() << "to-explanation:" << explanationAllocations.allocations << "allocations," << explanationAllocations.bytes << "bytes";
+    qDebug() << "remove-duplicates:" << duplicatesAllocations.allocations << "allocations," << duplicatesAllocations.bytes << "bytes";
+
+    QVERIFY2(treeAllocations.allocations <= treeBudget, "expression-to-nodes allocation budget exceeded");
+    QVERIFY2(explanationAllocations.allocations <= explanationBudget, "to-explanation allocation budget exceeded");
+    QVERIFY2(duplicatesAllocations.allocations <= duplicatesBudget, "remove-duplicates allocation budget exceeded");
+
+    expression.deleteTree(tree.value());
+}
+
+void test_allocationBudget::allocationBudget_data()
+{
+    QTest::addColumn<Expression>("expression");
+    QTest::addColumn<qint64>("treeBudget");
+    QTest::addColumn<qint64>("explanationBudget");
+    QTest::addColumn<qint64>("duplicatesBudget");
+
+    // Бюджеты лишь немного превышают число выделений каждого этапа, поэтому заметный рост выделений
+    // не проходит проверку; при сокращении выделений их следует уменьшать, закрепляя достигнутое
+
+    // Тест 1: Сложение двух констант
+    QTest::newRow("addition-of-two-constants")
+        << Expression("1 1 +", {}, {}, {}, {}, {}, {})
+        << qint64(60) << qint64(300) << qint64(2);
+
+    // Тест 2: Сложение двух разных переменных
+    QTest::newRow("addition-of-two-different-variables")
+        << Expression(
+               "warnings errors +",
+               {{"warnings", Variable("warnings", "int",
+                                      {{Case::Nominative, "предупреждения программы"},
+                                       {Case::Genitive, "предупреждений программы"},
+                                       {Case::Dative, "предупреждениям программы"},
+                                       {Case::Accusative, "предупреждения программы"},
+                                       {Case::Instrumental, "предупреждениями программы"},
+                                       {Case::Prepositional, "о предупреждениях программы"}})},
+                {"errors", Variable("errors", "int",
+                                    {{Case::Nominative, "ошибки"},
+                                     {Case::Genitive, "ошибок"},
+                                     {Case::Dative, "ошибкам"},
+                                     {Case::Accusative, "ошибки"},
+                                     {Case::Instrumental, "ошибками"},
+                                     {Case::Prepositional, "об ошибках"}})}},
+               {},
+               {},
+               {},
+               {},
+               {})
+        << qint64(80) << qint64(300) << qint64(2);
+
+    // Тест 3: Вызов функции в параметрах функции
+    QTest::newRow("function-in-function-parameters")
+        << Expression(
+               "1 4 max(2) 3 sum(2)",
+               {},
+               {{"sum", Function("sum", "int", 2,
+                                 {{Case::Nominative, "сложение {1(р)} и {2(р)}"},
+                                  {Case::Genitive, "сложения {1(р)} и {2(р)}"},
+                                  {Case::Dative, "сложению {1(р)} и {2(р)}"},
+                                  {Case::Accusative, "сложение {1(р)} и {2(р)}"},
+                                  {Case::Instrumental, "сложением {1(р)} и {2(р)}"},
+                                  {Case::Prepositional, "о сложении {1(р)} и {2(р)}"}})},
+                {"max", Function("max", "int", 2,
+                                 {{Case::Nominative, "максимум из {1(р)} и {2(р)}"},
+                                  {Case::Genitive, "максимума из {1(р)} и {2(р)}"},
+                                  {Case::Dative, "максимуму из {1(р)} и {2(р)}"},
+                                  {Case::Accusative, "максимум из {1(р)} и {2(р)}"},
+                                  {Case::Instrumental, "максимумом из {1(р)} и {2(р)}"},
+                                  {Case::Prepositional, "о максимуме из {1(р)} и {2(р)}"}})}},
+               {},
+               {},
+               {},
+               {})
+        << qint64(150) << qint64(600) << qint64(2);
+
+    // Тест 4: Вызов функции класса
+    QTest::newRow("class-function-call")
+        << Expression(
+               "oleg getAge(0) .",
+               {{"oleg", Variable("oleg", "Human",
+                                  {{Case::Nominative, "олег"},
+                                   {Case::Genitive, "олега"},
+                                   {Case::Dative, "олегу"},
+                                   {Case::Accusative, "олега"},
+                                   {Case::Instrumental, "олегом"},
+                                   {Case::Prepositional, "о олеге"}})}},
+               {},
+               {},
+               {},
+               {{"Human", Class("Human", {},
+                                {{"getAge", Function("getAge", "int", 0,
+                                                     {{Case::Nominative, "возраст"},
+                                                      {Case::Genitive, "возраста"},
+                                                      {Case::Dative, "возрасту"},
+                                                      {Case::Accusative, "возраст"},
+                                                      {Case::Instrumental, "возрастом"},
+                                                      {Case::Prepositional, "о возрасте"}})}})}},
+               {})
+        << qint64(120) << qint64(300) << qint64(2);
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_ALLOCATIONBUDGET_H
+#define TEST_ALLOCATIONBUDGET_H
+
+#include <QObject>
+
+class test_allocationBudget : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_allocationBudget(QObject *parent = nullptr);
+
+private slots:
+    void allocationBudget();
+    void allocationBudget_data();
+};
+
+#endif // TEST_ALLOCATIONBUDGET_H
@@ -0,0 +1,234 @@
+#include "test_batchrunner.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QDir>
+#include <QTemporaryDir>
+#include <batchrunner.h>
+
+Q_DECLARE_METATYPE(ShardKey)
+
+namespace {
+// Каталог входных файлов: корректные выражения и выражения с ошибками
+bool writeInputs(const QTemporaryDir& dir)
+{
+    const QList<QByteArray> expressions = {"a b +", "a b *", "a c +", "a b -", "a +", "b a /", "a b", "a b %", "a d *", "b a +", "a b >"};
+    for (qsizetype i = 0; i < expressions.size(); i++) {
+        if (!writeFile(dir.filePath(QString("input%1.xml").arg(i, 2, 10, QChar('0'))), expressionDocumentXml(expressions[i]))) return false;
+    }
+    return true;
+}
+
+// Совпадение результатов файлов, включая ошибки
+void compareRecords(const QList<BatchRecord>& actual, const QList<BatchRecord>& expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    for (qsizetype i = 0; i < expected.size(); i++) {
+        QCOMPARE(actual[i].order, expected[i].order);
+        QCOMPARE(actual[i].input, expected[i].input);
+        QCOMPARE(actual[i].explanation, expected[i].explanation);
+        QCOMPARE(actual[i].errors.size(), expected[i].errors.size());
+        for (qsizetype j = 0; j < expected[i].errors.size(); j++) {
+            QCOMPARE(actual[i].errors[j].type, expected[i].errors[j].type);
+            QCOMPARE(actual[i].errors[j].message, expected[i].errors[j].message);
+        }
+    }
+}
+}
+
+test_batchRunner::test_batchRunner(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_batchRunner::parseShard()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, valid);
+    QFETCH(int, index);
+    QFETCH(int, count);
+    QFETCH(ShardKey, key);
+
+    ShardSpec shard;
+    QCOMPARE(BatchRunner::parseShard(text, shard), valid);
+    if (!valid) return;
+    QCOMPARE(shard.index, index);
+    QCOMPARE(shard.count, count);
+    QCOMPARE(shard.key, key);
+}
+
+void test_batchRunner::parseShard_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("index");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<ShardKey>("key");
+
+    // Тест 1: Единственный шард
+    QTest::newRow("single") << "1/1" << true << 1 << 1 << ShardKey::Order;
+
+    // Тест 2: Распределение по позиции в списке
+    QTest::newRow("order") << "2/4" << true << 2 << 4 << ShardKey::Order;
+
+    // Тест 3: Явно указанное распределение по позиции
+    QTest::newRow("explicit-order") << "4/4:order" << true << 4 << 4 << ShardKey::Order;
+
+    // Тест 4: Распределение по хэшу содержимого
+    QTest::newRow("hash") << "3/8:hash" << true << 3 << 8 << ShardKey::ContentHash;
+
+    // Тест 5: Номера шардов начинаются с 1
+    QTest::newRow("zero-index") << "0/4" << false << 0 << 0 << ShardKey::Order;
+
+    // Тест 6: Номер шарда больше количества шардов
+    QTest::newRow("index-out-of-range") << "5/4" << false << 0 << 0 << ShardKey::Order;
+
+    // Тест 7: Нет количества шардов
+    QTest::newRow("no-count") << "2" << false << 0 << 0 << ShardKey::Order;
+
+    // Тест 8: Не число
+    QTest::newRow("not-number") << "a/b" << false << 0 << 0 << ShardKey::Order;
+
+    // Тест 9: Неизвестный способ распределения
+    QTest::newRow("unknown-key") << "1/4:size" << false << 0 << 0 << ShardKey::Order;
+}
+
+void test_batchRunner::shardsMatchSingleRun()
+{
+    QFETCH(int, count);
+    QFETCH(ShardKey, key);
+
+    QTemporaryDir inputs;
+    QTemporaryDir results;
+    QVERIFY(inputs.isValid());
+    QVERIFY(results.isValid());
+    QVERIFY(writeInputs(inputs));
+    TEResult<QStringList> manifest = BatchRunner::readManifest(inputs.path());
+    QVERIFY(manifest.isOk());
+
+    // Результат одного процесса без шардов
+    BatchResult single = BatchRunner::run(manifest.value(), ShardSpec());
+    QCOMPARE(single.records.size(), manifest.value().size());
+
+    // Каждый шард обрабатывается отдельно, его результат проходит через файл, как при запуске отдельными процессами
+    QList<BatchResult> shards;
+    qsizetype processed = 0;
+    for (int index = count; index >= 1; index--) {
+        ShardSpec shard{index, count, key};
+        QString path = results.filePath(QString("shard%1.json").arg(index));
+        QVERIFY(BatchRunner::save(BatchRunner::run(manifest.value(), shard), path).isEmpty());
+        TEResult<BatchResult> loaded = BatchRunner::load(path);
+        QVERIFY(loaded.isOk());
+        processed += loaded.value().records.size();
+        shards.append(loaded.takeValue());
+    }
+    QCOMPARE(processed, manifest.value().size());
+
+    TEResult<BatchResult> merged = BatchRunner::merge(shards);
+    QVERIFY(merged.isOk());
+    compareRecords(merged.value().records, single.records);
+    QCOMPARE(merged.value().manifestDigest, single.manifestDigest);
+
+    // Сводка ошибок объединённого результата совпадает со сводкой одного процесса
+    BatchStatistics expected = single.statistics();
+    BatchStatistics actual = merged.value().statistics();
+    QCOMPARE(actual.inputs, expected.inputs);
+    QCOMPARE(actual.succeeded, expected.succeeded);
+    QCOMPARE(actual.failed, expected.failed);
+    QCOMPARE(actual.errors, expected.errors);
+    QCOMPARE(actual.failed, qsizetype(4));
+    QCOMPARE(actual.errors.value("UndefinedId"), qsizetype(2));
+}
+
+void test_batchRunner::shardsMatchSingleRun_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<ShardKey>("key");
+
+    // Тест 1: Один шард
+    QTest::newRow("one-shard") << 1 << ShardKey::Order;
+
+    // Тест 2: Три шарда по позиции в списке
+    QTest::newRow("order-3") << 3 << ShardKey::Order;
+
+    // Тест 3: Шардов больше, чем файлов
+    QTest::newRow("order-16") << 16 << ShardKey::Order;
+
+    // Тест 4: Четыре шарда по хэшу содержимого
+    QTest::newRow("hash-4") << 4 << ShardKey::ContentHash;
+}
+
+void test_batchRunner::manifest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkdir("inputs"));
+    QVERIFY(writeFile(dir.filePath("inputs/b.xml"), expressionDocumentXml("a b +")));
+    QVERIFY(writeFile(dir.filePath("inputs/a.xml"), expressionDocumentXml("a b *")));
+    QVERIFY(writeFile(dir.filePath("inputs/notes.txt"), "a b -"));
+
+    // Файлы каталога сортируются, файлы без расширения xml пропускаются
+    TEResult<QStringList> fromDirectory = BatchRunner::readManifest(dir.filePath("inputs"));
+    QVERIFY(fromDirectory.isOk());
+    QCOMPARE(fromDirectory.value(), QStringList({dir.filePath("inputs/a.xml"), dir.filePath("inputs/b.xml")}));
+
+    // Пути списка отсчитываются от его каталога, сортируются и не повторяются
+    QVERIFY(writeFile(dir.filePath("manifest.txt"), "# входные файлы\ninputs/b.xml\n\n  inputs/a.xml  \ninputs/../inputs/b.xml\n"));
+    TEResult<QStringList> fromFile = BatchRunner::readManifest(dir.filePath("manifest.txt"));
+    QVERIFY(fromFile.isOk());
+    QCOMPARE(fromFile.value(), fromDirectory.value());
+
+    // Недоступный файл списка остаётся в результате с ошибкой
+    QVERIFY(writeFile(dir.filePath("manifest.txt"), "inputs/a.xml\ninputs/missing.xml\n"));
+    BatchResult result = BatchRunner::run(BatchRunner::readManifest(dir.filePath("manifest.txt")).value(), ShardSpec());
+    QCOMPARE(result.records.size(), qsizetype(2));
+    QCOMPARE(result.records[1].errors.first().type, QString("InputFileNotFound"));
+
+    QVERIFY(!BatchRunner::readManifest(dir.filePath("absent.txt")).isOk());
+}
+
+void test_batchRunner::mergeErrors()
+{
+    QTemporaryDir inputs;
+    QVERIFY(inputs.isValid());
+    QVERIFY(writeInputs(inputs));
+    QStringList manifest = BatchRunner::readManifest(inputs.path()).value();
+    BatchResult first = BatchRunner::run(manifest, ShardSpec{1, 2, ShardKey::Order});
+    BatchResult second = BatchRunner::run(manifest, ShardSpec{2, 2, ShardKey::Order});
+    QVERIFY(BatchRunner::merge({first, second}).isOk());
+
+    // Пропущенный шард
+    TEResult<BatchResult> missing = BatchRunner::merge({first});
+    QVERIFY(!missing.isOk());
+    QCOMPARE(missing.errors().first().getErrorType(), ErrorType::InvalidBatchResult);
+
+    // Повторённый шард
+    QVERIFY(!BatchRunner::merge({first, first}).isOk());
+
+    // Шард другого разбиения
+    BatchResult other = BatchRunner::run(manifest, ShardSpec{2, 2, ShardKey::ContentHash});
+    QVERIFY(!BatchRunner::merge({first, other}).isOk());
+
+    // Шард другого списка входных файлов
+    BatchResult shorter = BatchRunner::run(manifest.mid(1), ShardSpec{2, 2, ShardKey::Order});
+    QVERIFY(!BatchRunner::merge({first, shorter}).isOk());
+
+    // Шард списка того же размера с другим файлом
+    QStringList renamedManifest = manifest;
+    renamedManifest.last() = inputs.filePath("renamed.xml");
+    BatchResult renamed = BatchRunner::run(renamedManifest, ShardSpec{2, 2, ShardKey::Order});
+    QCOMPARE(renamed.manifestSize, first.manifestSize);
+    TEResult<BatchResult> mismatch = BatchRunner::merge({first, renamed});
+    QVERIFY(!mismatch.isOk());
+    QCOMPARE(mismatch.errors().first().getErrorType(), ErrorType::InvalidBatchResult);
+
+    // Тот же набор файлов в другом каталоге даёт тот же хэш списка
+    QTemporaryDir copy;
+    QVERIFY(copy.isValid());
+    QVERIFY(writeInputs(copy));
+    BatchResult copied = BatchRunner::run(BatchRunner::readManifest(copy.path()).value(), ShardSpec{2, 2, ShardKey::Order});
+    QVERIFY(BatchRunner::merge({first, copied}).isOk());
+
+    // Повреждённый файл результата
+    TEResult<BatchResult> corrupted = BatchRunner::deserialize(BatchRunner::serialize(first).chopped(10));
+    QVERIFY(!corrupted.isOk());
+    QCOMPARE(corrupted.errors().first().getErrorType(), ErrorType::InvalidBatchResult);
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_BATCHRUNNER_H
+#define TEST_BATCHRUNNER_H
+
+#include <QObject>
+
+class test_batchRunner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_batchRunner(QObject *parent = nullptr);
+
+private slots:
+    void parseShard();
+    void parseShard_data();
+    void shardsMatchSingleRun();
+    void shardsMatchSingleRun_data();
+    void manifest();
+    void mergeErrors();
+};
+
+#endif // TEST_BATCHRUNNER_H
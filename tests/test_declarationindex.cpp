@@ -0,0 +1,96 @@
+#include "test_declarationindex.h"
+#include <QtTest/QTest>
+#include <declarationindex.h>
+#include <expression.h>
+
+namespace {
+// Объявления: переменные, поле и метод класса, значения перечисления
+Expression declarations(const QString& expression)
+{
+    return Expression(expression,
+                      {{"chel", Variable("chel", "Human")}, {"count", Variable("count", "int")}},
+                      {}, {}, {},
+                      {{"Human", Class("Human", {{"age", Variable("age", "int")}}, {{"revive", Function("revive", "void", 0)}})}},
+                      {{"Color", Enum("Color", {{"Red", {}}, {"Green", {}}})}});
+}
+}
+
+test_declarationIndex::test_declarationIndex(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_declarationIndex::index()
+{
+    Expression expression = declarations("count");
+    const DeclarationIndex& index = expression.getDeclarationIndex();
+
+    const QSet<QString> expectedNames{"chel", "count", "Human", "Human.age", "Human.revive", "Color", "Color.Red", "Color.Green"};
+    QCOMPARE(index.size(), expectedNames.size());
+    QCOMPARE(index.names(), expectedNames);
+    QCOMPARE(expression.getAllNames(), expectedNames);
+
+    // Номера различны и покрывают диапазон [0, size())
+    QSet<int> numbers;
+    for (const QString& name : expectedNames) {
+        QBitArray single = index.mask({name});
+        QCOMPARE(single.count(true), 1);
+        QCOMPARE(index.names(single), QList<QString>{name});
+        for (qsizetype i = 0; i < single.size(); ++i)
+            if (single.testBit(i)) numbers.insert(int(i));
+    }
+    QCOMPARE(numbers.size(), expectedNames.size());
+
+    QCOMPARE(index.indexOf("Human.age"), -1);
+    QCOMPARE(index.memberIndexOf("Human", "height"), -1);
+    QCOMPARE(index.indexOf("missing"), -1);
+    QCOMPARE(index.mask({"missing", "Color.Blue"}).count(true), qsizetype(0));
+
+    // Копии выражения используют один и тот же индекс
+    Expression copy = expression;
+    QCOMPARE(&copy.getDeclarationIndex(), &index);
+
+    // Изменение объявлений приводит к построению нового индекса
+    copy.setEnums({});
+    QCOMPARE(copy.getDeclarationIndex().size(), expectedNames.size() - 3);
+    QCOMPARE(expression.getDeclarationIndex().size(), expectedNames.size());
+}
+
+void test_declarationIndex::unusedDeclarations()
+{
+    QFETCH(QString, expression);
+    QFETCH(QStringList, unusedNames);
+
+    Expression current = declarations(expression);
+    TEResult<ExpressionNode*> tree = current.tryExpressionToNodes();
+    QVERIFY(!tree);
+
+    TEException error = tree.errors().first();
+    qDebug() << "Actual error:" << TEException::ErrorTypeNames.value(error.getErrorType()) << error.getArgs();
+    QCOMPARE(error.getErrorType(), ErrorType::NeverUsedElement);
+
+    QStringList actualNames = error.getArgs().first().split(", ");
+    actualNames.sort();
+    unusedNames.sort();
+    QCOMPARE(actualNames, unusedNames);
+}
+
+void test_declarationIndex::unusedDeclarations_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<QStringList>("unusedNames");
+
+    // Тест 1: Не использованы поле и метод класса, переменная и перечисление
+    QTest::newRow("class-members-and-enum")
+        << "chel"
+        << QStringList{"count", "Human.age", "Human.revive", "Color", "Color.Red", "Color.Green"};
+
+    // Тест 2: Использовано значение перечисления, не использованы второе значение и остальные объявления
+    QTest::newRow("unused-enum-value")
+        << "Color Red ::"
+        << QStringList{"chel", "count", "Human", "Human.age", "Human.revive", "Color.Green"};
+
+    // Тест 3: Использованы поле класса и переменная, не использованы метод класса и перечисление
+    QTest::newRow("unused-class-method")
+        << "chel age . count +"
+        << QStringList{"Human.revive", "Color", "Color.Red", "Color.Green"};
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_DECLARATIONINDEX_H
+#define TEST_DECLARATIONINDEX_H
+
+#include <QObject>
+
+class test_declarationIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_declarationIndex(QObject *parent = nullptr);
+
+private slots:
+    void index();
+    void unusedDeclarations();
+    void unusedDeclarations_data();
+};
+
+#endif // TEST_DECLARATIONINDEX_H
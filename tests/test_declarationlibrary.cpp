@@ -0,0 +1,160 @@
+#include "test_declarationlibrary.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <declarationindex.h>
+#include <declarationlibrary.h>
+#include <expression.h>
+
+test_declarationLibrary::test_declarationLibrary(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_declarationLibrary::explanationWithLibrary()
+{
+    QFETCH(QByteArray, library);
+    QFETCH(QByteArray, input);
+    QFETCH(QVariant, result);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("library.xml"), library));
+    QVERIFY(writeFile(dir.filePath("input.xml"), input));
+
+    QList<TEException> errors;
+    TEResult<QSharedPointer<const DeclarationLibrary>> loaded = DeclarationLibrary::load(dir.filePath("library.xml"));
+    if (loaded) {
+        TEResult<Expression> expression = Expression::tryFromFile(dir.filePath("input.xml"), loaded.value().data());
+        TEResult<QString> explanation = expression ? expression.value().tryGetExplanationInRu() : TEResult<QString>(expression.errors());
+        if (explanation) {
+            qDebug() << "Actual result:" << explanation.value();
+            QCOMPARE(explanation.value(), result.toString());
+            return;
+        }
+        errors = explanation.errors();
+    }
+    else errors = loaded.errors();
+
+    QVERIFY2(result.userType() == qMetaTypeId<ErrorType>(), qPrintable(TEException::ErrorTypeNames.value(errors.first().getErrorType())));
+    qDebug() << "Actual error:" << TEException::ErrorTypeNames.value(errors.first().getErrorType());
+    QCOMPARE(errors.first().getErrorType(), result.value<ErrorType>());
+}
+
+void test_declarationLibrary::explanationWithLibrary_data()
+{
+    QTest::addColumn<QByteArray>("library");
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<QVariant>("result");
+
+    // Тест 1: Все объявления находятся в библиотеке
+    QTest::newRow("declarations-in-library")
+        << libraryXml(applesXml() + pearsXml())
+        << QByteArray("<root>\n<expression>a b +</expression>\n</root>\n")
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 2: Неиспользованные объявления библиотеки допустимы
+    QTest::newRow("unused-library-declarations")
+        << libraryXml(applesXml() + pearsXml() + plumsXml())
+        << QByteArray("<root>\n<expression>a b +</expression>\n</root>\n")
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 3: Объявления входного файла дополняют библиотеку
+    QTest::newRow("own-and-library-declarations")
+        << libraryXml(applesXml())
+        << QByteArray("<root>\n<expression>a b +</expression>\n<variables>\n" + pearsXml() + "</variables>\n</root>\n")
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 4: Собственное объявление входного файла заменяет объявление библиотеки
+    QTest::newRow("own-declaration-overrides-library")
+        << libraryXml(applesXml() + pearsXml())
+        << QByteArray("<root>\n<expression>a b +</expression>\n<variables>\n" + variableXml("b", "количество слив", "количества слив") + "</variables>\n</root>\n")
+        << QVariant("сумма количества яблок и количества слив");
+
+    // Тест 5: Неиспользованное собственное объявление входного файла остаётся ошибкой
+    QTest::newRow("unused-own-declaration")
+        << libraryXml(applesXml() + pearsXml())
+        << QByteArray("<root>\n<expression>a b +</expression>\n<variables>\n" + plumsXml() + "</variables>\n</root>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::NeverUsedElement);
+
+    // Тест 6: Идентификатор, не объявленный ни в библиотеке, ни во входном файле
+    QTest::newRow("undefined-identifier")
+        << libraryXml(applesXml())
+        << QByteArray("<root>\n<expression>a b +</expression>\n</root>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::UndefinedId);
+
+    // Тест 7: Входной файл без выражения
+    QTest::newRow("input-without-expression")
+        << libraryXml(applesXml())
+        << libraryXml(pearsXml())
+        << QVariant::fromValue<ErrorType>(ErrorType::MissingRequiredChildElement);
+
+    // Тест 8: Библиотека не может содержать выражение
+    QTest::newRow("library-with-expression")
+        << QByteArray("<root>\n<expression>a</expression>\n<variables>\n" + applesXml() + "</variables>\n</root>\n")
+        << QByteArray("<root>\n<expression>a</expression>\n</root>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::UnexpectedElement);
+}
+
+void test_declarationLibrary::reloadOnChange()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("library.xml");
+    QVERIFY(writeFile(path, libraryXml(applesXml())));
+
+    // Пока файл не изменился, используется один и тот же снимок
+    TEResult<QSharedPointer<const DeclarationLibrary>> first = DeclarationLibrary::load(path);
+    TEResult<QSharedPointer<const DeclarationLibrary>> second = DeclarationLibrary::load(path);
+    QVERIFY(first && second);
+    QCOMPARE(first.value().data(), second.value().data());
+    QCOMPARE(first.value()->names(), QSet<QString>{"a"});
+
+    // После изменения файла библиотека перечитывается, прежний снимок остаётся действительным
+    QVERIFY(writeFile(path, libraryXml(applesXml() + pearsXml())));
+    TEResult<QSharedPointer<const DeclarationLibrary>> reloaded = DeclarationLibrary::load(path);
+    QVERIFY(reloaded);
+    QVERIFY(reloaded.value().data() != first.value().data());
+    QCOMPARE(reloaded.value()->names(), (QSet<QString>{"a", "b"}));
+    QCOMPARE(first.value()->names(), QSet<QString>{"a"});
+
+    // После очистки кэша файл читается заново
+    DeclarationLibrary::clearCache();
+    TEResult<QSharedPointer<const DeclarationLibrary>> afterClear = DeclarationLibrary::load(path);
+    QVERIFY(afterClear);
+    QVERIFY(afterClear.value().data() != reloaded.value().data());
+}
+
+void test_declarationLibrary::libraryIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("library.xml"), libraryXml(applesXml() + pearsXml())));
+    QVERIFY(writeFile(dir.filePath("input.xml"),
+                      "<root>\n<expression>a b c + +</expression>\n<variables>\n"
+                      + variableXml("b", "количество слив", "количества слив") + plumsXml() + "</variables>\n</root>\n"));
+
+    TEResult<QSharedPointer<const DeclarationLibrary>> library = DeclarationLibrary::load(dir.filePath("library.xml"));
+    QVERIFY(library);
+    const QSharedPointer<const DeclarationIndex>& libraryIndex = library.value()->declarationIndex();
+    QCOMPARE(libraryIndex->size(), qsizetype(2));
+    QCOMPARE(library.value()->sharedDeclarations().count(true), qsizetype(2));
+
+    TEResult<Expression> expression = Expression::tryFromFile(dir.filePath("input.xml"), library.value().data());
+    QVERIFY(expression);
+
+    // Объявления библиотеки сохраняют свои номера, собственное объявление нумеруется после них
+    const DeclarationIndex& index = expression.value().getDeclarationIndex();
+    QCOMPARE(index.size(), qsizetype(3));
+    QCOMPARE(index.indexOf("a"), libraryIndex->indexOf("a"));
+    QCOMPARE(index.indexOf("b"), libraryIndex->indexOf("b"));
+    QCOMPARE(index.indexOf("c"), 2);
+    QCOMPARE(index.names(), (QSet<QString>{"a", "b", "c"}));
+
+    // Общим остаётся только объявление библиотеки, не объявленное во входном файле повторно
+    QCOMPARE(expression.value().getSharedNames(), QSet<QString>{"a"});
+    QCOMPARE(expression.value().getSharedDeclarations().count(true), qsizetype(1));
+
+    // Индекс библиотеки не изменяется
+    QCOMPARE(libraryIndex->size(), qsizetype(2));
+    QCOMPARE(libraryIndex->indexOf("c"), -1);
+}
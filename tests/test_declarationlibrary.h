@@ -0,0 +1,19 @@
+#ifndef TEST_DECLARATIONLIBRARY_H
+#define TEST_DECLARATIONLIBRARY_H
+
+#include <QObject>
+
+class test_declarationLibrary : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_declarationLibrary(QObject *parent = nullptr);
+
+private slots:
+    void explanationWithLibrary();
+    void explanationWithLibrary_data();
+    void reloadOnChange();
+    void libraryIndex();
+};
+
+#endif // TEST_DECLARATIONLIBRARY_H
@@ -0,0 +1,144 @@
+#include "test_directorywatcher.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QDir>
+#include <QTemporaryDir>
+#include <directorywatcher.h>
+
+Q_DECLARE_METATYPE(RefreshOutcome)
+
+namespace {
+// Входной документ, объявления которого находятся в библиотеке
+QByteArray libraryDocumentXml(const QByteArray& expression)
+{
+    return "<root>\n<expression>" + expression + "</expression>\n</root>\n";
+}
+}
+
+test_directoryWatcher::test_directoryWatcher(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_directoryWatcher::refresh()
+{
+    QFETCH(QByteArray, edited);
+    QFETCH(RefreshOutcome, outcome);
+    QFETCH(QString, output);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("first.xml"), expressionDocumentXml("a b +")));
+    QVERIFY(writeFile(dir.filePath("second.xml"), expressionDocumentXml("a b *")));
+
+    // При запуске поясняются все файлы каталога; пояснения по умолчанию записываются в его подкаталог
+    DirectoryWatcher watcher(dir.path());
+    QVERIFY(watcher.start().isEmpty());
+    QCOMPARE(watcher.fileCount(), qsizetype(2));
+    const QDir outputDirectory(dir.filePath(DirectoryWatcher::DefaultOutputDirectory));
+    QCOMPARE(watcher.outputPath(dir.filePath("first.xml")), outputDirectory.filePath("first.txt"));
+    QCOMPARE(QString::fromUtf8(readFile(outputDirectory.filePath("first.txt"))), QString("сумма количества яблок и количества груш"));
+    QCOMPARE(QString::fromUtf8(readFile(outputDirectory.filePath("second.txt"))), QString("произведение количества яблок и количества груш"));
+
+    // Изменить или удалить первый файл
+    if (edited.isNull()) QVERIFY(QFile::remove(dir.filePath("first.xml")));
+    else QVERIFY(writeFile(dir.filePath("first.xml"), edited));
+    QCOMPARE(watcher.refreshFile(dir.filePath("first.xml")), outcome);
+    QCOMPARE(QFile::exists(outputDirectory.filePath("first.txt")), !output.isNull());
+    QCOMPARE(QString::fromUtf8(readFile(outputDirectory.filePath("first.txt"))), output);
+
+    // Неизменённый файл не разбирается заново
+    QCOMPARE(watcher.refreshFile(dir.filePath("second.xml")), RefreshOutcome::Unchanged);
+    QCOMPARE(watcher.fileCount(), qsizetype(edited.isNull() ? 1 : 2));
+}
+
+void test_directoryWatcher::refresh_data()
+{
+    QTest::addColumn<QByteArray>("edited");
+    QTest::addColumn<RefreshOutcome>("outcome");
+    QTest::addColumn<QString>("output");
+
+    // Тест 1: Файл сохранён без изменений
+    QTest::newRow("same-content")
+        << expressionDocumentXml("a b +")
+        << RefreshOutcome::Unchanged
+        << QString("сумма количества яблок и количества груш");
+
+    // Тест 2: Изменение, не влияющее на пояснение
+    QTest::newRow("same-explanation")
+        << documentXml("<expression>a b +</expression>\n\n\n", applesXml() + pearsXml())
+        << RefreshOutcome::OutputUnchanged
+        << QString("сумма количества яблок и количества груш");
+
+    // Тест 3: Изменённое выражение
+    QTest::newRow("changed-expression")
+        << expressionDocumentXml("a b -")
+        << RefreshOutcome::Written
+        << QString("разность количества яблок и количества груш");
+
+    // Тест 4: При ошибке во входном файле прежнее пояснение удаляется
+    QTest::newRow("invalid-expression")
+        << expressionDocumentXml("a c +")
+        << RefreshOutcome::Failed
+        << QString();
+
+    // Тест 5: Удалённый входной файл
+    QTest::newRow("removed-file")
+        << QByteArray()
+        << RefreshOutcome::Removed
+        << QString("сумма количества яблок и количества груш");
+}
+
+void test_directoryWatcher::libraryChange()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkdir("output"));
+    const QString libraryPath = dir.filePath("library.xml");
+    QVERIFY(writeFile(libraryPath, libraryXml(applesXml() + pearsXml())));
+    QVERIFY(writeFile(dir.filePath("sum.xml"), libraryDocumentXml("a b +")));
+    QVERIFY(writeFile(dir.filePath("difference.xml"), libraryDocumentXml("a b -")));
+
+    // Библиотека в каталоге входных файлов не поясняется
+    DirectoryWatcher watcher(dir.path(), dir.filePath("output"), libraryPath);
+    QVERIFY(watcher.start().isEmpty());
+    QCOMPARE(watcher.fileCount(), qsizetype(2));
+    QCOMPARE(watcher.outputPath(dir.filePath("sum.xml")), QDir(dir.filePath("output")).filePath("sum.txt"));
+    QCOMPARE(QString::fromUtf8(readFile(dir.filePath("output/sum.txt"))), QString("сумма количества яблок и количества груш"));
+
+    // Без изменения библиотеки входные файлы не разбираются заново
+    QList<RefreshOutcome> outcomes;
+    connect(&watcher, &DirectoryWatcher::fileRefreshed, this, [&](const QString&, RefreshOutcome outcome, const QList<TEException>&) {
+        outcomes.append(outcome);
+    });
+    QVERIFY(watcher.reloadLibrary().isEmpty());
+    QVERIFY(outcomes.isEmpty());
+
+    // Изменение библиотеки обновляет пояснения всех файлов
+    QVERIFY(writeFile(libraryPath, libraryXml(variableXml("a", "число яблок", "числа яблок") + pearsXml())));
+    QVERIFY(watcher.reloadLibrary().isEmpty());
+    QCOMPARE(outcomes.size(), qsizetype(2));
+    QCOMPARE(outcomes.count(RefreshOutcome::Written), qsizetype(2));
+    QCOMPARE(QString::fromUtf8(readFile(dir.filePath("output/sum.txt"))), QString("сумма числа яблок и количества груш"));
+    QCOMPARE(QString::fromUtf8(readFile(dir.filePath("output/difference.txt"))), QString("разность числа яблок и количества груш"));
+
+    // Библиотека с ошибками не заменяет прежнюю
+    outcomes.clear();
+    QVERIFY(writeFile(libraryPath, "<root>\n<variables>\n"));
+    QVERIFY(!watcher.reloadLibrary().isEmpty());
+    QVERIFY(outcomes.isEmpty());
+}
+
+void test_directoryWatcher::outputInInputDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("sum.xml"), expressionDocumentXml("a b +")));
+
+    // Записи пояснений во входной каталог вызывали бы его повторный просмотр, поэтому наблюдение не начинается
+    DirectoryWatcher watcher(dir.path(), dir.path());
+    QList<TEException> errors = watcher.start();
+    QCOMPARE(errors.size(), qsizetype(1));
+    QCOMPARE(errors.first().getErrorType(), ErrorType::OutputFileCannotBeCreated);
+    QCOMPARE(watcher.fileCount(), qsizetype(0));
+    QVERIFY(!QFile::exists(dir.filePath("sum.txt")));
+}
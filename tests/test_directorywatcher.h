@@ -0,0 +1,19 @@
+#ifndef TEST_DIRECTORYWATCHER_H
+#define TEST_DIRECTORYWATCHER_H
+
+#include <QObject>
+
+class test_directoryWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_directoryWatcher(QObject *parent = nullptr);
+
+private slots:
+    void refresh();
+    void refresh_data();
+    void libraryChange();
+    void outputInInputDirectory();
+};
+
+#endif // TEST_DIRECTORYWATCHER_H
@@ -0,0 +1,225 @@
+#include "test_expressionbundle.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <declarationlibrary.h>
+#include <expressionbundle.h>
+#include <expressionxmlparser.h>
+
+namespace {
+// Описание во всех падежах
+QHash<Case, QString> cases(const QString& nominative, const QString& genitive)
+{
+    return {{Case::Nominative, nominative},
+            {Case::Genitive, genitive},
+            {Case::Dative, nominative},
+            {Case::Accusative, nominative},
+            {Case::Instrumental, nominative},
+            {Case::Prepositional, nominative}};
+}
+
+// Документ с объявлениями всех видов
+ExpressionDocument makeDocument(const QStringList& expressions, ExpressionNotation notation = ExpressionNotation::Postfix)
+{
+    ExpressionDocument document;
+    document.declarations() = Expression(
+        "",
+        {{"apple", Variable("apple", "Apple", cases("яблоко", "яблока"))},
+         {"count", Variable("count", "int", cases("количество", "количества"))},
+         {"fruit", Variable("fruit", "Fruits", cases("фрукт", "фрукта"))}},
+        {{"weigh", Function("weigh", "int", 1, cases("вес {1(р)}", "веса {1(р)}"))}},
+        {},
+        {{"Apple", Structure("Apple", {{"age", Variable("age", "int", cases("возраст", "возраста"))}}, {})}},
+        {},
+        {{"Fruits", Enum("Fruits", {{"Pear", cases("груша", "груши")}})}});
+    for (const QString& expression : expressions)
+        document.addExpression(expression, notation);
+    return document;
+}
+
+// Результат каждого выражения: пояснение или имя первой ошибки
+QStringList results(const ExpressionDocument& document)
+{
+    QList<TEException> documentErrors;
+    QStringList results;
+    for (const TEResult<QString>& explanation : document.tryGetExplanationsInRu(documentErrors))
+        results.append(explanation ? explanation.value() : TEException::ErrorTypeNames.value(explanation.errors().first().getErrorType()));
+    for (const TEException& error : documentErrors)
+        results.append(TEException::ErrorTypeNames.value(error.getErrorType()));
+    return results;
+}
+
+// Большой документ для сравнения загрузки XML и пакета
+QByteArray makeLargeDocument(int variableCount)
+{
+    // Выражение использует все переменные, чтобы документ не содержал неиспользованных объявлений
+    QByteArray expression = "v0";
+    for (int i = 1; i < variableCount; i++)
+        expression += " v" + QByteArray::number(i) + " +";
+
+    QByteArray variables;
+    for (int i = 0; i < variableCount; i++) {
+        QByteArray description = "значение переменной номер " + QByteArray::number(i);
+        variables += variableXml("v" + QByteArray::number(i), description, description);
+    }
+    return documentXml("<expression>" + expression + "</expression>\n", variables);
+}
+}
+
+test_expressionBundle::test_expressionBundle(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_expressionBundle::roundTrip()
+{
+    QFETCH(QStringList, expressions);
+    QFETCH(bool, infix);
+
+    ExpressionDocument document = makeDocument(expressions, infix ? ExpressionNotation::Infix : ExpressionNotation::Postfix);
+    QByteArray bundle = ExpressionBundle::serialize(document);
+
+    // Одинаковые документы дают одинаковые пакеты
+    QCOMPARE(ExpressionBundle::serialize(makeDocument(expressions, infix ? ExpressionNotation::Infix : ExpressionNotation::Postfix)), bundle);
+
+    TEResult<ExpressionDocument> loaded = ExpressionBundle::deserialize(bundle);
+    QVERIFY(loaded);
+    QCOMPARE(loaded.value().count(), document.count());
+    QCOMPARE(loaded.value().declarations().getAllNames(), document.declarations().getAllNames());
+    QCOMPARE(results(loaded.value()), results(document));
+}
+
+void test_expressionBundle::roundTrip_data()
+{
+    QTest::addColumn<QStringList>("expressions");
+    QTest::addColumn<bool>("infix");
+
+    // Тест 1: Все объявления использованы одним выражением
+    QTest::newRow("single-expression")
+        << QStringList{"apple age . weigh(1) count + fruit Fruits Pear :: == &&"}
+        << false;
+
+    // Тест 2: Объявления использованы несколькими выражениями
+    QTest::newRow("several-expressions")
+        << QStringList{"apple age . count +", "fruit Fruits Pear :: ==", "count weigh(1)"}
+        << false;
+
+    // Тест 3: Инфиксная запись
+    QTest::newRow("infix")
+        << QStringList{"apple.age + count", "fruit == Fruits::Pear", "weigh(count)"}
+        << true;
+
+    // Тест 4: Ошибки выражений сохраняются после загрузки
+    QTest::newRow("expression-errors")
+        << QStringList{"count unknown +", "count"}
+        << false;
+}
+
+void test_expressionBundle::rejectInvalid()
+{
+    QFETCH(int, offset);
+    QFETCH(int, truncate);
+
+    QByteArray bundle = ExpressionBundle::serialize(makeDocument({"count"}));
+    if (offset >= 0) bundle[offset] = char(bundle[offset] ^ 0x01);
+    if (truncate > 0) bundle.chop(truncate);
+
+    TEResult<ExpressionDocument> loaded = ExpressionBundle::deserialize(bundle, "bundle");
+    QVERIFY(!loaded);
+    QCOMPARE(loaded.errors().first().getErrorType(), ErrorType::InvalidBundle);
+}
+
+void test_expressionBundle::rejectInvalid_data()
+{
+    QTest::addColumn<int>("offset");
+    QTest::addColumn<int>("truncate");
+
+    // Тест 1: Неверная сигнатура
+    QTest::newRow("magic") << 0 << 0;
+    // Тест 2: Другая версия формата
+    QTest::newRow("version") << 7 << 0;
+    // Тест 3: Размер данных не совпадает с заголовком
+    QTest::newRow("truncated") << -1 << 3;
+    // Тест 4: Повреждённые данные
+    QTest::newRow("payload") << int(ExpressionBundle::headerSize) + 5 << 0;
+    // Тест 5: Обрезанный заголовок
+    QTest::newRow("header") << -1 << 1000;
+}
+
+void test_expressionBundle::rejectStale()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString libraryPath = dir.filePath("library.xml");
+    const QString sourcePath = dir.filePath("input.xml");
+    const QString bundlePath = dir.filePath("input.texb");
+    const QByteArray source = "<root>\n<expression>a b +</expression>\n</root>\n";
+    QVERIFY(writeFile(libraryPath, libraryXml(applesXml() + pearsXml())));
+    QVERIFY(writeFile(sourcePath, source));
+
+    DeclarationLibrary::clearCache();
+    TEResult<QSharedPointer<const DeclarationLibrary>> library = DeclarationLibrary::load(libraryPath);
+    QVERIFY(library);
+    ParseReport report;
+    TEResult<ExpressionDocument> document = ExpressionXmlParser::parseDocumentFile(sourcePath, ValidationMode::CollectAll, report, library.value().data());
+    QVERIFY(document);
+    QVERIFY(ExpressionBundle::save(document.value(), bundlePath, sourcePath, library.value().data()).isEmpty());
+
+    // Пакет с неизменёнными исходными файлами загружается с библиотекой и без неё
+    QVERIFY(ExpressionBundle::load(bundlePath, library.value().data()));
+    QVERIFY(ExpressionBundle::load(bundlePath));
+
+    // Изменённый исходный документ
+    QVERIFY(writeFile(sourcePath, "<root>\n<expression>a b -</expression>\n</root>\n"));
+    TEResult<ExpressionDocument> staleSource = ExpressionBundle::load(bundlePath, library.value().data());
+    QVERIFY(!staleSource);
+    QCOMPARE(staleSource.errors().first().getErrorType(), ErrorType::InvalidBundle);
+
+    // Удалённый исходный документ не проверяется: пакет можно использовать без исходных файлов
+    QVERIFY(QFile::remove(sourcePath));
+    QVERIFY(ExpressionBundle::load(bundlePath, library.value().data()));
+
+    // Изменённая библиотека: подключённая при загрузке либо записанная в пакете
+    QVERIFY(writeFile(libraryPath, libraryXml(variableXml("a", "число яблок", "числа яблок") + pearsXml())));
+    DeclarationLibrary::clearCache();
+    TEResult<QSharedPointer<const DeclarationLibrary>> changedLibrary = DeclarationLibrary::load(libraryPath);
+    QVERIFY(changedLibrary);
+    TEResult<ExpressionDocument> staleLibrary = ExpressionBundle::load(bundlePath, changedLibrary.value().data());
+    QVERIFY(!staleLibrary);
+    QCOMPARE(staleLibrary.errors().first().getErrorType(), ErrorType::InvalidBundle);
+    QVERIFY(!ExpressionBundle::load(bundlePath));
+}
+
+void test_expressionBundle::loadBenchmark()
+{
+    QFETCH(bool, bundle);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString xmlPath = dir.filePath("input.xml");
+    QString bundlePath = dir.filePath("input.texb");
+    QVERIFY(writeFile(xmlPath, makeLargeDocument(20)));
+    TEResult<ExpressionDocument> document = ExpressionDocument::tryFromFile(xmlPath);
+    QVERIFY(document);
+    QVERIFY(ExpressionBundle::save(document.value(), bundlePath).isEmpty());
+
+    if (bundle) {
+        QBENCHMARK {
+            TEResult<ExpressionDocument> loaded = ExpressionBundle::load(bundlePath);
+            QVERIFY(loaded);
+        }
+    }
+    else {
+        QBENCHMARK {
+            TEResult<Expression> loaded = Expression::tryFromFile(xmlPath);
+            QVERIFY(loaded);
+        }
+    }
+}
+
+void test_expressionBundle::loadBenchmark_data()
+{
+    QTest::addColumn<bool>("bundle");
+
+    QTest::newRow("xml") << false;
+    QTest::newRow("bundle") << true;
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_EXPRESSIONBUNDLE_H
+#define TEST_EXPRESSIONBUNDLE_H
+
+#include <QObject>
+
+class test_expressionBundle : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_expressionBundle(QObject *parent = nullptr);
+
+private slots:
+    void roundTrip();
+    void roundTrip_data();
+    void rejectInvalid();
+    void rejectInvalid_data();
+    void rejectStale();
+    void loadBenchmark();
+    void loadBenchmark_data();
+};
+
+#endif // TEST_EXPRESSIONBUNDLE_H
@@ -0,0 +1,91 @@
+#include "test_expressiondocument.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <expressiondocument.h>
+
+test_expressionDocument::test_expressionDocument(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_expressionDocument::explanations()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(QVariantList, results);
+    QFETCH(QVariant, documentError);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("input.xml"), document));
+
+    TEResult<ExpressionDocument> parsed = ExpressionDocument::tryFromFile(dir.filePath("input.xml"));
+    QVERIFY2(parsed, parsed ? "" : qPrintable(parsed.errors().first().what()));
+
+    QList<TEException> documentErrors;
+    QList<TEResult<QString>> explanations = parsed.value().tryGetExplanationsInRu(documentErrors);
+    QCOMPARE(explanations.size(), results.size());
+
+    // Результат каждого выражения: пояснение или первая ошибка
+    for (qsizetype i = 0; i < results.size(); i++) {
+        if (results[i].userType() == qMetaTypeId<QString>()) {
+            QVERIFY2(explanations[i], qPrintable(QString("expression %1").arg(i + 1)));
+            QCOMPARE(explanations[i].value(), results[i].toString());
+        }
+        else {
+            QVERIFY(!explanations[i]);
+            QCOMPARE(explanations[i].errors().first().getErrorType(), results[i].value<ErrorType>());
+        }
+    }
+
+    // Ошибка документа в целом
+    if (documentError.isValid()) {
+        QCOMPARE(documentErrors.size(), 1);
+        QCOMPARE(documentErrors.first().getErrorType(), documentError.value<ErrorType>());
+    }
+    else {
+        QVERIFY(documentErrors.isEmpty());
+    }
+}
+
+void test_expressionDocument::explanations_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<QVariantList>("results");
+    QTest::addColumn<QVariant>("documentError");
+
+    // Тест 1: Документ с одним выражением
+    QTest::newRow("single-expression")
+        << documentXml("<expression>a b +</expression>\n", applesXml() + pearsXml())
+        << QVariantList{"сумма количества яблок и количества груш"}
+        << QVariant();
+
+    // Тест 2: Несколько выражений с общими объявлениями, специальные символы XML в каждом выражении
+    QTest::newRow("several-expressions")
+        << documentXml("<expressions>\n<expression>a b +</expression>\n<expression>a b <</expression>\n<expression notation=\"infix\">a < b</expression>\n</expressions>\n", applesXml() + pearsXml())
+        << QVariantList{"сумма количества яблок и количества груш", "количество яблок меньше количества груш", "количество яблок меньше количества груш"}
+        << QVariant();
+
+    // Тест 3: Каждое объявление использовано хотя бы одним выражением
+    QTest::newRow("declarations-used-by-set")
+        << documentXml("<expressions>\n<expression>a</expression>\n<expression>b</expression>\n</expressions>\n", applesXml() + pearsXml())
+        << QVariantList{"количество яблок", "количество груш"}
+        << QVariant();
+
+    // Тест 4: Объявление не использовано ни одним выражением
+    QTest::newRow("declaration-unused-by-set")
+        << documentXml("<expressions>\n<expression>a</expression>\n<expression>b</expression>\n</expressions>\n", applesXml() + pearsXml() + plumsXml())
+        << QVariantList{"количество яблок", "количество груш"}
+        << QVariant::fromValue<ErrorType>(ErrorType::NeverUsedElement);
+
+    // Тест 5: Ошибка одного выражения не влияет на остальные
+    QTest::newRow("error-in-one-expression")
+        << documentXml("<expressions>\n<expression>a b +</expression>\n<expression>a x +</expression>\n</expressions>\n", applesXml() + pearsXml())
+        << QVariantList{"сумма количества яблок и количества груш", QVariant::fromValue<ErrorType>(ErrorType::UndefinedId)}
+        << QVariant();
+
+    // Тест 6: В документе с одним выражением неиспользованное объявление – ошибка выражения
+    QTest::newRow("single-expression-unused-declaration")
+        << documentXml("<expression>a</expression>\n", applesXml() + pearsXml())
+        << QVariantList{QVariant::fromValue<ErrorType>(ErrorType::NeverUsedElement)}
+        << QVariant();
+}
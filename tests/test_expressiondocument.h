@@ -0,0 +1,17 @@
+#ifndef TEST_EXPRESSIONDOCUMENT_H
+#define TEST_EXPRESSIONDOCUMENT_H
+
+#include <QObject>
+
+class test_expressionDocument : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_expressionDocument(QObject *parent = nullptr);
+
+private slots:
+    void explanations();
+    void explanations_data();
+};
+
+#endif // TEST_EXPRESSIONDOCUMENT_H
@@ -0,0 +1,117 @@
+#include "test_expressionsession.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QElapsedTimer>
+#include <expressionsession.h>
+
+test_expressionSession::test_expressionSession(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_expressionSession::sameAsExpression()
+{
+    QFETCH(QStringList, edits);
+
+    const Expression declarations = makeDeclarations();
+    ExpressionSession session(declarations);
+    for (const QString& edit : edits) {
+        TEResult<QString> actual = session.update(edit);
+        TEResult<QString> expected = explainDirectly(declarations, edit);
+        QCOMPARE(session.expression(), edit);
+
+        qDebug() << "Expression:" << edit;
+        QCOMPARE(actual.isOk(), expected.isOk());
+        if (expected) QCOMPARE(actual.value(), expected.value());
+        else QCOMPARE(actual.errors().first().getErrorType(), expected.errors().first().getErrorType());
+    }
+}
+
+void test_expressionSession::sameAsExpression_data()
+{
+    QTest::addColumn<QStringList>("edits");
+
+    // Тест 1: Ввод выражения по одному символу
+    QTest::newRow("typing")
+        << QStringList{"a", "a ", "a b", "a b ", "a b +", "a b + ", "a b + c", "a b + c ", "a b + c *"};
+
+    // Тест 2: Изменение лексем в середине выражения
+    QTest::newRow("middle-edit")
+        << QStringList{"a b + c *", "a c + c *", "a c - c *", "a cc - c *", "a c - c *"};
+
+    // Тест 3: Удаление лексем
+    QTest::newRow("deletion")
+        << QStringList{"a b + c *", "a b +", "a", "", "b"};
+
+    // Тест 4: Инкремент переводится через промежуточное описание всего выражения
+    QTest::newRow("increment")
+        << QStringList{"a ++_ b +", "a ++_ c +", "a b +", "a _++ b +"};
+
+    // Тест 5: Вызов функции
+    QTest::newRow("function")
+        << QStringList{"a b max(2)", "a c max(2)", "a c max(2) b +", "a c max(2) b max(2)"};
+
+    // Тест 6: Строковая константа с пробелом внутри кавычек
+    QTest::newRow("quotes")
+        << QStringList{"a \"x y\" +", "a \"x y +", "a \"x\" +", "a b +"};
+
+    // Тест 7: Вставка пробела внутрь лексемы и объединение лексем
+    QTest::newRow("split-and-join")
+        << QStringList{"a b +", "a b+", "a b +", "ab +", "a b +"};
+}
+
+void test_expressionSession::reuse()
+{
+    ExpressionSession session(makeDeclarations());
+    QVERIFY(session.update("a b + c *").isOk());
+    QCOMPARE(session.lastUpdate().replayedTokens, qsizetype(5));
+
+    // Замена последнего операнда: лексемы до предшествующей изменению используются повторно
+    TEResult<QString> explanation = session.replace(6, 1, "a");
+    QVERIFY(explanation.isOk());
+    QCOMPARE(session.expression(), QString("a b + a *"));
+    QCOMPARE(explanation.value(), explainDirectly(makeDeclarations(), "a b + a *").value());
+    QCOMPARE(session.lastUpdate().tokenizedLength, qsizetype(1));
+    QCOMPARE(session.lastUpdate().replayedTokens, qsizetype(3));
+    // Описание неизменённой суммы берётся из кэша, переводятся только новый операнд и корень
+    QCOMPARE(session.lastUpdate().cachedNodes, qsizetype(1));
+    QCOMPARE(session.lastUpdate().renderedNodes, qsizetype(2));
+
+    // Пробел вне лексем не изменяет дерево
+    QVERIFY(session.update("a b + a * ").isOk());
+    QCOMPARE(session.lastUpdate().replayedTokens, qsizetype(0));
+    QVERIFY(session.root() != nullptr);
+
+    // Ошибка не мешает следующему изменению
+    QVERIFY(!session.update("a b + a * d").isOk());
+    QVERIFY(session.root() == nullptr);
+    QVERIFY(session.update("a b + a * ").isOk());
+}
+
+void test_expressionSession::updateBenchmark()
+{
+    // Целевая задержка обновления пояснения после одной правки
+    constexpr qint64 targetNsecsPerEdit = 100000;
+    constexpr int edits = 1000;
+
+    ExpressionSession session(makeDeclarations());
+    QVERIFY(session.update("a b + c * a b - / c +").isOk());
+    bool toggle = false;
+    QBENCHMARK {
+        toggle = !toggle;
+        QVERIFY(session.replace(20, 1, toggle ? "-" : "+").isOk());
+    }
+
+    // Средняя задержка одной правки
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < edits; i++) {
+        toggle = !toggle;
+        QVERIFY(session.replace(20, 1, toggle ? "-" : "+").isOk());
+    }
+    qint64 nsecsPerEdit = timer.nsecsElapsed() / edits;
+    qDebug() << "Edit latency:" << nsecsPerEdit / 1000.0 << "us, target:" << targetNsecsPerEdit / 1000 << "us";
+#ifdef QT_NO_DEBUG
+    // Целевая задержка относится к оптимизированной сборке
+    QVERIFY2(nsecsPerEdit < targetNsecsPerEdit, "edit latency exceeds the target");
+#endif
+}
@@ -0,0 +1,19 @@
+#ifndef TEST_EXPRESSIONSESSION_H
+#define TEST_EXPRESSIONSESSION_H
+
+#include <QObject>
+
+class test_expressionSession : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_expressionSession(QObject *parent = nullptr);
+
+private slots:
+    void sameAsExpression();
+    void sameAsExpression_data();
+    void reuse();
+    void updateBenchmark();
+};
+
+#endif // TEST_EXPRESSIONSESSION_H
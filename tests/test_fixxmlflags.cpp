@@ -0,0 +1,182 @@
+#include "test_fixxmlflags.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QDomDocument>
+#include <QTextStream>
+#include <expressiondocument.h>
+#include <expressionxmlparser.h>
+#include <textscanner.h>
+
+namespace {
+// Документ с длинными русскоязычными описаниями, содержащими специальные символы XML
+QByteArray makeLargeDocument(int variableCount)
+{
+    QByteArray expression;
+    for (int i = 0; i < variableCount; i++)
+        expression += (i == 0 ? "" : " ") + QByteArray("v") + QByteArray::number(i) + (i == 0 ? "" : " <");
+    QByteArray variables;
+    for (int i = 0; i < variableCount; i++) {
+        QByteArray description = "значение \"переменной\" номер " + QByteArray::number(i) + " & её <копия>";
+        variables += variableXml("v" + QByteArray::number(i), description, description);
+    }
+    return documentXml("<expression>" + expression + "</expression>\n", variables);
+}
+
+// Документ с выражениями и переменными a и b, описания которых заданы в именительном и родительном падежах
+QByteArray makeDocument(const QByteArray& expressions, const QByteArray& nominative, const QByteArray& genitive)
+{
+    return documentXml(expressions + "\n", variableXml("a", nominative, genitive) + variableXml("b", nominative, genitive));
+}
+
+// Экранирование специальных символов XML в тексте UTF-16, как до исправления документа в UTF-8
+QString escapeXmlText(const QString& text)
+{
+    QString output;
+    qsizetype position = 0;
+    qsizetype special;
+    while ((special = TextScanner::findXmlSpecial(text, position)) != -1) {
+        output.append(QStringView(text).sliced(position, special - position));
+        switch (text[special].unicode()) {
+        case '&': output.append(u"&amp;"); break;
+        case '<': output.append(u"&lt;"); break;
+        case '>': output.append(u"&gt;"); break;
+        case '"': output.append(u"&quot;"); break;
+        default: output.append(u"&apos;"); break;
+        }
+        position = special + 1;
+    }
+    output.append(QStringView(text).sliced(position));
+    return output;
+}
+
+// Замена содержимого каждого элемента с тегом tag экранированным содержимым (с конца документа)
+void escapeElements(QString& xml, const QString& tag)
+{
+    qsizetype end = xml.size();
+    while ((end = xml.lastIndexOf("</" + tag + ">", end)) != -1) {
+        qsizetype start = xml.lastIndexOf("<" + tag, end);
+        if (start == -1) break;
+        qsizetype contentStart = xml.indexOf('>', start) + 1;
+        xml.replace(contentStart, end - contentStart, escapeXmlText(xml.mid(contentStart, end - contentStart)));
+        end = start;
+    }
+}
+
+// Прежний путь: перекодирование в QString через QTextStream, исправление копии в UTF-16 и разбор QDomDocument
+bool parseThroughQString(const QByteArray& content)
+{
+    QByteArray bytes = content;
+    QTextStream stream(&bytes);
+    QString xml = stream.readAll();
+    escapeElements(xml, "expression");
+    escapeElements(xml, "case");
+    QDomDocument doc;
+    return bool(doc.setContent(xml));
+}
+
+// Разбор содержимого документа через общий путь разбора
+TEResult<ExpressionDocument> parse(const QByteArray& content)
+{
+    ParseReport report;
+    return ExpressionXmlParser::parseDocumentContent(content, "input.xml", ValidationMode::CollectAll, report);
+}
+}
+
+test_fixXmlFlags::test_fixXmlFlags(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_fixXmlFlags::fixXmlFlags()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(QStringList, expressions);
+    QFETCH(QString, nominative);
+    QFETCH(QString, genitive);
+
+    // Неэкранированные специальные символы исправляются до разбора и возвращаются в исходном виде
+    TEResult<ExpressionDocument> parsed = parse(document);
+    QVERIFY(parsed.isOk());
+    QCOMPARE(parsed.value().count(), expressions.size());
+    for (qsizetype i = 0; i < expressions.size(); i++)
+        QCOMPARE(*parsed.value().expression(i).getExpression(), expressions[i]);
+    const CaseDescription& description = parsed.value().declarations().getVariables()->value("a").description;
+    QCOMPARE(description.value(Case::Nominative), nominative);
+    QCOMPARE(description.value(Case::Genitive), genitive);
+}
+
+void test_fixXmlFlags::fixXmlFlags_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<QStringList>("expressions");
+    QTest::addColumn<QString>("nominative");
+    QTest::addColumn<QString>("genitive");
+
+    // Тест 1: Документ без специальных символов
+    QTest::newRow("no-special-characters")
+        << makeDocument("<expression>a b +</expression>", "число", "числа")
+        << QStringList{"a b +"} << "число" << "числа";
+
+    // Тест 2: Специальные символы выражения экранируются
+    QTest::newRow("expression")
+        << makeDocument("<expression>a b < a b > &&</expression>", "число", "числа")
+        << QStringList{"a b < a b > &&"} << "число" << "числа";
+
+    // Тест 3: Атрибуты тега <expression> не экранируются
+    QTest::newRow("expression-with-attribute")
+        << makeDocument("<expression notation=\"infix\">a < b</expression>", "число", "числа")
+        << QStringList{"a < b"} << "число" << "числа";
+
+    // Тест 4: Экранируется каждое выражение списка <expressions>
+    QTest::newRow("expression-list")
+        << makeDocument("<expressions><expression>a b <</expression><expression notation=\"infix\">a && b</expression></expressions>", "число", "числа")
+        << QStringList{"a b <", "a && b"} << "число" << "числа";
+
+    // Тест 5: Содержимое каждого падежа экранируется, многобайтовые символы сохраняются
+    QTest::newRow("cyrillic-cases")
+        << makeDocument("<expression>a b +</expression>", "\"а\" & 'б'", "в < г")
+        << QStringList{"a b +"} << "\"а\" & 'б'" << "в < г";
+
+    // Тест 6: Теги внутри падежа считаются текстом описания
+    QTest::newRow("tag-in-case")
+        << makeDocument("<expression>a b +</expression>", "значение <копия>", "значения </копия>")
+        << QStringList{"a b +"} << "значение <копия>" << "значения </копия>";
+}
+
+void test_fixXmlFlags::largeDocument()
+{
+    TEResult<ExpressionDocument> parsed = parse(makeLargeDocument(20));
+    QVERIFY(parsed.isOk());
+    const QHash<QString, Variable>* variables = parsed.value().declarations().getVariables();
+    QCOMPARE(variables->size(), qsizetype(20));
+    for (int i = 0; i < 20; i++)
+        QCOMPARE(variables->value("v" + QString::number(i)).description.value(Case::Instrumental),
+                 "значение \"переменной\" номер " + QString::number(i) + " & её <копия>");
+}
+
+void test_fixXmlFlags::fixXmlFlagsBenchmark()
+{
+    QFETCH(bool, utf8);
+    QByteArray document = makeLargeDocument(20);
+
+    // Исправление байтов UTF-8 и разбор документа без промежуточного QString;
+    // в отличие от прежнего пути, включает и построение документа выражений
+    if (utf8) {
+        QBENCHMARK {
+            QVERIFY(parse(document).isOk());
+        }
+    }
+    // Перекодирование в QString, исправление в UTF-16 и построение QDomDocument
+    else {
+        QBENCHMARK {
+            QVERIFY(parseThroughQString(document));
+        }
+    }
+}
+
+void test_fixXmlFlags::fixXmlFlagsBenchmark_data()
+{
+    QTest::addColumn<bool>("utf8");
+
+    QTest::newRow("qstring") << false;
+    QTest::newRow("utf8") << true;
+}
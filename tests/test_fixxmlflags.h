@@ -0,0 +1,20 @@
+#ifndef TEST_FIXXMLFLAGS_H
+#define TEST_FIXXMLFLAGS_H
+
+#include <QObject>
+
+class test_fixXmlFlags : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_fixXmlFlags(QObject *parent = nullptr);
+
+private slots:
+    void fixXmlFlags();
+    void fixXmlFlags_data();
+    void largeDocument();
+    void fixXmlFlagsBenchmark();
+    void fixXmlFlagsBenchmark_data();
+};
+
+#endif // TEST_FIXXMLFLAGS_H
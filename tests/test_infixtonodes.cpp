@@ -0,0 +1,119 @@
+#include "test_infixtonodes.h"
+#include <QtTest/QTest>
+#include <expression.h>
+#include <expressionnode.h>
+#include <teexception.h>
+
+test_infixToNodes::test_infixToNodes(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_infixToNodes::infixToNodes()
+{
+    QFETCH(QString, infix);
+    QFETCH(QString, postfix);
+    QFETCH(Expression, declarations);
+    QFETCH(ErrorType, expectedError);
+
+    Expression infixExpression = declarations;
+    infixExpression.setExpression(infix);
+    infixExpression.setNotation(ExpressionNotation::Infix);
+
+    if (postfix.isEmpty()) {
+        // Ожидаем ошибку разбора инфиксной записи
+        TEResult<ExpressionNode*> actualTree = infixExpression.tryExpressionToNodes();
+        QVERIFY2(!actualTree, "Expected an error, but the tree was built.");
+        QCOMPARE(TEException::ErrorTypeNames.value(actualTree.errors().first().getErrorType()),
+                 TEException::ErrorTypeNames.value(expectedError));
+        return;
+    }
+
+    // Дерево инфиксной записи совпадает с деревом эквивалентной обратной польской записи
+    Expression postfixExpression = declarations;
+    postfixExpression.setExpression(postfix);
+    try {
+        ExpressionNode* expectedTree = postfixExpression.expressionToNodes();
+        ExpressionNode* actualTree = infixExpression.expressionToNodes();
+
+        if (!(*actualTree == *expectedTree)) {
+            qDebug().noquote() << "Actual tree:\n" << actualTree->toString();
+            qDebug().noquote() << "Expected tree:\n" << expectedTree->toString();
+            QFAIL("Trees do not match.");
+        }
+
+        delete actualTree;
+        delete expectedTree;
+    } catch (const TEException& e) {
+        qDebug() << "Exception type: " << TEException::ErrorTypeNames.value(e.getErrorType());
+        QFAIL("Unexpected exception thrown.");
+    }
+}
+
+void test_infixToNodes::infixToNodes_data()
+{
+    QTest::addColumn<QString>("infix");
+    QTest::addColumn<QString>("postfix");
+    QTest::addColumn<Expression>("declarations");
+    QTest::addColumn<ErrorType>("expectedError");
+
+    Expression numbers("", {{"a", Variable("a", "int")}, {"b", Variable("b", "int")}, {"c", Variable("c", "int")}});
+
+    // Тест 1: Умножение выполняется раньше сложения
+    QTest::newRow("precedence") << "a + b * c" << "a b c * +" << numbers << ErrorType::Parsing;
+
+    // Тест 2: Скобки изменяют порядок операций
+    QTest::newRow("parentheses") << "(a + b) * c" << "a b + c *" << numbers << ErrorType::Parsing;
+
+    // Тест 3: Вычитание левоассоциативно
+    QTest::newRow("left-associative") << "a - b - c" << "a b - c -" << numbers << ErrorType::Parsing;
+
+    // Тест 4: Присваивание правоассоциативно
+    QTest::newRow("right-associative") << "a = b = c" << "a b c = =" << numbers << ErrorType::Parsing;
+
+    // Тест 5: Унарный минус
+    QTest::newRow("unary-minus") << "-a + b * c" << "a - b c * +" << numbers << ErrorType::Parsing;
+
+    // Тест 6: Отрицание сравнения
+    QTest::newRow("not-comparison") << "!(a < b) && c" << "a b < ! c &&" << numbers << ErrorType::Parsing;
+
+    // Тест 7: Постфиксный инкремент связывает сильнее разыменования
+    QTest::newRow("dereference-increment")
+        << "*p++" << "p _++ *_"
+        << Expression("", {{"p", Variable("p", "int*")}}) << ErrorType::Parsing;
+
+    // Тест 8: Индекс массива – выражение
+    QTest::newRow("array-index")
+        << "array[a + 1]" << "array a 1 + []"
+        << Expression("", {{"array", Variable("array", "int[]")}, {"a", Variable("a", "int")}}) << ErrorType::Parsing;
+
+    // Тест 9: Вызов функции с несколькими аргументами
+    QTest::newRow("function-call")
+        << "max(a, b + c)" << "a b c + max(2)"
+        << Expression("", {{"a", Variable("a", "int")}, {"b", Variable("b", "int")}, {"c", Variable("c", "int")}},
+                      {{"max", Function("max", "int", 2)}}) << ErrorType::Parsing;
+
+    // Тест 10: Элемент перечисления
+    QTest::newRow("enum-access")
+        << "TestEnum::ValueEnum" << "TestEnum ValueEnum ::"
+        << Expression("", {}, {}, {}, {}, {}, {{"TestEnum", Enum("TestEnum", {{"ValueEnum", {}}})}}) << ErrorType::Parsing;
+
+    // Тест 11: Обращение к полю объекта
+    QTest::newRow("field-access")
+        << "chel.age + 1" << "chel age . 1 +"
+        << Expression("", {{"chel", Variable("chel", "Human")}}, {}, {}, {}, {{"Human", Class("Human", {{"age", Variable("age", "int", {})}})}}) << ErrorType::Parsing;
+
+    // Тест 12: Повторный инкремент
+    QTest::newRow("multiple-increment") << "a++ ++" << "" << numbers << ErrorType::MultipleIncrementDecrement;
+
+    // Тест 13: Отсутствует правый операнд
+    QTest::newRow("missing-operand") << "a + b *" << "" << numbers << ErrorType::MissingOperand;
+
+    // Тест 14: Два операнда подряд
+    QTest::newRow("missing-operation") << "a b c" << "" << numbers << ErrorType::MissingOperations;
+
+    // Тест 15: Незакрытая скобка
+    QTest::newRow("unclosed-parenthesis") << "(a + b * c" << "" << numbers << ErrorType::InvalidSymbol;
+
+    // Тест 16: Неопределённый идентификатор
+    QTest::newRow("undefined-id") << "a + b + x" << "" << numbers << ErrorType::UndefinedId;
+}
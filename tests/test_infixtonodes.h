@@ -0,0 +1,17 @@
+#ifndef TEST_INFIXTONODES_H
+#define TEST_INFIXTONODES_H
+
+#include <QObject>
+
+class test_infixToNodes : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_infixToNodes(QObject *parent = nullptr);
+
+private slots:
+    void infixToNodes();
+    void infixToNodes_data();
+};
+
+#endif // TEST_INFIXTONODES_H
@@ -0,0 +1,181 @@
+#include "test_inputbudget.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <batchrunner.h>
+#include <expressiondocument.h>
+#include <expressionxmlparser.h>
+#include <inputbudget.h>
+
+namespace {
+// Разбор и пояснение документа так же, как при пакетной обработке
+QString explainContent(const QByteArray& content, QList<TEException>& errors)
+{
+    ParseReport report;
+    TEResult<ExpressionDocument> document = ExpressionXmlParser::parseDocumentContent(content, "input.xml", ValidationMode::CollectAll, report);
+    if (!document) {
+        errors = document.errors();
+        return QString();
+    }
+    QStringList lines;
+    for (const TEResult<QString>& explanation : document.value().tryGetExplanationsInRu(errors)) {
+        if (explanation) lines.append(explanation.value());
+        else errors += explanation.errors();
+    }
+    return lines.join('\n');
+}
+
+// Документ с инфиксным выражением, обращающимся к полю переменной-структуры
+QByteArray memberAccessDocumentXml(const QByteArray& expression)
+{
+    QByteArray point = "<variable name=\"p\" type=\"Point\">\n" + descriptionXml("точка", "точки") + "</variable>\n";
+    QByteArray structures = "<structures>\n<structure name=\"Point\">\n<variables>\n" + variableXml("x", "абсцисса", "абсциссы")
+                            + "</variables>\n<functions/>\n</structure>\n</structures>\n";
+    return documentXml("<expression notation=\"infix\">" + expression + "</expression>\n", point + applesXml())
+        .replace("<structures/>\n", structures);
+}
+}
+
+test_inputBudget::test_inputBudget(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_inputBudget::parseLimits()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, valid);
+    QFETCH(qint64, wallTimeMs);
+    QFETCH(qint64, nodes);
+    QFETCH(qint64, outputLength);
+    QFETCH(qint64, bytes);
+
+    BudgetLimits limits;
+    QCOMPARE(InputBudget::parseLimits(text, limits), valid);
+    if (!valid) return;
+    QCOMPARE(limits.wallTimeMs, wallTimeMs);
+    QCOMPARE(limits.nodes, nodes);
+    QCOMPARE(limits.outputLength, outputLength);
+    QCOMPARE(limits.bytes, bytes);
+}
+
+void test_inputBudget::parseLimits_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<qint64>("wallTimeMs");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<qint64>("outputLength");
+    QTest::addColumn<qint64>("bytes");
+
+    QTest::newRow("all-resources") << "time-ms:1000,nodes:50,output-length:2000,bytes:65536" << true << qint64(1000) << qint64(50) << qint64(2000) << qint64(65536);
+    QTest::newRow("any-order") << "bytes:10, time-ms:20" << true << qint64(20) << qint64(0) << qint64(0) << qint64(10);
+    QTest::newRow("single-resource") << "nodes:7" << true << qint64(0) << qint64(7) << qint64(0) << qint64(0);
+    QTest::newRow("unknown-resource") << "memory:100" << false << qint64(0) << qint64(0) << qint64(0) << qint64(0);
+    QTest::newRow("zero-value") << "nodes:0" << false << qint64(0) << qint64(0) << qint64(0) << qint64(0);
+    QTest::newRow("negative-value") << "nodes:-5" << false << qint64(0) << qint64(0) << qint64(0) << qint64(0);
+    QTest::newRow("missing-value") << "nodes" << false << qint64(0) << qint64(0) << qint64(0) << qint64(0);
+    QTest::newRow("empty") << "" << false << qint64(0) << qint64(0) << qint64(0) << qint64(0);
+}
+
+void test_inputBudget::exceedsBudget()
+{
+    QFETCH(QByteArray, content);
+    QFETCH(qint64, nodes);
+    QFETCH(qint64, outputLength);
+    QFETCH(qint64, bytes);
+    QFETCH(QString, exceededResource);
+
+    QList<TEException> unlimitedErrors;
+    QString unlimited = explainContent(content, unlimitedErrors);
+    QVERIFY(unlimitedErrors.isEmpty());
+
+    BudgetLimits limits;
+    limits.nodes = nodes;
+    limits.outputLength = outputLength;
+    limits.bytes = bytes;
+    QList<TEException> errors;
+    QString explanation;
+    {
+        InputBudget::Scope budget(limits);
+        explanation = explainContent(content, errors);
+        QCOMPARE(budget.isExceeded(), !exceededResource.isEmpty());
+    }
+    QVERIFY(!InputBudget::isActive());
+
+    // В пределах бюджета пояснение не отличается от пояснения без бюджета
+    if (exceededResource.isEmpty()) {
+        QVERIFY(errors.isEmpty());
+        QCOMPARE(explanation, unlimited);
+        return;
+    }
+    // Превышение бюджета сообщается одной ошибкой с именем ресурса
+    QCOMPARE(errors.size(), qsizetype(1));
+    QCOMPARE(errors.first().getErrorType(), ErrorType::BudgetExceeded);
+    QCOMPARE(errors.first().getArgs().value(0), exceededResource);
+}
+
+void test_inputBudget::exceedsBudget_data()
+{
+    QTest::addColumn<QByteArray>("content");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<qint64>("outputLength");
+    QTest::addColumn<qint64>("bytes");
+    QTest::addColumn<QString>("exceededResource");
+
+    QTest::newRow("unlimited") << expressionDocumentXml("a b +") << qint64(0) << qint64(0) << qint64(0) << QString();
+    QTest::newRow("within-budget") << expressionDocumentXml("a b + a *") << qint64(5) << qint64(100000) << qint64(1000000) << QString();
+    QTest::newRow("input-bytes") << expressionDocumentXml("a b +") << qint64(0) << qint64(0) << qint64(100) << "bytes";
+    QTest::newRow("postfix-nodes") << expressionDocumentXml("a b + a *") << qint64(4) << qint64(0) << qint64(0) << "nodes";
+    QTest::newRow("infix-nodes") << expressionDocumentXml("(a + b) * a", ExpressionNotation::Infix) << qint64(4) << qint64(0) << qint64(0) << "nodes";
+    QTest::newRow("infix-member-access-nodes") << memberAccessDocumentXml("p.x + a") << qint64(2) << qint64(0) << qint64(0) << "nodes";
+    QTest::newRow("output-length") << expressionDocumentXml("a b + a *") << qint64(0) << qint64(20) << qint64(0) << "output-length";
+}
+
+void test_inputBudget::wallTime()
+{
+    BudgetLimits limits;
+    limits.wallTimeMs = 1;
+    InputBudget::Scope budget(limits);
+    QTest::qSleep(20);
+
+    QList<TEException> errors;
+    explainContent(expressionDocumentXml("a b +"), errors);
+    QVERIFY(budget.isExceeded());
+    QCOMPARE(errors.size(), qsizetype(1));
+    QCOMPARE(errors.first().getErrorType(), ErrorType::BudgetExceeded);
+    QCOMPARE(errors.first().getArgs().value(0), QString("time-ms"));
+}
+
+void test_inputBudget::batchStatistics()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    // Файл с длинным выражением превышает бюджет узлов, следующие файлы обрабатываются в собственном бюджете
+    QVERIFY(writeFile(dir.filePath("input0.xml"), expressionDocumentXml("a b + a * b - a +")));
+    QVERIFY(writeFile(dir.filePath("input1.xml"), expressionDocumentXml("a b +")));
+    QVERIFY(writeFile(dir.filePath("input2.xml"), expressionDocumentXml("a b *")));
+    QVERIFY(writeFile(dir.filePath("input3.xml"), expressionDocumentXml("a c +")));
+
+    TEResult<QStringList> manifest = BatchRunner::readManifest(dir.path());
+    QVERIFY(manifest.isOk());
+    BatchResult unlimited = BatchRunner::run(manifest.value(), ShardSpec());
+    BudgetLimits limits;
+    limits.nodes = 4;
+    BatchResult result = BatchRunner::run(manifest.value(), ShardSpec(), nullptr, limits);
+
+    BatchStatistics statistics = result.statistics();
+    QCOMPARE(statistics.inputs, qsizetype(4));
+    QCOMPARE(statistics.succeeded, qsizetype(2));
+    QCOMPARE(statistics.failed, qsizetype(2));
+    QCOMPARE(statistics.budgetHits, qsizetype(1));
+    QCOMPARE(statistics.errors.value("BudgetExceeded"), qsizetype(1));
+    QCOMPARE(statistics.errors.value("UndefinedId"), qsizetype(1));
+    QCOMPARE(unlimited.statistics().budgetHits, qsizetype(0));
+    for (qsizetype i = 1; i < result.records.size(); i++)
+        QCOMPARE(result.records[i].explanation, unlimited.records[i].explanation);
+
+    // Сводка восстанавливается из файла результата
+    TEResult<BatchResult> restored = BatchRunner::deserialize(BatchRunner::serialize(result));
+    QVERIFY(restored.isOk());
+    QCOMPARE(restored.value().statistics().budgetHits, qsizetype(1));
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_INPUTBUDGET_H
+#define TEST_INPUTBUDGET_H
+
+#include <QObject>
+
+class test_inputBudget : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_inputBudget(QObject *parent = nullptr);
+
+private slots:
+    void parseLimits();
+    void parseLimits_data();
+    void exceedsBudget();
+    void exceedsBudget_data();
+    void wallTime();
+    void batchStatistics();
+};
+
+#endif // TEST_INPUTBUDGET_H
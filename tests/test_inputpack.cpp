@@ -0,0 +1,194 @@
+#include "test_inputpack.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <batchrunner.h>
+#include <inputpack.h>
+#include <cstring>
+
+namespace {
+// Каталог входных файлов: пояснимые выражения, выражение с необъявленной переменной и не XML
+bool writeInputs(const QTemporaryDir& dir)
+{
+    return writeFile(dir.filePath("input0.xml"), expressionDocumentXml("a b +"))
+        && writeFile(dir.filePath("input1.xml"), expressionDocumentXml("a b * a -"))
+        && writeFile(dir.filePath("input2.xml"), expressionDocumentXml("a c +"))
+        && writeFile(dir.filePath("input3.xml"), "not xml")
+        && writeFile(dir.filePath("input4.xml"), expressionDocumentXml("a b /"));
+}
+
+// Заголовок контейнера с указанными версией и количеством записей
+QByteArray packHeader(quint32 version, quint64 count)
+{
+    QByteArray header(InputPack::headerSize, '\0');
+    memcpy(header.data(), "TEXP", 4);
+    qToBigEndian<quint32>(version, header.data() + 4);
+    qToBigEndian<quint64>(count, header.data() + 8);
+    return header;
+}
+
+// Запись контейнера с длиной содержимого, которая может не совпадать с фактической
+QByteArray packRecord(quint8 kind, const QByteArray& name, const QByteArray& data, quint64 dataSize)
+{
+    QByteArray record(1, char(kind));
+    char size[8];
+    qToBigEndian<quint32>(quint32(name.size()), size);
+    record += QByteArray(size, 4) + name;
+    qToBigEndian<quint64>(dataSize, size);
+    return record + QByteArray(size, 8) + data;
+}
+}
+
+test_inputPack::test_inputPack(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_inputPack::roundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeInputs(dir));
+    QVERIFY(writeFile(dir.filePath("empty.xml"), QByteArray()));
+
+    QString packPath = dir.filePath("inputs.texp");
+    QVERIFY(BatchRunner::pack(dir.path(), packPath).isEmpty());
+    QVERIFY(InputPack::isPackFile(packPath));
+    QVERIFY(!InputPack::isPackFile(dir.filePath("input0.xml")));
+
+    // Записи следуют в порядке списка входных файлов и совпадают с файлами побайтно
+    TEResult<QStringList> manifest = BatchRunner::readManifest(dir.path());
+    QVERIFY(manifest.isOk());
+    TEResult<QSharedPointer<const InputPack>> pack = InputPack::load(packPath);
+    QVERIFY(pack.isOk());
+    QCOMPARE(pack.value()->count(), manifest.value().size());
+    for (qsizetype i = 0; i < manifest.value().size(); i++) {
+        QFile file(manifest.value()[i]);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const PackRecord& record = pack.value()->record(i);
+        QCOMPARE(record.name, QFileInfo(file).fileName());
+        QCOMPARE(record.kind, PackRecordKind::Content);
+        QCOMPARE(record.data, file.readAll());
+    }
+
+    // Недоступный файл не создаёт контейнер
+    QVERIFY(!BatchRunner::pack(dir.filePath("missing"), dir.filePath("missing.texp")).isEmpty());
+    QVERIFY(!QFile::exists(dir.filePath("missing.texp")));
+}
+
+void test_inputPack::runMatchesManifest()
+{
+    QFETCH(QString, shardText);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeInputs(dir));
+    QString packPath = dir.filePath("inputs.texp");
+    QVERIFY(BatchRunner::pack(dir.path(), packPath).isEmpty());
+
+    ShardSpec shard;
+    QVERIFY(BatchRunner::parseShard(shardText, shard));
+    TEResult<QStringList> manifest = BatchRunner::readManifest(dir.path());
+    QVERIFY(manifest.isOk());
+    TEResult<QSharedPointer<const InputPack>> pack = InputPack::load(packPath);
+    QVERIFY(pack.isOk());
+    BatchResult expected = BatchRunner::run(manifest.value(), shard);
+    BatchResult actual = BatchRunner::run(*pack.value(), shard);
+
+    // Контейнер поясняется так же, как отдельные файлы; различаются только имена входных файлов
+    QCOMPARE(actual.manifestSize, expected.manifestSize);
+    QCOMPARE(actual.manifestDigest, expected.manifestDigest);
+    QCOMPARE(actual.records.size(), expected.records.size());
+    for (qsizetype i = 0; i < expected.records.size(); i++) {
+        QCOMPARE(actual.records[i].order, expected.records[i].order);
+        QCOMPARE(actual.records[i].input, QFileInfo(expected.records[i].input).fileName());
+        QCOMPARE(actual.records[i].explanation, expected.records[i].explanation);
+        QCOMPARE(actual.records[i].errors.size(), expected.records[i].errors.size());
+        for (qsizetype j = 0; j < expected.records[i].errors.size(); j++)
+            QCOMPARE(actual.records[i].errors[j].type, expected.records[i].errors[j].type);
+    }
+}
+
+void test_inputPack::runMatchesManifest_data()
+{
+    QTest::addColumn<QString>("shardText");
+
+    QTest::newRow("all") << "1/1";
+    QTest::newRow("order-first") << "1/2";
+    QTest::newRow("order-second") << "2/2";
+    QTest::newRow("hash-first") << "1/3:hash";
+    QTest::newRow("hash-third") << "3/3:hash";
+}
+
+void test_inputPack::savePacked()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeInputs(dir));
+    QString packPath = dir.filePath("inputs.texp");
+    QVERIFY(BatchRunner::pack(dir.path(), packPath).isEmpty());
+    TEResult<QSharedPointer<const InputPack>> input = InputPack::load(packPath);
+    QVERIFY(input.isOk());
+    BatchResult result = BatchRunner::run(*input.value(), ShardSpec());
+
+    QString outputPath = dir.filePath("explanations.texp");
+    QVERIFY(BatchRunner::savePacked(result, outputPath).isEmpty());
+    TEResult<QSharedPointer<const InputPack>> output = InputPack::load(outputPath);
+    QVERIFY(output.isOk());
+
+    // Каждой записи входного контейнера соответствует запись пояснения или ошибок с тем же именем
+    QCOMPARE(output.value()->count(), input.value()->count());
+    for (qsizetype i = 0; i < result.records.size(); i++) {
+        const BatchRecord& batchRecord = result.records[i];
+        const PackRecord& record = output.value()->record(i);
+        QCOMPARE(record.name, input.value()->record(batchRecord.order).name);
+        if (batchRecord.errors.isEmpty()) {
+            QCOMPARE(record.kind, PackRecordKind::Content);
+            QCOMPARE(QString::fromUtf8(record.data), batchRecord.explanation);
+        }
+        else {
+            QCOMPARE(record.kind, PackRecordKind::Errors);
+            QStringList messages;
+            for (const BatchError& error : batchRecord.errors)
+                messages.append(error.message);
+            QCOMPARE(QString::fromUtf8(record.data), messages.join('\n'));
+        }
+    }
+}
+
+void test_inputPack::invalidPack()
+{
+    QFETCH(QByteArray, content);
+    QFETCH(bool, valid);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("input.texp");
+    QVERIFY(writeFile(path, content));
+
+    TEResult<QSharedPointer<const InputPack>> pack = InputPack::load(path);
+    QCOMPARE(pack.isOk(), valid);
+    if (valid) return;
+    QCOMPARE(pack.errors().size(), qsizetype(1));
+    QCOMPARE(pack.errors().first().getErrorType(), ErrorType::InvalidInputPack);
+}
+
+void test_inputPack::invalidPack_data()
+{
+    QTest::addColumn<QByteArray>("content");
+    QTest::addColumn<bool>("valid");
+
+    QByteArray record = packRecord(0, "a.xml", "<root/>", 7);
+    QTest::newRow("valid") << packHeader(1, 1) + record << true;
+    QTest::newRow("empty-pack") << packHeader(1, 0) << true;
+    QTest::newRow("empty-file") << QByteArray() << false;
+    QTest::newRow("wrong-magic") << "TEXB" + packHeader(1, 1).mid(4) + record << false;
+    QTest::newRow("wrong-version") << packHeader(2, 1) + record << false;
+    QTest::newRow("truncated-header") << packHeader(1, 1).left(10) << false;
+    QTest::newRow("truncated-record") << packHeader(1, 1) + record.chopped(3) << false;
+    QTest::newRow("huge-count") << packHeader(1, quint64(1) << 60) + record << false;
+    QTest::newRow("huge-data-size") << packHeader(1, 1) + packRecord(0, "a.xml", "<root/>", quint64(1) << 62) << false;
+    QTest::newRow("unknown-kind") << packHeader(1, 1) + packRecord(7, "a.xml", "<root/>", 7) << false;
+    QTest::newRow("trailing-data") << packHeader(1, 1) + record + "x" << false;
+}
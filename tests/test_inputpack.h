@@ -0,0 +1,21 @@
+#ifndef TEST_INPUTPACK_H
+#define TEST_INPUTPACK_H
+
+#include <QObject>
+
+class test_inputPack : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_inputPack(QObject *parent = nullptr);
+
+private slots:
+    void roundTrip();
+    void runMatchesManifest();
+    void runMatchesManifest_data();
+    void savePacked();
+    void invalidPack();
+    void invalidPack_data();
+};
+
+#endif // TEST_INPUTPACK_H
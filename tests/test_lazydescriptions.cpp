@@ -0,0 +1,154 @@
+#include "test_lazydescriptions.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <declarationlibrary.h>
+#include <expression.h>
+#include <expressionxmlparser.h>
+#include <pipelinestats.h>
+
+namespace {
+// Библиотека из 20 переменных и 20 структур по 20 полей
+QByteArray makeLibrary()
+{
+    QByteArray library = "<root>\n<variables>\n";
+    for (int i = 0; i < 20; i++)
+        library += variableXml("v" + QByteArray::number(i), "значение переменной " + QByteArray::number(i), "значения переменной " + QByteArray::number(i));
+    library += "</variables>\n<structures>\n";
+    for (int i = 0; i < 20; i++) {
+        library += "<structure name=\"S" + QByteArray::number(i) + "\">\n<variables>\n";
+        for (int j = 0; j < 20; j++)
+            library += variableXml("f" + QByteArray::number(j), "поле " + QByteArray::number(j), "поля " + QByteArray::number(j));
+        library += "</variables>\n<functions/>\n</structure>\n";
+    }
+    return library + "</structures>\n</root>\n";
+}
+
+const QByteArray InputStart = "<root>\n<expression>a b +</expression>\n<variables>\n";
+}
+
+test_lazyDescriptions::test_lazyDescriptions(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_lazyDescriptions::sameInBothModes()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(QVariant, result);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("input.xml"), input));
+
+    // Результат и ошибки не зависят от режима загрузки описаний
+    for (DescriptionLoading loading : {DescriptionLoading::Eager, DescriptionLoading::Lazy}) {
+        ExpressionXmlParser::setDescriptionLoading(loading);
+        TEResult<Expression> expression = Expression::tryFromFile(dir.filePath("input.xml"));
+        TEResult<QString> explanation = expression ? expression.value().tryGetExplanationInRu() : TEResult<QString>(expression.errors());
+        ExpressionXmlParser::setDescriptionLoading(DescriptionLoading::Lazy);
+
+        if (explanation) {
+            qDebug() << "Actual result:" << explanation.value();
+            QCOMPARE(explanation.value(), result.toString());
+            continue;
+        }
+
+        ErrorType errorType = explanation.errors().first().getErrorType();
+        QVERIFY2(result.userType() == qMetaTypeId<ErrorType>(), qPrintable(TEException::ErrorTypeNames.value(errorType)));
+        qDebug() << "Actual error:" << TEException::ErrorTypeNames.value(errorType);
+        QCOMPARE(errorType, result.value<ErrorType>());
+    }
+}
+
+void test_lazyDescriptions::sameInBothModes_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<QVariant>("result");
+
+    // Тест 1: Текст падежей без пробелов по краям
+    QTest::newRow("compact-cases")
+        << QByteArray(InputStart + variableXml("a", "количество яблок", "количества яблок") + pearsXml() + "</variables>\n</root>\n")
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 2: Текст падежей с переводами строк и отступами по краям
+    QTest::newRow("padded-cases")
+        << QByteArray(InputStart + variableXml("a", "количество яблок", "количества яблок", "\n    ") + pearsXml() + "</variables>\n</root>\n")
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 3: Текст падежа со ссылками на символы, который не совпадает с участком документа
+    QTest::newRow("escaped-case")
+        << QByteArray(InputStart + variableXml("a", "количество яблок", "количества \"яблок\" & слив") + pearsXml() + "</variables>\n</root>\n")
+        << QVariant("сумма количества \"яблок\" & слив и количества груш");
+
+    // Тест 4: Текст падежа с неразрывными пробелами по краям
+    QTest::newRow("nbsp-padded-case")
+        << QByteArray(InputStart + variableXml("a", "количество яблок", "\u00A0количества яблок\u00A0") + pearsXml() + "</variables>\n</root>\n")
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 5: Падеж, содержащий только пробелы
+    QTest::newRow("whitespace-only-case")
+        << QByteArray(InputStart + variableXml("a", "   ", "количества яблок") + pearsXml() + "</variables>\n</root>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::EmptyElementValue);
+
+    // Тест 6: Падеж длиннее допустимого
+    QTest::newRow("too-long-case")
+        << QByteArray(InputStart + variableXml("a", QByteArray(300, 'x'), "количества яблок", "  ") + pearsXml() + "</variables>\n</root>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::InputSizeExceeded);
+
+    // Тест 7: Описание без предложного падежа
+    QByteArray incomplete = variableXml("a", "количество яблок", "количества яблок");
+    incomplete.replace("<case type=\"предложный\">количество яблок</case>\n", "");
+    QTest::newRow("missing-case")
+        << QByteArray(InputStart + incomplete + pearsXml() + "</variables>\n</root>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::MissingCases);
+}
+
+void test_lazyDescriptions::materializesUsedOnly()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("library.xml"), makeLibrary()));
+    QVERIFY(writeFile(dir.filePath("input.xml"), "<root>\n<expression>v0 v1 +</expression>\n</root>\n"));
+
+    PipelineStats::reset();
+    PipelineStats::setEnabled(true);
+    TEResult<QSharedPointer<const DeclarationLibrary>> library = DeclarationLibrary::load(dir.filePath("library.xml"));
+    qint64 materializedOnLoad = PipelineStats::value(PipelineCounter::DescriptionMaterializations);
+    TEResult<Expression> expression = library ? Expression::tryFromFile(dir.filePath("input.xml"), library.value().data()) : TEResult<Expression>(library.errors());
+    TEResult<QString> explanation = expression ? expression.value().tryGetExplanationInRu() : TEResult<QString>(expression.errors());
+    qint64 materialized = PipelineStats::value(PipelineCounter::DescriptionMaterializations);
+    PipelineStats::setEnabled(false);
+
+    QVERIFY(explanation);
+    QCOMPARE(explanation.value(), QString("сумма значения переменной 0 и значения переменной 1"));
+
+    // При загрузке библиотеки строки падежей не извлекаются. Каждая из шести форм шаблона суммы подставляет
+    // родительный падеж обоих слагаемых, поэтому при переводе извлекаются только эти падежи v0 и v1
+    QCOMPARE(materializedOnLoad, qint64(0));
+    QCOMPARE(materialized, qint64(2 * CaseCount));
+}
+
+void test_lazyDescriptions::libraryLoadBenchmark()
+{
+    QFETCH(bool, lazy);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("library.xml");
+    QVERIFY(writeFile(path, makeLibrary()));
+
+    ExpressionXmlParser::setDescriptionLoading(lazy ? DescriptionLoading::Lazy : DescriptionLoading::Eager);
+    QBENCHMARK {
+        TEResult<Expression> declarations = ExpressionXmlParser::parseLibraryFile(path);
+        QVERIFY(declarations);
+    }
+    ExpressionXmlParser::setDescriptionLoading(DescriptionLoading::Lazy);
+}
+
+void test_lazyDescriptions::libraryLoadBenchmark_data()
+{
+    QTest::addColumn<bool>("lazy");
+
+    QTest::newRow("eager") << false;
+    QTest::newRow("lazy") << true;
+}
@@ -0,0 +1,20 @@
+#ifndef TEST_LAZYDESCRIPTIONS_H
+#define TEST_LAZYDESCRIPTIONS_H
+
+#include <QObject>
+
+class test_lazyDescriptions : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_lazyDescriptions(QObject *parent = nullptr);
+
+private slots:
+    void sameInBothModes();
+    void sameInBothModes_data();
+    void materializesUsedOnly();
+    void libraryLoadBenchmark();
+    void libraryLoadBenchmark_data();
+};
+
+#endif // TEST_LAZYDESCRIPTIONS_H
@@ -0,0 +1,78 @@
+#include "test_normalize.h"
+#include <QtTest/QTest>
+#include <expression.h>
+#include <expressionnormalizer.h>
+
+Q_DECLARE_METATYPE(RenderRule)
+Q_DECLARE_METATYPE(OperationType)
+
+test_normalize::test_normalize(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_normalize::normalize()
+{
+    QFETCH(QString, expression);
+    QFETCH(RenderRule, rootRule);
+    QFETCH(OperationType, rootTemplate);
+    QFETCH(RenderRule, leftRule);
+    QFETCH(OperationType, leftTemplate);
+
+    // Дерево нормализуется при построении
+    ExpressionNode* root = Expression(expression).expressionToNodes();
+
+    QCOMPARE(root->getRenderRule(), rootRule);
+    QCOMPARE(root->getTemplateType(), rootTemplate);
+    QCOMPARE(root->getLeftNode()->getRenderRule(), leftRule);
+    QCOMPARE(root->getLeftNode()->getTemplateType(), leftTemplate);
+
+    // Сохранённый способ перевода совпадает с определяемым заново
+    NodeRendering resolved = ExpressionNormalizer::resolve(root, OperationType::None);
+    QCOMPARE(resolved.rule, rootRule);
+    QCOMPARE(resolved.templateType, rootTemplate);
+}
+
+void test_normalize::normalize_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<RenderRule>("rootRule");
+    QTest::addColumn<OperationType>("rootTemplate");
+    QTest::addColumn<RenderRule>("leftRule");
+    QTest::addColumn<OperationType>("leftTemplate");
+
+    // Тест 1: Сложение констант переводится шаблоном операции
+    QTest::newRow("addition")
+        << "1 2 +"
+        << RenderRule::Template << OperationType::Addition
+        << RenderRule::Unresolved << OperationType::None;
+
+    // Тест 2: Последовательность вычитаний: вложенное вычитание переводится шаблоном последовательности
+    QTest::newRow("subtraction-sequence")
+        << "1 2 - 3 -"
+        << RenderRule::Enumeration << OperationType::None
+        << RenderRule::Template << OperationType::SubtractionSequence;
+
+    // Тест 3: Отрицание сравнения: вложенное сравнение переводится обратным шаблоном
+    QTest::newRow("not-over-comparison")
+        << "1 2 < !"
+        << RenderRule::InvertedComparison << OperationType::None
+        << RenderRule::Template << OperationType::NotLessThan;
+
+    // Тест 4: Двойной унарный минус сокращается, вложенный минус не переводится
+    QTest::newRow("double-unary-minus")
+        << "1 - -"
+        << RenderRule::SkipSelfInverse << OperationType::None
+        << RenderRule::Unresolved << OperationType::None;
+
+    // Тест 5: Сложение строк переводится как конкатенация
+    QTest::newRow("string-concatenation")
+        << "\"a\" \"b\" +"
+        << RenderRule::Template << OperationType::Concatenation
+        << RenderRule::Unresolved << OperationType::None;
+
+    // Тест 6: Сложение внутри сложения переводится перечислением
+    QTest::newRow("nested-addition")
+        << "1 2 + 3 +"
+        << RenderRule::Template << OperationType::Addition
+        << RenderRule::Enumeration << OperationType::None;
+}
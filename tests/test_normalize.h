@@ -0,0 +1,17 @@
+#ifndef TEST_NORMALIZE_H
+#define TEST_NORMALIZE_H
+
+#include <QObject>
+
+class test_normalize : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_normalize(QObject *parent = nullptr);
+
+private slots:
+    void normalize();
+    void normalize_data();
+};
+
+#endif // TEST_NORMALIZE_H
@@ -87,4 +87,19 @@ void test_removeConsecutiveDuplicates::removeConsecutiveDuplicates_data()
     QTest::newRow("two-identical-words-not-separated")
         << "словослово"
         << "словослово";
+
+    // Test 13: Слова разделены несколькими пробелами, строка начинается и заканчивается пробелом
+    QTest::newRow("multiple-spaces-between-words")
+        << " слово   слово  другое "
+        << "слово другое";
+
+    // Test 14: Повторы латинских слов в разном регистре
+    QTest::newRow("latin-words-different-case")
+        << "Value value VALUE x"
+        << "Value x";
+
+    // Test 15: Повтор после слова с запятой удаляется только для следующего за ним слова
+    QTest::newRow("duplicates-after-word-with-comma")
+        << "слово, слово слово"
+        << "слово, слово";
 }
@@ -0,0 +1,146 @@
+#include "test_subtreeexplanations.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <expressionsession.h>
+
+Q_DECLARE_METATYPE(ExpressionNotation)
+
+namespace {
+// Общие объявления для выражения в заданной форме записи
+Expression makeDeclarations(ExpressionNotation notation)
+{
+    Expression declarations = ::makeDeclarations();
+    declarations.setNotation(notation);
+    return declarations;
+}
+
+// Пояснения поддеревьев выражения
+TEResult<QList<SubtreeExplanation>> explainSubtrees(const Expression& declarations, const QString& text, Case grammaticalCase = Case::Nominative)
+{
+    Expression expression = declarations;
+    expression.setExpression(text);
+    return expression.tryGetSubtreeExplanations(grammaticalCase);
+}
+}
+
+test_subtreeExplanations::test_subtreeExplanations(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_subtreeExplanations::sameAsStandalone()
+{
+    QFETCH(QString, expression);
+    QFETCH(ExpressionNotation, notation);
+    QFETCH(QStringList, expectedSpans);
+
+    const Expression declarations = makeDeclarations(notation);
+    TEResult<QList<SubtreeExplanation>> explanations = explainSubtrees(declarations, expression);
+    QVERIFY(explanations.isOk());
+
+    // Поддеревья перечисляются в порядке обратного обхода, участок каждого – его запись в выражении
+    QStringList actualSpans;
+    for (const SubtreeExplanation& subtree : explanations.value()) {
+        QVERIFY(subtree.span.isValid());
+        actualSpans.append(expression.sliced(subtree.span.start, subtree.span.end - subtree.span.start));
+    }
+    QCOMPARE(actualSpans, expectedSpans);
+
+    // Пояснение поддерева совпадает с пояснением его записи как самостоятельного выражения
+    for (qsizetype i = 0; i < actualSpans.size(); i++) {
+        TEResult<QString> expected = explainDirectly(declarations, actualSpans[i]);
+        QVERIFY(expected.isOk());
+        QCOMPARE(explanations.value()[i].explanation, expected.value());
+    }
+}
+
+void test_subtreeExplanations::sameAsStandalone_data()
+{
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<ExpressionNotation>("notation");
+    QTest::addColumn<QStringList>("expectedSpans");
+
+    // Тест 1: Вложенные бинарные операции
+    QTest::newRow("binary")
+        << "a b + c *" << ExpressionNotation::Postfix
+        << QStringList{"a", "b", "a b +", "c", "a b + c *"};
+
+    // Тест 2: Лишние пробелы не входят в участки операндов
+    QTest::newRow("spaces")
+        << "a  b   +" << ExpressionNotation::Postfix
+        << QStringList{"a", "b", "a  b   +"};
+
+    // Тест 3: Вызов функции
+    QTest::newRow("function")
+        << "a b max(2) c +" << ExpressionNotation::Postfix
+        << QStringList{"a", "b", "a b max(2)", "c", "a b max(2) c +"};
+
+    // Тест 4: Сравнение под отрицанием переводится в составе выражения обратным сравнением
+    QTest::newRow("inverted-comparison")
+        << "a b < !" << ExpressionNotation::Postfix
+        << QStringList{"a", "b", "a b <", "a b < !"};
+
+    // Тест 5: Внутреннее отрицание двойного отрицания сокращается нормализацией
+    QTest::newRow("double-negation")
+        << "a ! !" << ExpressionNotation::Postfix
+        << QStringList{"a", "a !", "a ! !"};
+
+    // Тест 6: Смысл инкремента добавляется к корню выражения
+    QTest::newRow("increment")
+        << "a ++_ b +" << ExpressionNotation::Postfix
+        << QStringList{"a", "a ++_", "b", "a ++_ b +"};
+
+    // Тест 7: Участок выражения в скобках включает скобки
+    QTest::newRow("infix-parentheses")
+        << "(a + b) * c" << ExpressionNotation::Infix
+        << QStringList{"a", "b", "(a + b)", "c", "(a + b) * c"};
+
+    // Тест 8: Участок вызова функции включает имя и скобки
+    QTest::newRow("infix-function")
+        << "max(a, b + c)" << ExpressionNotation::Infix
+        << QStringList{"a", "b", "c", "b + c", "max(a, b + c)"};
+
+    // Тест 9: Префиксная операция
+    QTest::newRow("infix-prefix")
+        << "-a * b" << ExpressionNotation::Infix
+        << QStringList{"a", "-a", "b", "-a * b"};
+
+    // Тест 10: Сравнение под отрицанием в инфиксной записи
+    QTest::newRow("infix-inverted-comparison")
+        << "!(a < b)" << ExpressionNotation::Infix
+        << QStringList{"a", "b", "(a < b)", "!(a < b)"};
+}
+
+void test_subtreeExplanations::grammaticalCase()
+{
+    TEResult<QList<SubtreeExplanation>> explanations = explainSubtrees(makeDeclarations(ExpressionNotation::Postfix), "a b +", Case::Genitive);
+    QVERIFY(explanations.isOk());
+    QCOMPARE(explanations.value().size(), qsizetype(3));
+    QCOMPARE(explanations.value()[0].explanation, QString("количества яблок"));
+    QCOMPARE(explanations.value()[1].explanation, QString("количества груш"));
+
+    // Пустое выражение не имеет поддеревьев, ошибка построения дерева возвращается без исключения
+    QVERIFY(explainSubtrees(makeDeclarations(ExpressionNotation::Postfix), "").value().isEmpty());
+    QVERIFY(!explainSubtrees(makeDeclarations(ExpressionNotation::Postfix), "a d +").isOk());
+}
+
+void test_subtreeExplanations::session()
+{
+    const Expression declarations = makeDeclarations(ExpressionNotation::Postfix);
+    ExpressionSession session(declarations);
+    // Вставка в начало и внутрь выражения сдвигает участки следующих лексем
+    const QStringList edits = {"a b +", " a b +", "a b +", "a  b +", "a  b + c *", "c a  b + *"};
+    for (const QString& edit : edits) {
+        QVERIFY(session.update(edit).isOk());
+        TEResult<QList<SubtreeExplanation>> actual = session.subtreeExplanations();
+        TEResult<QList<SubtreeExplanation>> expected = explainSubtrees(declarations, edit);
+        QVERIFY(actual.isOk());
+        QVERIFY(expected.isOk());
+
+        qDebug() << "Expression:" << edit;
+        QCOMPARE(actual.value().size(), expected.value().size());
+        for (qsizetype i = 0; i < expected.value().size(); i++) {
+            QCOMPARE(actual.value()[i].span, expected.value()[i].span);
+            QCOMPARE(actual.value()[i].explanation, expected.value()[i].explanation);
+        }
+    }
+}
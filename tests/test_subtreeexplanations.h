@@ -0,0 +1,19 @@
+#ifndef TEST_SUBTREEEXPLANATIONS_H
+#define TEST_SUBTREEEXPLANATIONS_H
+
+#include <QObject>
+
+class test_subtreeExplanations : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_subtreeExplanations(QObject *parent = nullptr);
+
+private slots:
+    void sameAsStandalone();
+    void sameAsStandalone_data();
+    void grammaticalCase();
+    void session();
+};
+
+#endif // TEST_SUBTREEEXPLANATIONS_H
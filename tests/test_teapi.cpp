@@ -0,0 +1,116 @@
+#include "test_teapi.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <teapi.h>
+
+test_teApi::test_teApi(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_teApi::explain()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(int, status);
+    QFETCH(QString, text);
+
+    te_context* context = te_context_create();
+    QVERIFY(context != nullptr);
+    te_result* result = te_explain(context, input.constData(), size_t(input.size()));
+    QVERIFY(result != nullptr);
+
+    QString actualText = QString::fromUtf8(te_result_text(result), qsizetype(te_result_size(result)));
+    int actualStatus = te_result_status(result);
+    te_result_free(result);
+    te_context_free(context);
+
+    qDebug() << "Actual result:" << actualStatus << actualText;
+    QCOMPARE(actualStatus, status);
+    // Для ошибок проверяется только наличие описания
+    if (status == TE_OK) QCOMPARE(actualText, text);
+    else QVERIFY(!actualText.isEmpty());
+}
+
+void test_teApi::explain_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<int>("status");
+    QTest::addColumn<QString>("text");
+
+    // Тест 1: Одно выражение
+    QTest::newRow("single-expression")
+        << documentXml("<expression>a b +</expression>\n", applesXml() + pearsXml())
+        << int(TE_OK)
+        << QString("сумма количества яблок и количества груш");
+
+    // Тест 2: Список выражений с общими объявлениями
+    QTest::newRow("expression-list")
+        << documentXml("<expressions>\n<expression>a b +</expression>\n<expression>a b *</expression>\n</expressions>\n", applesXml() + pearsXml())
+        << int(TE_OK)
+        << QString("сумма количества яблок и количества груш\nпроизведение количества яблок и количества груш");
+
+    // Тест 3: Некорректный XML-документ
+    QTest::newRow("invalid-xml")
+        << QByteArray("<root>\n<expression>a b +</expression>\n<variables>\n")
+        << int(TE_INPUT_ERROR)
+        << QString();
+
+    // Тест 4: Необъявленный идентификатор в выражении
+    QTest::newRow("undefined-identifier")
+        << documentXml("<expression>a c +</expression>\n", applesXml())
+        << int(TE_INPUT_ERROR)
+        << QString();
+}
+
+void test_teApi::explainWithLibrary()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile libraryFile(dir.filePath("library.xml"));
+    QVERIFY(libraryFile.open(QIODevice::WriteOnly));
+    libraryFile.write(libraryXml(applesXml() + pearsXml()));
+    libraryFile.close();
+
+    te_context* context = te_context_create();
+    te_result* loaded = te_context_load_declarations(context, dir.filePath("library.xml").toUtf8().constData());
+    QCOMPARE(te_result_status(loaded), int(TE_OK));
+    te_result_free(loaded);
+
+    // Контекст с библиотекой используется для нескольких входных документов
+    const QByteArray inputs[] = {"<root>\n<expression>a b +</expression>\n</root>\n", "<root>\n<expression>a b -</expression>\n</root>\n"};
+    const QString expected[] = {"сумма количества яблок и количества груш", "разность количества яблок и количества груш"};
+    for (int i = 0; i < 2; i++) {
+        te_result* result = te_explain(context, inputs[i].constData(), size_t(inputs[i].size()));
+        QCOMPARE(te_result_status(result), int(TE_OK));
+        QCOMPARE(QString::fromUtf8(te_result_text(result)), expected[i]);
+        te_result_free(result);
+    }
+
+    // Отсутствующая библиотека не заменяет подключённую
+    te_result* missing = te_context_load_declarations(context, dir.filePath("missing.xml").toUtf8().constData());
+    QCOMPARE(te_result_status(missing), int(TE_INPUT_ERROR));
+    te_result_free(missing);
+
+    te_context_free(context);
+}
+
+void test_teApi::invalidArguments()
+{
+    QCOMPARE(te_abi_version(), TE_ABI_VERSION);
+
+    te_result* result = te_explain(nullptr, "", 0);
+    QCOMPARE(te_result_status(result), int(TE_INVALID_ARGUMENT));
+    te_result_free(result);
+
+    te_context* context = te_context_create();
+    result = te_explain(context, nullptr, 10);
+    QCOMPARE(te_result_status(result), int(TE_INVALID_ARGUMENT));
+    te_result_free(result);
+    te_context_free(context);
+
+    QCOMPARE(te_result_status(nullptr), int(TE_INVALID_ARGUMENT));
+    QCOMPARE(QByteArray(te_result_text(nullptr)), QByteArray());
+    QCOMPARE(te_result_size(nullptr), size_t(0));
+    te_result_free(nullptr);
+    te_context_free(nullptr);
+}
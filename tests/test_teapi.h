@@ -0,0 +1,19 @@
+#ifndef TEST_TEAPI_H
+#define TEST_TEAPI_H
+
+#include <QObject>
+
+class test_teApi : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_teApi(QObject *parent = nullptr);
+
+private slots:
+    void explain();
+    void explain_data();
+    void explainWithLibrary();
+    void invalidArguments();
+};
+
+#endif // TEST_TEAPI_H
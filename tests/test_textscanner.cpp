@@ -0,0 +1,76 @@
+#include "test_textscanner.h"
+#include <QtTest/QTest>
+#include <textscanner.h>
+
+test_textScanner::test_textScanner(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_textScanner::textScanner()
+{
+    QFETCH(QString, text);
+    QFETCH(qsizetype, from);
+    QFETCH(qsizetype, xmlSpecial);
+    QFETCH(qsizetype, spaceOrQuote);
+    QFETCH(qsizetype, nonIdentifier);
+
+    InstructionSet supported = TextScanner::supportedInstructionSet();
+
+    // Результат не зависит от набора инструкций
+    for (InstructionSet set : {InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2}) {
+        if (set > supported) continue;
+        TextScanner::setInstructionSet(set);
+        QString setName = TextScanner::instructionSetName(set);
+
+        QVERIFY2(TextScanner::findXmlSpecial(text, from) == xmlSpecial, qPrintable(setName));
+        QVERIFY2(TextScanner::findXmlSpecial(QByteArrayView(text.toLatin1()), from) == xmlSpecial, qPrintable(setName));
+        QVERIFY2(TextScanner::findSpaceOrQuote(text, from) == spaceOrQuote, qPrintable(setName));
+        QVERIFY2(TextScanner::findNonIdentifier(text, from) == nonIdentifier, qPrintable(setName));
+    }
+    TextScanner::setInstructionSet(supported);
+}
+
+void test_textScanner::textScanner_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<qsizetype>("from");
+    QTest::addColumn<qsizetype>("xmlSpecial");
+    QTest::addColumn<qsizetype>("spaceOrQuote");
+    QTest::addColumn<qsizetype>("nonIdentifier");
+
+    // Тест 1: Пустая строка
+    QTest::newRow("empty") << QString() << qsizetype(0) << qsizetype(-1) << qsizetype(-1) << qsizetype(-1);
+
+    // Тест 2: Короткий идентификатор обрабатывается посимвольно
+    QTest::newRow("short-identifier") << "value_1" << qsizetype(0) << qsizetype(-1) << qsizetype(-1) << qsizetype(-1);
+
+    // Тест 3: Длинный идентификатор занимает несколько блоков
+    QTest::newRow("long-identifier")
+        << "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789" << qsizetype(0)
+        << qsizetype(-1) << qsizetype(-1) << qsizetype(-1);
+
+    // Тест 4: Символы находятся в третьем блоке SSE2 и во втором блоке AVX2
+    QTest::newRow("second-block")
+        << "aaaaaaaaaaaaaaaaaa bbbbbb<cc\"" << qsizetype(0)
+        << qsizetype(25) << qsizetype(18) << qsizetype(18);
+
+    // Тест 5: Поиск начинается с заданной позиции
+    QTest::newRow("from-position")
+        << "a<b c&d\"e f'g" << qsizetype(3)
+        << qsizetype(5) << qsizetype(3) << qsizetype(3);
+
+    // Тест 6: Символы вне ASCII: неразрывный пробел – пробельный символ, кириллица недопустима в идентификаторе
+    QTest::newRow("non-ascii")
+        << QString::fromUtf8("identifier_with_ space_and_кириллица") << qsizetype(0)
+        << qsizetype(-1) << qsizetype(16) << qsizetype(16);
+
+    // Тест 7: Цифры вне ASCII допустимы в идентификаторе, как и при проверке QChar::isDigit
+    QTest::newRow("non-ascii-digit")
+        << QString::fromUtf8("digits_١٢٣_and_more_letters-") << qsizetype(0)
+        << qsizetype(-1) << qsizetype(-1) << qsizetype(27);
+
+    // Тест 8: Управляющие символы не являются пробельными, но недопустимы в идентификаторе
+    QTest::newRow("control-characters")
+        << QString("abc\x01" "def\tghi") << qsizetype(0)
+        << qsizetype(-1) << qsizetype(7) << qsizetype(3);
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_TEXTSCANNER_H
+#define TEST_TEXTSCANNER_H
+
+#include <QObject>
+
+class test_textScanner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_textScanner(QObject *parent = nullptr);
+
+private slots:
+    void textScanner();
+    void textScanner_data();
+};
+
+#endif // TEST_TEXTSCANNER_H
@@ -0,0 +1,104 @@
+#include "test_xmlschema.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+#include <expression.h>
+#include <xmlschema.h>
+
+namespace {
+// Описание переменной с заданными атрибутами во всех падежах
+QByteArray attributedVariableXml(const QByteArray& attributes, const QByteArray& nominative, const QByteArray& genitive, const QByteArray& extra = "")
+{
+    return "<variable " + attributes + ">\n" + descriptionXml(nominative, genitive) + extra + "</variable>\n";
+}
+
+// Документ с выражением "a b +" и заданными переменными
+QByteArray schemaDocumentXml(const QByteArray& variables, const QByteArray& lists = otherListsXml())
+{
+    return "<root>\n<expression>a b +</expression>\n<variables>\n" + variables + "</variables>\n" + lists + "</root>\n";
+}
+}
+
+test_xmlSchema::test_xmlSchema(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_xmlSchema::validation()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(QVariant, result);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("input.xml"), input));
+
+    TEResult<Expression> expression = Expression::tryFromFile(dir.filePath("input.xml"));
+    TEResult<QString> explanation = expression ? expression.value().tryGetExplanationInRu() : TEResult<QString>(expression.errors());
+    if (explanation) {
+        qDebug() << "Actual result:" << explanation.value();
+        QCOMPARE(explanation.value(), result.toString());
+        return;
+    }
+
+    ErrorType errorType = explanation.errors().first().getErrorType();
+    QVERIFY2(result.userType() == qMetaTypeId<ErrorType>(), qPrintable(TEException::ErrorTypeNames.value(errorType)));
+    qDebug() << "Actual error:" << TEException::ErrorTypeNames.value(errorType);
+    QCOMPARE(errorType, result.value<ErrorType>());
+}
+
+void test_xmlSchema::validation_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<QVariant>("result");
+
+    // Тест 1: Документ, соответствующий схеме
+    QTest::newRow("valid")
+        << schemaDocumentXml(applesXml() + pearsXml())
+        << QVariant("сумма количества яблок и количества груш");
+
+    // Тест 2: Атрибут, не допустимый для элемента
+    QTest::newRow("unexpected-attribute")
+        << schemaDocumentXml(attributedVariableXml("name=\"a\" type=\"int\" size=\"4\"", "количество яблок", "количества яблок") + pearsXml())
+        << QVariant::fromValue<ErrorType>(ErrorType::UnexpectedAttribute);
+
+    // Тест 3: Элемент, не допустимый в корне
+    QTest::newRow("unexpected-element")
+        << schemaDocumentXml(applesXml() + pearsXml(), "<functions/>\n<unions/>\n<structures/>\n<classes/>\n<enums/>\n<constants/>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::UnexpectedElement);
+
+    // Тест 4: Второе описание переменной
+    QTest::newRow("duplicate-description")
+        << schemaDocumentXml(attributedVariableXml("name=\"a\" type=\"int\"", "количество яблок", "количества яблок",
+                                   "<description>\n<case type=\"именительный\">яблоки</case>\n</description>\n") + pearsXml())
+        << QVariant::fromValue<ErrorType>(ErrorType::DuplicateElement);
+
+    // Тест 5: Переменная без обязательного атрибута "type"
+    QTest::newRow("missing-required-attribute")
+        << schemaDocumentXml(attributedVariableXml("name=\"a\"", "количество яблок", "количества яблок") + pearsXml())
+        << QVariant::fromValue<ErrorType>(ErrorType::MissingRequiredAttribute);
+
+    // Тест 6: Документ без обязательного списка перечислений
+    QTest::newRow("missing-required-child")
+        << schemaDocumentXml(applesXml() + pearsXml(), "<functions/>\n<unions/>\n<structures/>\n<classes/>\n")
+        << QVariant::fromValue<ErrorType>(ErrorType::MissingRequiredChildElement);
+
+    // Тест 7: Переменных больше допустимого количества
+    QByteArray variables = applesXml() + pearsXml();
+    for (int i = 0; i < 19; i++)
+        variables += attributedVariableXml("name=\"c" + QByteArray::number(i) + "\" type=\"int\"", "число", "числа");
+    QTest::newRow("too-many-variables")
+        << schemaDocumentXml(variables)
+        << QVariant::fromValue<ErrorType>(ErrorType::DuplicateElement);
+}
+
+void test_xmlSchema::names()
+{
+    // Каждое имя схемы распознаётся обратно в тот же элемент или атрибут
+    for (int tag = 0; tag < XmlTagCount; ++tag)
+        QCOMPARE(xmlTagByName(xmlTagName(static_cast<XmlTag>(tag))), static_cast<XmlTag>(tag));
+    for (int attribute = 0; attribute < XmlAttributeCount; ++attribute)
+        QCOMPARE(xmlAttributeByName(xmlAttributeName(static_cast<XmlAttribute>(attribute))), static_cast<XmlAttribute>(attribute));
+
+    QCOMPARE(xmlTagByName(u"root"), XmlTag::Unknown);
+    QCOMPARE(xmlAttributeByName(u"size"), XmlAttribute::Unknown);
+}
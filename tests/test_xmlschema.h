@@ -0,0 +1,18 @@
+#ifndef TEST_XMLSCHEMA_H
+#define TEST_XMLSCHEMA_H
+
+#include <QObject>
+
+class test_xmlSchema : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_xmlSchema(QObject *parent = nullptr);
+
+private slots:
+    void validation();
+    void validation_data();
+    void names();
+};
+
+#endif // TEST_XMLSCHEMA_H
@@ -0,0 +1,208 @@
+#include "test_xmltree.h"
+#include "allocationcounter.h"
+#include "testfixtures.h"
+#include <QtTest/QTest>
+#include <QDomDocument>
+#include <xmlelement.h>
+#include <xmltree.h>
+
+namespace {
+// Документ с заданным количеством переменных, описанных во всех падежах
+QByteArray makeDocument(int variableCount)
+{
+    QByteArray variables;
+    for (int i = 0; i < variableCount; i++) {
+        QByteArray name = "a" + QByteArray::number(i);
+        variables += variableXml(name, "значение переменной &lt;" + name + "&gt;", "значение переменной &lt;" + name + "&gt;");
+    }
+    return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" + documentXml("<expression>a0 a1 +</expression>\n", variables);
+}
+
+// Сравнение элемента XmlElement с элементом QDomElement вместе со всеми вложенными элементами
+void compareElements(const XmlElement& element, const QDomElement& expected)
+{
+    QCOMPARE(element.tagName(), expected.tagName());
+    QCOMPARE(element.text(), expected.text());
+    QCOMPARE(element.attributeCount(), expected.attributes().length());
+    for (int i = 0; i < element.attributeCount(); i++) {
+        QString name = element.attributeName(i);
+        QVERIFY(expected.hasAttribute(name));
+        QCOMPARE(element.attribute(name.toUtf8()), expected.attribute(name));
+    }
+
+    XmlElement child = element.firstChildElement();
+    QDomElement expectedChild = expected.firstChildElement();
+    while (!child.isNull() && !expectedChild.isNull()) {
+        compareElements(child, expectedChild);
+        child = child.nextSiblingElement();
+        expectedChild = expectedChild.nextSiblingElement();
+    }
+    QCOMPARE(child.isNull(), expectedChild.isNull());
+}
+}
+
+test_xmlTree::test_xmlTree(QObject *parent)
+    : QObject{parent}
+{}
+
+void test_xmlTree::parse()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(bool, valid);
+    QFETCH(int, line);
+
+    XmlTree tree;
+    bool parsed = tree.parse(std::string_view(input.constData(), size_t(input.size())));
+    qDebug() << "Actual result:" << parsed << QString::fromStdString(tree.errorMessage()) << tree.errorLine();
+    QCOMPARE(parsed, valid);
+    if (!valid) {
+        QCOMPARE(tree.errorLine(), line);
+        QCOMPARE(tree.root(), XmlTree::NoNode);
+        return;
+    }
+    QCOMPARE(XmlElement::documentElement(tree).lineNumber(), line);
+}
+
+void test_xmlTree::parse_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("line");
+
+    // Тест 1: Объявление XML, комментарий и корневой элемент на третьей строке
+    QTest::newRow("prolog")
+        << QByteArray("<?xml version=\"1.0\"?>\n<!-- комментарий -->\n<root/>\n")
+        << true << 3;
+
+    // Тест 2: Несовпадающий закрывающий тег
+    QTest::newRow("tag-mismatch")
+        << QByteArray("<root>\n<a>\n</b>\n</root>")
+        << false << 3;
+
+    // Тест 3: Повторяющийся атрибут
+    QTest::newRow("duplicate-attribute")
+        << QByteArray("<root>\n<a x=\"1\" x=\"2\"/>\n</root>")
+        << false << 2;
+
+    // Тест 4: Неизвестная ссылка на сущность
+    QTest::newRow("undefined-entity")
+        << QByteArray("<root>\n\n&nbsp;</root>")
+        << false << 3;
+
+    // Тест 5: Незакрытый элемент
+    QTest::newRow("unexpected-end")
+        << QByteArray("<root>\n<a>\n")
+        << false << 3;
+
+    // Тест 6: Второй корневой элемент
+    QTest::newRow("extra-root")
+        << QByteArray("<root/>\n<root/>")
+        << false << 2;
+
+    // Тест 7: Символ '<' в значении атрибута
+    QTest::newRow("lt-in-attribute")
+        << QByteArray("<root a=\"<\"/>")
+        << false << 1;
+}
+
+void test_xmlTree::sameAsDom()
+{
+    QFETCH(QByteArray, input);
+
+    XmlTree tree;
+    QVERIFY(tree.parse(std::string_view(input.constData(), size_t(input.size()))));
+    QDomDocument doc;
+    QVERIFY(doc.setContent(input));
+
+    compareElements(XmlElement::documentElement(tree), doc.documentElement());
+}
+
+void test_xmlTree::sameAsDom_data()
+{
+    QTest::addColumn<QByteArray>("input");
+
+    // Тест 1: Ссылки на символы, CDATA и пробелы в атрибутах
+    QTest::newRow("references")
+        << QByteArray("<root a=\"x&amp;y&#x41;&#1046;\" b='1\t2'>\n  <e>t&lt;1&quot;</e><e/>\r\n<f><![CDATA[<x>]]>хвост</f>\n</root>\n");
+
+    // Тест 2: Смешанное содержимое и комментарии внутри элементов
+    QTest::newRow("mixed-content")
+        << QByteArray("<root>начало<a>середина<!-- c --></a>конец<?pi данные?></root>");
+
+    // Тест 3: Входной документ с переменными, описанными во всех падежах
+    QTest::newRow("input-document")
+        << makeDocument(3);
+}
+
+void test_xmlTree::parseBenchmark()
+{
+    QFETCH(bool, dom);
+    QFETCH(int, variableCount);
+    QByteArray document = makeDocument(variableCount);
+
+    // Построение QDomDocument
+    if (dom) {
+        QBENCHMARK {
+            QDomDocument doc;
+            QVERIFY(doc.setContent(document));
+        }
+    }
+    // Построение плоского дерева на стандартной библиотеке
+    else {
+        QBENCHMARK {
+            XmlTree tree;
+            QVERIFY(tree.parse(std::string_view(document.constData(), size_t(document.size()))));
+        }
+    }
+}
+
+void test_xmlTree::parseBenchmark_data()
+{
+    QTest::addColumn<bool>("dom");
+    QTest::addColumn<int>("variableCount");
+
+    // Небольшой документ: время определяется затратами на запуск разбора
+    QTest::newRow("dom-small") << true << 2;
+    QTest::newRow("xmltree-small") << false << 2;
+    // Документ с двадцатью переменными
+    QTest::newRow("dom-large") << true << 20;
+    QTest::newRow("xmltree-large") << false << 20;
+}
+
+void test_xmlTree::footprint()
+{
+#if !defined(__GLIBC__)
+    QSKIP("Выделения контейнеров Qt учитываются только при замещении malloc (glibc)");
+#endif
+    QFETCH(int, variableCount);
+    QByteArray document = makeDocument(variableCount);
+
+    // Выделения памяти при построении документа каждым способом
+    AllocationCounter::Snapshot domFootprint;
+    {
+        AllocationCounter::Scope scope;
+        QDomDocument doc;
+        QVERIFY(doc.setContent(document));
+        domFootprint = scope.result();
+    }
+    AllocationCounter::Snapshot treeFootprint;
+    {
+        AllocationCounter::Scope scope;
+        XmlTree tree;
+        QVERIFY(tree.parse(std::string_view(document.constData(), size_t(document.size()))));
+        treeFootprint = scope.result();
+    }
+    qDebug() << "QDomDocument:" << domFootprint.allocations << "allocations," << domFootprint.bytes << "bytes";
+    qDebug() << "XmlTree:" << treeFootprint.allocations << "allocations," << treeFootprint.bytes << "bytes";
+
+    QVERIFY(treeFootprint.allocations < domFootprint.allocations);
+    QVERIFY(treeFootprint.bytes < domFootprint.bytes);
+}
+
+void test_xmlTree::footprint_data()
+{
+    QTest::addColumn<int>("variableCount");
+
+    QTest::newRow("small") << 2;
+    QTest::newRow("large") << 20;
+}
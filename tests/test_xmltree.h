@@ -0,0 +1,23 @@
+#ifndef TEST_XMLTREE_H
+#define TEST_XMLTREE_H
+
+#include <QObject>
+
+class test_xmlTree : public QObject
+{
+    Q_OBJECT
+public:
+    explicit test_xmlTree(QObject *parent = nullptr);
+
+private slots:
+    void parse();
+    void parse_data();
+    void sameAsDom();
+    void sameAsDom_data();
+    void parseBenchmark();
+    void parseBenchmark_data();
+    void footprint();
+    void footprint_data();
+};
+
+#endif // TEST_XMLTREE_H
@@ -0,0 +1,97 @@
+#include "testfixtures.h"
+#include <QFile>
+
+QByteArray descriptionXml(const QByteArray& nominative, const QByteArray& genitive, const QByteArray& padding)
+{
+    static const char* const CaseNames[] = {"именительный", "родительный", "дательный", "винительный", "творительный", "предложный"};
+    QByteArray xml = "<description>\n";
+    for (int c = 0; c < CaseCount; c++) {
+        const QByteArray& text = c == static_cast<int>(Case::Genitive) ? genitive : nominative;
+        xml += QByteArray("<case type=\"") + CaseNames[c] + "\">" + padding + text + padding + "</case>\n";
+    }
+    return xml + "</description>\n";
+}
+
+QByteArray variableXml(const QByteArray& name, const QByteArray& nominative, const QByteArray& genitive, const QByteArray& padding)
+{
+    return "<variable name=\"" + name + "\" type=\"int\">\n" + descriptionXml(nominative, genitive, padding) + "</variable>\n";
+}
+
+QByteArray applesXml()
+{
+    return variableXml("a", "количество яблок", "количества яблок");
+}
+
+QByteArray pearsXml()
+{
+    return variableXml("b", "количество груш", "количества груш");
+}
+
+QByteArray plumsXml()
+{
+    return variableXml("c", "количество слив", "количества слив");
+}
+
+QByteArray otherListsXml()
+{
+    return "<functions/>\n<unions/>\n<structures/>\n<classes/>\n<enums/>\n";
+}
+
+QByteArray documentXml(const QByteArray& expressions, const QByteArray& variables)
+{
+    return "<root>\n" + expressions + "<variables>\n" + variables + "</variables>\n" + otherListsXml() + "</root>\n";
+}
+
+QByteArray expressionDocumentXml(const QByteArray& expression, ExpressionNotation notation)
+{
+    QByteArray attributes = notation == ExpressionNotation::Infix ? " notation=\"infix\"" : "";
+    return documentXml("<expression" + attributes + ">" + expression + "</expression>\n", applesXml() + pearsXml());
+}
+
+QByteArray libraryXml(const QByteArray& variables)
+{
+    return "<root>\n<variables>\n" + variables + "</variables>\n</root>\n";
+}
+
+bool writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return file.write(content) == content.size();
+}
+
+QByteArray readFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QByteArray();
+    return file.readAll();
+}
+
+Variable variable(const QString& name, const QString& nominative, const QString& genitive)
+{
+    return Variable(name, "int", {{Case::Nominative, nominative}, {Case::Genitive, genitive}, {Case::Dative, nominative},
+                                  {Case::Accusative, nominative}, {Case::Instrumental, nominative}, {Case::Prepositional, nominative}});
+}
+
+Expression makeDeclarations()
+{
+    QString maxDescription = "наибольшее из {1(р)} и {2(р)}";
+    Expression declarations("",
+                            {{"a", variable("a", "количество яблок", "количества яблок")},
+                             {"b", variable("b", "количество груш", "количества груш")},
+                             {"c", variable("c", "количество слив", "количества слив")}},
+                            {{"max", Function("max", "int", 2,
+                                              {{Case::Nominative, maxDescription}, {Case::Genitive, maxDescription},
+                                               {Case::Dative, maxDescription}, {Case::Accusative, maxDescription},
+                                               {Case::Instrumental, maxDescription}, {Case::Prepositional, maxDescription}})}},
+                            {}, {}, {}, {});
+    declarations.markDeclarationsShared();
+    return declarations;
+}
+
+TEResult<QString> explainDirectly(const Expression& declarations, const QString& text)
+{
+    Expression expression = declarations;
+    expression.setExpression(text);
+    return expression.tryGetExplanationInRu();
+}
@@ -0,0 +1,46 @@
+#ifndef TESTFIXTURES_H
+#define TESTFIXTURES_H
+
+#include <QByteArray>
+#include <QString>
+#include <expression.h>
+
+// Описание в элементе <description> во всех падежах; текст каждого падежа окружён заданными пробелами
+QByteArray descriptionXml(const QByteArray& nominative, const QByteArray& genitive, const QByteArray& padding = QByteArray());
+
+// Описание переменной типа int во всех падежах
+QByteArray variableXml(const QByteArray& name, const QByteArray& nominative, const QByteArray& genitive, const QByteArray& padding = QByteArray());
+
+// Переменные a, b и c
+QByteArray applesXml();
+QByteArray pearsXml();
+QByteArray plumsXml();
+
+// Пустые списки объявлений, кроме переменных
+QByteArray otherListsXml();
+
+// Документ с заданными элементами выражений и объявлениями переменных
+QByteArray documentXml(const QByteArray& expressions, const QByteArray& variables);
+
+// Документ с одним выражением над переменными a и b
+QByteArray expressionDocumentXml(const QByteArray& expression, ExpressionNotation notation = ExpressionNotation::Postfix);
+
+// Библиотека объявлений с заданными переменными
+QByteArray libraryXml(const QByteArray& variables);
+
+// Запись содержимого в файл
+bool writeFile(const QString& path, const QByteArray& content);
+
+// Чтение содержимого файла
+QByteArray readFile(const QString& path);
+
+// Описание переменной типа int во всех падежах
+Variable variable(const QString& name, const QString& nominative, const QString& genitive);
+
+// Общие объявления: переменные a, b, c и функция max с двумя параметрами; выражение может использовать не все объявления
+Expression makeDeclarations();
+
+// Пояснение выражения с общими объявлениями
+TEResult<QString> explainDirectly(const Expression& declarations, const QString& text);
+
+#endif // TESTFIXTURES_H
@@ -1,32 +1,76 @@
-include(../textExplanationsInRu/textExplanationsInRu.pri)
-
+# Qt Xml используется только тестами для сравнения с QDomDocument
 QT = core \
     testlib \
-    qml \
     xml
 
+CONFIG += c++17 console
+
+include(../textExplanationsInRuCore/textExplanationsInRuCore.pri)
+
 SOURCES += \
+    allocationcounter.cpp \
     main.cpp \
+    test_batchrunner.cpp \
+    test_declarationindex.cpp \
+    test_declarationlibrary.cpp \
+    test_directorywatcher.cpp \
+    test_allocationbudget.cpp \
+    test_expressionbundle.cpp \
+    test_expressiondocument.cpp \
+    test_expressionsession.cpp \
     test_expressiontonodes.cpp \
+    test_fixxmlflags.cpp \
     test_getexplanation.cpp \
     test_getexplanationinru.cpp \
+    test_infixtonodes.cpp \
+    test_inputbudget.cpp \
+    test_inputpack.cpp \
     test_iscustomtypewithfileds.cpp \
     test_isfunction.cpp \
     test_isidentifier.cpp \
     test_isreducibleunaryselfinverse.cpp \
+    test_lazydescriptions.cpp \
+    test_normalize.cpp \
     test_removeconsecutiveduplicates.cpp \
-    test_toexplanation.cpp
+    test_subtreeexplanations.cpp \
+    test_teapi.cpp \
+    test_textscanner.cpp \
+    test_toexplanation.cpp \
+    test_xmlschema.cpp \
+    test_xmltree.cpp \
+    testfixtures.cpp
 
 HEADERS += \
+    allocationcounter.h \
+    test_batchrunner.h \
+    test_declarationindex.h \
+    test_declarationlibrary.h \
+    test_directorywatcher.h \
+    test_allocationbudget.h \
+    test_expressionbundle.h \
+    test_expressiondocument.h \
+    test_expressionsession.h \
     test_expressiontonodes.h \
+    test_fixxmlflags.h \
     test_getexplanation.h \
     test_getexplanationinru.h \
+    test_infixtonodes.h \
+    test_inputbudget.h \
+    test_inputpack.h \
     test_iscustomtypewithfileds.h \
     test_isfunction.h \
     test_isidentifier.h \
     test_isreducibleunaryselfinverse.h \
+    test_lazydescriptions.h \
+    test_normalize.h \
     test_removeconsecutiveduplicates.h \
-    test_toexplanation.h
+    test_subtreeexplanations.h \
+    test_teapi.h \
+    test_textscanner.h \
+    test_toexplanation.h \
+    test_xmlschema.h \
+    test_xmltree.h \
+    testfixtures.h
 
 QMAKE_CXXFLAGS += -fprofile-arcs -ftest-coverage -O0
 QMAKE_LFLAGS += -fprofile-arcs -ftest-coverage
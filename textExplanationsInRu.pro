@@ -2,7 +2,12 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     tests \
-    textExplanationsInRu
+    textExplanationsInRu \
+    textExplanationsInRuCore
+
+# Программа и тесты компонуются с библиотекой ядра
+tests.depends = textExplanationsInRuCore
+textExplanationsInRu.depends = textExplanationsInRuCore
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
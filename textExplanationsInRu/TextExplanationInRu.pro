@@ -1,5 +1,4 @@
-QT = core \
-     xml
+QT = core
 
 CONFIG += c++17 cmdline
 
@@ -8,13 +7,31 @@ CONFIG += c++17 cmdline
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+        batchrunner.cpp \
         codeentity.cpp \
+        declarationindex.cpp \
+        declarationlibrary.cpp \
+        descriptioncache.cpp \
+        directorywatcher.cpp \
         expression.cpp \
+        expressionbundle.cpp \
+        expressiondocument.cpp \
         expressionnode.cpp \
+        expressionnormalizer.cpp \
+        expressionsession.cpp \
         expressiontranslator.cpp \
         expressionxmlparser.cpp \
+        infixparser.cpp \
+        inputbudget.cpp \
+        inputpack.cpp \
         main.cpp \
-        teexception.cpp
+        pipelinestats.cpp \
+        teexception.cpp \
+        textscanner.cpp \
+        tracerecorder.cpp \
+        xmlelement.cpp \
+        xmlschema.cpp \
+        xmltree.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -22,9 +39,27 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    batchrunner.h \
     codeentity.h \
+    declarationindex.h \
+    declarationlibrary.h \
+    descriptioncache.h \
+    directorywatcher.h \
     expression.h \
+    expressionbundle.h \
+    expressiondocument.h \
     expressionnode.h \
+    expressionnormalizer.h \
+    expressionsession.h \
     expressiontranslator.h \
     expressionxmlparser.h \
-    teexception.h
+    infixparser.h \
+    inputbudget.h \
+    inputpack.h \
+    pipelinestats.h \
+    teexception.h \
+    textscanner.h \
+    tracerecorder.h \
+    xmlelement.h \
+    xmlschema.h \
+    xmltree.h
@@ -0,0 +1,411 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса BatchRunner для пакетной обработки входных файлов по шардам.
+ */
+
+#include "batchrunner.h"
+#include "expressionbundle.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+#include "pipelinestats.h"
+#include "tracerecorder.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+// Сигнатура файла результата пакетной обработки
+const QString ResultFormat = QStringLiteral("textExplanationsInRu-batch");
+
+// Ошибка недействительного результата пакетной обработки
+TEException invalidResult(const QString& source, const QString& reason)
+{
+    return TEException(ErrorType::InvalidBatchResult, QList<QString>{source, reason});
+}
+
+// Чтение содержимого входного файла
+bool readFile(const QString& path, QByteArray& content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    content = file.readAll();
+    PipelineStats::add(PipelineCounter::BytesRead, content.size());
+    return true;
+}
+
+// Ошибки пояснения в виде, не зависящем от процесса, который их получил
+QList<BatchError> toBatchErrors(const QList<TEException>& errors)
+{
+    QList<BatchError> result;
+    result.reserve(errors.size());
+    for (const TEException& error : errors)
+        result.append(BatchError{TEException::ErrorTypeNames.value(error.getErrorType()), error.what()});
+    return result;
+}
+}
+
+QString ShardSpec::toString() const
+{
+    QString text = QString::number(index) + '/' + QString::number(count);
+    if (key == ShardKey::ContentHash) text += QStringLiteral(":hash");
+    return text;
+}
+
+BatchStatistics BatchResult::statistics() const
+{
+    const QString budgetExceeded = TEException::ErrorTypeNames.value(ErrorType::BudgetExceeded);
+    BatchStatistics statistics;
+    statistics.inputs = records.size();
+    for (const BatchRecord& record : records) {
+        if (record.errors.isEmpty()) statistics.succeeded++;
+        else statistics.failed++;
+        bool budgetHit = false;
+        for (const BatchError& error : record.errors) {
+            statistics.errors[error.type]++;
+            budgetHit = budgetHit || error.type == budgetExceeded;
+        }
+        if (budgetHit) statistics.budgetHits++;
+    }
+    return statistics;
+}
+
+bool BatchRunner::parseShard(QStringView text, ShardSpec& shard)
+{
+    ShardSpec parsed;
+    qsizetype colon = text.indexOf(':');
+    if (colon != -1) {
+        QStringView key = text.sliced(colon + 1);
+        if (key == u"hash") parsed.key = ShardKey::ContentHash;
+        else if (key != u"order") return false;
+        text = text.first(colon);
+    }
+    qsizetype slash = text.indexOf('/');
+    if (slash == -1) return false;
+    bool indexOk = false;
+    bool countOk = false;
+    parsed.index = text.first(slash).toInt(&indexOk);
+    parsed.count = text.sliced(slash + 1).toInt(&countOk);
+    if (!indexOk || !countOk || parsed.count < 1 || parsed.index < 1 || parsed.index > parsed.count) return false;
+    shard = parsed;
+    return true;
+}
+
+TEResult<QStringList> BatchRunner::readManifest(const QString& path)
+{
+    QFileInfo info(path);
+    QStringList paths;
+    if (info.isDir()) {
+        const QDir directory(info.absoluteFilePath());
+        const QStringList names = directory.entryList({"*.xml"}, QDir::Files);
+        for (const QString& name : names)
+            paths.append(directory.absoluteFilePath(name));
+    }
+    else {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return TEException(ErrorType::InputFileNotFound, path);
+        const QDir base = info.absoluteDir();
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        for (const QByteArray& line : lines) {
+            QString entry = QString::fromUtf8(line).trimmed();
+            if (entry.isEmpty() || entry.startsWith('#')) continue;
+            paths.append(QDir::cleanPath(base.absoluteFilePath(entry)));
+        }
+    }
+
+    // Одинаковый порядок во всех процессах не зависит от порядка строк списка и файловой системы
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return paths;
+}
+
+QString BatchRunner::manifestDigest(const QStringList& manifest)
+{
+    // Общий каталог отсортированного списка определяется первым и последним путями
+    qsizetype prefix = 0;
+    if (!manifest.isEmpty()) {
+        const QString& first = manifest.first();
+        const QString& last = manifest.last();
+        qsizetype common = 0;
+        while (common < first.size() && common < last.size() && first[common] == last[common]) common++;
+        prefix = common == 0 ? 0 : first.lastIndexOf('/', common - 1) + 1;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString& path : manifest)
+        hash.addData(path.sliced(prefix).toUtf8() + '\n');
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+bool BatchRunner::belongsToShard(const ShardSpec& shard, qsizetype order, QByteArrayView content)
+{
+    if (shard.key == ShardKey::Order) return order % shard.count == shard.index - 1;
+    // Первые 8 байт хэша содержимого одинаковы на всех машинах
+    QByteArray hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+    quint64 value = qFromBigEndian<quint64>(hash.constData());
+    return value % quint64(shard.count) == quint64(shard.index - 1);
+}
+
+BatchResult BatchRunner::run(const QStringList& manifest, const ShardSpec& shard, const DeclarationLibrary* library, const BudgetLimits& budget)
+{
+    TraceRecorder::Span span("BatchRunner::run");
+    BatchResult result;
+    result.shard = shard;
+    result.manifestSize = manifest.size();
+    result.manifestDigest = manifestDigest(manifest);
+    for (qsizetype order = 0; order < manifest.size(); order++) {
+        const QString& path = manifest[order];
+        // При распределении по порядку файлы других шардов не читаются
+        if (shard.key == ShardKey::Order && !belongsToShard(shard, order, QByteArrayView())) continue;
+
+        QByteArray content;
+        bool isRead = readFile(path, content);
+        runInput(result, order, path, isRead ? &content : nullptr, library, budget);
+    }
+    return result;
+}
+
+BatchResult BatchRunner::run(const InputPack& pack, const ShardSpec& shard, const DeclarationLibrary* library, const BudgetLimits& budget)
+{
+    TraceRecorder::Span span("BatchRunner::run");
+    BatchResult result;
+    result.shard = shard;
+    result.manifestSize = pack.count();
+    QStringList names;
+    names.reserve(pack.count());
+    for (qsizetype order = 0; order < pack.count(); order++)
+        names.append(pack.record(order).name);
+    result.manifestDigest = manifestDigest(names);
+    for (qsizetype order = 0; order < pack.count(); order++) {
+        // Записи других шардов по порядку пропускаются, распределение по хэшу проверяется по содержимому записи
+        if (shard.key == ShardKey::Order && !belongsToShard(shard, order, QByteArrayView())) continue;
+        const PackRecord& record = pack.record(order);
+        runInput(result, order, record.name, &record.data, library, budget);
+    }
+    return result;
+}
+
+QList<TEException> BatchRunner::pack(const QString& manifestPath, const QString& packPath)
+{
+    TEResult<QStringList> manifest = readManifest(manifestPath);
+    if (!manifest) return manifest.errors();
+    // Имена записей отсчитываются от каталога входных файлов или от каталога списка
+    QFileInfo info(manifestPath);
+    QString baseDirectory = info.isDir() ? info.absoluteFilePath() : info.absolutePath();
+    return InputPack::packFiles(manifest.value(), baseDirectory, packPath);
+}
+
+void BatchRunner::runInput(BatchResult& result, qsizetype order, const QString& input, const QByteArray* content,
+                           const DeclarationLibrary* library, const BudgetLimits& budget)
+{
+    const ShardSpec& shard = result.shard;
+    if (content == nullptr) {
+        // Недоступный файл относится к шарду по позиции, иначе его ошибку не сообщит ни один шард
+        if (shard.key == ShardKey::ContentHash && shard.index != 1) return;
+        result.records.append(BatchRecord{order, input, QString(), toBatchErrors({TEException(ErrorType::InputFileNotFound, input)})});
+        return;
+    }
+    if (!belongsToShard(shard, order, *content)) return;
+    result.records.append(explain(order, input, *content, library, budget));
+}
+
+TEResult<BatchResult> BatchRunner::merge(const QList<BatchResult>& shards)
+{
+    if (shards.isEmpty()) return invalidResult(QString(), "нет результатов шардов");
+    const BatchResult& first = shards.first();
+
+    // Шарды должны относиться к одному списку и одному разбиению и покрывать его полностью
+    QSet<int> indexes;
+    for (const BatchResult& shard : shards) {
+        if (shard.shard.count != first.shard.count || shard.shard.key != first.shard.key)
+            return invalidResult(shard.shard.toString(), "шард относится к другому разбиению");
+        if (shard.manifestSize != first.manifestSize || shard.manifestDigest != first.manifestDigest)
+            return invalidResult(shard.shard.toString(), "шард относится к другому списку входных файлов");
+        if (indexes.contains(shard.shard.index))
+            return invalidResult(shard.shard.toString(), "шард указан повторно");
+        indexes.insert(shard.shard.index);
+    }
+    for (int index = 1; index <= first.shard.count; index++) {
+        if (!indexes.contains(index)) {
+            ShardSpec missing = first.shard;
+            missing.index = index;
+            return invalidResult(missing.toString(), "результат шарда отсутствует");
+        }
+    }
+
+    BatchResult merged;
+    merged.shard.key = first.shard.key;
+    merged.manifestSize = first.manifestSize;
+    merged.manifestDigest = first.manifestDigest;
+    for (const BatchResult& shard : shards)
+        merged.records += shard.records;
+    std::sort(merged.records.begin(), merged.records.end(), [](const BatchRecord& left, const BatchRecord& right) {
+        return left.order < right.order;
+    });
+
+    // Каждый входной файл обработан ровно одним шардом
+    for (qsizetype i = 0; i < merged.records.size(); i++) {
+        if (merged.records[i].order != i)
+            return invalidResult(merged.records[i].input, i < merged.records[i].order ? "пропущены входные файлы" : "входной файл обработан несколькими шардами");
+    }
+    if (merged.records.size() != merged.manifestSize)
+        return invalidResult(QString(), "обработано " + QString::number(merged.records.size()) + " из " + QString::number(merged.manifestSize) + " входных файлов");
+    return merged;
+}
+
+QByteArray BatchRunner::serialize(const BatchResult& result)
+{
+    QJsonArray records;
+    for (const BatchRecord& record : result.records) {
+        QJsonArray errors;
+        for (const BatchError& error : record.errors)
+            errors.append(QJsonObject{{"type", error.type}, {"message", error.message}});
+        QJsonObject entry;
+        entry.insert("order", record.order);
+        entry.insert("input", record.input);
+        entry.insert("explanation", record.explanation);
+        entry.insert("errors", errors);
+        records.append(entry);
+    }
+
+    // Сводка записывается для читателя файла и при загрузке вычисляется заново
+    BatchStatistics statistics = result.statistics();
+    QJsonObject errorCounts;
+    for (auto it = statistics.errors.cbegin(); it != statistics.errors.cend(); ++it)
+        errorCounts.insert(it.key(), it.value());
+    QJsonObject summary;
+    summary.insert("inputs", statistics.inputs);
+    summary.insert("succeeded", statistics.succeeded);
+    summary.insert("failed", statistics.failed);
+    summary.insert("errors", errorCounts);
+    summary.insert("budgetHits", statistics.budgetHits);
+
+    QJsonObject root;
+    root.insert("format", ResultFormat);
+    root.insert("version", formatVersion);
+    root.insert("shard", result.shard.toString());
+    root.insert("manifestSize", result.manifestSize);
+    root.insert("manifestDigest", result.manifestDigest);
+    root.insert("statistics", summary);
+    root.insert("records", records);
+    return QJsonDocument(root).toJson();
+}
+
+TEResult<BatchResult> BatchRunner::deserialize(QByteArrayView data, const QString& source)
+{
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(data.toByteArray(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject())
+        return invalidResult(source, "файл не является документом JSON");
+    QJsonObject root = document.object();
+    if (root.value("format").toString() != ResultFormat)
+        return invalidResult(source, "неверная сигнатура");
+    if (root.value("version").toInt() != formatVersion)
+        return invalidResult(source, "версия формата " + QString::number(root.value("version").toInt()) + ", ожидается " + QString::number(formatVersion));
+
+    BatchResult result;
+    if (!parseShard(root.value("shard").toString(), result.shard))
+        return invalidResult(source, "неверная запись шарда");
+    result.manifestSize = root.value("manifestSize").toInteger(-1);
+    if (result.manifestSize < 0)
+        return invalidResult(source, "неверный размер списка входных файлов");
+    result.manifestDigest = root.value("manifestDigest").toString();
+    if (result.manifestDigest.size() != 2 * QCryptographicHash::hashLength(QCryptographicHash::Sha1))
+        return invalidResult(source, "неверный хэш списка входных файлов");
+
+    const QJsonArray records = root.value("records").toArray();
+    for (const QJsonValue& value : records) {
+        QJsonObject entry = value.toObject();
+        BatchRecord record;
+        record.order = entry.value("order").toInteger(-1);
+        record.input = entry.value("input").toString();
+        record.explanation = entry.value("explanation").toString();
+        if (record.order < 0 || record.order >= result.manifestSize)
+            return invalidResult(source, "неверная позиция входного файла");
+        const QJsonArray errors = entry.value("errors").toArray();
+        for (const QJsonValue& error : errors)
+            record.errors.append(BatchError{error.toObject().value("type").toString(), error.toObject().value("message").toString()});
+        result.records.append(record);
+    }
+    return result;
+}
+
+TEResult<BatchResult> BatchRunner::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return TEException(ErrorType::InputFileNotFound, path);
+    QByteArray content = file.readAll();
+    PipelineStats::add(PipelineCounter::BytesRead, content.size());
+    return deserialize(content, path);
+}
+
+QList<TEException> BatchRunner::save(const BatchResult& result, const QString& path)
+{
+    PipelineStats::ScopedTimer timer(PipelineStage::OutputWrite);
+    QByteArray content = serialize(result);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size() || !file.commit())
+        return QList<TEException>{TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{path})};
+    PipelineStats::add(PipelineCounter::BytesWritten, content.size());
+    return QList<TEException>{};
+}
+
+QList<TEException> BatchRunner::savePacked(const BatchResult& result, const QString& path)
+{
+    QList<PackRecord> records;
+    records.reserve(result.records.size());
+    for (const BatchRecord& record : result.records) {
+        if (record.errors.isEmpty()) {
+            records.append(PackRecord{record.input, record.explanation.toUtf8(), PackRecordKind::Content});
+            continue;
+        }
+        QStringList messages;
+        for (const BatchError& error : record.errors)
+            messages.append(error.message);
+        records.append(PackRecord{record.input, messages.join('\n').toUtf8(), PackRecordKind::Errors});
+    }
+    return InputPack::save(records, path);
+}
+
+BatchRecord BatchRunner::explain(qsizetype order, const QString& path, const QByteArray& content, const DeclarationLibrary* library, const BudgetLimits& budget)
+{
+    TraceRecorder::FileScope traceFile(path);
+    BatchRecord record{order, path, QString(), {}};
+    InputBudget::Scope budgetScope(budget);
+
+    // Скомпилированный пакет загружается без разбора XML; библиотека уже включена в пакет и только сверяется с подключённой.
+    // Исходные файлы пакета проверяются только для файлов списка: у записи контейнера нет каталога
+    ParseReport report;
+    TEResult<ExpressionDocument> document = ExpressionBundle::isBundle(content)
+        ? ExpressionBundle::deserialize(content, path, library, QFileInfo(path).isAbsolute() ? path : QString())
+        : ExpressionXmlParser::parseDocumentContent(content, path, ValidationMode::CollectAll, report, library);
+    if (!document) {
+        record.errors = toBatchErrors(document.errors());
+        return record;
+    }
+
+    QList<TEException> errors;
+    QList<TEResult<QString>> explanations = document.value().tryGetExplanationsInRu(errors);
+    QStringList lines;
+    for (const TEResult<QString>& explanation : explanations) {
+        if (explanation) lines.append(explanation.value());
+        else errors += explanation.errors();
+    }
+    // После превышения бюджета все следующие выражения файла прерываются, поэтому сообщается одна ошибка
+    if (budgetScope.isExceeded()) {
+        errors.clear();
+        InputBudget::charge(BudgetResource::WallTime, 0, errors);
+    }
+    if (!errors.isEmpty()) record.errors = toBatchErrors(errors);
+    else record.explanation = lines.join('\n');
+    return record;
+}
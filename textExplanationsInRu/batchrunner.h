@@ -0,0 +1,250 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса BatchRunner для пакетной обработки входных файлов по шардам.
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "declarationlibrary.h"
+#include "inputbudget.h"
+#include "inputpack.h"
+#include "teexception.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Способ распределения входных файлов по шардам.
+ */
+enum class ShardKey {
+    Order,          /*!< По позиции файла в отсортированном списке входных файлов */
+    ContentHash     /*!< По хэшу содержимого файла; не зависит от состава и порядка списка */
+};
+
+/*!
+ * \brief Структура, описывающая шард пакетной обработки.
+ */
+struct ShardSpec {
+    int index = 1;                  /*!< Номер шарда, начиная с 1 */
+    int count = 1;                  /*!< Количество шардов */
+    ShardKey key = ShardKey::Order; /*!< Способ распределения файлов по шардам */
+
+    /*!
+     * \brief Запись шарда в виде "i/N" или "i/N:hash".
+     */
+    QString toString() const;
+};
+
+/*!
+ * \brief Структура, описывающая ошибку обработки входного файла в результате пакетной обработки.
+ */
+struct BatchError {
+    QString type;       /*!< Имя типа ошибки */
+    QString message;    /*!< Текст ошибки */
+};
+
+/*!
+ * \brief Структура, описывающая результат обработки одного входного файла.
+ */
+struct BatchRecord {
+    qsizetype order = 0;        /*!< Позиция файла в отсортированном списке входных файлов */
+    QString input;              /*!< Путь к входному файлу */
+    QString explanation;        /*!< Пояснения выражений файла, по одному на строку */
+    QList<BatchError> errors;   /*!< Ошибки файла; пустой список, если файл пояснён */
+};
+
+/*!
+ * \brief Структура, описывающая сводку результатов пакетной обработки.
+ */
+struct BatchStatistics {
+    qsizetype inputs = 0;               /*!< Количество обработанных входных файлов */
+    qsizetype succeeded = 0;            /*!< Количество пояснённых файлов */
+    qsizetype failed = 0;               /*!< Количество файлов с ошибками */
+    QMap<QString, qsizetype> errors;    /*!< Количество ошибок каждого типа */
+    qsizetype budgetHits = 0;           /*!< Количество файлов, обработка которых прервана превышением бюджета */
+};
+
+/*!
+ * \brief Структура, описывающая результат пакетной обработки шарда или объединённый результат всех шардов.
+ */
+struct BatchResult {
+    ShardSpec shard;                /*!< Обработанный шард; для объединённого результата – "1/1" */
+    qsizetype manifestSize = 0;     /*!< Количество файлов во всём списке входных файлов */
+    QString manifestDigest;         /*!< Хэш списка входных файлов (см. BatchRunner::manifestDigest()) */
+    QList<BatchRecord> records;     /*!< Результаты файлов в порядке списка входных файлов */
+
+    /*!
+     * \brief Подсчёт пояснённых файлов, файлов с ошибками, ошибок каждого типа и превышений бюджета.
+     */
+    BatchStatistics statistics() const;
+};
+
+/*!
+ * \brief Класс для пакетной обработки входных файлов несколькими независимыми процессами.
+ *
+ * Список входных файлов (файлы *.xml каталога или строки файла-списка) сортируется, поэтому все процессы,
+ * в том числе на разных машинах, получают одинаковый список без координатора. Процесс обрабатывает только
+ * файлы своего шарда: при распределении по порядку – файлы, позиция которых даёт остаток index - 1 при
+ * делении на количество шардов, при распределении по хэшу – файлы, хэш содержимого (SHA-1) которых даёт
+ * такой остаток. Результат шарда сохраняется в файл JSON; результаты всех шардов объединяются в один
+ * результат в порядке списка входных файлов со сводкой ошибок. Результат шарда содержит хэш списка входных
+ * файлов, поэтому объединение отклоняет результаты разных списков, в том числе списков одного размера, а также
+ * пропущенные и повторённые шарды с ошибкой InvalidBatchResult. Недоступный файл при распределении
+ * по хэшу относится к первому шарду. Каждый файл обрабатывается в своём бюджете InputBudget, поэтому файл,
+ * превысивший бюджет, получает ошибку BudgetExceeded, а обработка остальных файлов продолжается.
+ *
+ * Входные файлы можно заранее собрать в контейнер InputPack: записи контейнера идут в порядке того же
+ * отсортированного списка и разбираются из отображённой памяти без открытия отдельных файлов, а результат
+ * можно сохранить в контейнер с записями тех же имён.
+ */
+class BatchRunner
+{
+public:
+    /*!
+     * \brief Текущая версия формата файла результата.
+     */
+    static constexpr int formatVersion = 2;
+
+    /*!
+     * \brief Разбор записи шарда вида "i/N", "i/N:order" или "i/N:hash".
+     * \param[in] text Запись шарда.
+     * \param[out] shard Шард.
+     * \return true, если запись корректна и 1 <= i <= N.
+     */
+    static bool parseShard(QStringView text, ShardSpec& shard);
+
+    /*!
+     * \brief Получение отсортированного списка входных файлов.
+     * \param[in] path Каталог (используются его файлы *.xml) или файл со списком путей, по одному на строку;
+     * пустые строки и строки, начинающиеся с "#", пропускаются, относительные пути отсчитываются от каталога списка.
+     * \return Абсолютные пути входных файлов без повторов либо ошибка InputFileNotFound.
+     */
+    static TEResult<QStringList> readManifest(const QString& path);
+
+    /*!
+     * \brief Получение хэша списка входных файлов.
+     *
+     * Хэшируются пути в порядке списка относительно их общего каталога, поэтому один и тот же набор файлов,
+     * расположенный на разных машинах в разных каталогах, даёт одинаковый хэш.
+     * \param[in] manifest Отсортированный список путей входных файлов или имён записей контейнера.
+     * \return Хэш SHA-1 в шестнадцатеричной записи.
+     */
+    static QString manifestDigest(const QStringList& manifest);
+
+    /*!
+     * \brief Проверка, относится ли входной файл к шарду.
+     * \param[in] shard Шард.
+     * \param[in] order Позиция файла в списке входных файлов.
+     * \param[in] content Содержимое файла; используется только при распределении по хэшу.
+     */
+    static bool belongsToShard(const ShardSpec& shard, qsizetype order, QByteArrayView content);
+
+    /*!
+     * \brief Пояснение входных файлов шарда.
+     * \param[in] manifest Отсортированный список входных файлов.
+     * \param[in] shard Шард.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \param[in] budget Ограничения ресурсов обработки каждого файла.
+     * \return Результат шарда.
+     */
+    static BatchResult run(const QStringList& manifest, const ShardSpec& shard, const DeclarationLibrary* library = nullptr,
+                           const BudgetLimits& budget = BudgetLimits());
+
+    /*!
+     * \brief Пояснение записей контейнера, относящихся к шарду.
+     * \param[in] pack Контейнер входных файлов; позиция записи используется как позиция файла в списке.
+     * \param[in] shard Шард.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \param[in] budget Ограничения ресурсов обработки каждого файла.
+     * \return Результат шарда; входной файл записи – имя записи.
+     */
+    static BatchResult run(const InputPack& pack, const ShardSpec& shard, const DeclarationLibrary* library = nullptr,
+                           const BudgetLimits& budget = BudgetLimits());
+
+    /*!
+     * \brief Сборка контейнера из входных файлов.
+     * \param[in] manifestPath Каталог или файл со списком входных файлов, как в readManifest().
+     * \param[in] packPath Путь к файлу контейнера.
+     * \return Список ошибок; пустой, если контейнер сохранён.
+     */
+    static QList<TEException> pack(const QString& manifestPath, const QString& packPath);
+
+    /*!
+     * \brief Объединение результатов всех шардов.
+     * \param[in] shards Результаты шардов в любом порядке.
+     * \return Результат в порядке списка входных файлов либо ошибка InvalidBatchResult.
+     */
+    static TEResult<BatchResult> merge(const QList<BatchResult>& shards);
+
+    /*!
+     * \brief Преобразование результата в JSON.
+     * \param[in] result Результат.
+     * \return Содержимое файла результата; включает сводку ошибок.
+     */
+    static QByteArray serialize(const BatchResult& result);
+
+    /*!
+     * \brief Восстановление результата из JSON.
+     * \param[in] data Содержимое файла результата.
+     * \param[in] source Имя источника для сообщений об ошибках.
+     * \return Результат либо ошибка InvalidBatchResult.
+     */
+    static TEResult<BatchResult> deserialize(QByteArrayView data, const QString& source = QString());
+
+    /*!
+     * \brief Загрузка результата из файла.
+     * \param[in] path Путь к файлу результата.
+     * \return Результат либо список ошибок.
+     */
+    static TEResult<BatchResult> load(const QString& path);
+
+    /*!
+     * \brief Сохранение результата в файл.
+     *
+     * Файл заменяется целиком, поэтому объединение не прочитает частично записанный результат.
+     * \param[in] result Результат.
+     * \param[in] path Путь к файлу результата.
+     * \return Список ошибок; пустой, если результат сохранён.
+     */
+    static QList<TEException> save(const BatchResult& result, const QString& path);
+
+    /*!
+     * \brief Сохранение результата в контейнер.
+     *
+     * Каждому файлу результата соответствует запись с именем входного файла: пояснение либо сообщения об ошибках.
+     * \param[in] result Результат.
+     * \param[in] path Путь к файлу контейнера.
+     * \return Список ошибок; пустой, если контейнер сохранён.
+     */
+    static QList<TEException> savePacked(const BatchResult& result, const QString& path);
+
+private:
+    /*!
+     * \brief Пояснение входного файла, если он относится к шарду, и добавление его результата.
+     * \param[in,out] result Результат шарда.
+     * \param[in] order Позиция файла в списке входных файлов.
+     * \param[in] input Путь к файлу или имя записи контейнера.
+     * \param[in] content Содержимое файла или nullptr, если файл недоступен.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \param[in] budget Ограничения ресурсов обработки файла.
+     */
+    static void runInput(BatchResult& result, qsizetype order, const QString& input, const QByteArray* content,
+                         const DeclarationLibrary* library, const BudgetLimits& budget);
+
+    /*!
+     * \brief Пояснение одного входного файла.
+     * \param[in] order Позиция файла в списке входных файлов.
+     * \param[in] path Путь к файлу.
+     * \param[in] content Содержимое файла (XML или скомпилированный пакет).
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \param[in] budget Ограничения ресурсов обработки файла.
+     */
+    static BatchRecord explain(qsizetype order, const QString& path, const QByteArray& content, const DeclarationLibrary* library,
+                               const BudgetLimits& budget);
+};
+
+#endif // BATCHRUNNER_H
@@ -1,55 +1,147 @@
 #include "codeentity.h"
+#include "pipelinestats.h"
 
-const QSet<QString> DataTypes = {"int", "float", "double", "char", "bool", "string"};
-
-const QHash<OperationType, OperationType> InverseComparisonOperationsMap = {
-    {OperationType::LessThan, OperationType::NotLessThan},
-    {OperationType::LessThanOrEqual, OperationType::NotLessThanOrEqual},
-    {OperationType::GreaterThan, OperationType::NotGreaterThan},
-    {OperationType::GreaterThanOrEqual, OperationType::NotGreaterThanOrEqual},
-    {OperationType::Equal, OperationType::NotEqual},
-    {OperationType::NotEqual, OperationType::Equal},
-    {OperationType::NotLessThan, OperationType::LessThan},
-    {OperationType::NotLessThanOrEqual, OperationType::LessThanOrEqual},
-    {OperationType::NotGreaterThan, OperationType::GreaterThan},
-    {OperationType::NotGreaterThanOrEqual, OperationType::GreaterThanOrEqual}
-};
-
-const QHash<QString, OperatorInfo> OperationMap = {
-    {"++_", {OperationArity::Unary, OperationType::PrefixIncrement}},       // Префиксный инкремент
-    {"--_", {OperationArity::Unary, OperationType::PrefixDecrement}},       // Префиксный декремент
-    {"[]",  {OperationArity::Binary, OperationType::ArrayAccess}},          // Обращение к элементу под индексом
-    {".",   {OperationArity::Binary, OperationType::FieldAccess}},          // Обращение к полю элемента
-    {"->",  {OperationArity::Binary, OperationType::PointerFieldAccess}},   // Обращение к полю по указателю
-    {"*_",  {OperationArity::Unary, OperationType::Dereference}},           // Обращение к значению по адресу
-    {"&",   {OperationArity::Unary, OperationType::AddressOf}},             // Обращение к адресу элемента
-    {"-",   {OperationArity::Unary, OperationType::UnaryMinus}},            // Унарный минус
-    {"!",   {OperationArity::Unary, OperationType::Not}},                   // Логическое «не»
-    {"&&",  {OperationArity::Binary, OperationType::And}},                  // Логическое «и»
-    {"||",  {OperationArity::Binary, OperationType::Or}},                   // Логическое «или»
-    {"*",   {OperationArity::Binary, OperationType::Multiplication}},       // Умножение
-    {"/",   {OperationArity::Binary, OperationType::Division}},             // Деление
-    {"%",   {OperationArity::Binary, OperationType::Modulus}},              // Остаток от деления
-    {"+",   {OperationArity::Binary, OperationType::Addition}},             // Сложение
-    {"-",   {OperationArity::Binary, OperationType::Subtraction}},          // Вычитание
-    {"<",   {OperationArity::Binary, OperationType::LessThan}},             // Оператор сравнения «меньше»
-    {">",   {OperationArity::Binary, OperationType::GreaterThan}},          // Оператор сравнения «больше»
-    {"<=",  {OperationArity::Binary, OperationType::LessThanOrEqual}},      // Оператор сравнения «меньше либо равно»
-    {">=",  {OperationArity::Binary, OperationType::GreaterThanOrEqual}},   // Оператор сравнения «больше либо равно»
-    {"==",  {OperationArity::Binary, OperationType::Equal}},                // Оператор сравнения «равно»
-    {"!=",  {OperationArity::Binary, OperationType::NotEqual}},             // Оператор сравнения «не равно»
-    {"%=",  {OperationArity::Binary, OperationType::ModulusAssignment}},    // Взятие остатка от деления с присваиванием
-    {"/=",  {OperationArity::Binary, OperationType::DivisionAssignment}},   // Деление с присваиванием
-    {"*=",  {OperationArity::Binary, OperationType::MultiplicationAssignment}}, // Умножение с присваиванием
-    {"-=",  {OperationArity::Binary, OperationType::SubtractionAssignment}},// Вычитание с присваиванием
-    {"+=",  {OperationArity::Binary, OperationType::AdditionAssignment}},   // Сложение с присваиванием
-    {"=",   {OperationArity::Binary, OperationType::Assignment}},           // Присваивание
-    {"_--", {OperationArity::Unary, OperationType::PostfixDecrement}},      // Постфиксный декремент
-    {"_++", {OperationArity::Unary, OperationType::PostfixIncrement}},      // Постфиксный инкремент
-    {"::",  {OperationArity::Binary, OperationType::StaticMemberAccess}}    // Обращение к статическому элементу
-};
-
-Variable::Variable(const QString &name, const QString &type, const QHash<Case, QString> &description)
+namespace {
+// Поддерживаемые стандартные типы данных
+constexpr QStringView DataTypes[] = {u"int", u"float", u"double", u"char", u"bool", u"string"};
+
+// Ключ для распознавания двухсимвольных операторов
+constexpr char32_t operatorKey(char16_t first, char16_t second)
+{
+    return (char32_t(first) << 16) | second;
+}
+}
+
+bool isStandardDataType(QStringView dataType)
+{
+    for (QStringView type : DataTypes) {
+        if (type == dataType) return true;
+    }
+    return false;
+}
+
+std::optional<OperatorInfo> findOperator(QStringView token)
+{
+    const OperationArity unary = OperationArity::Unary;
+    const OperationArity binary = OperationArity::Binary;
+
+    switch (token.size()) {
+    case 1:
+        switch (token[0].unicode()) {
+        case u'.': return OperatorInfo{binary, OperationType::FieldAccess};         // Обращение к полю элемента
+        case u'&': return OperatorInfo{unary, OperationType::AddressOf};           // Обращение к адресу элемента
+        case u'!': return OperatorInfo{unary, OperationType::Not};                 // Логическое «не»
+        case u'*': return OperatorInfo{binary, OperationType::Multiplication};     // Умножение
+        case u'/': return OperatorInfo{binary, OperationType::Division};           // Деление
+        case u'%': return OperatorInfo{binary, OperationType::Modulus};            // Остаток от деления
+        case u'+': return OperatorInfo{binary, OperationType::Addition};           // Сложение
+        // Вычитание; унарный минус определяется по количеству операндов при построении дерева
+        case u'-': return OperatorInfo{binary, OperationType::Subtraction};
+        case u'<': return OperatorInfo{binary, OperationType::LessThan};           // Оператор сравнения «меньше»
+        case u'>': return OperatorInfo{binary, OperationType::GreaterThan};        // Оператор сравнения «больше»
+        case u'=': return OperatorInfo{binary, OperationType::Assignment};         // Присваивание
+        }
+        break;
+    case 2:
+        switch (operatorKey(token[0].unicode(), token[1].unicode())) {
+        case operatorKey(u'[', u']'): return OperatorInfo{binary, OperationType::ArrayAccess};              // Обращение к элементу под индексом
+        case operatorKey(u'-', u'>'): return OperatorInfo{binary, OperationType::PointerFieldAccess};       // Обращение к полю по указателю
+        case operatorKey(u'*', u'_'): return OperatorInfo{unary, OperationType::Dereference};              // Обращение к значению по адресу
+        case operatorKey(u'&', u'&'): return OperatorInfo{binary, OperationType::And};                      // Логическое «и»
+        case operatorKey(u'|', u'|'): return OperatorInfo{binary, OperationType::Or};                       // Логическое «или»
+        case operatorKey(u'<', u'='): return OperatorInfo{binary, OperationType::LessThanOrEqual};          // Оператор сравнения «меньше либо равно»
+        case operatorKey(u'>', u'='): return OperatorInfo{binary, OperationType::GreaterThanOrEqual};       // Оператор сравнения «больше либо равно»
+        case operatorKey(u'=', u'='): return OperatorInfo{binary, OperationType::Equal};                    // Оператор сравнения «равно»
+        case operatorKey(u'!', u'='): return OperatorInfo{binary, OperationType::NotEqual};                 // Оператор сравнения «не равно»
+        case operatorKey(u'%', u'='): return OperatorInfo{binary, OperationType::ModulusAssignment};        // Взятие остатка от деления с присваиванием
+        case operatorKey(u'/', u'='): return OperatorInfo{binary, OperationType::DivisionAssignment};       // Деление с присваиванием
+        case operatorKey(u'*', u'='): return OperatorInfo{binary, OperationType::MultiplicationAssignment}; // Умножение с присваиванием
+        case operatorKey(u'-', u'='): return OperatorInfo{binary, OperationType::SubtractionAssignment};    // Вычитание с присваиванием
+        case operatorKey(u'+', u'='): return OperatorInfo{binary, OperationType::AdditionAssignment};       // Сложение с присваиванием
+        case operatorKey(u':', u':'): return OperatorInfo{binary, OperationType::StaticMemberAccess};       // Обращение к статическому элементу
+        }
+        break;
+    case 3:
+        if (token == u"++_") return OperatorInfo{unary, OperationType::PrefixIncrement};     // Префиксный инкремент
+        if (token == u"--_") return OperatorInfo{unary, OperationType::PrefixDecrement};     // Префиксный декремент
+        if (token == u"_++") return OperatorInfo{unary, OperationType::PostfixIncrement};    // Постфиксный инкремент
+        if (token == u"_--") return OperatorInfo{unary, OperationType::PostfixDecrement};    // Постфиксный декремент
+        break;
+    }
+    return std::nullopt;
+}
+
+CaseDescription::CaseDescription(const QHash<Case, QString> &cases)
+{
+    for (auto it = cases.cbegin(); it != cases.cend(); ++it)
+        insert(it.key(), it.value());
+}
+
+CaseDescription::CaseDescription(std::initializer_list<std::pair<Case, QString>> cases)
+{
+    for (const auto& item : cases)
+        insert(item.first, item.second);
+}
+
+void CaseDescription::insert(Case c, const QString &text)
+{
+    spans[static_cast<int>(c)] = Span{text, QByteArray(), 0, text.size()};
+}
+
+void CaseDescription::insertSpan(Case c, const QString &source, qsizetype position, qsizetype length)
+{
+    spans[static_cast<int>(c)] = Span{source, QByteArray(), position, length};
+}
+
+void CaseDescription::insertSpan(Case c, const QByteArray &source, qsizetype position, qsizetype length)
+{
+    spans[static_cast<int>(c)] = Span{QString(), source, position, length};
+}
+
+bool CaseDescription::contains(Case c) const
+{
+    return spans[static_cast<int>(c)].length >= 0;
+}
+
+bool CaseDescription::isEmpty() const
+{
+    for (const Span& span : spans)
+        if (span.length >= 0) return false;
+    return true;
+}
+
+QString CaseDescription::value(Case c) const
+{
+    const Span& span = spans[static_cast<int>(c)];
+    if (span.length < 0) return QString();
+
+    // Участок документа преобразуется из UTF-8 только для запрошенного падежа
+    if (!span.utf8Source.isNull()) {
+        PipelineStats::add(PipelineCounter::DescriptionMaterializations);
+        return QString::fromUtf8(span.utf8Source.constData() + span.position, span.length);
+    }
+
+    // Участок, занимающий всю строку, возвращается без копирования
+    if (span.position == 0 && span.length == span.source.size()) return span.source;
+
+    PipelineStats::add(PipelineCounter::DescriptionMaterializations);
+    return span.source.mid(span.position, span.length);
+}
+
+QHash<Case, QString> CaseDescription::toHash() const
+{
+    QHash<Case, QString> cases;
+    for (int c = 0; c < CaseCount; ++c)
+        if (spans[c].length >= 0) cases.insert(static_cast<Case>(c), value(static_cast<Case>(c)));
+    return cases;
+}
+
+CaseDescription::operator QHash<Case, QString>() const
+{
+    return toHash();
+}
+
+Variable::Variable(const QString &name, const QString &type, const CaseDescription &description)
     : name(name), type(type), description(description) {}
 
 QString Variable::toQString(const QString& startLine) const {
@@ -62,7 +154,7 @@ QString Variable::toQString(const QString& startLine) const {
     return result;
 }
 
-Function::Function(const QString &name, const QString &type, int paramsCount, const QHash<Case, QString> &description)
+Function::Function(const QString &name, const QString &type, int paramsCount, const CaseDescription &description)
     : name(name), type(type), paramsCount(paramsCount), description(description) {}
 
 QString Function::toQString(const QString& startLine) const {
@@ -133,7 +225,7 @@ QString Class::toQString(const QString& startLine) const {
 
 }
 
-Enum::Enum(const QString &name, const QHash<QString, QHash<Case, QString> > &values)
+Enum::Enum(const QString &name, const QHash<QString, CaseDescription> &values)
     : name(name), values(values) {}
 
 QString Enum::toQString(const QString& startLine) const {
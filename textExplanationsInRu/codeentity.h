@@ -6,10 +6,17 @@
 #ifndef CODEENTITY_H
 #define CODEENTITY_H
 
+#include <QByteArray>
 #include <QList>
 #include <QHash>
 #include <QString>
 #include <QSet>
+#include <QStringView>
+
+#include <array>
+#include <initializer_list>
+#include <optional>
+#include <utility>
 
 /*!
  * \brief Перечисление падежей для описания сущностей.
@@ -23,6 +30,11 @@ enum class Case {
     Prepositional   /*!< Предложный */
 };
 
+/*!
+ * \brief Количество падежей.
+ */
+constexpr int CaseCount = static_cast<int>(Case::Prepositional) + 1;
+
 /*!
  * \brief Перечисление типов сущностей.
  */
@@ -102,19 +114,89 @@ struct OperatorInfo {
 };
 
 /*!
- * \brief Глобальное множество поддерживаемых стандартных типов данных.
+ * \brief Количество типов операций (включая OperationType::None).
+ */
+constexpr int OperationTypeCount = static_cast<int>(OperationType::None) + 1;
+
+/*!
+ * \brief Структура, описывающая свойства типа операции.
+ */
+struct OperationTraits {
+    OperationArity arity = OperationArity::Binary;      /*!< Арность операции */
+    bool isComparison = false;                          /*!< Является ли операция сравнением */
+    bool isIncrementOrDecrement = false;                /*!< Является ли операция инкрементом или декрементом */
+    OperationType inverse = OperationType::None;        /*!< Логическая инверсия операции сравнения */
+    OperationType cancelledBy = OperationType::None;    /*!< Унарная операция, вложение которой взаимно сокращается с данной */
+};
+
+/*!
+ * \brief Построение таблицы свойств операций на этапе компиляции.
+ * \return Таблица свойств, индексируемая типом операции.
  */
-extern const QSet<QString> DataTypes;
+constexpr std::array<OperationTraits, OperationTypeCount> makeOperationTraits()
+{
+    std::array<OperationTraits, OperationTypeCount> traits{};
+    auto at = [&traits](OperationType type) -> OperationTraits& { return traits[static_cast<int>(type)]; };
+
+    for (OperationType type : {OperationType::PrefixIncrement, OperationType::PrefixDecrement, OperationType::Dereference,
+                               OperationType::AddressOf, OperationType::UnaryMinus, OperationType::Not,
+                               OperationType::PostfixDecrement, OperationType::PostfixIncrement,
+                               OperationType::SingleIncrement, OperationType::SingleDecrement})
+        at(type).arity = OperationArity::Unary;
+
+    for (OperationType type : {OperationType::PrefixIncrement, OperationType::PrefixDecrement,
+                               OperationType::PostfixIncrement, OperationType::PostfixDecrement})
+        at(type).isIncrementOrDecrement = true;
+
+    const OperationType comparisons[][2] = {
+        {OperationType::LessThan, OperationType::NotLessThan},
+        {OperationType::LessThanOrEqual, OperationType::NotLessThanOrEqual},
+        {OperationType::GreaterThan, OperationType::NotGreaterThan},
+        {OperationType::GreaterThanOrEqual, OperationType::NotGreaterThanOrEqual},
+        {OperationType::Equal, OperationType::NotEqual}
+    };
+    for (const auto& pair : comparisons) {
+        at(pair[0]).isComparison = at(pair[1]).isComparison = true;
+        at(pair[0]).inverse = pair[1];
+        at(pair[1]).inverse = pair[0];
+    }
+
+    at(OperationType::UnaryMinus).cancelledBy = OperationType::UnaryMinus;
+    at(OperationType::Not).cancelledBy = OperationType::Not;
+    at(OperationType::Dereference).cancelledBy = OperationType::AddressOf;
+    at(OperationType::AddressOf).cancelledBy = OperationType::Dereference;
+
+    return traits;
+}
 
 /*!
- * \brief Глобальная таблица соответствий операций и их логических инверсий.
+ * \brief Глобальная таблица свойств операций, индексируемая типом операции.
  */
-extern const QHash<OperationType, OperationType> InverseComparisonOperationsMap;
+inline constexpr std::array<OperationTraits, OperationTypeCount> OperationTraitsTable = makeOperationTraits();
 
 /*!
- * \brief Глобальная таблица операций: строка → информация об операторе.
+ * \brief Получение свойств операции.
+ * \param[in] type Тип операции.
+ * \return Свойства операции.
  */
-extern const QHash<QString, OperatorInfo> OperationMap;
+constexpr const OperationTraits& operationTraits(OperationType type)
+{
+    return OperationTraitsTable[static_cast<int>(type)];
+}
+
+/*!
+ * \brief Распознавание оператора по строке.
+ * \param[in] token Строковое представление оператора.
+ * \return Информация об операторе, либо пустое значение, если строка не является оператором.
+ */
+std::optional<OperatorInfo> findOperator(QStringView token);
+
+/*!
+ * \brief Проверка, является ли тип стандартным типом данных.
+ * \param[in] dataType Имя типа данных.
+ * \return true, если тип входит в число поддерживаемых стандартных типов.
+ */
+bool isStandardDataType(QStringView dataType);
 
 /*!
  * \brief Глобальная таблица строковых имён типов сущностей.
@@ -126,18 +208,111 @@ extern const QHash<EntityType, QString> EntityTypeNames;
  */
 extern const QHash<OperationType, QString> OperationTypeNames;
 
+/*!
+ * \brief Класс, описывающий описание сущности в разных падежах.
+ *
+ * Каждый падеж хранится как участок неявно разделяемой исходной строки. Описание, заданное готовыми
+ * строками, занимает исходную строку целиком; при ленивой загрузке описаний из XML участок указывает на
+ * текст элемента <case> в исходном документе в кодировке UTF-8, и строка падежа преобразуется в QString
+ * только при обращении к этому падежу.
+ */
+class CaseDescription {
+public:
+    /*!
+     * \brief Конструктор пустого описания.
+     */
+    CaseDescription() = default;
+
+    /*!
+     * \brief Конструктор описания по готовым строкам падежей.
+     * \param[in] cases Строки описания по падежам.
+     */
+    CaseDescription(const QHash<Case, QString>& cases);
+
+    /*!
+     * \brief Конструктор описания по списку пар "падеж – строка".
+     * \param[in] cases Строки описания по падежам.
+     */
+    CaseDescription(std::initializer_list<std::pair<Case, QString>> cases);
+
+    /*!
+     * \brief Задание готовой строки падежа.
+     * \param[in] c Падеж.
+     * \param[in] text Строка описания.
+     */
+    void insert(Case c, const QString& text);
+
+    /*!
+     * \brief Задание участка исходной строки, из которого строка падежа извлекается при обращении.
+     * \param[in] c Падеж.
+     * \param[in] source Исходная строка.
+     * \param[in] position Начало участка.
+     * \param[in] length Длина участка.
+     */
+    void insertSpan(Case c, const QString& source, qsizetype position, qsizetype length);
+
+    /*!
+     * \brief Задание участка исходного документа в кодировке UTF-8, из которого строка падежа извлекается при обращении.
+     * \param[in] c Падеж.
+     * \param[in] source Исходный документ.
+     * \param[in] position Начало участка в байтах.
+     * \param[in] length Длина участка в байтах.
+     */
+    void insertSpan(Case c, const QByteArray& source, qsizetype position, qsizetype length);
+
+    /*!
+     * \brief Проверка, задан ли падеж.
+     */
+    bool contains(Case c) const;
+
+    /*!
+     * \brief Проверка, что не задан ни один падеж.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Получение строки падежа.
+     * \param[in] c Падеж.
+     * \return Строка описания; для незаданного падежа – пустая строка.
+     */
+    QString value(Case c) const;
+
+    /*!
+     * \brief Получение строк всех заданных падежей.
+     */
+    QHash<Case, QString> toHash() const;
+
+    /*!
+     * \brief Преобразование в строки всех заданных падежей.
+     */
+    operator QHash<Case, QString>() const;
+
+private:
+    /*!
+     * \brief Участок исходной строки, содержащий строку падежа.
+     */
+    struct Span {
+        QString source;             /*!< Исходная строка */
+        QByteArray utf8Source;      /*!< Исходный документ в UTF-8; если задан, участок указывает на него */
+        qsizetype position = 0;     /*!< Начало участка */
+        qsizetype length = -1;      /*!< Длина участка; -1 – падеж не задан */
+    };
+
+    std::array<Span, CaseCount> spans;  /*!< Участки по падежам */
+};
+
 /*!
  * \brief Структура, описывающая переменную.
  */
 struct Variable {
     QString name;                       /*!< Имя переменной */
     QString type;                       /*!< Тип переменной */
-    QHash<Case, QString> description;   /*!< Описание в разных падежах */
+    CaseDescription description;        /*!< Описание в разных падежах */
 
     /*!
      * \brief Конструктор переменной.
      */
-    explicit Variable(const QString& name = "", const QString& type = "", const QHash<Case, QString>& description = {});
+    explicit Variable(const QString& name = "", const QString& type = "", const CaseDescription& description = {});
 
     /*!
      * \brief Преобразует переменную в строку.
@@ -154,12 +329,12 @@ struct Function {
     QString name;                       /*!< Имя функции */
     QString type;                       /*!< Тип возвращаемого значения */
     int paramsCount;                    /*!< Количество параметров */
-    QHash<Case, QString> description;   /*!< Описание функции в разных падежах */
+    CaseDescription description;        /*!< Описание функции в разных падежах */
 
     /*!
      * \brief Конструктор функции.
      */
-    explicit Function(const QString& name = "", const QString& type = "", int paramsCount = 0, const QHash<Case, QString>& description = {});
+    explicit Function(const QString& name = "", const QString& type = "", int paramsCount = 0, const CaseDescription& description = {});
 
     /*!
      * \brief Преобразует функцию в строку.
@@ -219,12 +394,12 @@ struct Class : public CustomTypeWithFields {
  */
 struct Enum {
     QString name;                                           /*!< Имя перечисления */
-    QHash<QString, QHash<Case, QString>> values;            /*!< Значения и их описания по падежам */
+    QHash<QString, CaseDescription> values;                 /*!< Значения и их описания по падежам */
 
     /*!
      * \brief Конструктор перечисления.
      */
-    explicit Enum(const QString& name = "", const QHash<QString, QHash<Case, QString>>& values = {});
+    explicit Enum(const QString& name = "", const QHash<QString, CaseDescription>& values = {});
 
     /*!
      * \brief Преобразует перечисление в строку.
@@ -0,0 +1,145 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса DeclarationIndex.
+ */
+
+#include "declarationindex.h"
+#include "expression.h"
+
+DeclarationIndex::DeclarationIndex(const Expression& declarations)
+{
+    addDeclarations(declarations);
+}
+
+DeclarationIndex::DeclarationIndex(const QSharedPointer<const DeclarationIndex>& baseIndex, const Expression& declarations)
+    : base(baseIndex)
+    , baseSize(baseIndex->size())
+{
+    addDeclarations(declarations);
+}
+
+void DeclarationIndex::addDeclarations(const Expression& declarations)
+{
+    for (const Variable& variable : *declarations.getVariables())
+        add(variable.name);
+    for (const Function& function : *declarations.getFunctions())
+        add(function.name);
+    for (const Union& customType : *declarations.getUnions())
+        addCustomType(customType);
+    for (const Structure& customType : *declarations.getStructures())
+        addCustomType(customType);
+    for (const Class& customType : *declarations.getClasses())
+        addCustomType(customType);
+    for (const Enum& _enum : *declarations.getEnums()) {
+        add(_enum.name);
+        for (auto it = _enum.values.cbegin(); it != _enum.values.cend(); ++it)
+            addMember(_enum.name, it.key());
+    }
+}
+
+qsizetype DeclarationIndex::size() const
+{
+    return baseSize + fullNames.size();
+}
+
+int DeclarationIndex::indexOf(const QString& name) const
+{
+    auto it = topLevel.constFind(name);
+    if (it != topLevel.cend()) return it.value();
+    return base.isNull() ? -1 : base->indexOf(name);
+}
+
+int DeclarationIndex::memberIndexOf(const QString& typeName, const QString& memberName) const
+{
+    auto type = members.constFind(typeName);
+    if (type != members.cend()) {
+        auto it = type.value().constFind(memberName);
+        if (it != type.value().cend()) return it.value();
+    }
+    return base.isNull() ? -1 : base->memberIndexOf(typeName, memberName);
+}
+
+QSet<QString> DeclarationIndex::names() const
+{
+    return base.isNull() ? nameSet : base->names() + nameSet;
+}
+
+QList<QString> DeclarationIndex::names(const QBitArray& bits) const
+{
+    QList<QString> result;
+    for (qsizetype i = 0; i < bits.size() && i < size(); ++i)
+        if (bits.testBit(i)) result.append(fullName(i));
+    return result;
+}
+
+QBitArray DeclarationIndex::mask(const QSet<QString>& names) const
+{
+    QBitArray bits(size());
+    for (const QString& name : names) {
+        // Полное имя вида "Тип.элемент" ищется среди элементов типа
+        qsizetype dot = name.indexOf('.');
+        int index = dot < 0 ? indexOf(name) : memberIndexOf(name.left(dot), name.mid(dot + 1));
+        if (index >= 0) bits.setBit(index);
+    }
+    return bits;
+}
+
+const QList<int>& DeclarationIndex::redeclaredIndices() const
+{
+    return redeclared;
+}
+
+const QString& DeclarationIndex::fullName(qsizetype index) const
+{
+    return index < baseSize ? base->fullName(index) : fullNames.at(index - baseSize);
+}
+
+int DeclarationIndex::add(const QString& name)
+{
+    auto it = topLevel.constFind(name);
+    if (it != topLevel.cend()) return it.value();
+
+    // Объявление базового индекса сохраняет свой номер
+    int index = base.isNull() ? -1 : base->indexOf(name);
+    if (index >= 0) {
+        topLevel.insert(name, index);
+        redeclared.append(index);
+        return index;
+    }
+
+    index = int(size());
+    topLevel.insert(name, index);
+    fullNames.append(name);
+    nameSet.insert(name);
+    return index;
+}
+
+int DeclarationIndex::addMember(const QString& typeName, const QString& memberName)
+{
+    QHash<QString, int>& typeMembers = members[typeName];
+    auto it = typeMembers.constFind(memberName);
+    if (it != typeMembers.cend()) return it.value();
+
+    int index = base.isNull() ? -1 : base->memberIndexOf(typeName, memberName);
+    if (index >= 0) {
+        typeMembers.insert(memberName, index);
+        redeclared.append(index);
+        return index;
+    }
+
+    index = int(size());
+    QString fullName = typeName + "." + memberName;
+    typeMembers.insert(memberName, index);
+    fullNames.append(fullName);
+    nameSet.insert(fullName);
+    return index;
+}
+
+void DeclarationIndex::addCustomType(const CustomTypeWithFields& customType)
+{
+    add(customType.name);
+    for (const Variable& variable : customType.variables)
+        addMember(customType.name, variable.name);
+    for (const Function& function : customType.functions)
+        addMember(customType.name, function.name);
+}
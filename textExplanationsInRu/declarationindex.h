@@ -0,0 +1,129 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса DeclarationIndex для плотной нумерации объявлений.
+ */
+
+#ifndef DECLARATIONINDEX_H
+#define DECLARATIONINDEX_H
+
+#include "codeentity.h"
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+
+class Expression;
+
+/*!
+ * \brief Класс, присваивающий каждому объявлению выражения номер от 0 до size() - 1.
+ *
+ * Нумеруются переменные, функции, пользовательские типы и перечисления, а также поля и методы
+ * пользовательских типов и значения перечислений (имена вида "Тип.элемент"). Номера позволяют
+ * отмечать использованные и общие объявления битовыми масками, не составляя строк имён при построении
+ * каждого дерева; полные имена составляются один раз при построении индекса.
+ *
+ * Индекс может продолжать базовый индекс (например, индекс библиотеки объявлений): собственные объявления
+ * нумеруются после объявлений базового индекса, а базовый индекс не копируется и не перестраивается.
+ */
+class DeclarationIndex
+{
+public:
+    /*!
+     * \brief Построение индекса объявлений выражения.
+     * \param[in] declarations Выражение, объявления которого нумеруются.
+     */
+    explicit DeclarationIndex(const Expression& declarations);
+
+    /*!
+     * \brief Построение индекса, продолжающего базовый индекс.
+     *
+     * Объявления, уже имеющиеся в базовом индексе, сохраняют свои номера и считаются объявленными повторно.
+     * \param[in] baseIndex Базовый индекс.
+     * \param[in] declarations Выражение, собственные объявления которого нумеруются после базовых.
+     */
+    DeclarationIndex(const QSharedPointer<const DeclarationIndex>& baseIndex, const Expression& declarations);
+
+    /*!
+     * \brief Получение количества объявлений.
+     */
+    qsizetype size() const;
+
+    /*!
+     * \brief Получение номера объявления верхнего уровня.
+     * \param[in] name Имя переменной, функции, типа или перечисления.
+     * \return Номер объявления либо -1.
+     */
+    int indexOf(const QString& name) const;
+
+    /*!
+     * \brief Получение номера элемента пользовательского типа или перечисления.
+     * \param[in] typeName Имя типа или перечисления.
+     * \param[in] memberName Имя поля, метода или значения.
+     * \return Номер объявления либо -1.
+     */
+    int memberIndexOf(const QString& typeName, const QString& memberName) const;
+
+    /*!
+     * \brief Получение множества полных имён всех объявлений.
+     */
+    QSet<QString> names() const;
+
+    /*!
+     * \brief Получение полных имён объявлений, отмеченных в маске.
+     * \param[in] bits Маска объявлений.
+     * \return Имена в порядке номеров.
+     */
+    QList<QString> names(const QBitArray& bits) const;
+
+    /*!
+     * \brief Построение маски объявлений по их полным именам.
+     * \param[in] names Полные имена объявлений; имена, отсутствующие в индексе, пропускаются.
+     * \return Маска размера size().
+     */
+    QBitArray mask(const QSet<QString>& names) const;
+
+    /*!
+     * \brief Получение номеров объявлений базового индекса, объявленных повторно.
+     */
+    const QList<int>& redeclaredIndices() const;
+
+private:
+    /*!
+     * \brief Нумерация объявлений выражения.
+     */
+    void addDeclarations(const Expression& declarations);
+
+    /*!
+     * \brief Получение полного имени объявления по номеру.
+     */
+    const QString& fullName(qsizetype index) const;
+
+    /*!
+     * \brief Добавление объявления верхнего уровня.
+     * \return Номер объявления.
+     */
+    int add(const QString& name);
+
+    /*!
+     * \brief Добавление элемента типа или перечисления.
+     * \return Номер объявления.
+     */
+    int addMember(const QString& typeName, const QString& memberName);
+
+    /*!
+     * \brief Добавление пользовательского типа вместе с его полями и методами.
+     */
+    void addCustomType(const CustomTypeWithFields& customType);
+
+    QHash<QString, int> topLevel;                   /*!< Номера объявлений верхнего уровня */
+    QHash<QString, QHash<QString, int>> members;    /*!< Номера элементов по имени типа */
+    QList<QString> fullNames;                       /*!< Полные имена собственных объявлений в порядке номеров */
+    QSet<QString> nameSet;                          /*!< Множество полных имён собственных объявлений */
+    QSharedPointer<const DeclarationIndex> base;    /*!< Базовый индекс или nullptr */
+    qsizetype baseSize = 0;                         /*!< Количество объявлений базового индекса */
+    QList<int> redeclared;                          /*!< Номера повторно объявленных объявлений базового индекса */
+};
+
+#endif // DECLARATIONINDEX_H
@@ -0,0 +1,124 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса DeclarationLibrary.
+ */
+
+#include "declarationlibrary.h"
+#include "expressionxmlparser.h"
+#include "tracerecorder.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+
+namespace {
+// Кэш снимков библиотек по абсолютному пути к файлу
+QMutex cacheMutex;
+QHash<QString, QSharedPointer<const DeclarationLibrary>> cache;
+}
+
+TEResult<QSharedPointer<const DeclarationLibrary>> DeclarationLibrary::load(const QString& path)
+{
+    QFileInfo info(path);
+    QString absolutePath = info.absoluteFilePath();
+    QDateTime lastModified = info.lastModified();
+    qint64 fileSize = info.size();
+
+    // Снимок используется повторно, пока файл не изменился
+    {
+        QMutexLocker locker(&cacheMutex);
+        QSharedPointer<const DeclarationLibrary> cached = cache.value(absolutePath);
+        if (!cached.isNull() && info.exists() && cached->lastModified() == lastModified && cached->fileSize() == fileSize)
+            return cached;
+    }
+
+    TraceRecorder::Span span("DeclarationLibrary::load");
+    // Хэш содержимого связывает скомпилированные пакеты с тем снимком библиотеки, с которым они построены
+    QByteArray digest;
+    {
+        QFile file(absolutePath);
+        if (file.open(QIODevice::ReadOnly)) digest = QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1);
+    }
+    TEResult<Expression> declarations = ExpressionXmlParser::parseLibraryFile(path);
+    if (!declarations) {
+        QMutexLocker locker(&cacheMutex);
+        cache.remove(absolutePath);
+        return declarations.errors();
+    }
+
+    QSharedPointer<const DeclarationLibrary> library(new DeclarationLibrary(absolutePath, declarations.takeValue(), lastModified, fileSize, digest));
+    QMutexLocker locker(&cacheMutex);
+    cache.insert(absolutePath, library);
+    return library;
+}
+
+void DeclarationLibrary::clearCache()
+{
+    QMutexLocker locker(&cacheMutex);
+    cache.clear();
+}
+
+DeclarationLibrary::DeclarationLibrary(const QString& path, const Expression& declarations, const QDateTime& lastModified, qint64 fileSize,
+                                       const QByteArray& digest)
+    : libraryPath(path)
+    , libraryDeclarations(declarations)
+    , modified(lastModified)
+    , size(fileSize)
+    , contentDigest(digest)
+{
+    // Индекс объявлений и маска общих объявлений строятся здесь один раз, до того как снимок станет доступен
+    // нескольким потокам
+    libraryIndex.reset(new DeclarationIndex(libraryDeclarations));
+    librarySharedDeclarations = QBitArray(libraryIndex->size(), true);
+    declaredNames = libraryIndex->names();
+    for (const QString& name : std::as_const(declaredNames)) {
+        for (const QString& part : name.split('.'))
+            identifiers.insert(part);
+    }
+}
+
+const Expression& DeclarationLibrary::declarations() const
+{
+    return libraryDeclarations;
+}
+
+const QSet<QString>& DeclarationLibrary::names() const
+{
+    return declaredNames;
+}
+
+const QSharedPointer<const DeclarationIndex>& DeclarationLibrary::declarationIndex() const
+{
+    return libraryIndex;
+}
+
+const QBitArray& DeclarationLibrary::sharedDeclarations() const
+{
+    return librarySharedDeclarations;
+}
+
+bool DeclarationLibrary::declaresIdentifier(const QString& identifier) const
+{
+    return identifiers.contains(identifier);
+}
+
+const QString& DeclarationLibrary::path() const
+{
+    return libraryPath;
+}
+
+QDateTime DeclarationLibrary::lastModified() const
+{
+    return modified;
+}
+
+qint64 DeclarationLibrary::fileSize() const
+{
+    return size;
+}
+
+const QByteArray& DeclarationLibrary::digest() const
+{
+    return contentDigest;
+}
@@ -0,0 +1,120 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса DeclarationLibrary для общих библиотек объявлений.
+ */
+
+#ifndef DECLARATIONLIBRARY_H
+#define DECLARATIONLIBRARY_H
+
+#include "declarationindex.h"
+#include "expression.h"
+#include <QBitArray>
+#include <QByteArray>
+#include <QDateTime>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+
+/*!
+ * \brief Класс, представляющий библиотеку объявлений, общую для многих входных файлов.
+ *
+ * Библиотека – XML-файл с элементом <root>, который содержит только объявления (<variables>, <functions>,
+ * <unions>, <structures>, <classes>, <enums>). Файл разбирается и проверяется один раз; полученный снимок
+ * не изменяется и используется совместно всеми входными файлами, которые на него ссылаются. Снимки
+ * кэшируются по абсолютному пути и перечитываются, когда изменяется время модификации или размер файла.
+ *
+ * Индекс объявлений библиотеки и маска общих объявлений строятся один раз для снимка; входные файлы
+ * нумеруют только собственные объявления после объявлений библиотеки.
+ */
+class DeclarationLibrary
+{
+public:
+    /*!
+     * \brief Получение библиотеки объявлений из кэша или из файла.
+     *
+     * Безопасно для вызова из нескольких потоков.
+     * \param[in] path Путь к файлу библиотеки.
+     * \return Снимок библиотеки либо список ошибок файла библиотеки.
+     */
+    static TEResult<QSharedPointer<const DeclarationLibrary>> load(const QString& path);
+
+    /*!
+     * \brief Очистка кэша библиотек.
+     *
+     * Снимки, которые ещё используются, остаются действительными.
+     */
+    static void clearCache();
+
+    /*!
+     * \brief Получение объявлений библиотеки.
+     * \return Выражение без строки выражения, содержащее объявления библиотеки.
+     */
+    const Expression& declarations() const;
+
+    /*!
+     * \brief Получение всех имён, объявленных в библиотеке (в том числе полей вида "Тип.поле").
+     */
+    const QSet<QString>& names() const;
+
+    /*!
+     * \brief Получение индекса объявлений библиотеки.
+     */
+    const QSharedPointer<const DeclarationIndex>& declarationIndex() const;
+
+    /*!
+     * \brief Получение маски общих объявлений в нумерации индекса библиотеки (все объявления библиотеки).
+     */
+    const QBitArray& sharedDeclarations() const;
+
+    /*!
+     * \brief Проверка, встречается ли идентификатор в объявлениях библиотеки.
+     * \param[in] identifier Идентификатор без квалификации.
+     * \return true, если идентификатор является именем или частью составного имени из библиотеки.
+     */
+    bool declaresIdentifier(const QString& identifier) const;
+
+    /*!
+     * \brief Получение абсолютного пути к файлу библиотеки.
+     */
+    const QString& path() const;
+
+    /*!
+     * \brief Получение времени модификации файла, из которого получен снимок.
+     */
+    QDateTime lastModified() const;
+
+    /*!
+     * \brief Получение размера файла, из которого получен снимок.
+     */
+    qint64 fileSize() const;
+
+    /*!
+     * \brief Получение хэша содержимого файла, из которого получен снимок.
+     * \return Хэш SHA-1.
+     */
+    const QByteArray& digest() const;
+
+private:
+    /*!
+     * \brief Конструктор класса DeclarationLibrary.
+     * \param[in] path Абсолютный путь к файлу библиотеки.
+     * \param[in] declarations Объявления библиотеки.
+     * \param[in] lastModified Время модификации файла.
+     * \param[in] fileSize Размер файла.
+     * \param[in] digest Хэш содержимого файла.
+     */
+    DeclarationLibrary(const QString& path, const Expression& declarations, const QDateTime& lastModified, qint64 fileSize,
+                       const QByteArray& digest);
+
+    QString libraryPath;                /*!< Абсолютный путь к файлу библиотеки */
+    Expression libraryDeclarations;     /*!< Объявления библиотеки */
+    QSharedPointer<const DeclarationIndex> libraryIndex;    /*!< Индекс объявлений библиотеки */
+    QBitArray librarySharedDeclarations;    /*!< Маска общих объявлений библиотеки */
+    QSet<QString> declaredNames;        /*!< Все объявленные имена */
+    QSet<QString> identifiers;          /*!< Идентификаторы, из которых состоят объявленные имена */
+    QDateTime modified;                 /*!< Время модификации файла */
+    qint64 size;                        /*!< Размер файла */
+    QByteArray contentDigest;           /*!< Хэш SHA-1 содержимого файла */
+};
+
+#endif // DECLARATIONLIBRARY_H
@@ -0,0 +1,106 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса DescriptionCache для повторного использования описаний поддеревьев.
+ */
+
+#include "descriptioncache.h"
+
+namespace {
+// Наибольшее количество описаний; при превышении кэш описаний очищается
+constexpr qsizetype MaxDescriptions = 4096;
+
+// Запись строки с её длиной, чтобы разделители внутри значения не делали ключ неоднозначным
+void appendField(QString& key, const QString& value)
+{
+    key += QString::number(value.size());
+    key += '#';
+    key += value;
+}
+}
+
+const CaseDescription* DescriptionCache::find(const ExpressionNode* node, const QString& className, OperationType parentOperType)
+{
+    QString key = descriptionKey(node, className, parentOperType);
+    auto it = key.isEmpty() ? descriptions.constEnd() : descriptions.constFind(key);
+    if (it == descriptions.constEnd()) {
+        missCount++;
+        return nullptr;
+    }
+    hitCount++;
+    return &it.value();
+}
+
+void DescriptionCache::insert(const ExpressionNode* node, const QString& className, OperationType parentOperType, const CaseDescription& description)
+{
+    QString key = descriptionKey(node, className, parentOperType);
+    if (key.isEmpty()) return;
+    if (descriptions.size() >= MaxDescriptions) descriptions.clear();
+    descriptions.insert(key, description);
+}
+
+void DescriptionCache::forget(const ExpressionNode* node)
+{
+    nodeKeys.remove(node);
+}
+
+void DescriptionCache::clear()
+{
+    nodeKeys.clear();
+    descriptions.clear();
+}
+
+qsizetype DescriptionCache::hits() const
+{
+    return hitCount;
+}
+
+qsizetype DescriptionCache::misses() const
+{
+    return missCount;
+}
+
+void DescriptionCache::resetCounters()
+{
+    hitCount = 0;
+    missCount = 0;
+}
+
+const DescriptionCache::NodeKey& DescriptionCache::nodeKey(const ExpressionNode* node)
+{
+    auto it = nodeKeys.constFind(node);
+    if (it != nodeKeys.constEnd()) return it.value();
+
+    NodeKey result;
+    result.cacheable = !node->isIncrementOrDecrement();
+    result.key = QString::number(static_cast<int>(node->getNodeType())) + ':' + QString::number(static_cast<int>(node->getOperType())) + ':';
+    appendField(result.key, node->getValue());
+    appendField(result.key, node->getDataType());
+
+    // Ключ поддерева включает ключи дочерних узлов и аргументов функции
+    QList<const ExpressionNode*> children = {node->getLeftNode(), node->getRightNode()};
+    if (node->getFunctionArgs() != nullptr)
+        for (const ExpressionNode* argument : *node->getFunctionArgs()) children.append(argument);
+    result.key += '(';
+    for (const ExpressionNode* child : children) {
+        if (child != nullptr) {
+            const NodeKey& childKey = nodeKey(child);
+            result.key += childKey.key;
+            result.cacheable = result.cacheable && childKey.cacheable;
+        }
+        result.key += ',';
+    }
+    result.key += ')';
+    return *nodeKeys.insert(node, result);
+}
+
+QString DescriptionCache::descriptionKey(const ExpressionNode* node, const QString& className, OperationType parentOperType)
+{
+    // Корень дерева переводится вместе с промежуточным описанием выражения
+    if (parentOperType == OperationType::None) return QString();
+    const NodeKey& key = nodeKey(node);
+    if (!key.cacheable) return QString();
+
+    QString result = QString::number(static_cast<int>(parentOperType)) + ':';
+    appendField(result, className);
+    return result + key.key;
+}
@@ -0,0 +1,94 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса DescriptionCache для повторного использования описаний поддеревьев.
+ */
+
+#ifndef DESCRIPTIONCACHE_H
+#define DESCRIPTIONCACHE_H
+
+#include "codeentity.h"
+#include "expressionnode.h"
+#include <QHash>
+#include <QString>
+
+/*!
+ * \brief Класс, хранящий описания поддеревьев выражения между последовательными переводами.
+ *
+ * Описание поддерева определяется его структурой (типы, значения и типы данных узлов), именем класса и типом
+ * родительской операции, с которыми оно переводится. Структурный ключ узла вычисляется один раз и хранится
+ * по адресу узла, поэтому узлы должны оставаться неизменными, а перед удалением узла его ключ нужно забыть.
+ * Поддеревья с инкрементом или декрементом, а также корень дерева не кэшируются: их описание зависит от
+ * промежуточного описания всего выражения.
+ */
+class DescriptionCache
+{
+public:
+    /*!
+     * \brief Поиск описания поддерева.
+     * \param[in] node Корень поддерева.
+     * \param[in] className Имя класса, с которым переводится поддерево.
+     * \param[in] parentOperType Тип родительской операции.
+     * \return Описание либо nullptr, если его нет в кэше или поддерево не кэшируется.
+     */
+    const CaseDescription* find(const ExpressionNode* node, const QString& className, OperationType parentOperType);
+
+    /*!
+     * \brief Сохранение описания поддерева.
+     * \param[in] node Корень поддерева.
+     * \param[in] className Имя класса, с которым переводится поддерево.
+     * \param[in] parentOperType Тип родительской операции.
+     * \param[in] description Описание поддерева.
+     */
+    void insert(const ExpressionNode* node, const QString& className, OperationType parentOperType, const CaseDescription& description);
+
+    /*!
+     * \brief Удаление структурного ключа узла перед удалением самого узла.
+     */
+    void forget(const ExpressionNode* node);
+
+    /*!
+     * \brief Удаление всех описаний и ключей.
+     */
+    void clear();
+
+    /*!
+     * \brief Получение количества описаний, найденных в кэше, с последнего сброса счётчиков.
+     */
+    qsizetype hits() const;
+
+    /*!
+     * \brief Получение количества описаний, отсутствовавших в кэше, с последнего сброса счётчиков.
+     */
+    qsizetype misses() const;
+
+    /*!
+     * \brief Сброс счётчиков найденных и отсутствовавших описаний.
+     */
+    void resetCounters();
+
+private:
+    /*!
+     * \brief Структурный ключ узла.
+     */
+    struct NodeKey {
+        QString key;            /*!< Запись структуры поддерева */
+        bool cacheable = true;  /*!< Не содержит ли поддерево инкремента или декремента */
+    };
+
+    /*!
+     * \brief Получение структурного ключа узла; ключи дочерних узлов вычисляются один раз.
+     */
+    const NodeKey& nodeKey(const ExpressionNode* node);
+
+    /*!
+     * \brief Получение ключа описания или пустой строки, если поддерево не кэшируется.
+     */
+    QString descriptionKey(const ExpressionNode* node, const QString& className, OperationType parentOperType);
+
+    QHash<const ExpressionNode*, NodeKey> nodeKeys;         /*!< Структурные ключи узлов */
+    QHash<QString, CaseDescription> descriptions;           /*!< Описания по структурному ключу, имени класса и родительской операции */
+    qsizetype hitCount = 0;                                 /*!< Количество найденных описаний */
+    qsizetype missCount = 0;                                /*!< Количество отсутствовавших описаний */
+};
+
+#endif // DESCRIPTIONCACHE_H
@@ -0,0 +1,220 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса DirectoryWatcher для наблюдения за каталогом входных файлов.
+ */
+
+#include "directorywatcher.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+#include "pipelinestats.h"
+#include "tracerecorder.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+
+namespace {
+// Хэш содержимого входного или выходного файла
+QByteArray contentHash(const QByteArray& content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
+}
+
+DirectoryWatcher::DirectoryWatcher(const QString& inputDirectory, const QString& outputDirectory, const QString& libraryPath, QObject* parent)
+    : QObject{parent}
+    , inputDirectory(QDir(inputDirectory).absolutePath())
+    , outputDirectory(QDir(outputDirectory.isEmpty() ? QDir(inputDirectory).filePath(DefaultOutputDirectory) : outputDirectory).absolutePath())
+    , libraryPath(libraryPath.isEmpty() ? QString() : QFileInfo(libraryPath).absoluteFilePath())
+{
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &DirectoryWatcher::onFileChanged);
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, &DirectoryWatcher::onDirectoryChanged);
+}
+
+QList<TEException> DirectoryWatcher::start()
+{
+    // Запись пояснений во входной каталог вызывала бы его просмотр после каждой записи
+    if (outputDirectory == inputDirectory || !QDir().mkpath(outputDirectory))
+        return {TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{outputDirectory})};
+    if (!libraryPath.isEmpty()) {
+        TEResult<QSharedPointer<const DeclarationLibrary>> loaded = DeclarationLibrary::load(libraryPath);
+        if (!loaded) return loaded.errors();
+        library = loaded.takeValue();
+        watcher.addPath(libraryPath);
+    }
+    watcher.addPath(inputDirectory);
+    refreshDirectory();
+    return {};
+}
+
+RefreshOutcome DirectoryWatcher::refreshFile(const QString& inputFile, bool force)
+{
+    const QString path = QFileInfo(inputFile).absoluteFilePath();
+    TraceRecorder::FileScope traceFile(path);
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (QFileInfo::exists(path)) {
+            removeOutput(outputPath(path), files[path]);
+            emit fileRefreshed(path, RefreshOutcome::Failed, {TEException(ErrorType::InputFileNotFound, QList<QString>{path})});
+            return RefreshOutcome::Failed;
+        }
+        files.remove(path);
+        emit fileRefreshed(path, RefreshOutcome::Removed, {});
+        return RefreshOutcome::Removed;
+    }
+    QByteArray content = file.readAll();
+    file.close();
+    // Редакторы часто сохраняют файл заменой, после чего наблюдение за прежним файлом прекращается
+    watcher.addPath(path);
+
+    // Файл с прежним содержимым не разбирается
+    FileState& state = files[path];
+    QByteArray hash = contentHash(content);
+    if (!force && state.contentHash == hash) {
+        emit fileRefreshed(path, RefreshOutcome::Unchanged, {});
+        return RefreshOutcome::Unchanged;
+    }
+    state.contentHash = hash;
+
+    // Пояснение файла с ошибками не должно оставаться в выходном каталоге как актуальное
+    const QString output = outputPath(path);
+    TEResult<QByteArray> explanation = explain(content, path);
+    if (!explanation) {
+        removeOutput(output, state);
+        emit fileRefreshed(path, RefreshOutcome::Failed, explanation.errors());
+        return RefreshOutcome::Failed;
+    }
+
+    // После запуска пояснение сравнивается с выходным файлом, оставшимся от предыдущей обработки
+    QByteArray outputHash = contentHash(explanation.value());
+    if (state.outputHash.isEmpty()) {
+        QFile existing(output);
+        if (existing.open(QIODevice::ReadOnly | QIODevice::Text)) state.outputHash = contentHash(existing.readAll());
+    }
+    if (state.outputHash == outputHash && QFileInfo::exists(output)) {
+        emit fileRefreshed(path, RefreshOutcome::OutputUnchanged, {});
+        return RefreshOutcome::OutputUnchanged;
+    }
+
+    // Выходной файл заменяется целиком, поэтому читатели не видят частично записанное пояснение
+    PipelineStats::ScopedTimer timer(PipelineStage::OutputWrite);
+    QSaveFile saveFile(output);
+    if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Text)
+        || saveFile.write(explanation.value()) != explanation.value().size()
+        || !saveFile.commit()) {
+        // Следующее изменение файла должно снова попытаться записать пояснение
+        state.contentHash.clear();
+        removeOutput(output, state);
+        emit fileRefreshed(path, RefreshOutcome::Failed, {TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{output})});
+        return RefreshOutcome::Failed;
+    }
+    PipelineStats::add(PipelineCounter::BytesWritten, explanation.value().size());
+    state.outputHash = outputHash;
+    emit fileRefreshed(path, RefreshOutcome::Written, {});
+    return RefreshOutcome::Written;
+}
+
+void DirectoryWatcher::refreshDirectory()
+{
+    const QStringList current = inputFiles();
+    const QSet<QString> present(current.begin(), current.end());
+
+    // Забыть состояние удалённых файлов
+    for (auto it = files.begin(); it != files.end(); ) {
+        if (present.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        const QString path = it.key();
+        it = files.erase(it);
+        watcher.removePath(path);
+        emit fileRefreshed(path, RefreshOutcome::Removed, {});
+    }
+
+    // Пояснить добавленные файлы; изменения известных файлов обрабатываются по сигналу об изменении файла
+    for (const QString& path : current)
+        if (!files.contains(path)) refreshFile(path);
+}
+
+QList<TEException> DirectoryWatcher::reloadLibrary()
+{
+    if (libraryPath.isEmpty()) return {};
+    watcher.addPath(libraryPath);
+
+    TEResult<QSharedPointer<const DeclarationLibrary>> loaded = DeclarationLibrary::load(libraryPath);
+    if (!loaded) return loaded.errors();
+    // Кэш возвращает прежний снимок, если время модификации и размер файла не изменились
+    if (loaded.value() == library) return {};
+    library = loaded.takeValue();
+
+    // Объявления библиотеки используются каждым входным файлом
+    const QStringList paths = files.keys();
+    for (const QString& path : paths)
+        refreshFile(path, true);
+    return {};
+}
+
+QString DirectoryWatcher::outputPath(const QString& inputFile) const
+{
+    return QDir(outputDirectory).filePath(QFileInfo(inputFile).completeBaseName() + ".txt");
+}
+
+qsizetype DirectoryWatcher::fileCount() const
+{
+    return files.size();
+}
+
+void DirectoryWatcher::onFileChanged(const QString& path)
+{
+    if (path == libraryPath) {
+        QList<TEException> errors = reloadLibrary();
+        if (!errors.isEmpty()) emit fileRefreshed(path, RefreshOutcome::Failed, errors);
+        return;
+    }
+    refreshFile(path);
+}
+
+void DirectoryWatcher::onDirectoryChanged(const QString& path)
+{
+    Q_UNUSED(path);
+    refreshDirectory();
+}
+
+TEResult<QByteArray> DirectoryWatcher::explain(const QByteArray& content, const QString& inputFile) const
+{
+    ParseReport report;
+    TEResult<ExpressionDocument> document = ExpressionXmlParser::parseDocumentContent(content, inputFile, ValidationMode::CollectAll, report, library.data());
+    if (!document) return document.errors();
+
+    QList<TEException> errors;
+    QList<TEResult<QString>> explanations = document.value().tryGetExplanationsInRu(errors);
+    QStringList lines;
+    for (const TEResult<QString>& explanation : explanations) {
+        if (explanation) lines.append(explanation.value());
+        else errors += explanation.errors();
+    }
+    if (!errors.isEmpty()) return errors;
+    return lines.join('\n').toUtf8();
+}
+
+void DirectoryWatcher::removeOutput(const QString& output, FileState& state)
+{
+    QFile::remove(output);
+    state.outputHash.clear();
+}
+
+QStringList DirectoryWatcher::inputFiles() const
+{
+    QStringList paths;
+    const QDir directory(inputDirectory);
+    const QStringList names = directory.entryList({"*.xml"}, QDir::Files);
+    for (const QString& name : names) {
+        QString path = directory.absoluteFilePath(name);
+        // Библиотека объявлений может лежать в том же каталоге, но не является входным файлом
+        if (path != libraryPath) paths.append(path);
+    }
+    return paths;
+}
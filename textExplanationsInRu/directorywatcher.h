@@ -0,0 +1,153 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса DirectoryWatcher для наблюдения за каталогом входных файлов.
+ */
+
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include "declarationlibrary.h"
+#include "teexception.h"
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+
+/*!
+ * \brief Результат обновления одного входного файла.
+ */
+enum class RefreshOutcome {
+    Unchanged,          /*!< Содержимое входного файла не изменилось, файл не разбирался */
+    Written,            /*!< Пояснение изменилось и записано в выходной файл */
+    OutputUnchanged,    /*!< Файл разобран заново, но пояснение совпадает с записанным, выходной файл не перезаписан */
+    Failed,             /*!< Входной файл содержит ошибки или пояснение не записано, прежний выходной файл удалён */
+    Removed             /*!< Входной файл удалён, его состояние забыто */
+};
+
+/*!
+ * \brief Класс, поддерживающий пояснения XML-файлов каталога в актуальном состоянии.
+ *
+ * Для каждого входного файла (*.xml) хранится хэш содержимого и хэш записанного пояснения. При изменении
+ * файла он считывается один раз; если хэш содержимого не изменился, файл не разбирается, а если не изменилось
+ * пояснение, выходной файл не перезаписывается. Изменение отдельного файла обрабатывается независимо от
+ * количества файлов в каталоге. Все входные файлы разбираются с общей библиотекой объявлений, поэтому при её
+ * изменении библиотека перечитывается и пояснения всех файлов строятся заново.
+ *
+ * Пояснение файла name.xml записывается в файл name.txt выходного каталога. Выходной каталог не может совпадать
+ * с входным: иначе каждая запись пояснения меняла бы список файлов входного каталога и вызывала его полный просмотр.
+ * Если пояснение файла не удалось построить или записать, прежний выходной файл удаляется, чтобы не выдавать
+ * устаревшее пояснение за актуальное.
+ */
+class DirectoryWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * \brief Имя выходного подкаталога входного каталога, используемого по умолчанию.
+     */
+    static constexpr const char* DefaultOutputDirectory = "explanations";
+
+    /*!
+     * \brief Конструктор класса DirectoryWatcher.
+     * \param[in] inputDirectory Каталог входных XML-файлов.
+     * \param[in] outputDirectory Каталог выходных файлов; пустая строка – подкаталог DefaultOutputDirectory входного каталога.
+     * \param[in] libraryPath Путь к библиотеке объявлений или пустая строка.
+     * \param[in] parent Родительский объект.
+     */
+    explicit DirectoryWatcher(const QString& inputDirectory, const QString& outputDirectory = QString(),
+                              const QString& libraryPath = QString(), QObject* parent = nullptr);
+
+    /*!
+     * \brief Загрузка библиотеки, пояснение всех файлов каталога и начало наблюдения.
+     * \return Ошибки библиотеки объявлений или выходного каталога; если список не пуст, наблюдение не начинается.
+     */
+    QList<TEException> start();
+
+    /*!
+     * \brief Обновление пояснения одного входного файла.
+     * \param[in] inputFile Путь к входному файлу.
+     * \param[in] force Разобрать файл, даже если его содержимое не изменилось.
+     * \return Результат обновления.
+     */
+    RefreshOutcome refreshFile(const QString& inputFile, bool force = false);
+
+    /*!
+     * \brief Обнаружение добавленных и удалённых файлов каталога.
+     */
+    void refreshDirectory();
+
+    /*!
+     * \brief Перечитывание библиотеки объявлений и обновление пояснений всех файлов, которые её используют.
+     * \return Ошибки библиотеки; при ошибках продолжает использоваться прежний снимок библиотеки.
+     */
+    QList<TEException> reloadLibrary();
+
+    /*!
+     * \brief Получение пути к выходному файлу для входного файла.
+     */
+    QString outputPath(const QString& inputFile) const;
+
+    /*!
+     * \brief Получение количества отслеживаемых входных файлов.
+     */
+    qsizetype fileCount() const;
+
+signals:
+    /*!
+     * \brief Сигнал об обновлении входного файла.
+     * \param[in] inputFile Путь к входному файлу.
+     * \param[in] outcome Результат обновления.
+     * \param[in] errors Ошибки входного файла или выходного файла.
+     */
+    void fileRefreshed(const QString& inputFile, RefreshOutcome outcome, const QList<TEException>& errors);
+
+private slots:
+    /*!
+     * \brief Обработка изменения отслеживаемого файла.
+     */
+    void onFileChanged(const QString& path);
+
+    /*!
+     * \brief Обработка изменения списка файлов каталога.
+     */
+    void onDirectoryChanged(const QString& path);
+
+private:
+    /*!
+     * \brief Состояние входного файла.
+     */
+    struct FileState {
+        QByteArray contentHash;     /*!< Хэш содержимого при последнем разборе */
+        QByteArray outputHash;      /*!< Хэш записанного пояснения; пустой, если пояснение не записано */
+    };
+
+    /*!
+     * \brief Получение пояснений документа или ошибок в том же виде, что и в консольной программе.
+     * \param[in] content Содержимое входного файла.
+     * \param[in] inputFile Путь к входному файлу для сообщений об ошибках.
+     * \return Пояснения по одному на строку в кодировке UTF-8 либо список ошибок.
+     */
+    TEResult<QByteArray> explain(const QByteArray& content, const QString& inputFile) const;
+
+    /*!
+     * \brief Удаление выходного файла, пояснение которого больше не соответствует входному файлу.
+     * \param[in] output Путь к выходному файлу.
+     * \param[in,out] state Состояние входного файла; хэш записанного пояснения сбрасывается.
+     */
+    void removeOutput(const QString& output, FileState& state);
+
+    /*!
+     * \brief Получение списка входных файлов каталога.
+     */
+    QStringList inputFiles() const;
+
+    QString inputDirectory;                             /*!< Каталог входных файлов */
+    QString outputDirectory;                            /*!< Каталог выходных файлов */
+    QString libraryPath;                                /*!< Абсолютный путь к библиотеке объявлений или пустая строка */
+    QSharedPointer<const DeclarationLibrary> library;   /*!< Текущий снимок библиотеки объявлений */
+    QHash<QString, FileState> files;                    /*!< Состояние входных файлов по абсолютному пути */
+    QFileSystemWatcher watcher;                         /*!< Наблюдение за каталогом, входными файлами и библиотекой */
+};
+
+#endif // DIRECTORYWATCHER_H
@@ -1,6 +1,69 @@
 #include "expression.h"
+#include "declarationindex.h"
+#include "declarationlibrary.h"
+#include "descriptioncache.h"
 #include "expressionxmlparser.h"
 #include "expressiontranslator.h"
+#include "expressionnormalizer.h"
+#include "infixparser.h"
+#include "inputbudget.h"
+#include "pipelinestats.h"
+#include "textscanner.h"
+#include "tracerecorder.h"
+
+namespace {
+// Объединение объявлений библиотеки с собственными объявлениями выражения
+template <typename T>
+QHash<QString, T> mergeDeclarations(const QHash<QString, T>& shared, const QHash<QString, T>& own)
+{
+    // Без собственных объявлений хэш библиотеки используется совместно
+    if (own.isEmpty()) return shared;
+    QHash<QString, T> merged = shared;
+    merged.insert(own);
+    return merged;
+}
+
+// Отметка объявления в маске использованных объявлений
+void markUsed(QBitArray& usedDeclarations, int index)
+{
+    if (index >= 0) usedDeclarations.setBit(index);
+}
+
+// Сбор узлов поддерева в порядке обратного обхода
+void collectPostOrder(const ExpressionNode* node, QList<const ExpressionNode*>& nodes)
+{
+    if (node == nullptr) return;
+    collectPostOrder(node->getLeftNode(), nodes);
+    collectPostOrder(node->getRightNode(), nodes);
+    if (node->getFunctionArgs() != nullptr)
+        for (const ExpressionNode* argument : *node->getFunctionArgs()) collectPostOrder(argument, nodes);
+    nodes.append(node);
+}
+
+// Содержит ли поддерево инкремент или декремент
+bool containsIncrementOrDecrement(const ExpressionNode* node)
+{
+    if (node == nullptr) return false;
+    if (node->isIncrementOrDecrement()) return true;
+    if (containsIncrementOrDecrement(node->getLeftNode()) || containsIncrementOrDecrement(node->getRightNode())) return true;
+    if (node->getFunctionArgs() != nullptr)
+        for (const ExpressionNode* argument : *node->getFunctionArgs())
+            if (containsIncrementOrDecrement(argument)) return true;
+    return false;
+}
+
+// Отличается ли описание узла в составе выражения от его описания как самостоятельного выражения
+bool dependsOnParent(const ExpressionNode* node, OperationType parentOperType)
+{
+    // Смысл инкремента и декремента добавляется к корню выражения
+    if (containsIncrementOrDecrement(node)) return true;
+    if (node->getNodeType() != EntityType::Operation) return false;
+    // Например, сравнение под отрицанием переводится обратным сравнением
+    NodeRendering inContext = ExpressionNormalizer::rendering(node, parentOperType);
+    NodeRendering standalone = ExpressionNormalizer::rendering(node, OperationType::None);
+    return inContext.rule != standalone.rule || inContext.templateType != standalone.templateType;
+}
+}
 
 void Expression::setExpression(const QString &newExpression)
 {
@@ -12,6 +75,16 @@ const QString* Expression::getExpression() const
     return &expression;
 }
 
+void Expression::setNotation(ExpressionNotation newNotation)
+{
+    notation = newNotation;
+}
+
+ExpressionNotation Expression::getNotation() const
+{
+    return notation;
+}
+
 const QHash<QString, Variable>* Expression::getVariables() const
 {
     return &variables;
@@ -20,6 +93,7 @@ const QHash<QString, Variable>* Expression::getVariables() const
 void Expression::setVariables(const QHash<QString, Variable> &newVariables)
 {
     variables = newVariables;
+    invalidateDeclarationIndex();
 }
 
 const Variable Expression::getVarByName(const QString & name) const
@@ -35,6 +109,7 @@ const QHash<QString, Function>* Expression::getFunctions() const
 void Expression::setFunctions(const QHash<QString, Function> &newFunctions)
 {
     functions = newFunctions;
+    invalidateDeclarationIndex();
 }
 
 const Function Expression::getFuncByName(const QString & name) const
@@ -50,6 +125,7 @@ const QHash<QString, Union>* Expression::getUnions() const
 void Expression::setUnions(const QHash<QString, Union> &newUnions)
 {
     unions = newUnions;
+    invalidateDeclarationIndex();
 }
 
 const Union Expression::getUnionByName(const QString & name) const
@@ -65,6 +141,7 @@ const QHash<QString, Structure>* Expression::getStructures() const
 void Expression::setStructures(const QHash<QString, Structure> &newStructures)
 {
     structures = newStructures;
+    invalidateDeclarationIndex();
 }
 
 const Structure Expression::getStructByName(const QString & name) const
@@ -80,6 +157,7 @@ const QHash<QString, Class>* Expression::getClasses() const
 void Expression::setClasses(const QHash<QString, Class> &newClasses)
 {
     classes = newClasses;
+    invalidateDeclarationIndex();
 }
 
 const Class Expression::getClassByName(const QString & name) const
@@ -95,6 +173,7 @@ const QHash<QString, Enum>* Expression::getEnums() const
 void Expression::setEnums(const QHash<QString, Enum> &newEnums)
 {
     enums = newEnums;
+    invalidateDeclarationIndex();
 }
 
 const Enum Expression::getEnumByName(const QString & name) const
@@ -140,11 +219,100 @@ const CustomTypeWithFields Expression::getCustomTypeByName(const QString &typeNa
 
 Expression Expression::fromFile(const QString &path)
 {
+    TraceRecorder::FileScope traceFile(path);
+    TraceRecorder::Span span("Expression::fromFile");
     Expression expr;
     ExpressionXmlParser::readDataFromXML(path, expr);
     return expr;
 }
 
+TEResult<Expression> Expression::tryFromFile(const QString &path)
+{
+    return tryFromFile(path, nullptr);
+}
+
+TEResult<Expression> Expression::tryFromFile(const QString &path, const DeclarationLibrary* library)
+{
+    TraceRecorder::FileScope traceFile(path);
+    TraceRecorder::Span span("Expression::fromFile");
+    ParseReport report;
+    return ExpressionXmlParser::parseFile(path, ValidationMode::CollectAll, report, library);
+}
+
+void Expression::attachLibrary(const DeclarationLibrary& library)
+{
+    // Нумеруются только собственные объявления; индекс и маска библиотеки построены один раз для снимка
+    QSharedPointer<const DeclarationIndex> index(new DeclarationIndex(library.declarationIndex(), *this));
+    // Общими остаются объявления библиотеки, которые выражение не объявило повторно
+    QBitArray shared = library.sharedDeclarations();
+    shared.resize(index->size());
+    for (int redeclared : index->redeclaredIndices())
+        shared.clearBit(redeclared);
+    if (!sharedNames.isEmpty()) shared |= index->mask(sharedNames);
+
+    const Expression& declarations = library.declarations();
+    variables = mergeDeclarations(*declarations.getVariables(), variables);
+    functions = mergeDeclarations(*declarations.getFunctions(), functions);
+    unions = mergeDeclarations(*declarations.getUnions(), unions);
+    structures = mergeDeclarations(*declarations.getStructures(), structures);
+    classes = mergeDeclarations(*declarations.getClasses(), classes);
+    enums = mergeDeclarations(*declarations.getEnums(), enums);
+
+    declarationIndex = index;
+    sharedDeclarations = shared;
+    sharedDeclarationsValid = true;
+}
+
+void Expression::markDeclarationsShared()
+{
+    sharedDeclarations = QBitArray(getDeclarationIndex().size(), true);
+    sharedDeclarationsValid = true;
+}
+
+QSet<QString> Expression::getSharedNames() const
+{
+    const QList<QString> names = getDeclarationIndex().names(getSharedDeclarations());
+    return QSet<QString>(names.cbegin(), names.cend());
+}
+
+void Expression::setSharedNames(const QSet<QString>& newSharedNames)
+{
+    sharedNames = newSharedNames;
+    sharedDeclarationsValid = false;
+}
+
+const DeclarationIndex& Expression::getDeclarationIndex() const
+{
+    if (declarationIndex.isNull()) declarationIndex.reset(new DeclarationIndex(*this));
+    return *declarationIndex;
+}
+
+const QBitArray& Expression::getSharedDeclarations() const
+{
+    if (!sharedDeclarationsValid) {
+        sharedDeclarations = getDeclarationIndex().mask(sharedNames);
+        sharedDeclarationsValid = true;
+    }
+    return sharedDeclarations;
+}
+
+const QBitArray& Expression::getUsedDeclarations() const
+{
+    return usedDeclarations;
+}
+
+void Expression::invalidateDeclarationIndex()
+{
+    if (!declarationIndex.isNull() && sharedDeclarationsValid) sharedNames = getSharedNames();
+    declarationIndex.reset();
+    sharedDeclarationsValid = false;
+}
+
+void Expression::setDescriptionCache(DescriptionCache* cache)
+{
+    descriptionCache = cache;
+}
+
 QSet<QString> Expression::getCustomDataTypes() const
 {
     QSet<QString> customDataTypes;
@@ -215,11 +383,17 @@ QString Expression::ToQstring()
     return result;
 }
 
-QHash<Case, QString> Expression::toExplanation(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className, OperationType parentOperType) const
+CaseDescription Expression::toExplanation(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className, OperationType parentOperType) const
 {
-    QHash<Case, QString> description = {};
-    QHash<Case, QString> descOfRightNode = {};
-    QHash<Case, QString> descOfLeftNode = {};
+    // Описание поддерева, не изменившегося с предыдущего перевода, берётся из кэша
+    if(descriptionCache != nullptr) {
+        const CaseDescription* cached = descriptionCache->find(node, className, parentOperType);
+        if(cached != nullptr) return *cached;
+    }
+
+    CaseDescription description;
+    CaseDescription descOfRightNode;
+    CaseDescription descOfLeftNode;
 
     if(node->getNodeType() == EntityType::Operation) {
         description = handleOperationNode(node, intermediateDescription, className, parentOperType, descOfLeftNode, descOfRightNode);
@@ -241,47 +415,42 @@ QHash<Case, QString> Expression::toExplanation(const ExpressionNode *node, QHash
     }
 
     if(!intermediateDescription.isEmpty() && parentOperType == OperationType::None) {
-        description = ExpressionTranslator::getExplanation(intermediateDescription, QList<QHash<Case, QString>>{{}, description});
+        description = ExpressionTranslator::getExplanation(CaseDescription(intermediateDescription), QList<CaseDescription>{CaseDescription(), description});
     }
 
+    if(descriptionCache != nullptr) descriptionCache->insert(node, className, parentOperType, description);
+    if(recordedDescriptions != nullptr) recordedDescriptions->insert(node, RecordedDescription{className, parentOperType, description});
     return description;
 }
 
-QHash<Case, QString> Expression::handleOperationNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className, OperationType parentOperType, QHash<Case, QString> &descOfLeftNode, QHash<Case, QString> &descOfRightNode) const
+CaseDescription Expression::handleOperationNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className, OperationType parentOperType, CaseDescription &descOfLeftNode, CaseDescription &descOfRightNode) const
 {
-    QHash<Case, QString> description = {};
+    CaseDescription description;
+    NodeRendering rendering = ExpressionNormalizer::rendering(node, parentOperType);
 
-    if(node->isReducibleUnarySelfInverse())
+    if(rendering.rule == RenderRule::SkipSelfInverse)
     {
         description = toExplanation(node->getLeftNode()->getLeftNode(), intermediateDescription, "", node->getOperType());
     }
-    else if(node->getOperType() == OperationType::Not && node->getLeftNode()->isComparisonOperation())
+    else if(rendering.rule == RenderRule::InvertedComparison)
     {
         description = toExplanation(node->getLeftNode(), intermediateDescription, "", node->getOperType());
     }
-    else if(node->isIncrementOrDecrement())
+    else if(rendering.rule == RenderRule::IncrementDecrement)
     {
-        QHash<Case, QString> secondValueDescription;
+        CaseDescription secondValueDescription;
         for (Case c : {Case::Nominative, Case::Genitive, Case::Dative, Case::Accusative, Case::Instrumental, Case::Prepositional}) {
-            secondValueDescription[c] = "{2 (в)}";
+            secondValueDescription.insert(c, "{2 (в)}");
         }
         description = toExplanation(node->getLeftNode(), intermediateDescription, "", node->getOperType());
 
         if(intermediateDescription.isEmpty())
         {
-            if (parentOperType != OperationType::None){
-                intermediateDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(node->getOperType()), QList<QHash<Case, QString>>{description, secondValueDescription});
-            }
-            else {
-                if(node->getOperType() == OperationType::PostfixIncrement || node->getOperType() == OperationType::PrefixIncrement)
-                    intermediateDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::SingleIncrement), QList<QHash<Case, QString>>{description});
-                else if(node->getOperType() == OperationType::PostfixDecrement || node->getOperType() == OperationType::PrefixDecrement)
-                    intermediateDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::SingleDecrement), QList<QHash<Case, QString>>{description});
-            }
+            intermediateDescription = ExpressionTranslator::getExplanation(rendering.templateType, QList<CaseDescription>{description, secondValueDescription}).toHash();
         }
         else {
-            QHash<Case, QString> nestedDescription = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(node->getOperType()), QList<QHash<Case, QString>>{description, secondValueDescription});
-            intermediateDescription = ExpressionTranslator::getExplanation(intermediateDescription, QList<QHash<Case, QString>>{{}, nestedDescription});
+            CaseDescription nestedDescription = ExpressionTranslator::getExplanation(node->getOperType(), QList<CaseDescription>{description, secondValueDescription});
+            intermediateDescription = ExpressionTranslator::getExplanation(CaseDescription(intermediateDescription), QList<CaseDescription>{CaseDescription(), nestedDescription}).toHash();
         }
     }
     else
@@ -295,61 +464,33 @@ QHash<Case, QString> Expression::handleOperationNode(const ExpressionNode *node,
         else if(node->getRightNode() != nullptr)
             descOfRightNode = toExplanation(node->getRightNode(), intermediateDescription, "", node->getOperType());
 
-        if(description.isEmpty()){
-            if(parentOperType == node->getOperType()){
-                if(node->getOperType() == OperationType::Subtraction && node->getLeftNode()->getOperType() != OperationType::Subtraction && node->getRightNode()->getOperType() != OperationType::Subtraction)
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::SubtractionSequence), QList<QHash<Case, QString>>{descOfLeftNode, descOfRightNode});
-                else if(node->getOperType() == OperationType::Division && node->getLeftNode()->getOperType() != OperationType::Division && node->getRightNode()->getOperType() != OperationType::Division)
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::DivisionSequence), QList<QHash<Case, QString>>{descOfLeftNode, descOfRightNode});
-                else {
-                    for (Case c : {Case::Nominative, Case::Genitive, Case::Dative,
-                                   Case::Accusative, Case::Instrumental, Case::Prepositional}) {
-                        description[c] = descOfLeftNode[c] + ", " + descOfRightNode[c];
-                    }
-                }
-            }
-            else if((node->getOperType() == OperationType::Subtraction && node->getLeftNode()->getOperType() == OperationType::Subtraction) ||
-                     (node->getOperType() == OperationType::Division && node->getLeftNode()->getOperType() == OperationType::Division))
-            {
-                for (Case c : {Case::Nominative, Case::Genitive, Case::Dative,
-                               Case::Accusative, Case::Instrumental, Case::Prepositional}) {
-                    description[c] = descOfLeftNode[c] + ", " + descOfRightNode[c];
-                }
-            }
-            else if(node->getOperType() == OperationType::Dereference && node->getLeftNode()->getNodeType() == EntityType::Operation)
-            {
-                description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::PointerIndexAccess), QList<QHash<Case, QString>>{descOfLeftNode, descOfRightNode});
-            }
-            else if(node->isComparisonOperation() && parentOperType == OperationType::Not)
-            {
-                description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(InverseComparisonOperationsMap.value(node->getOperType())), QList<QHash<Case, QString>>{descOfLeftNode, descOfRightNode});
-            }
-            else
-            {
-                if(node->getLeftNode()->getDataType() == "string" && node->getLeftNode()->getDataType() == node->getRightNode()->getDataType() && node->getOperType() == OperationType::Addition)
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(OperationType::Concatenation), QList<QHash<Case, QString>>{descOfLeftNode, descOfRightNode});
-                else
-                    description = ExpressionTranslator::getExplanation(ExpressionTranslator::Templates.value(node->getOperType()), QList<QHash<Case, QString>>{descOfLeftNode, descOfRightNode});
+        if(rendering.rule == RenderRule::Enumeration) {
+            for (Case c : {Case::Nominative, Case::Genitive, Case::Dative,
+                           Case::Accusative, Case::Instrumental, Case::Prepositional}) {
+                description.insert(c, descOfLeftNode.value(c) + ", " + descOfRightNode.value(c));
             }
         }
+        else {
+            description = ExpressionTranslator::getExplanation(rendering.templateType, QList<CaseDescription>{descOfLeftNode, descOfRightNode});
+        }
     }
 
     return description;
 }
 
-QHash<Case, QString> Expression::handleConstNode(const ExpressionNode *node) const
+CaseDescription Expression::handleConstNode(const ExpressionNode *node) const
 {
-    QHash<Case, QString> description;
+    CaseDescription description;
     for (Case c : {Case::Nominative, Case::Genitive, Case::Dative,
                    Case::Accusative, Case::Instrumental, Case::Prepositional}) {
-        description[c] = node->getValue();
+        description.insert(c, node->getValue());
     }
     return description;
 }
 
-QHash<Case, QString> Expression::handleFunctionNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className) const
+CaseDescription Expression::handleFunctionNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className) const
 {
-    QHash<Case, QString> description;
+    CaseDescription description;
     if(!className.isEmpty()){
         description = this->getFunctionByNameFromCustomData(node->getValue(), className).description;
     }
@@ -362,9 +503,10 @@ QHash<Case, QString> Expression::handleFunctionNode(const ExpressionNode *node,
     return description;
 }
 
-QHash<Case, QString> Expression::handleVariableNode(const ExpressionNode *node, const QString& className, OperationType parentOperType) const
+CaseDescription Expression::handleVariableNode(const ExpressionNode *node, const QString& className, OperationType parentOperType) const
 {
-    QHash<Case, QString> description;
+    // Описание из объявления передаётся без извлечения строк: шаблон родительской операции запросит только нужные падежи
+    CaseDescription description;
     if(className != ""){
         if(parentOperType == OperationType::FieldAccess){
             description = this->getVariableByNameFromCustomData(node->getValue(), className).description;
@@ -379,49 +521,134 @@ QHash<Case, QString> Expression::handleVariableNode(const ExpressionNode *node,
     return description;
 }
 
+QList<SubtreeExplanation> Expression::getSubtreeExplanations(const ExpressionNode* root, Case grammaticalCase) const
+{
+    TraceRecorder::Span span("Expression::getSubtreeExplanations");
+    PipelineStats::ScopedTimer timer(PipelineStage::ToExplanation);
+
+    // Один перевод дерева записывает описание каждого узла в составе выражения
+    QHash<const ExpressionNode*, RecordedDescription> recorded;
+    Expression renderer(*this);
+    renderer.descriptionCache = nullptr;
+    renderer.recordedDescriptions = &recorded;
+    QHash<Case, QString> intermediateDescription = {};
+    renderer.toExplanation(root, intermediateDescription);
+
+    // При самостоятельном переводе поддерева описания его дочерних узлов берутся из записанных
+    DescriptionCache cache;
+    for (auto it = recorded.cbegin(); it != recorded.cend(); ++it)
+        cache.insert(it.key(), it.value().className, it.value().parentOperType, it.value().description);
+    renderer.recordedDescriptions = nullptr;
+    renderer.descriptionCache = &cache;
+
+    QList<const ExpressionNode*> nodes;
+    collectPostOrder(root, nodes);
+    QList<SubtreeExplanation> explanations;
+    explanations.reserve(nodes.size());
+    for (const ExpressionNode* node : std::as_const(nodes)) {
+        auto it = recorded.constFind(node);
+        CaseDescription description;
+        // Узлы, сокращённые нормализацией, не переводятся в составе выражения
+        if (it != recorded.constEnd() && (node == root || !dependsOnParent(node, it.value().parentOperType))) {
+            description = it.value().description;
+        }
+        else {
+            QHash<Case, QString> nodeIntermediateDescription = {};
+            description = renderer.toExplanation(node, nodeIntermediateDescription);
+        }
+        explanations.append(SubtreeExplanation{node->getSpan(), removeConsecutiveDuplicates(description.value(grammaticalCase))});
+    }
+    return explanations;
+}
+
+TEResult<QList<SubtreeExplanation>> Expression::tryGetSubtreeExplanations(Case grammaticalCase)
+{
+    // Пустое выражение не имеет поддеревьев
+    if (this->getExpression()->isEmpty()) return QList<SubtreeExplanation>();
+    TEResult<ExpressionNode*> tree = this->tryExpressionToNodes();
+    if (!tree) return tree.errors();
+    QList<SubtreeExplanation> explanations;
+    try {
+        explanations = getSubtreeExplanations(tree.value(), grammaticalCase);
+    }
+    // Ошибки шаблонов описаний возникают при некорректных плейсхолдерах и превышении бюджета
+    catch (const TEException& error) {
+        deleteTree(tree.value());
+        return error;
+    }
+    // Пояснения ссылаются на строку выражения, а не на узлы, поэтому дерево больше не нужно
+    deleteTree(tree.value());
+    return explanations;
+}
+
 QString Expression::getExplanationInRu()
+{
+    TEResult<QString> explanation = tryGetExplanationInRu();
+    if(!explanation) throw explanation.errors().first();
+    return explanation.takeValue();
+}
+
+TEResult<QString> Expression::tryGetExplanationInRu()
 {
     //...Считать что объяснение пустое
     QString explanation = "";
-    if(!this->getExpression()->isEmpty() || !this->getAllNames().isEmpty()){
+    if(!this->getExpression()->isEmpty() || getDeclarationIndex().size() > 0){
         // Преобразовать выражение в дерево
-        const ExpressionNode* explanationTree = this->expressionToNodes();
+        TEResult<ExpressionNode*> explanationTree = this->tryExpressionToNodes();
+        if(!explanationTree) return explanationTree.errors();
         // Получить объяснение выражения
         QHash<Case, QString> intermediateDescription = {};
-        explanation = this->toExplanation(explanationTree, intermediateDescription).value(Case::Nominative);
+        try {
+            PipelineStats::ScopedTimer timer(PipelineStage::ToExplanation);
+            TraceRecorder::Span span("Expression::toExplanation");
+            explanation = this->toExplanation(explanationTree.value(), intermediateDescription).value(Case::Nominative);
+        }
+        // Ошибки шаблонов описаний возникают при некорректных плейсхолдерах и превышении бюджета
+        catch (const TEException& error) {
+            deleteTree(explanationTree.value());
+            return error;
+        }
+        // Дерево нужно только для перевода
+        deleteTree(explanationTree.value());
     }
     // Удалить дубликаты слов в полученном выражении
-    explanation = removeConsecutiveDuplicates(explanation);
-    return explanation;
+    PipelineStats::ScopedTimer timer(PipelineStage::RemoveDuplicates);
+    return removeConsecutiveDuplicates(explanation);
 }
 
 QStringList Expression::splitExpression(const QString &str) {
     QStringList tokens;
     QString currentToken;
     bool insideQuotes = false;
+    qsizetype i = 0;
+
+    while (i < str.size()) {
+        // Если находимся внутри кавычек, добавляем в текущий токен всё до закрывающей кавычки включительно
+        if (insideQuotes) {
+            qsizetype closingQuote = str.indexOf('"', i);
+            qsizetype end = closingQuote == -1 ? str.size() : closingQuote + 1;
+            currentToken += QStringView(str).sliced(i, end - i);
+            insideQuotes = closingQuote == -1;
+            i = end;
+            continue;
+        }
+        // Иначе добавляем в текущий токен всё до ближайшего пробела или кавычки
+        qsizetype boundary = TextScanner::findSpaceOrQuote(str, i);
+        if (boundary == -1) boundary = str.size();
+        currentToken += QStringView(str).sliced(i, boundary - i);
+        if (boundary == str.size()) break;
 
-    for (int i = 0; i < str.size(); ++i) {
-        QChar currentChar = str[i];
         // Если обнаружили кавычку, переключаем режим обработки
-        if (currentChar == '"') {
-            insideQuotes = !insideQuotes;
-            currentToken += currentChar;
-        }
-        // Если находимся внутри кавычек, добавляем символ в текущий токен
-        else if (insideQuotes) {
-            currentToken += currentChar;
+        if (str[boundary] == '"') {
+            insideQuotes = true;
+            currentToken += '"';
         }
         // Если пробел и не внутри кавычек, завершаем текущий токен
-        else if (currentChar.isSpace()) {
-            if (!currentToken.isEmpty()) {
-                tokens.append(currentToken);
-                currentToken.clear();
-            }
-        }
-        // Иначе добавляем символ в текущий токен
-        else {
-            currentToken += currentChar;
+        else if (!currentToken.isEmpty()) {
+            tokens.append(currentToken);
+            currentToken.clear();
         }
+        i = boundary + 1;
     }
     // Добавляем последний токен, если он не пустой
     if (!currentToken.isEmpty()) {
@@ -430,6 +657,20 @@ QStringList Expression::splitExpression(const QString &str) {
     return tokens;
 }
 
+QList<ExpressionToken> Expression::tokenizeExpression(const QString &str) {
+    QList<ExpressionToken> tokens;
+    const QStringList parts = splitExpression(str);
+    tokens.reserve(parts.size());
+    // Каждая лексема – непрерывный участок выражения, следующий за предыдущей лексемой через пробелы
+    qsizetype offset = 0;
+    for (const QString& part : parts) {
+        offset = str.indexOf(part, offset);
+        tokens.append(ExpressionToken{part, offset});
+        offset += part.size();
+    }
+    return tokens;
+}
+
 QString Expression::sanitizeDataType(const QString& dataType) {
     if (dataType.contains('[')) {
         return dataType.left(dataType.indexOf('['));
@@ -440,52 +681,121 @@ QString Expression::sanitizeDataType(const QString& dataType) {
 }
 
 ExpressionNode* Expression::expressionToNodes() {
-    QSet<QString> customDataTypes = getCustomDataTypes();
+    QList<TEException> errors;
+    ExpressionNode* root = expressionToNodes(errors);
+    if (root == nullptr) throw errors.first();
+    return root;
+}
+
+TEResult<ExpressionNode*> Expression::tryExpressionToNodes() {
+    QList<TEException> errors;
+    ExpressionNode* root = expressionToNodes(errors);
+    if (root == nullptr) return errors;
+    return root;
+}
+
+ExpressionNode* Expression::expressionToNodes(QList<TEException>& errors) {
+    PipelineStats::ScopedTimer timer(PipelineStage::ExpressionToNodes);
+    TraceRecorder::Span span("Expression::expressionToNodes");
+    // Построить дерево в соответствии с формой записи выражения
+    if (notation == ExpressionNotation::Infix) return InfixParser(*this).parse(errors);
+
     // Разделяем выражение на лексемы
-    QStringList tokens = splitExpression(*this->getExpression());
+    QList<ExpressionToken> tokens;
+    {
+        PipelineStats::ScopedTimer splitTimer(PipelineStage::SplitExpression);
+        tokens = tokenizeExpression(*this->getExpression());
+    }
+    PipelineStats::add(PipelineCounter::Tokens, tokens.size());
     //...Считаем, что стек узлов пустой
     QStack<ExpressionNode*> nodeStack;
-    //...Считаем что количество операций = 0
-    int operationCounter = 0;
-    //...Считаем что ни один элемент не использован
-    QSet<QString> usedElements;
+    //...Считаем что количество операций = 0 и ни один элемент не использован
+    TreeBuildContext context;
+    context.customDataTypes = getCustomDataTypes();
+    context.usedDeclarations = QBitArray(getDeclarationIndex().size());
 
     // Иначе если выражение было пустым, то дерева нет
     if(expression.isEmpty()) return new ExpressionNode();
 
-    QStringList::const_iterator i;
-    // Для каждой лексемы и пока количество операций не превышает 20
-    for (i = tokens.constBegin(); i != tokens.constEnd() && operationCounter <= 20; i++) {
-        // Получить тип лексемы
-        EntityType nodeType = getEntityTypeByStr(*i);
+    // Узлы, созданные лексемами; удаляются, если дерево не построено
+    QList<ExpressionNode*> createdNodes;
+    createdNodes.reserve(tokens.size());
 
-        if (nodeType == EntityType::Operation) {
-            processOperation(*i, nodeStack, operationCounter, tokens, i);
-        }
-        else if (nodeType == EntityType::Const) {
-            processConst(*i, nodeStack);
-        }
-        else if (nodeType == EntityType::Variable) {
-            processVariable(*i, nodeStack, usedElements, customDataTypes, tokens, i);
-        }
-        else if (nodeType == EntityType::Enum) {
-            processEnum(*i, nodeStack, usedElements);
-        }
-        else if (nodeType == EntityType::Function) {
-            processFunction(*i, nodeStack, customDataTypes, usedElements, tokens, i);
-        }
-        else if (nodeType == EntityType::Undefined || nodeType == EntityType::CustomTypeWithFields) {
-            throw TEException(ErrorType::UndefinedId, QList<QString>{*i});
+    // Для каждой лексемы и пока количество операций не превышает 20
+    for (qsizetype i = 0; i < tokens.size() && context.operationCounter <= 20; i++) {
+        QString nextToken = i + 1 < tokens.size() ? tokens[i + 1].text : QString();
+        // Прекратить построение дерева при первой ошибке
+        if (!processToken(tokens[i].text, nextToken, nodeStack, context, errors)) {
+            deleteNodes(createdNodes);
+            return nullptr;
         }
+        createdNodes.append(nodeStack.top());
+        // Участок узла объединяет лексему узла и участки его операндов
+        nodeStack.top()->setSpan({tokens[i].position, tokens[i].position + tokens[i].text.size()});
+    }
+
+    if (!finalizeNodeProcessing(nodeStack, *this->getExpression(), context.operationCounter, context.usedDeclarations, errors)) {
+        deleteNodes(createdNodes);
+        return nullptr;
     }
 
-    finalizeNodeProcessing(nodeStack, *this->getExpression(), operationCounter, usedElements);
+    // Один раз определить способ перевода каждого узла
+    ExpressionNode* root = nodeStack.pop();
+    ExpressionNormalizer::normalize(root);
+    return root;
+}
+
+bool Expression::processToken(const QString& token, const QString& nextToken, QStack<ExpressionNode*>& nodeStack, TreeBuildContext& context, QList<TEException>& errors) {
+    // Каждая обработанная лексема добавляет один узел, поэтому бюджет расходуется до создания узла
+    if (!InputBudget::charge(BudgetResource::Nodes, 1, errors) ||
+        !InputBudget::charge(BudgetResource::Bytes, sizeof(ExpressionNode), errors)) return false;
+
+    // Получить тип лексемы
+    EntityType nodeType = getEntityTypeByStr(token, errors);
+    // Если лексема содержит недопустимые символы
+    if (!errors.isEmpty()) return false;
+
+    bool processed = true;
+    if (nodeType == EntityType::Operation) {
+        processed = processOperation(token, nodeStack, context.operationCounter, nextToken, errors);
+    }
+    else if (nodeType == EntityType::Const) {
+        processConst(token, nodeStack);
+    }
+    else if (nodeType == EntityType::Variable) {
+        processed = processVariable(token, nodeStack, context.usedDeclarations, context.customDataTypes, nextToken, errors);
+    }
+    else if (nodeType == EntityType::Enum) {
+        processEnum(token, nodeStack, context.usedDeclarations);
+    }
+    else if (nodeType == EntityType::Function) {
+        processed = processFunction(token, nodeStack, context.customDataTypes, context.usedDeclarations, nextToken, errors);
+    }
+    else if (nodeType == EntityType::Undefined || nodeType == EntityType::CustomTypeWithFields) {
+        errors.append(TEException(ErrorType::UndefinedId, QList<QString>{token}));
+        processed = false;
+    }
+    return processed;
+}
 
+void Expression::deleteNodes(const QList<ExpressionNode*>& nodes) const {
+    for (ExpressionNode* node : nodes) {
+        if (descriptionCache != nullptr) descriptionCache->forget(node);
+        delete node->getFunctionArgs();
+        delete node;
+    }
+}
 
-    return nodeStack.pop();
+void Expression::deleteTree(ExpressionNode* node) const {
+    if (node == nullptr) return;
+    deleteTree(node->getLeftNode());
+    deleteTree(node->getRightNode());
+    if (node->getFunctionArgs() != nullptr)
+        for (ExpressionNode* argument : *node->getFunctionArgs()) deleteTree(argument);
+    deleteNodes({node});
 }
 
-void Expression::processOperation(const QString& token, QStack<ExpressionNode*>& nodeStack, int& operationCounter, const QStringList& tokens, QStringList::const_iterator i) {
+bool Expression::processOperation(const QString& token, QStack<ExpressionNode*>& nodeStack, int& operationCounter, const QString& nextToken, QList<TEException>& errors) {
     // Увеличить счетчик операций
     operationCounter++;
     OperationType operType = getOperationTypeByStr(token);
@@ -494,32 +804,35 @@ void Expression::processOperation(const QString& token, QStack<ExpressionNode*>&
 
     // Если операция – инкремент или декремент и следующая операция такого же типа
     if (!nodeStack.empty() &&
-        (operType == OperationType::PostfixIncrement || operType == OperationType::PrefixIncrement ||
-         operType == OperationType::PostfixDecrement || operType == OperationType::PrefixDecrement) &&
-        (i + 1) != tokens.end())
+        operationTraits(operType).isIncrementOrDecrement &&
+        !nextToken.isEmpty())
     {
-        OperationType newOperType = getOperationTypeByStr(*(i + 1));
-        if ((newOperType == OperationType::PostfixIncrement || newOperType == OperationType::PrefixIncrement ||
-             newOperType == OperationType::PostfixDecrement || newOperType == OperationType::PrefixDecrement))
-            throw TEException(ErrorType::MultipleIncrementDecrement, QList<QString>{nodeStack.top()->getValue()});
+        OperationType newOperType = getOperationTypeByStr(nextToken);
+        if (operationTraits(newOperType).isIncrementOrDecrement) {
+            errors.append(TEException(ErrorType::MultipleIncrementDecrement, QList<QString>{nodeStack.top()->getValue()}));
+            return false;
+        }
     }
 
-    if (nodeStack.size() >= 2 && OperationMap.value(token).arity == OperationArity::Binary) {
+    if (nodeStack.size() >= 2 && operationTraits(operType).arity == OperationArity::Binary) {
         right = nodeStack.pop();
         left = nodeStack.pop();
     }
     else if ((nodeStack.size() == 1 && operType == OperationType::Subtraction) ||
-             (nodeStack.size() >= 1 && OperationMap.value(token).arity == OperationArity::Unary)) {
+             (nodeStack.size() >= 1 && operationTraits(operType).arity == OperationArity::Unary)) {
         left = nodeStack.pop();
         if (operType == OperationType::Subtraction) operType = OperationType::UnaryMinus;
     }
     else if (nodeStack.size() < 2) {
-        throw TEException(ErrorType::MissingOperand, QList<QString>{token});
+        errors.append(TEException(ErrorType::MissingOperand, QList<QString>{token}));
+        return false;
     }
     else if (nodeStack.size() > 2) {
-        throw TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.pop()->getValue()});
+        errors.append(TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.pop()->getValue()}));
+        return false;
     }
     nodeStack.push(new ExpressionNode(EntityType::Operation, token, left, right, "", operType));
+    return true;
 }
 
 void Expression::processConst(const QString& token, QStack<ExpressionNode*>& nodeStack) {
@@ -529,36 +842,39 @@ void Expression::processConst(const QString& token, QStack<ExpressionNode*>& nod
         nodeStack.push(new ExpressionNode(EntityType::Const, token, nullptr, nullptr));
 }
 
-void Expression::processVariable(const QString& token, QStack<ExpressionNode*>& nodeStack, QSet<QString>& usedElements, const QSet<QString>& customDataTypes, const QStringList& tokens, QStringList::const_iterator i) {
+bool Expression::processVariable(const QString& token, QStack<ExpressionNode*>& nodeStack, QBitArray& usedDeclarations, const QSet<QString>& customDataTypes, const QString& nextToken, QList<TEException>& errors) {
     QString className;
     QString dataType = getVariables()->value(token).type;
     // если тип данных не определен
     if (dataType == "") {
-        dataType = handleVariableTypeInference(token, nodeStack, tokens, i, className);
+        dataType = handleVariableTypeInference(token, nodeStack, nextToken, className);
     }
     if (dataType != "") {
         dataType = sanitizeDataType(dataType);
-        if (customDataTypes.contains(dataType) || DataTypes.contains(dataType)) {
-            if (customDataTypes.contains(dataType)) usedElements.insert(dataType);
+        if (customDataTypes.contains(dataType) || isStandardDataType(dataType)) {
+            const DeclarationIndex& index = getDeclarationIndex();
+            if (customDataTypes.contains(dataType)) markUsed(usedDeclarations, index.indexOf(dataType));
             nodeStack.push(new ExpressionNode(EntityType::Variable, token, nullptr, nullptr, dataType));
             if (!className.isEmpty()) {
-                usedElements.insert(className + "." + token);
-                usedElements.insert(className);
+                markUsed(usedDeclarations, index.memberIndexOf(className, token));
+                markUsed(usedDeclarations, index.indexOf(className));
             }
-            else usedElements.insert(token);
+            else markUsed(usedDeclarations, index.indexOf(token));
+            return true;
         }
-        else if (dataType == "void") throw TEException(ErrorType::VariableWithVoidType, QList<QString>{token});
-        else throw TEException(ErrorType::UnidentifedType, QList<QString>{dataType});
+        else if (dataType == "void") errors.append(TEException(ErrorType::VariableWithVoidType, QList<QString>{token}));
+        else errors.append(TEException(ErrorType::UnidentifedType, QList<QString>{dataType}));
     }
-    else throw TEException(ErrorType::UndefinedId, QList<QString>{token});
+    else errors.append(TEException(ErrorType::UndefinedId, QList<QString>{token}));
+    return false;
 }
 
-void Expression::processEnum(const QString& token, QStack<ExpressionNode*>& nodeStack, QSet<QString>& usedElements) {
+void Expression::processEnum(const QString& token, QStack<ExpressionNode*>& nodeStack, QBitArray& usedDeclarations) {
     nodeStack.push(new ExpressionNode(EntityType::Enum, token, nullptr, nullptr, ""));
-    usedElements.insert(token);
+    markUsed(usedDeclarations, getDeclarationIndex().indexOf(token));
 }
 
-void Expression::processFunction(const QString& token, QStack<ExpressionNode*>& nodeStack, const QSet<QString>& customDataTypes, QSet<QString>& usedElements, const QStringList& tokens, QStringList::const_iterator i) {
+bool Expression::processFunction(const QString& token, QStack<ExpressionNode*>& nodeStack, const QSet<QString>& customDataTypes, QBitArray& usedDeclarations, const QString& nextToken, QList<TEException>& errors) {
     int argCountStart = token.indexOf('(');
     int argCountEnd = token.indexOf(')');
     int argCount = token.mid(argCountStart + 1, argCountEnd - argCountStart - 1).toInt();
@@ -569,125 +885,100 @@ void Expression::processFunction(const QString& token, QStack<ExpressionNode*>&
     if (funcDataType == "") {
         if (!nodeStack.empty()) {
             const ExpressionNode* rightSibling = nodeStack.top();
-            if (i + 1 != tokens.end()) {
-                QString nextToken = *(i + 1);
-                if (nextToken == "." || nextToken == "->") {
-                    funcDataType = sanitizeDataType(getFunctionByNameFromCustomData(funcName, rightSibling->getDataType()).type);
-                    className = sanitizeDataType(rightSibling->getDataType());
-                }
+            if (nextToken == "." || nextToken == "->") {
+                funcDataType = sanitizeDataType(getFunctionByNameFromCustomData(funcName, rightSibling->getDataType()).type);
+                className = sanitizeDataType(rightSibling->getDataType());
             }
         }
     }
 
     if (funcDataType != "") {
         funcDataType = sanitizeDataType(funcDataType);
-        if (argCount != getFunctions()->value(funcName).paramsCount)
-            throw TEException(ErrorType::ParamsCountFunctionMissmatch, QList<QString>{token});
+        if (argCount != getFunctions()->value(funcName).paramsCount) {
+            errors.append(TEException(ErrorType::ParamsCountFunctionMissmatch, QList<QString>{token}));
+            return false;
+        }
+        if (nodeStack.size() < argCount) {
+            errors.append(TEException(ErrorType::MissingOperand, QList<QString>{token}));
+            return false;
+        }
         QList<ExpressionNode*>* functionArgs = new QList<ExpressionNode*>();
-        if (nodeStack.size() < argCount)
-            throw TEException(ErrorType::MissingOperand, QList<QString>{token});
-        else {
-            for (int j = 0; j < argCount; j++) {
-                functionArgs->prepend(nodeStack.pop());
-            }
+        for (int j = 0; j < argCount; j++) {
+            functionArgs->prepend(nodeStack.pop());
         }
-        if (customDataTypes.contains(funcDataType) || DataTypes.contains(funcDataType) || funcDataType == "void") {
-            if (customDataTypes.contains(funcDataType)) usedElements.insert(funcDataType);
+        if (customDataTypes.contains(funcDataType) || isStandardDataType(funcDataType) || funcDataType == "void") {
+            const DeclarationIndex& index = getDeclarationIndex();
+            if (customDataTypes.contains(funcDataType)) markUsed(usedDeclarations, index.indexOf(funcDataType));
             ExpressionNode* functionNode = new ExpressionNode(EntityType::Function, funcName, nullptr, nullptr, funcDataType, OperationType::None, functionArgs);
             nodeStack.push(functionNode);
             if (!className.isEmpty()) {
-                usedElements.insert(className + "." + funcName);
-                usedElements.insert(className);
+                markUsed(usedDeclarations, index.memberIndexOf(className, funcName));
+                markUsed(usedDeclarations, index.indexOf(className));
             }
-            else usedElements.insert(funcName);
+            else markUsed(usedDeclarations, index.indexOf(funcName));
+            return true;
         }
-        else throw TEException(ErrorType::UnidentifedType, QList<QString>{funcDataType});
+        else errors.append(TEException(ErrorType::UnidentifedType, QList<QString>{funcDataType}));
     }
-    else throw TEException(ErrorType::UndefinedId, QList<QString>{funcName});
+    else errors.append(TEException(ErrorType::UndefinedId, QList<QString>{funcName}));
+    return false;
 }
 
-QString Expression::handleVariableTypeInference(const QString& token, QStack<ExpressionNode*>& nodeStack, const QStringList& tokens, QStringList::const_iterator i, QString& className) {
+QString Expression::handleVariableTypeInference(const QString& token, QStack<ExpressionNode*>& nodeStack, const QString& nextToken, QString& className) {
     QString dataType;
     if (!nodeStack.empty()) {
         const ExpressionNode* rightSibling = nodeStack.top();
-        if (i + 1 != tokens.end()) {
-            QString nextToken = *(i + 1);
-            if (nextToken == "." || nextToken == "->") {
-                className = sanitizeDataType(rightSibling->getDataType());
-                dataType = getVariableByNameFromCustomData(token, rightSibling->getDataType()).type;
-            }
-            else if (nextToken == "::") {
-                dataType = isEnumValue(token, rightSibling->getValue()) ? rightSibling->getValue() : "";
-                className = sanitizeDataType(dataType);
-            }
+        if (nextToken == "." || nextToken == "->") {
+            className = sanitizeDataType(rightSibling->getDataType());
+            dataType = getVariableByNameFromCustomData(token, rightSibling->getDataType()).type;
+        }
+        else if (nextToken == "::") {
+            dataType = isEnumValue(token, rightSibling->getValue()) ? rightSibling->getValue() : "";
+            className = sanitizeDataType(dataType);
         }
     }
     return dataType;
 }
 
-void Expression::finalizeNodeProcessing(QStack<ExpressionNode*>& nodeStack, const QString& expression, int operationCounter, const QSet<QString>& usedElements) {
-    if (nodeStack.size() > 1) throw TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.pop()->getValue()});
-    else if (expression.isEmpty()) return; // Возвращаем nullptr или new ExpressionNode() - по твоей логике
+bool Expression::finalizeNodeProcessing(QStack<ExpressionNode*>& nodeStack, const QString& expression, int operationCounter, const QBitArray& usedDeclarations, QList<TEException>& errors) {
+    // Запомнить использованные объявления для проверки общих объявлений по всему документу
+    this->usedDeclarations = usedDeclarations;
+    if (nodeStack.size() > 1) {
+        errors.append(TEException(ErrorType::MissingOperations, QList<QString>{nodeStack.pop()->getValue()}));
+        return false;
+    }
+    else if (expression.isEmpty()) return true; // Возвращаем nullptr или new ExpressionNode() - по твоей логике
 
-    else if (operationCounter > 20) throw TEException(ErrorType::InputDataExprSizeExceeded, QList<QString>{QString::number(operationCounter)});
+    else if (operationCounter > 20) {
+        errors.append(TEException(ErrorType::InputDataExprSizeExceeded, QList<QString>{QString::number(operationCounter)}));
+        return false;
+    }
 
-    QSet<QString> allElements = this->getAllNames();
-    QSet<QString> unusedElements = allElements - usedElements;
+    // Общие объявления используются многими выражениями, поэтому их неиспользованные имена допустимы
+    QBitArray unusedDeclarations = ~(usedDeclarations | getSharedDeclarations());
 
-    if (!unusedElements.isEmpty())
-        throw TEException(ErrorType::NeverUsedElement, QList<QString>{unusedElements.values().join(", ")});
-}
-
-void Expression::getCustomTypeFields(QSet<QString>& names, const CustomTypeWithFields& customType) {
-    names.insert(customType.name);
-    for (auto i = customType.variables.cbegin(); i != customType.variables.cend(); i++) {
-        names.insert(customType.name + "." + i.value().name);
-    }
-    for (auto i = customType.functions.cbegin(); i != customType.functions.cend(); i++) {
-        names.insert(customType.name + "." + i.value().name);
+    if (unusedDeclarations.count(true) > 0) {
+        errors.append(TEException(ErrorType::NeverUsedElement, QList<QString>{getDeclarationIndex().names(unusedDeclarations).join(", ")}));
+        return false;
     }
+    return true;
 }
 
-
-QSet<QString> Expression::getAllNames() {
-    QSet<QString> names;
-    // переменные
-    for (auto i = variables.cbegin(); i != variables.cend(); i++) {
-        names.insert(i.value().name);
-    }
-    // функции
-    for (auto i = functions.cbegin(); i != functions.cend(); i++) {
-        names.insert(i.value().name);
-    }
-    for (auto i = unions.cbegin(); i != unions.cend(); i++) {
-        getCustomTypeFields(names, i.value());
-    }
-    for (auto i = structures.cbegin(); i != structures.cend(); i++) {
-        getCustomTypeFields(names, i.value());
-    }
-    for (auto i = classes.cbegin(); i != classes.cend(); i++) {
-        getCustomTypeFields(names, i.value());
-    }
-    // перечисления
-    for (auto i = enums.cbegin(); i != enums.cend(); i++) {
-        names.insert(i.value().name);
-        for (auto enumI = i.value().values.cbegin(); enumI != i.value().values.cend(); enumI++) {
-            names.insert(i.value().name + "." + enumI.key());
-        }
-    }
-    return names;
+QSet<QString> Expression::getAllNames() const {
+    return getDeclarationIndex().names();
 }
 
-EntityType Expression::getEntityTypeByStr(const QString &str)
+EntityType Expression::getEntityTypeByStr(const QString &str, QList<TEException>& errors)
 {
     //...Считаем, что тип неопределен
     EntityType type = EntityType::Undefined;
     if(isConst(str)) type = EntityType::Const;
-    else if(isFunction(str)) type = EntityType::Function;
+    else if(isFunction(str, errors)) type = EntityType::Function;
+    else if(!errors.isEmpty()) return type;
     else if(isCustomTypeWithFields(str)) type = EntityType::CustomTypeWithFields;
     else if(isEnum(str)) type = EntityType::Enum;
     else if(getOperationTypeByStr(str) != OperationType::None) type = EntityType::Operation;
-    else if(isVariable(str)) type = EntityType::Variable;
+    else if(isVariable(str, errors)) type = EntityType::Variable;
     return type;
 }
 
@@ -704,17 +995,25 @@ bool Expression::isConst(const QString &str)
     return ok;
 }
 
-bool Expression::isVariable(const QString &str)
+bool Expression::isVariable(const QString &str, QList<TEException>& errors)
 {
     bool ok = false;
-    if(isIdentifier(str)){
+    if(isIdentifier(str, errors)){
         ok = true;
     }
-    else throw TEException(ErrorType::InvalidSymbol, QList<QString>{str});
+    else if(errors.isEmpty()) errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{str}));
     return ok;
 }
 
 bool Expression::isFunction(const QString &str)
+{
+    QList<TEException> errors;
+    bool ok = isFunction(str, errors);
+    if (!errors.isEmpty()) throw errors.first();
+    return ok;
+}
+
+bool Expression::isFunction(const QString &str, QList<TEException>& errors)
 {
     bool ok = false;
     if(str.contains('(') && str.endsWith(')')){
@@ -722,7 +1021,7 @@ bool Expression::isFunction(const QString &str)
         QString contentInParentheses = str.mid(str.indexOf('(') + 1, str.length() - str.indexOf('(') - 2).trimmed();
         bool isNumber = false;
         contentInParentheses.toDouble(&isNumber);
-        if(isIdentifier(identifier) && isNumber) ok = true;
+        if(isIdentifier(identifier, errors) && isNumber) ok = true;
     }
     return ok;
 }
@@ -746,19 +1045,28 @@ bool Expression::isEnum(const QString &str)
 }
 
 bool Expression::isIdentifier(const QString &str)
+{
+    QList<TEException> errors;
+    bool isInd = isIdentifier(str, errors);
+    if (!errors.isEmpty()) throw errors.first();
+    return isInd;
+}
+
+bool Expression::isIdentifier(const QString &str, QList<TEException>& errors)
 {
     bool isInd = true;
     // Первый символ - латинская буква или _
     if (str.isEmpty()) isInd = false;
     else{
         if (!(isLatinLetter(str[0]) || str[0] == '_')) {
-            throw TEException(ErrorType::InvalidSymbol, QList<QString>{str[0]});
+            errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{str[0]}));
+            return false;
         }
         // Остальные символы - латинские буквы, цифры или _
-        for(int i = 0; i < str.length() && isInd == true; i++) {
-            if (!(isLatinLetter(str[i]) || str[i].isDigit() || str[i] == '_')) {
-                throw TEException(ErrorType::InvalidSymbol, QList<QString>{str[i]});
-            }
+        qsizetype invalid = TextScanner::findNonIdentifier(str, 1);
+        if (invalid != -1) {
+            errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{str[invalid]}));
+            return false;
         }
     }
     return isInd;
@@ -772,38 +1080,47 @@ bool Expression::isLatinLetter(const QChar c)
 
 OperationType Expression::getOperationTypeByStr(const QString &str)
 {
-    OperationType type = OperationType::None;
-    if(OperationMap.contains(str)){
-        type = OperationMap.value(str).type;
-    }
-    return type;
+    std::optional<OperatorInfo> info = findOperator(str);
+    return info ? info->type : OperationType::None;
 }
 
-QString Expression::removeConsecutiveDuplicates(const QString &str)
+QString Expression::removeConsecutiveDuplicates(QStringView str)
 {
-    // Разделить строку на отдельные слова
-    QStringList words = str.split(' ', Qt::SkipEmptyParts);
-    QStringList copyOfWords = str.toLower().split(' ', Qt::SkipEmptyParts);
-
-
-    QStringList seenWords;
-    QStringList result;
-
-    // Для каждого слова в строке
-    for (int i = 0; i < words.count(); i++) {
-        // Если предыдущее слово в строке не совпадает с текущим
-        if (!seenWords.endsWith(copyOfWords[i]) || (copyOfWords[i].endsWith(","))) {
-            // Запоминаем его и добавляем в результирующую строку
-            seenWords.append(copyOfWords[i]);
-            result.append(words[i]);
+    QString result;
+    result.reserve(str.size());
+
+    // Последнее добавленное в результат слово
+    QStringView previousWord;
+    bool hasPreviousWord = false;
+    qsizetype wordStart = -1;
+
+    // Для каждого символа строки, включая позицию за её концом
+    for (qsizetype i = 0; i <= str.size(); i++) {
+        // Если слово продолжается
+        if (i < str.size() && str[i] != u' ') {
+            if (wordStart == -1) wordStart = i;
+            continue;
+        }
+        // Иначе, если закончилось непустое слово
+        if (wordStart != -1) {
+            QStringView word = str.sliced(wordStart, i - wordStart);
+            // Если предыдущее слово в строке не совпадает с текущим без учёта регистра
+            if (!hasPreviousWord || word.endsWith(u',') || word.compare(previousWord, Qt::CaseInsensitive) != 0) {
+                // Запоминаем его и добавляем в результирующую строку
+                if (!result.isEmpty()) result += u' ';
+                result += word;
+                previousWord = word;
+                hasPreviousWord = true;
+            }
+            wordStart = -1;
         }
     }
-    return result.join(" ");
+    return result;
 }
 
-QList<QHash<Case, QString>> Expression::argsToDescr(const QList<ExpressionNode *> *functionArgs, QHash<Case, QString>& intermediateDescription, QString customDataType, OperationType parentOperType) const
+QList<CaseDescription> Expression::argsToDescr(const QList<ExpressionNode *> *functionArgs, QHash<Case, QString>& intermediateDescription, QString customDataType, OperationType parentOperType) const
 {
-    QList<QHash<Case, QString>> descriptions;
+    QList<CaseDescription> descriptions;
     QList<ExpressionNode *>::const_iterator i;
     for(i = functionArgs->constBegin(); i != functionArgs->constEnd(); i++){
         descriptions.append(toExplanation(*i, intermediateDescription, customDataType, parentOperType));
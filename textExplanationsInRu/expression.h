@@ -8,10 +8,40 @@
 #include "expressionnode.h"
 #include "teexception.h"
 
+#include <QBitArray>
 #include <QHash>
+#include <QSharedPointer>
 #include <QString>
 #include <QStack>
 
+class DeclarationIndex;
+class DeclarationLibrary;
+class DescriptionCache;
+
+/*!
+ * \brief Перечисление форм записи выражения.
+ */
+enum class ExpressionNotation {
+    Postfix,    /*!< Обратная польская запись, лексемы разделены пробелами */
+    Infix       /*!< Обычная инфиксная запись выражения C++ */
+};
+
+/*!
+ * \brief Структура, описывающая лексему обратной польской записи и её положение в строке выражения.
+ */
+struct ExpressionToken {
+    QString text;               /*!< Текст лексемы */
+    qsizetype position = 0;     /*!< Позиция первого символа лексемы */
+};
+
+/*!
+ * \brief Структура, описывающая пояснение одного поддерева выражения.
+ */
+struct SubtreeExplanation {
+    ExpressionSpan span;            /*!< Участок строки выражения, занимаемый поддеревом */
+    QString explanation;            /*!< Пояснение поддерева в запрошенном падеже */
+};
+
 /*!
  * \brief Класс, представляющий выражение и связанные с ним переменные, функции и пользовательские типы.
  */
@@ -53,6 +83,78 @@ public:
      */
     static Expression fromFile(const QString& path);
 
+    /*!
+     * \brief Создание объекта Expression из XML-файла без использования исключений.
+     * \param[in] path Путь к файлу.
+     * \return Объект Expression либо список ошибок входного файла.
+     */
+    static TEResult<Expression> tryFromFile(const QString& path);
+
+    /*!
+     * \brief Создание объекта Expression из XML-файла, объявления которого дополняются библиотекой объявлений.
+     * \param[in] path Путь к файлу.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \return Объект Expression либо список ошибок входного файла.
+     */
+    static TEResult<Expression> tryFromFile(const QString& path, const DeclarationLibrary* library);
+
+    /*!
+     * \brief Подключение библиотеки объявлений.
+     *
+     * Объявления библиотеки объединяются с собственными объявлениями выражения; при совпадении имён
+     * используется собственное объявление. Если собственных объявлений какого-либо вида нет, хэш библиотеки
+     * используется совместно без копирования. Неиспользованные объявления библиотеки не считаются ошибкой.
+     * Индекс объявлений продолжает индекс библиотеки: нумеруются только собственные объявления выражения.
+     * \param[in] library Библиотека объявлений.
+     */
+    void attachLibrary(const DeclarationLibrary& library);
+
+    /*!
+     * \brief Пометка всех объявлений выражения как общих для нескольких выражений документа.
+     *
+     * Неиспользованные общие объявления не считаются ошибкой выражения; их использование проверяется
+     * по всем выражениям документа.
+     */
+    void markDeclarationsShared();
+
+    /*!
+     * \brief Получение имён, объявления которых являются общими (из библиотеки или для нескольких выражений).
+     *
+     * Имена составляются по маске общих объявлений при каждом вызове.
+     */
+    QSet<QString> getSharedNames() const;
+
+    /*!
+     * \brief Установка имён общих объявлений, которые выражение может не использовать.
+     */
+    void setSharedNames(const QSet<QString>& newSharedNames);
+
+    /*!
+     * \brief Получение индекса объявлений выражения.
+     *
+     * Индекс строится при первом обращении после изменения объявлений и используется совместно копиями
+     * выражения с теми же объявлениями.
+     */
+    const DeclarationIndex& getDeclarationIndex() const;
+
+    /*!
+     * \brief Получение маски общих объявлений в нумерации индекса объявлений.
+     */
+    const QBitArray& getSharedDeclarations() const;
+
+    /*!
+     * \brief Получение маски объявлений, использованных при последнем построении дерева выражения.
+     */
+    const QBitArray& getUsedDeclarations() const;
+
+    /*!
+     * \brief Подключение кэша описаний поддеревьев, используемого при переводе.
+     *
+     * Кэш не принадлежит выражению и должен существовать, пока выражение переводится.
+     * \param[in] cache Кэш описаний или nullptr, чтобы переводить без кэша.
+     */
+    void setDescriptionCache(DescriptionCache* cache);
+
     /*!
      * \brief Получает множество пользовательских типов данных, определённых в выражении.
      *
@@ -72,9 +174,31 @@ public:
      * \param[in|out] intermediateDescription Промежуточное описание.
      * \param[in] className Имя класса (если есть).
      * \param[in] parentOperType Тип родительской операции.
-     * \return Хэш падежей и строк описания.
+     * \return Описание выражения в падежах.
+     */
+    CaseDescription toExplanation(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className = "", OperationType parentOperType = OperationType::None) const;
+
+    /*!
+     * \brief Получение пояснений всех поддеревьев дерева за один обход.
+     *
+     * Каждый узел переводится один раз, а описания дочерних узлов используются при переводе родителя, поэтому
+     * пояснения всех поддеревьев стоят столько же, сколько пояснение всего выражения. Пояснение поддерева –
+     * его описание как самостоятельного выражения. Обычно оно совпадает с описанием в составе всего выражения;
+     * заново переводятся только поддеревья, описание которых зависит от родителя (инкремент и декремент, смысл
+     * которых добавляется к корню, сравнение под отрицанием), и узлы, сокращённые нормализацией.
+     * \param[in] root Корневой узел дерева.
+     * \param[in] grammaticalCase Падеж пояснений.
+     * \return Пояснения поддеревьев в порядке обратного обхода (дочерние узлы раньше родительских).
+     * \throws TEException Ошибка шаблона описания.
+     */
+    QList<SubtreeExplanation> getSubtreeExplanations(const ExpressionNode* root, Case grammaticalCase = Case::Nominative) const;
+
+    /*!
+     * \brief Построение дерева выражения и получение пояснений всех его поддеревьев без использования исключений.
+     * \param[in] grammaticalCase Падеж пояснений.
+     * \return Пояснения поддеревьев, участки которых указывают на строку выражения, либо ошибки построения дерева или перевода.
      */
-    QHash<Case, QString> toExplanation(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString& className = "", OperationType parentOperType = OperationType::None) const;
+    TEResult<QList<SubtreeExplanation>> tryGetSubtreeExplanations(Case grammaticalCase = Case::Nominative);
 
     /*!
      * \brief Генерация пояснения выражения на русском языке.
@@ -82,24 +206,45 @@ public:
      */
     QString getExplanationInRu();
 
+    /*!
+     * \brief Генерация пояснения выражения на русском языке без использования исключений.
+     * \return Строка пояснения либо ошибка построения дерева или перевода.
+     */
+    TEResult<QString> tryGetExplanationInRu();
+
     /*!
      * \brief Преобразование выражения в дерево ExpressionNode.
      * \return Указатель на корневой узел дерева.
+     * \throws TEException Первая обнаруженная ошибка выражения.
      */
     ExpressionNode* expressionToNodes();
 
+    /*!
+     * \brief Преобразование выражения в дерево ExpressionNode без использования исключений.
+     * \return Указатель на корневой узел дерева либо ошибка выражения.
+     */
+    TEResult<ExpressionNode*> tryExpressionToNodes();
+
+    /*!
+     * \brief Преобразование выражения в дерево ExpressionNode с остановкой на первой ошибке.
+     * \param[out] errors Список ошибок.
+     * \return Указатель на корневой узел дерева или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* expressionToNodes(QList<TEException>& errors);
+
     /*!
      * \brief Получение всех имён, используемых в выражении.
      * \return Множество имён.
      */
-    QSet<QString> getAllNames();
+    QSet<QString> getAllNames() const;
 
     /*!
      * \brief Определение типа сущности по строке.
      * \param[in] str Строка.
+     * \param[out] errors Список ошибок (недопустимые символы в идентификаторе).
      * \return Тип сущности.
      */
-    EntityType getEntityTypeByStr(const QString& str);
+    EntityType getEntityTypeByStr(const QString& str, QList<TEException>& errors);
 
     /*!
      * \brief Проверка, является ли идентификатор константой.
@@ -111,9 +256,10 @@ public:
     /*!
      * \brief Проверка, является ли идентификатор переменной.
      * \param[in] str Идентификатор.
+     * \param[out] errors Список ошибок.
      * \return true, если это переменная.
      */
-    bool isVariable(const QString& str);
+    bool isVariable(const QString& str, QList<TEException>& errors);
 
     /*!
      * \brief Проверка, является ли идентификатор функцией.
@@ -122,6 +268,14 @@ public:
      */
     static bool isFunction(const QString& str);
 
+    /*!
+     * \brief Проверка, является ли идентификатор функцией, без использования исключений.
+     * \param[in] str Идентификатор.
+     * \param[out] errors Список ошибок.
+     * \return true, если это функция.
+     */
+    static bool isFunction(const QString& str, QList<TEException>& errors);
+
     /*!
      * \brief Проверка, является ли тип пользовательским типом с полями.
      */
@@ -137,6 +291,14 @@ public:
      */
     static bool isIdentifier(const QString& str);
 
+    /*!
+     * \brief Проверка, является ли строка допустимым идентификатором, без использования исключений.
+     * \param[in] str Строка.
+     * \param[out] errors Список ошибок.
+     * \return true, если строка является идентификатором.
+     */
+    static bool isIdentifier(const QString& str, QList<TEException>& errors);
+
     /*!
      * \brief Проверка, является ли символ латинской буквой.
      */
@@ -145,7 +307,7 @@ public:
     /*!
      * \brief Преобразование аргументов функции в падежные описания.
      */
-    QList<QHash<Case, QString>> argsToDescr(const QList<ExpressionNode *> *functionArgs, QHash<Case, QString> &intermediateDescription, QString customDataType = "", OperationType parentOperType = OperationType::None) const;
+    QList<CaseDescription> argsToDescr(const QList<ExpressionNode *> *functionArgs, QHash<Case, QString> &intermediateDescription, QString customDataType = "", OperationType parentOperType = OperationType::None) const;
 
     /*!
      * \brief Получение типа операции по строке.
@@ -154,8 +316,13 @@ public:
 
     /*!
      * \brief Удаление идущих подряд дубликатов.
+     *
+     * Выполняется за один проход по строке без промежуточных списков слов;
+     * слова сравниваются без учёта регистра без создания копии строки в нижнем регистре.
+     * \param[in] str Исходная строка.
+     * \return Строка без идущих подряд повторяющихся слов.
      */
-    static QString removeConsecutiveDuplicates(const QString &str);
+    static QString removeConsecutiveDuplicates(QStringView str);
 
     /*!
      * \brief Установка нового выражения.
@@ -167,6 +334,16 @@ public:
      */
     const QString* getExpression() const;
 
+    /*!
+     * \brief Установка формы записи выражения.
+     */
+    void setNotation(ExpressionNotation newNotation);
+
+    /*!
+     * \brief Получение формы записи выражения.
+     */
+    ExpressionNotation getNotation() const;
+
     /*!
      * \brief Получение списка переменных.
      */
@@ -277,13 +454,6 @@ public:
      */
     const CustomTypeWithFields getCustomTypeByName(const QString &typeName) const;
 
-    /*!
-     * \brief Получение всех полей пользовательского типа.
-     * \param[out] names Список, куда  добавляются имена полей.
-     * \param[in] customType Пользовательский тип.
-     */
-    void getCustomTypeFields(QSet<QString> &names, const CustomTypeWithFields &customType);
-
     /*!
      * \brief Разделение выражения на составляющие.
      * \param[in] str Выражение.
@@ -291,6 +461,15 @@ public:
      */
     static QStringList splitExpression(const QString &str);
 
+    /*!
+     * \brief Разделение выражения на лексемы с их позициями.
+     *
+     * Лексемы совпадают с результатом splitExpression.
+     * \param[in] str Выражение.
+     * \return Список лексем с позициями в строке выражения.
+     */
+    static QList<ExpressionToken> tokenizeExpression(const QString &str);
+
     /*!
      * \brief Преобразует строковое представление типа данных в стандартизированный формат.
      * \param[in] dataType Строковое представление типа данных.
@@ -298,15 +477,48 @@ public:
      */
     QString sanitizeDataType(const QString &dataType);
 
+    /*!
+     * \brief Состояние построения дерева выражения.
+     */
+    struct TreeBuildContext {
+        QSet<QString> customDataTypes;  /*!< Набор пользовательских типов данных */
+        QBitArray usedDeclarations;     /*!< Маска используемых объявлений в нумерации индекса объявлений */
+        int operationCounter = 0;       /*!< Счётчик операций в выражении */
+    };
+
+    /*!
+     * \brief Обрабатывает лексему записи выражения и добавляет соответствующий узел в стек.
+     * \param[in] token Лексема в обратной польской записи.
+     * \param[in] nextToken Следующая лексема (пустая строка, если лексема последняя).
+     * \param[in,out] nodeStack Стек узлов выражения.
+     * \param[in,out] context Состояние построения дерева.
+     * \param[out] errors Список ошибок.
+     * \return true, если узел добавлен в стек.
+     */
+    bool processToken(const QString &token, const QString &nextToken, QStack<ExpressionNode *> &nodeStack, TreeBuildContext &context, QList<TEException> &errors);
+
+    /*!
+     * \brief Удаляет узлы вместе со списками аргументов; дочерние узлы не удаляются.
+     * \param[in] nodes Узлы, созданные построителем дерева.
+     */
+    void deleteNodes(const QList<ExpressionNode *> &nodes) const;
+
+    /*!
+     * \brief Удаляет все узлы дерева.
+     * \param[in] node Корневой узел дерева или nullptr.
+     */
+    void deleteTree(ExpressionNode *node) const;
+
     /*!
      * \brief Обрабатывает операцию и добавляет соответствующий узел в стек.
      * \param[in] token Токен, представляющий операцию.
      * \param[in,out] nodeStack Стек узлов выражения.
      * \param[in,out] operationCounter Счётчик операций в выражении.
-     * \param[in] tokens Полный список токенов выражения.
-     * \param[in] i Итератор текущей позиции в списке токенов.
+     * \param[in] nextToken Следующая лексема (пустая строка, если лексема последняя).
+     * \param[out] errors Список ошибок.
+     * \return true, если узел добавлен в стек.
      */
-    void processOperation(const QString &token, QStack<ExpressionNode *> &nodeStack, int &operationCounter, const QStringList &tokens, QStringList::const_iterator i);
+    bool processOperation(const QString &token, QStack<ExpressionNode *> &nodeStack, int &operationCounter, const QString &nextToken, QList<TEException> &errors);
 
     /*!
      * \brief Обрабатывает константу и добавляет соответствующий узел в стек.
@@ -319,76 +531,79 @@ public:
      * \brief Обрабатывает переменную и добавляет соответствующий узел в стек.
      * \param[in] token Токен, представляющий переменную.
      * \param[in,out] nodeStack Стек узлов выражения.
-     * \param[in,out] usedElements Набор используемых переменных.
+     * \param[in,out] usedDeclarations Маска используемых объявлений.
      * \param[in] customDataTypes Набор пользовательских типов данных.
-     * \param[in] tokens Полный список токенов выражения.
-     * \param[in] i Итератор текущей позиции в списке токенов.
+     * \param[in] nextToken Следующая лексема (пустая строка, если лексема последняя).
+     * \param[out] errors Список ошибок.
+     * \return true, если узел добавлен в стек.
      */
-    void processVariable(const QString &token, QStack<ExpressionNode *> &nodeStack, QSet<QString> &usedElements, const QSet<QString> &customDataTypes, const QStringList &tokens, QStringList::const_iterator i);
+    bool processVariable(const QString &token, QStack<ExpressionNode *> &nodeStack, QBitArray &usedDeclarations, const QSet<QString> &customDataTypes, const QString &nextToken, QList<TEException> &errors);
 
     /*!
      * \brief Обрабатывает перечисление (enum) и добавляет соответствующий узел в стек.
      * \param[in] token Токен, представляющий элемент перечисления.
      * \param[in,out] nodeStack Стек узлов выражения.
-     * \param[in,out] usedElements Набор используемых элементов перечисления.
+     * \param[in,out] usedDeclarations Маска используемых объявлений.
      */
-    void processEnum(const QString &token, QStack<ExpressionNode *> &nodeStack, QSet<QString> &usedElements);
+    void processEnum(const QString &token, QStack<ExpressionNode *> &nodeStack, QBitArray &usedDeclarations);
 
     /*!
      * \brief Обрабатывает функцию и добавляет соответствующий узел в стек.
      * \param[in] token Токен, представляющий функцию.
      * \param[in,out] nodeStack Стек узлов выражения.
      * \param[in] customDataTypes Набор пользовательских типов данных.
-     * \param[in,out] usedElements Набор используемых элементов.
-     * \param[in] tokens Полный список токенов выражения.
-     * \param[in] i Итератор текущей позиции в списке токенов.
+     * \param[in,out] usedDeclarations Маска используемых объявлений.
+     * \param[in] nextToken Следующая лексема (пустая строка, если лексема последняя).
+     * \param[out] errors Список ошибок.
+     * \return true, если узел добавлен в стек.
      */
-    void processFunction(const QString &token, QStack<ExpressionNode *> &nodeStack, const QSet<QString> &customDataTypes, QSet<QString> &usedElements, const QStringList &tokens, QStringList::const_iterator i);
+    bool processFunction(const QString &token, QStack<ExpressionNode *> &nodeStack, const QSet<QString> &customDataTypes, QBitArray &usedDeclarations, const QString &nextToken, QList<TEException> &errors);
 
     /*!
      * \brief Определяет тип переменной на основе контекста.
      * \param[in] token Токен, представляющий переменную.
      * \param[in,out] nodeStack Стек узлов выражения.
-     * \param[in] tokens Полный список токенов выражения.
-     * \param[in] i Итератор текущей позиции в списке токенов.
+     * \param[in] nextToken Следующая лексема (пустая строка, если лексема последняя).
      * \param[out] className Название класса, к которому принадлежит переменная.
      * \return Тип переменной.
      */
-    QString handleVariableTypeInference(const QString &token, QStack<ExpressionNode *> &nodeStack, const QStringList &tokens, QStringList::const_iterator i, QString &className);
+    QString handleVariableTypeInference(const QString &token, QStack<ExpressionNode *> &nodeStack, const QString &nextToken, QString &className);
 
     /*!
      * \brief Завершает обработку узлов и формирует результирующее выражение.
      * \param[in,out] nodeStack Стек узлов выражения.
      * \param[in] expression Исходное строковое выражение.
      * \param[in] operationCounter Счётчик операций в выражении.
-     * \param[in] usedElements Набор используемых элементов.
+     * \param[in] usedDeclarations Маска используемых объявлений.
+     * \param[out] errors Список ошибок.
+     * \return true, если дерево построено корректно.
      */
-    void finalizeNodeProcessing(QStack<ExpressionNode *> &nodeStack, const QString &expression, int operationCounter, const QSet<QString> &usedElements);
+    bool finalizeNodeProcessing(QStack<ExpressionNode *> &nodeStack, const QString &expression, int operationCounter, const QBitArray &usedDeclarations, QList<TEException> &errors);
 
     /*!
      * \brief Обрабатывает узел типа переменной.
      * \param[in] node Узел выражения, представляющий переменную.
      * \param[in] className Название класса, если переменная принадлежит классу.
      * \param[in] parentOperType Тип родительской операции.
-     * \return Описание узла в формате QHash<Case, QString>.
+     * \return Описание переменной из объявления; строки падежей извлекаются при обращении.
      */
-    QHash<Case, QString> handleVariableNode(const ExpressionNode *node, const QString &className, OperationType parentOperType) const;
+    CaseDescription handleVariableNode(const ExpressionNode *node, const QString &className, OperationType parentOperType) const;
 
     /*!
      * \brief Обрабатывает узел типа функции.
      * \param[in] node Узел выражения, представляющий функцию.
      * \param[in,out] intermediateDescription Промежуточное описание функции.
      * \param[in] className Название класса, если функция принадлежит классу.
-     * \return Описание узла в формате QHash<Case, QString>.
+     * \return Описание узла в падежах.
      */
-    QHash<Case, QString> handleFunctionNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString &className) const;
+    CaseDescription handleFunctionNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString &className) const;
 
     /*!
      * \brief Обрабатывает узел типа константы.
      * \param[in] node Узел выражения, представляющий константу.
-     * \return Описание узла в формате QHash<Case, QString>.
+     * \return Описание узла в падежах.
      */
-    QHash<Case, QString> handleConstNode(const ExpressionNode *node) const;
+    CaseDescription handleConstNode(const ExpressionNode *node) const;
 
     /*!
      * \brief Обрабатывает узел типа операции.
@@ -398,10 +613,19 @@ public:
      * \param[in] parentOperType Тип родительской операции.
      * \param[in,out] descOfLeftNode Описание левого поддерева.
      * \param[in,out] descOfRightNode Описание правого поддерева.
-     * \return Описание узла в формате QHash<Case, QString>.
+     * \return Описание узла в падежах.
      */
-    QHash<Case, QString> handleOperationNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString &className, OperationType parentOperType, QHash<Case, QString> &descOfLeftNode, QHash<Case, QString> &descOfRightNode) const;
+    CaseDescription handleOperationNode(const ExpressionNode *node, QHash<Case, QString> &intermediateDescription, const QString &className, OperationType parentOperType, CaseDescription &descOfLeftNode, CaseDescription &descOfRightNode) const;
 private:
+    /*!
+     * \brief Описание узла, построенное при переводе дерева, и условия, с которыми оно построено.
+     */
+    struct RecordedDescription {
+        QString className;                  /*!< Имя класса, с которым переводился узел */
+        OperationType parentOperType;       /*!< Тип родительской операции */
+        CaseDescription description;        /*!< Описание узла */
+    };
+
     QString expression;                          /*!< Строка выражения */
     QHash<QString, Variable> variables;          /*!< Список переменных */
     QHash<QString, Function> functions;          /*!< Список функций */
@@ -409,6 +633,21 @@ private:
     QHash<QString, Structure> structures;        /*!< Список структур */
     QHash<QString, Class> classes;               /*!< Список классов */
     QHash<QString, Enum> enums;                  /*!< Список перечислений */
+    ExpressionNotation notation = ExpressionNotation::Postfix; /*!< Форма записи выражения */
+    QSet<QString> sharedNames;                   /*!< Имена общих объявлений, по которым строится маска после изменения объявлений */
+    QBitArray usedDeclarations;                  /*!< Объявления, использованные при последнем построении дерева */
+    mutable QSharedPointer<const DeclarationIndex> declarationIndex;    /*!< Индекс объявлений; строится при первом обращении */
+    mutable QBitArray sharedDeclarations;        /*!< Маска общих объявлений; вычисляется при первом обращении */
+    mutable bool sharedDeclarationsValid = false;   /*!< Соответствует ли маска общих объявлений индексу объявлений */
+    DescriptionCache* descriptionCache = nullptr;   /*!< Кэш описаний поддеревьев или nullptr */
+    QHash<const ExpressionNode*, RecordedDescription>* recordedDescriptions = nullptr;  /*!< Описания переведённых узлов или nullptr */
+
+    /*!
+     * \brief Сброс индекса объявлений и маски общих объявлений после изменения объявлений.
+     *
+     * Имена общих объявлений сохраняются, чтобы маска была построена заново для нового индекса.
+     */
+    void invalidateDeclarationIndex();
 };
 
 #endif // EXPRESSION_H
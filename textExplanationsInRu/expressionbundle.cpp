@@ -0,0 +1,403 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса ExpressionBundle.
+ */
+
+#include "expressionbundle.h"
+#include "pipelinestats.h"
+#include "tracerecorder.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace {
+// Сигнатура в начале каждого пакета
+constexpr char BundleMagic[4] = {'T', 'E', 'X', 'B'};
+
+// Версия QDataStream, которой записываются данные пакета
+constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_0;
+
+// Размер хэша исходного файла в заголовке (SHA-1)
+constexpr qsizetype DigestSize = 20;
+
+// Контрольная сумма FNV-1a (64 бита)
+quint64 checksum(QByteArrayView data)
+{
+    quint64 hash = 14695981039346656037ULL;
+    for (char c : data) {
+        hash ^= uchar(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Таблица текстов описаний: падеж записывается как участок одной строки, одинаковые тексты хранятся один раз
+struct TextTable {
+    QString text;                           // Тексты описаний подряд
+    QHash<QString, quint32> offsets;        // Начала уже записанных текстов при сохранении
+};
+
+// Описание во всех заданных падежах в порядке перечисления Case
+void writeCases(QDataStream& out, TextTable& table, const CaseDescription& cases)
+{
+    quint32 count = 0;
+    for (int c = 0; c < CaseCount; ++c)
+        if (cases.contains(static_cast<Case>(c))) ++count;
+
+    out << count;
+    for (int c = 0; c < CaseCount; ++c) {
+        if (!cases.contains(static_cast<Case>(c))) continue;
+        QString text = cases.value(static_cast<Case>(c));
+        auto offset = table.offsets.constFind(text);
+        if (offset == table.offsets.cend()) {
+            offset = table.offsets.insert(text, quint32(table.text.size()));
+            table.text += text;
+        }
+        out << qint32(c) << offset.value() << quint32(text.size());
+    }
+}
+
+// Падежи ссылаются на таблицу текстов без копирования строк
+CaseDescription readCases(QDataStream& in, TextTable& table)
+{
+    CaseDescription cases;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint32 c = 0;
+        quint32 offset = 0;
+        quint32 length = 0;
+        in >> c >> offset >> length;
+        if (c < 0 || c >= CaseCount || quint64(offset) + length > quint64(table.text.size()))
+            in.setStatus(QDataStream::ReadCorruptData);
+        else cases.insertSpan(static_cast<Case>(c), table.text, offset, length);
+    }
+    return cases;
+}
+
+// Хэш объявлений в порядке имён
+template <typename T, typename WriteItem>
+void writeHash(QDataStream& out, TextTable& table, const QHash<QString, T>& hash, WriteItem writeItem)
+{
+    QList<QString> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    out << quint32(keys.size());
+    for (const QString& key : std::as_const(keys)) {
+        out << key;
+        writeItem(out, table, hash.value(key));
+    }
+}
+
+template <typename T, typename ReadItem>
+QHash<QString, T> readHash(QDataStream& in, TextTable& table, ReadItem readItem)
+{
+    QHash<QString, T> hash;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        in >> key;
+        hash.insert(key, readItem(in, table));
+    }
+    return hash;
+}
+
+void writeVariable(QDataStream& out, TextTable& table, const Variable& variable)
+{
+    out << variable.name << variable.type;
+    writeCases(out, table, variable.description);
+}
+
+Variable readVariable(QDataStream& in, TextTable& table)
+{
+    QString name, type;
+    in >> name >> type;
+    return Variable(name, type, readCases(in, table));
+}
+
+void writeFunction(QDataStream& out, TextTable& table, const Function& function)
+{
+    out << function.name << function.type << qint32(function.paramsCount);
+    writeCases(out, table, function.description);
+}
+
+Function readFunction(QDataStream& in, TextTable& table)
+{
+    QString name, type;
+    qint32 paramsCount = 0;
+    in >> name >> type >> paramsCount;
+    return Function(name, type, paramsCount, readCases(in, table));
+}
+
+void writeCustomType(QDataStream& out, TextTable& table, const CustomTypeWithFields& customType)
+{
+    out << customType.name;
+    writeHash(out, table, customType.variables, writeVariable);
+    writeHash(out, table, customType.functions, writeFunction);
+}
+
+template <typename T>
+T readCustomType(QDataStream& in, TextTable& table)
+{
+    QString name;
+    in >> name;
+    QHash<QString, Variable> variables = readHash<Variable>(in, table, readVariable);
+    QHash<QString, Function> functions = readHash<Function>(in, table, readFunction);
+    return T(name, variables, functions);
+}
+
+void writeEnum(QDataStream& out, TextTable& table, const Enum& _enum)
+{
+    out << _enum.name;
+    writeHash(out, table, _enum.values, writeCases);
+}
+
+Enum readEnum(QDataStream& in, TextTable& table)
+{
+    QString name;
+    in >> name;
+    return Enum(name, readHash<CaseDescription>(in, table, readCases));
+}
+
+// Хэш содержимого файла либо пустой массив, если файл недоступен
+QByteArray fileDigest(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    return QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1);
+}
+
+// Хэш в заголовке; отсутствующий хэш записывается нулями
+void writeDigest(QDataStream& out, const QByteArray& digest)
+{
+    QByteArray bytes = digest.leftJustified(DigestSize, '\0', true);
+    out.writeRawData(bytes.constData(), DigestSize);
+}
+
+QByteArray readDigest(QDataStream& in)
+{
+    QByteArray digest(DigestSize, '\0');
+    in.readRawData(digest.data(), DigestSize);
+    return digest.count('\0') == DigestSize ? QByteArray() : digest;
+}
+
+// Ошибка недействительного пакета
+TEException invalidBundle(const QString& source, const QString& reason)
+{
+    return TEException(ErrorType::InvalidBundle, QList<QString>{source, reason});
+}
+}
+
+QByteArray ExpressionBundle::serialize(const ExpressionDocument& document, const BundleOrigin& origin)
+{
+    TraceRecorder::Span span("ExpressionBundle::serialize");
+
+    // Объявления и выражения; тексты описаний собираются в таблицу
+    TextTable table;
+    QByteArray declarationData;
+    {
+        QDataStream out(&declarationData, QIODevice::WriteOnly);
+        out.setVersion(StreamVersion);
+        out << origin.sourcePath << origin.libraryPath;
+
+        const Expression& declarations = document.declarations();
+        writeHash(out, table, *declarations.getVariables(), writeVariable);
+        writeHash(out, table, *declarations.getFunctions(), writeFunction);
+        writeHash(out, table, *declarations.getUnions(), writeCustomType);
+        writeHash(out, table, *declarations.getStructures(), writeCustomType);
+        writeHash(out, table, *declarations.getClasses(), writeCustomType);
+        writeHash(out, table, *declarations.getEnums(), writeEnum);
+
+        QList<QString> sharedNames = declarations.getSharedNames().values();
+        std::sort(sharedNames.begin(), sharedNames.end());
+        out << sharedNames;
+
+        out << quint32(document.count());
+        for (qsizetype i = 0; i < document.count(); ++i)
+            out << document.entry(i).expression << qint32(document.entry(i).notation);
+    }
+
+    // Данные пакета: длина таблицы текстов, таблица в UTF-16LE и объявления
+    QByteArray payload;
+    payload.reserve(8 + table.text.size() * 2 + declarationData.size());
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out << quint64(table.text.size());
+    }
+    for (QChar c : std::as_const(table.text)) {
+        char bytes[2];
+        qToLittleEndian<quint16>(c.unicode(), bytes);
+        payload.append(bytes, 2);
+    }
+    payload.append(declarationData);
+
+    // Заголовок фиксированного размера
+    QByteArray bundle;
+    bundle.reserve(headerSize + payload.size());
+    {
+        QDataStream out(&bundle, QIODevice::WriteOnly);
+        out.writeRawData(BundleMagic, sizeof(BundleMagic));
+        out << formatVersion;
+        writeDigest(out, origin.sourceDigest);
+        writeDigest(out, origin.libraryDigest);
+        out << quint64(payload.size()) << checksum(payload);
+    }
+    bundle.append(payload);
+    return bundle;
+}
+
+TEResult<ExpressionDocument> ExpressionBundle::deserialize(QByteArrayView data, const QString& source, const DeclarationLibrary* library,
+                                                          const QString& bundlePath)
+{
+    TraceRecorder::Span span("ExpressionBundle::deserialize");
+
+    // Проверить заголовок до чтения данных
+    if (data.size() < headerSize || !data.startsWith(QByteArrayView(BundleMagic, sizeof(BundleMagic))))
+        return invalidBundle(source, "неверная сигнатура");
+
+    QByteArray header = QByteArray::fromRawData(data.data(), headerSize);
+    QDataStream headerStream(header);
+    headerStream.skipRawData(sizeof(BundleMagic));
+    quint32 version = 0;
+    quint64 payloadSize = 0;
+    quint64 payloadChecksum = 0;
+    headerStream >> version;
+    QByteArray sourceDigest = readDigest(headerStream);
+    QByteArray libraryDigest = readDigest(headerStream);
+    headerStream >> payloadSize >> payloadChecksum;
+
+    if (version != formatVersion)
+        return invalidBundle(source, "версия формата " + QString::number(version) + ", ожидается " + QString::number(formatVersion));
+    QByteArrayView payloadView = data.sliced(headerSize);
+    if (payloadSize != quint64(payloadView.size()))
+        return invalidBundle(source, "размер данных не совпадает с заголовком");
+    if (payloadChecksum != checksum(payloadView))
+        return invalidBundle(source, "контрольная сумма не совпадает");
+
+    // Таблица текстов копируется из отображённой памяти одним блоком; описания ссылаются на неё участками
+    quint64 tableSize = payloadView.size() >= 8 ? qFromBigEndian<quint64>(payloadView.data()) : 0;
+    if (payloadView.size() < 8 || tableSize > quint64(payloadView.size() - 8) / 2)
+        return invalidBundle(source, "данные повреждены");
+    TextTable table;
+    table.text = QString(qsizetype(tableSize), Qt::Uninitialized);
+    qFromLittleEndian<quint16>(payloadView.data() + 8, qsizetype(tableSize), table.text.data());
+
+    // Остальные данные читаются из отображённой памяти без копирования
+    qsizetype declarationStart = 8 + qsizetype(tableSize) * 2;
+    QByteArray payload = QByteArray::fromRawData(payloadView.data() + declarationStart, payloadView.size() - declarationStart);
+    QDataStream in(payload);
+    in.setVersion(StreamVersion);
+
+    // Пакет, исходные файлы которого изменились после компиляции, отклоняется до чтения объявлений
+    QString sourcePath, libraryPath;
+    in >> sourcePath >> libraryPath;
+    const QDir bundleDirectory = QFileInfo(bundlePath).absoluteDir();
+    if (!sourceDigest.isEmpty() && !bundlePath.isEmpty() && !sourcePath.isEmpty()) {
+        QByteArray currentDigest = fileDigest(bundleDirectory.filePath(sourcePath));
+        if (!currentDigest.isEmpty() && currentDigest != sourceDigest)
+            return invalidBundle(source, "исходный документ изменён после компиляции");
+    }
+    if (!libraryDigest.isEmpty()) {
+        QByteArray currentDigest = library != nullptr ? library->digest()
+            : !bundlePath.isEmpty() && !libraryPath.isEmpty() ? fileDigest(bundleDirectory.filePath(libraryPath))
+            : QByteArray();
+        if (!currentDigest.isEmpty() && currentDigest != libraryDigest)
+            return invalidBundle(source, "библиотека объявлений изменена после компиляции");
+    }
+
+    ExpressionDocument document;
+    Expression& declarations = document.declarations();
+    declarations.setVariables(readHash<Variable>(in, table, readVariable));
+    declarations.setFunctions(readHash<Function>(in, table, readFunction));
+    declarations.setUnions(readHash<Union>(in, table, readCustomType<Union>));
+    declarations.setStructures(readHash<Structure>(in, table, readCustomType<Structure>));
+    declarations.setClasses(readHash<Class>(in, table, readCustomType<Class>));
+    declarations.setEnums(readHash<Enum>(in, table, readEnum));
+
+    QList<QString> sharedNames;
+    in >> sharedNames;
+    declarations.setSharedNames(QSet<QString>(sharedNames.cbegin(), sharedNames.cend()));
+
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString expression;
+        qint32 notation = 0;
+        in >> expression >> notation;
+        if (notation != qint32(ExpressionNotation::Postfix) && notation != qint32(ExpressionNotation::Infix))
+            in.setStatus(QDataStream::ReadCorruptData);
+        document.addExpression(expression, static_cast<ExpressionNotation>(notation));
+    }
+
+    if (in.status() != QDataStream::Ok || !in.atEnd() || document.count() == 0)
+        return invalidBundle(source, "данные повреждены");
+    return document;
+}
+
+TEResult<ExpressionDocument> ExpressionBundle::load(const QString& bundlePath, const DeclarationLibrary* library)
+{
+    TraceRecorder::FileScope traceFile(bundlePath);
+    TraceRecorder::Span span("ExpressionBundle::load");
+
+    QFile file(bundlePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return TEException(ErrorType::InputFileNotFound, bundlePath);
+
+    // Отобразить файл в память; если отображение недоступно, прочитать его целиком
+    qint64 size = file.size();
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    QByteArray content;
+    QByteArrayView data;
+    if (mapped != nullptr) {
+        data = QByteArrayView(mapped, size);
+    }
+    else {
+        content = file.readAll();
+        data = content;
+    }
+    PipelineStats::add(PipelineCounter::BytesRead, data.size());
+
+    TEResult<ExpressionDocument> document = deserialize(data, bundlePath, library, bundlePath);
+    if (mapped != nullptr) file.unmap(mapped);
+    return document;
+}
+
+QList<TEException> ExpressionBundle::save(const ExpressionDocument& document, const QString& bundlePath, const QString& sourcePath,
+                                          const DeclarationLibrary* library)
+{
+    // Пути исходных файлов отсчитываются от каталога пакета, поэтому каталог можно перенести целиком
+    BundleOrigin origin;
+    const QDir bundleDirectory = QFileInfo(bundlePath).absoluteDir();
+    if (!sourcePath.isEmpty()) {
+        origin.sourcePath = bundleDirectory.relativeFilePath(QFileInfo(sourcePath).absoluteFilePath());
+        origin.sourceDigest = fileDigest(sourcePath);
+    }
+    if (library != nullptr) {
+        origin.libraryPath = bundleDirectory.relativeFilePath(library->path());
+        origin.libraryDigest = library->digest();
+    }
+
+    QByteArray bundle = serialize(document, origin);
+    QFile file(bundlePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bundle) != bundle.size())
+        return QList<TEException>{TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{bundlePath})};
+    PipelineStats::add(PipelineCounter::BytesWritten, bundle.size());
+    return QList<TEException>{};
+}
+
+bool ExpressionBundle::isBundleFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    return isBundle(file.read(sizeof(BundleMagic)));
+}
+
+bool ExpressionBundle::isBundle(QByteArrayView data)
+{
+    return data.startsWith(QByteArrayView(BundleMagic, sizeof(BundleMagic)));
+}
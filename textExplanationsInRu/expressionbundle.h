@@ -0,0 +1,108 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExpressionBundle для скомпилированных пакетов выражений.
+ */
+
+#ifndef EXPRESSIONBUNDLE_H
+#define EXPRESSIONBUNDLE_H
+
+#include "declarationlibrary.h"
+#include "expressiondocument.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+/*!
+ * \brief Структура, описывающая исходные файлы, из которых скомпилирован пакет.
+ */
+struct BundleOrigin {
+    QString sourcePath;         /*!< Путь к исходному документу относительно каталога пакета или пустая строка */
+    QByteArray sourceDigest;    /*!< Хэш SHA-1 исходного документа; пустой, если документ не задан */
+    QString libraryPath;        /*!< Путь к библиотеке объявлений относительно каталога пакета или пустая строка */
+    QByteArray libraryDigest;   /*!< Хэш SHA-1 библиотеки объявлений (DeclarationLibrary::digest()); пустой без библиотеки */
+};
+
+/*!
+ * \brief Класс для сохранения проверенного документа в двоичный пакет и загрузки пакета без разбора XML.
+ *
+ * Пакет начинается с заголовка фиксированного размера: сигнатура "TEXB", версия формата, хэши исходного документа
+ * и библиотеки объявлений, размер данных и их контрольная сумма (FNV-1a, 64 бита). Данные начинаются с таблицы
+ * текстов описаний в UTF-16LE, за которой QDataStream записывает пути исходного документа и библиотеки относительно
+ * каталога пакета, объявления, имена общих объявлений библиотеки и выражения документа. Падеж описания
+ * хранится как участок таблицы: при загрузке таблица копируется одним блоком, а описания ссылаются на неё без
+ * отдельных строк. Указателей в пакете нет, поэтому его можно отображать в память по любому адресу. Пакет с другой
+ * версией формата, другим размером или контрольной суммой отклоняется с ошибкой InvalidBundle.
+ *
+ * Устаревший пакет также отклоняется с ошибкой InvalidBundle: если исходный документ, записанный в пакете, существует
+ * и его содержимое изменилось после компиляции, а также если пакет скомпилирован с библиотекой объявлений, а
+ * подключённая при загрузке библиотека (или, без неё, файл библиотеки, записанный в пакете) отличается от неё.
+ */
+class ExpressionBundle
+{
+public:
+    /*!
+     * \brief Текущая версия формата пакета.
+     */
+    static constexpr quint32 formatVersion = 3;
+
+    /*!
+     * \brief Размер заголовка пакета в байтах.
+     */
+    static constexpr qsizetype headerSize = 64;
+
+    /*!
+     * \brief Преобразование документа в пакет.
+     *
+     * Объявления записываются в порядке имён, поэтому одинаковые документы дают одинаковые пакеты.
+     * \param[in] document Документ.
+     * \param[in] origin Исходные файлы документа; пустые поля не проверяются при загрузке.
+     * \return Содержимое пакета.
+     */
+    static QByteArray serialize(const ExpressionDocument& document, const BundleOrigin& origin = BundleOrigin());
+
+    /*!
+     * \brief Восстановление документа из содержимого пакета.
+     * \param[in] data Содержимое пакета.
+     * \param[in] source Имя источника для сообщений об ошибках.
+     * \param[in] library Библиотека объявлений, подключённая при загрузке, или nullptr.
+     * \param[in] bundlePath Путь к файлу пакета; если задан, от его каталога отсчитываются пути исходных файлов.
+     * \return Документ либо ошибка InvalidBundle.
+     */
+    static TEResult<ExpressionDocument> deserialize(QByteArrayView data, const QString& source = QString(),
+                                                    const DeclarationLibrary* library = nullptr, const QString& bundlePath = QString());
+
+    /*!
+     * \brief Загрузка пакета из файла, отображённого в память.
+     * \param[in] bundlePath Путь к файлу пакета.
+     * \param[in] library Библиотека объявлений, подключённая при загрузке, или nullptr.
+     * \return Документ либо список ошибок.
+     */
+    static TEResult<ExpressionDocument> load(const QString& bundlePath, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Сохранение документа в файл пакета.
+     * \param[in] document Документ.
+     * \param[in] bundlePath Путь к файлу пакета.
+     * \param[in] sourcePath Путь к исходному документу или пустая строка.
+     * \param[in] library Библиотека объявлений, с которой разобран документ, или nullptr.
+     * \return Список ошибок; пустой, если пакет сохранён.
+     */
+    static QList<TEException> save(const ExpressionDocument& document, const QString& bundlePath,
+                                   const QString& sourcePath = QString(), const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Проверка, начинается ли файл с сигнатуры пакета.
+     * \param[in] path Путь к файлу.
+     * \return true, если файл является пакетом (возможно, повреждённым или устаревшим).
+     */
+    static bool isBundleFile(const QString& path);
+
+    /*!
+     * \brief Проверка, начинаются ли данные с сигнатуры пакета.
+     * \param[in] data Данные.
+     * \return true, если данные являются пакетом (возможно, повреждённым или устаревшим).
+     */
+    static bool isBundle(QByteArrayView data);
+};
+
+#endif // EXPRESSIONBUNDLE_H
@@ -0,0 +1,100 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса ExpressionDocument.
+ */
+
+#include "expressiondocument.h"
+#include "declarationindex.h"
+#include "expressionxmlparser.h"
+#include "tracerecorder.h"
+
+TEResult<ExpressionDocument> ExpressionDocument::tryFromFile(const QString& path, const DeclarationLibrary* library)
+{
+    TraceRecorder::FileScope traceFile(path);
+    TraceRecorder::Span span("ExpressionDocument::fromFile");
+    ParseReport report;
+    return ExpressionXmlParser::parseDocumentFile(path, ValidationMode::CollectAll, report, library);
+}
+
+const Expression& ExpressionDocument::declarations() const
+{
+    return sharedDeclarations;
+}
+
+Expression& ExpressionDocument::declarations()
+{
+    return sharedDeclarations;
+}
+
+void ExpressionDocument::addExpression(const QString& expression, ExpressionNotation notation)
+{
+    expressions.append(DocumentExpression{expression, notation});
+}
+
+qsizetype ExpressionDocument::count() const
+{
+    return expressions.size();
+}
+
+const DocumentExpression& ExpressionDocument::entry(qsizetype index) const
+{
+    return expressions.at(index);
+}
+
+Expression ExpressionDocument::expression(qsizetype index) const
+{
+    // Индекс объявлений строится до копирования, чтобы копии использовали его совместно
+    sharedDeclarations.getDeclarationIndex();
+    Expression result = sharedDeclarations;
+    result.setExpression(expressions.at(index).expression);
+    result.setNotation(expressions.at(index).notation);
+    // Использование объявлений нескольких выражений проверяется по всему документу
+    if (expressions.size() > 1) result.markDeclarationsShared();
+    return result;
+}
+
+QList<TEResult<QString>> ExpressionDocument::tryGetExplanationsInRu(QList<TEException>& documentErrors) const
+{
+    QList<TEResult<QString>> explanations;
+    explanations.reserve(expressions.size());
+    QBitArray usedDeclarations(sharedDeclarations.getDeclarationIndex().size());
+    bool allBuilt = true;
+
+    for (qsizetype i = 0; i < expressions.size(); i++) {
+        Expression current = expression(i);
+        TEResult<QString> explanation = current.tryGetExplanationInRu();
+        allBuilt = allBuilt && explanation;
+        usedDeclarations |= current.getUsedDeclarations();
+        explanations.append(explanation);
+    }
+
+    // Использование объявлений известно полностью, только если построены все деревья
+    if (expressions.size() > 1 && allBuilt) checkUnusedDeclarations(usedDeclarations, documentErrors);
+    return explanations;
+}
+
+QList<TEException> ExpressionDocument::checkExpressions() const
+{
+    QList<TEException> errors;
+    QBitArray usedDeclarations(sharedDeclarations.getDeclarationIndex().size());
+
+    for (qsizetype i = 0; i < expressions.size(); i++) {
+        Expression current = expression(i);
+        TEResult<ExpressionNode*> tree = current.tryExpressionToNodes();
+        if (!tree) return tree.errors();
+        usedDeclarations |= current.getUsedDeclarations();
+        current.deleteTree(tree.value());
+    }
+
+    if (expressions.size() > 1) checkUnusedDeclarations(usedDeclarations, errors);
+    return errors;
+}
+
+void ExpressionDocument::checkUnusedDeclarations(const QBitArray& usedDeclarations, QList<TEException>& errors) const
+{
+    // Объявления подключённой библиотеки могут не использоваться
+    QBitArray unusedDeclarations = ~(usedDeclarations | sharedDeclarations.getSharedDeclarations());
+    if (unusedDeclarations.count(true) > 0)
+        errors.append(TEException(ErrorType::NeverUsedElement,
+                                  QList<QString>{sharedDeclarations.getDeclarationIndex().names(unusedDeclarations).join(", ")}));
+}
@@ -0,0 +1,102 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExpressionDocument для документов с несколькими выражениями.
+ */
+
+#ifndef EXPRESSIONDOCUMENT_H
+#define EXPRESSIONDOCUMENT_H
+
+#include "expression.h"
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief Структура, описывающая одно выражение документа.
+ */
+struct DocumentExpression {
+    QString expression;                                         /*!< Строка выражения */
+    ExpressionNotation notation = ExpressionNotation::Postfix;  /*!< Форма записи выражения */
+};
+
+/*!
+ * \brief Класс, представляющий документ с одним или несколькими выражениями и общими объявлениями.
+ *
+ * Объявления документа разбираются один раз и используются каждым выражением совместно. Если выражений
+ * несколько, неиспользованные объявления (NeverUsedElement) проверяются по всем выражениям документа,
+ * а не по каждому выражению отдельно.
+ */
+class ExpressionDocument
+{
+public:
+    /*!
+     * \brief Создание документа из XML-файла без использования исключений.
+     * \param[in] path Путь к файлу.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \return Документ либо список ошибок входного файла.
+     */
+    static TEResult<ExpressionDocument> tryFromFile(const QString& path, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Получение общих объявлений документа.
+     * \return Выражение без строки выражения, содержащее объявления.
+     */
+    const Expression& declarations() const;
+
+    /*!
+     * \brief Получение общих объявлений документа для изменения.
+     */
+    Expression& declarations();
+
+    /*!
+     * \brief Добавление выражения в документ.
+     * \param[in] expression Строка выражения.
+     * \param[in] notation Форма записи выражения.
+     */
+    void addExpression(const QString& expression, ExpressionNotation notation);
+
+    /*!
+     * \brief Получение количества выражений документа.
+     */
+    qsizetype count() const;
+
+    /*!
+     * \brief Получение строки и формы записи выражения документа.
+     * \param[in] index Индекс выражения.
+     */
+    const DocumentExpression& entry(qsizetype index) const;
+
+    /*!
+     * \brief Получение выражения документа вместе с общими объявлениями.
+     *
+     * Хэши объявлений используются выражением совместно с документом без копирования.
+     * \param[in] index Индекс выражения.
+     * \return Выражение с объявлениями документа.
+     */
+    Expression expression(qsizetype index) const;
+
+    /*!
+     * \brief Генерация пояснений всех выражений документа без использования исключений.
+     * \param[out] documentErrors Ошибки, относящиеся к документу в целом (неиспользованные объявления).
+     * \return Пояснение либо ошибки для каждого выражения в порядке документа.
+     */
+    QList<TEResult<QString>> tryGetExplanationsInRu(QList<TEException>& documentErrors) const;
+
+    /*!
+     * \brief Построение деревьев всех выражений с остановкой на первой ошибке.
+     * \return Первая ошибка выражения или ошибка неиспользованных объявлений документа; пустой список, если ошибок нет.
+     */
+    QList<TEException> checkExpressions() const;
+
+private:
+    /*!
+     * \brief Проверка, что каждое собственное объявление документа использовано хотя бы одним выражением.
+     * \param[in] usedDeclarations Маска объявлений, использованных выражениями.
+     * \param[out] errors Список ошибок.
+     */
+    void checkUnusedDeclarations(const QBitArray& usedDeclarations, QList<TEException>& errors) const;
+
+    Expression sharedDeclarations;              /*!< Общие объявления документа */
+    QList<DocumentExpression> expressions;      /*!< Выражения документа */
+};
+
+#endif // EXPRESSIONDOCUMENT_H
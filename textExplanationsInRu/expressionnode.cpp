@@ -1,4 +1,5 @@
 #include "expressionnode.h"
+#include "pipelinestats.h"
 
 // Конструктор по умолчанию
 ExpressionNode::ExpressionNode()
@@ -9,7 +10,9 @@ ExpressionNode::ExpressionNode()
     nodeType(EntityType::Undefined),
     operType(OperationType::None),
     dataType(""),
-    FunctionArgs(nullptr) {}
+    FunctionArgs(nullptr) {
+    PipelineStats::add(PipelineCounter::Nodes);
+}
 
 ExpressionNode::ExpressionNode(EntityType nodeType, const QString &value, ExpressionNode *left, ExpressionNode *right, const QString &dataType, OperationType operType, QList<ExpressionNode *> *functionArgs)
     : value(value),
@@ -18,7 +21,9 @@ ExpressionNode::ExpressionNode(EntityType nodeType, const QString &value, Expres
     nodeType(nodeType),
     operType(operType),
     dataType(dataType),
-    FunctionArgs(functionArgs) {}
+    FunctionArgs(functionArgs) {
+    PipelineStats::add(PipelineCounter::Nodes);
+}
 
 QString ExpressionNode::toString() const {
     QString result;
@@ -56,44 +61,66 @@ QString ExpressionNode::toString() const {
 bool ExpressionNode::isReducibleUnarySelfInverse() const
 {
     if(this->getLeftNode() != nullptr && this->getRightNode() == nullptr){
-        if((this->getOperType() == this->getLeftNode()->getOperType() && (this->getOperType() == OperationType::UnaryMinus ||this->getOperType() == OperationType::Not)) ||
-            (this->getOperType() == OperationType::Dereference && this->getLeftNode()->getOperType() == OperationType::AddressOf) ||
-            (this->getOperType() == OperationType::AddressOf && this->getLeftNode()->getOperType() == OperationType::Dereference))
-        {
-            return true;
-        }
+        OperationType cancelledBy = operationTraits(this->getOperType()).cancelledBy;
+        return cancelledBy != OperationType::None && cancelledBy == this->getLeftNode()->getOperType();
     }
     return false;
 }
 
 bool ExpressionNode::isComparisonOperation() const {
     if (this != nullptr && this->getNodeType() == EntityType::Operation) {
-        OperationType operType = this->getOperType();
-        return operType == OperationType::LessThan ||
-               operType == OperationType::LessThanOrEqual ||
-               operType == OperationType::GreaterThan ||
-               operType == OperationType::GreaterThanOrEqual ||
-               operType == OperationType::Equal ||
-               operType == OperationType::NotEqual ||
-               operType == OperationType::NotLessThan ||
-               operType == OperationType::NotLessThanOrEqual ||
-               operType == OperationType::NotGreaterThan ||
-               operType == OperationType::NotGreaterThanOrEqual;
+        return operationTraits(this->getOperType()).isComparison;
     }
     return false;
 }
 
 bool ExpressionNode::isIncrementOrDecrement() const {
     if (this != nullptr && this->getNodeType() == EntityType::Operation) {
-        OperationType operType = this->getOperType();
-        return operType == OperationType::PostfixIncrement ||
-               operType == OperationType::PrefixIncrement ||
-               operType == OperationType::PostfixDecrement ||
-               operType == OperationType::PrefixDecrement;
+        return operationTraits(this->getOperType()).isIncrementOrDecrement;
     }
     return false;
 }
 
+void ExpressionNode::setRendering(RenderRule rule, OperationType templateType, OperationType parentOperType)
+{
+    this->renderRule = rule;
+    this->templateType = templateType;
+    this->renderParentType = parentOperType;
+}
+
+RenderRule ExpressionNode::getRenderRule() const {
+    return renderRule;
+}
+
+OperationType ExpressionNode::getTemplateType() const {
+    return templateType;
+}
+
+OperationType ExpressionNode::getRenderParentType() const {
+    return renderParentType;
+}
+
+void ExpressionNode::setSpan(ExpressionSpan tokenSpan)
+{
+    QList<const ExpressionNode*> children = {left, right};
+    if (FunctionArgs != nullptr)
+        for (const ExpressionNode* argument : *FunctionArgs) children.append(argument);
+    for (const ExpressionNode* child : children) {
+        if (child == nullptr || !child->span.isValid()) continue;
+        if (!tokenSpan.isValid()) {
+            tokenSpan = child->span;
+            continue;
+        }
+        tokenSpan.start = qMin(tokenSpan.start, child->span.start);
+        tokenSpan.end = qMax(tokenSpan.end, child->span.end);
+    }
+    span = tokenSpan;
+}
+
+ExpressionSpan ExpressionNode::getSpan() const {
+    return span;
+}
+
 OperationType ExpressionNode::getOperType() const {
     return operType;
 }
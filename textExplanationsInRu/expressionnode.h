@@ -8,6 +8,41 @@
 #include <QString>
 #include "codeentity.h"
 
+/*!
+ * \brief Способ перевода узла операции, определяемый нормализацией дерева.
+ */
+enum class RenderRule {
+    Unresolved,         /*!< Узел не нормализован */
+    SkipSelfInverse,    /*!< Пара взаимно сокращающихся унарных операций: переводится только операнд вложенной операции */
+    InvertedComparison, /*!< Отрицание сравнения: переводится вложенное сравнение с обратным шаблоном */
+    IncrementDecrement, /*!< Инкремент или декремент, переводимый через промежуточное описание */
+    Enumeration,        /*!< Продолжение последовательности операций: описания операндов через запятую */
+    Template            /*!< Заполнение шаблона описаниями операндов */
+};
+
+/*!
+ * \brief Структура, описывающая участок строки выражения, занимаемый поддеревом.
+ */
+struct ExpressionSpan {
+    qsizetype start = -1;   /*!< Позиция первого символа; -1, если участок не задан */
+    qsizetype end = -1;     /*!< Позиция после последнего символа */
+
+    /*!
+     * \brief Проверка, задан ли участок.
+     */
+    bool isValid() const { return start >= 0; }
+
+    /*!
+     * \brief Сравнение участков на равенство.
+     */
+    bool operator==(const ExpressionSpan& other) const { return start == other.start && end == other.end; }
+
+    /*!
+     * \brief Упорядочение участков по началу, а при равном начале – от длинного к короткому.
+     */
+    bool operator<(const ExpressionSpan& other) const { return start != other.start ? start < other.start : end > other.end; }
+};
+
 /*!
  * \brief Класс, представляющий узел дерева математического или логического выражения.
  */
@@ -169,6 +204,45 @@ public:
      * \return true, если операция — инкремент или декремент.
      */
     bool isIncrementOrDecrement() const;
+
+    /*!
+     * \brief Установка способа перевода узла, найденного нормализацией дерева.
+     * \param[in] rule Способ перевода.
+     * \param[in] templateType Тип операции, шаблон которой используется при переводе.
+     * \param[in] parentOperType Тип родительской операции, для которой определён способ перевода.
+     */
+    void setRendering(RenderRule rule, OperationType templateType, OperationType parentOperType);
+
+    /*!
+     * \brief Получение способа перевода узла.
+     * \return Способ перевода; RenderRule::Unresolved, если узел не нормализован.
+     */
+    RenderRule getRenderRule() const;
+
+    /*!
+     * \brief Получение типа операции, шаблон которой используется при переводе узла.
+     */
+    OperationType getTemplateType() const;
+
+    /*!
+     * \brief Получение типа родительской операции, для которой определён способ перевода узла.
+     */
+    OperationType getRenderParentType() const;
+
+    /*!
+     * \brief Установка участка строки выражения, занимаемого поддеревом.
+     *
+     * Участок объединяет участок лексемы узла с участками дочерних узлов и аргументов функции,
+     * поэтому задаётся после построения дочерних узлов.
+     * \param[in] tokenSpan Участок лексемы узла (например, знака операции или имени функции со скобками).
+     */
+    void setSpan(ExpressionSpan tokenSpan);
+
+    /*!
+     * \brief Получение участка строки выражения, занимаемого поддеревом.
+     * \return Участок; недействительный, если дерево построено не из строки выражения.
+     */
+    ExpressionSpan getSpan() const;
 private:
     QString value;                          /*!< Значение узла */
     ExpressionNode* right;                  /*!< Правый дочерний узел */
@@ -177,6 +251,10 @@ private:
     OperationType operType;                 /*!< Тип операции */
     QString dataType;                       /*!< Тип данных */
     QList<ExpressionNode*>* FunctionArgs;   /*!< Аргументы функции */
+    RenderRule renderRule = RenderRule::Unresolved;             /*!< Способ перевода узла */
+    OperationType templateType = OperationType::None;           /*!< Тип операции, шаблон которой используется при переводе */
+    OperationType renderParentType = OperationType::None;       /*!< Тип родительской операции, для которой определён способ перевода */
+    ExpressionSpan span;                                        /*!< Участок строки выражения, занимаемый поддеревом */
 };
 
 #endif // EXPRESSIONNODE_H
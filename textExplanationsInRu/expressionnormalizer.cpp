@@ -0,0 +1,98 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса ExpressionNormalizer.
+ */
+
+#include "expressionnormalizer.h"
+
+void ExpressionNormalizer::normalize(ExpressionNode* root)
+{
+    normalizeNode(root, OperationType::None);
+}
+
+void ExpressionNormalizer::normalizeNode(ExpressionNode* node, OperationType parentOperType)
+{
+    if (node == nullptr) return;
+
+    // Аргументы функции переводятся в контексте вызова функции
+    if (node->getNodeType() == EntityType::Function) {
+        if (node->getFunctionArgs() != nullptr) {
+            for (ExpressionNode* arg : *node->getFunctionArgs())
+                normalizeNode(arg, OperationType::FunctionCall);
+        }
+        return;
+    }
+
+    if (node->getNodeType() != EntityType::Operation) return;
+
+    NodeRendering nodeRendering = resolve(node, parentOperType);
+    node->setRendering(nodeRendering.rule, nodeRendering.templateType, parentOperType);
+
+    // Обойти те поддеревья, которые будут переведены, с той родительской операцией, с которой они будут переведены
+    if (nodeRendering.rule == RenderRule::SkipSelfInverse) {
+        normalizeNode(node->getLeftNode()->getLeftNode(), node->getOperType());
+    }
+    else {
+        normalizeNode(node->getLeftNode(), node->getOperType());
+        if (nodeRendering.rule != RenderRule::InvertedComparison && nodeRendering.rule != RenderRule::IncrementDecrement)
+            normalizeNode(node->getRightNode(), node->getOperType());
+    }
+}
+
+NodeRendering ExpressionNormalizer::resolve(const ExpressionNode* node, OperationType parentOperType)
+{
+    OperationType operType = node->getOperType();
+    const ExpressionNode* left = node->getLeftNode();
+    const ExpressionNode* right = node->getRightNode();
+
+    // Двойное отрицание, двойной унарный минус, пары *& и &*
+    if (node->isReducibleUnarySelfInverse())
+        return {RenderRule::SkipSelfInverse, OperationType::None};
+
+    // Отрицание сравнения переводится обратным сравнением
+    if (operType == OperationType::Not && left->isComparisonOperation())
+        return {RenderRule::InvertedComparison, OperationType::None};
+
+    // Инкремент и декремент; отдельно стоящие переводятся повелительной формой
+    if (node->isIncrementOrDecrement()) {
+        if (parentOperType != OperationType::None)
+            return {RenderRule::IncrementDecrement, operType};
+        if (operType == OperationType::PostfixIncrement || operType == OperationType::PrefixIncrement)
+            return {RenderRule::IncrementDecrement, OperationType::SingleIncrement};
+        return {RenderRule::IncrementDecrement, OperationType::SingleDecrement};
+    }
+
+    // Последовательности однотипных операций
+    if (parentOperType == operType) {
+        if (operType == OperationType::Subtraction && left->getOperType() != OperationType::Subtraction && right->getOperType() != OperationType::Subtraction)
+            return {RenderRule::Template, OperationType::SubtractionSequence};
+        if (operType == OperationType::Division && left->getOperType() != OperationType::Division && right->getOperType() != OperationType::Division)
+            return {RenderRule::Template, OperationType::DivisionSequence};
+        return {RenderRule::Enumeration, OperationType::None};
+    }
+    if ((operType == OperationType::Subtraction && left->getOperType() == OperationType::Subtraction) ||
+        (operType == OperationType::Division && left->getOperType() == OperationType::Division))
+        return {RenderRule::Enumeration, OperationType::None};
+
+    // Обращение к значению по указателю со смещением
+    if (operType == OperationType::Dereference && left->getNodeType() == EntityType::Operation)
+        return {RenderRule::Template, OperationType::PointerIndexAccess};
+
+    // Сравнение под отрицанием
+    if (node->isComparisonOperation() && parentOperType == OperationType::Not)
+        return {RenderRule::Template, operationTraits(operType).inverse};
+
+    // Конкатенация строк
+    if (operType == OperationType::Addition && right != nullptr &&
+        left->getDataType() == "string" && left->getDataType() == right->getDataType())
+        return {RenderRule::Template, OperationType::Concatenation};
+
+    return {RenderRule::Template, operType};
+}
+
+NodeRendering ExpressionNormalizer::rendering(const ExpressionNode* node, OperationType parentOperType)
+{
+    if (node->getRenderRule() != RenderRule::Unresolved && node->getRenderParentType() == parentOperType)
+        return {node->getRenderRule(), node->getTemplateType()};
+    return resolve(node, parentOperType);
+}
@@ -0,0 +1,64 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExpressionNormalizer для нормализации дерева выражения перед переводом.
+ */
+
+#ifndef EXPRESSIONNORMALIZER_H
+#define EXPRESSIONNORMALIZER_H
+
+#include "expressionnode.h"
+
+/*!
+ * \brief Структура, описывающая способ перевода узла операции.
+ */
+struct NodeRendering {
+    RenderRule rule = RenderRule::Unresolved;           /*!< Способ перевода */
+    OperationType templateType = OperationType::None;   /*!< Тип операции, шаблон которой используется при переводе */
+};
+
+/*!
+ * \brief Класс для нормализации дерева выражения.
+ *
+ * Нормализация один раз применяет к дереву правила перевода (сокращение двойного отрицания и пар `*&`/`&*`,
+ * отрицание сравнений, последовательности вычитаний и делений, конкатенацию строк, обращение по указателю
+ * со смещением) и сохраняет в каждом узле операции способ перевода и тип шаблона. Поскольку способ перевода
+ * зависит от родительской операции, он сохраняется вместе с её типом. Структура дерева не изменяется.
+ */
+class ExpressionNormalizer
+{
+public:
+    /*!
+     * \brief Нормализация дерева выражения.
+     * \param[in,out] root Корневой узел дерева.
+     */
+    static void normalize(ExpressionNode* root);
+
+    /*!
+     * \brief Определение способа перевода узла операции.
+     * \param[in] node Узел операции.
+     * \param[in] parentOperType Тип родительской операции.
+     * \return Способ перевода узла.
+     */
+    static NodeRendering resolve(const ExpressionNode* node, OperationType parentOperType);
+
+    /*!
+     * \brief Получение способа перевода узла операции.
+     *
+     * Возвращает сохранённый нормализацией способ перевода, если он определён для той же родительской
+     * операции; иначе определяет его заново.
+     * \param[in] node Узел операции.
+     * \param[in] parentOperType Тип родительской операции.
+     * \return Способ перевода узла.
+     */
+    static NodeRendering rendering(const ExpressionNode* node, OperationType parentOperType);
+
+private:
+    /*!
+     * \brief Нормализация поддерева.
+     * \param[in,out] node Корневой узел поддерева.
+     * \param[in] parentOperType Тип родительской операции, с которой поддерево будет переводиться.
+     */
+    static void normalizeNode(ExpressionNode* node, OperationType parentOperType);
+};
+
+#endif // EXPRESSIONNORMALIZER_H
@@ -0,0 +1,233 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса ExpressionSession для пошагового перевода редактируемого выражения.
+ */
+
+#include "expressionsession.h"
+#include "declarationindex.h"
+#include "expressionnormalizer.h"
+#include "infixparser.h"
+#include "pipelinestats.h"
+#include "tracerecorder.h"
+
+namespace {
+// Наибольшее количество операций, после которого построение дерева прекращается
+constexpr int MaxOperations = 20;
+
+// Удаление узла вместе со списком аргументов; дочерние узлы удаляются отдельно
+void deleteNode(ExpressionNode* node, DescriptionCache& cache)
+{
+    cache.forget(node);
+    delete node->getFunctionArgs();
+    delete node;
+}
+
+// Сбор всех узлов дерева
+void collectNodes(ExpressionNode* node, QList<ExpressionNode*>& nodes)
+{
+    if (node == nullptr) return;
+    nodes.append(node);
+    collectNodes(node->getLeftNode(), nodes);
+    collectNodes(node->getRightNode(), nodes);
+    if (node->getFunctionArgs() != nullptr)
+        for (ExpressionNode* argument : *node->getFunctionArgs()) collectNodes(argument, nodes);
+}
+}
+
+ExpressionSession::ExpressionSession(const Expression& declarations)
+    : declarations(declarations)
+{
+    // Индекс объявлений и пользовательские типы вычисляются один раз для всех изменений выражения
+    this->declarations.setExpression(QString());
+    this->declarations.setDescriptionCache(&descriptionCache);
+    BuildState initial;
+    initial.context.customDataTypes = this->declarations.getCustomDataTypes();
+    initial.context.usedDeclarations = QBitArray(this->declarations.getDeclarationIndex().size());
+    states.append(initial);
+}
+
+ExpressionSession::~ExpressionSession()
+{
+    releaseNodes(0);
+    releaseInfixNodes();
+}
+
+TEResult<QString> ExpressionSession::update(const QString& newExpression)
+{
+    // Изменённый участок лежит между совпадающими началом и концом выражений
+    const qsizetype common = qMin(text.size(), newExpression.size());
+    qsizetype prefix = 0;
+    while (prefix < common && text[prefix] == newExpression[prefix]) prefix++;
+    qsizetype suffix = 0;
+    while (suffix < common - prefix && text[text.size() - 1 - suffix] == newExpression[newExpression.size() - 1 - suffix]) suffix++;
+    return replace(prefix, text.size() - prefix - suffix, newExpression.sliced(prefix, newExpression.size() - prefix - suffix));
+}
+
+TEResult<QString> ExpressionSession::replace(qsizetype position, qsizetype length, const QString& insertion)
+{
+    TraceRecorder::Span span("ExpressionSession::replace");
+    stats = SessionUpdateStats();
+    position = qBound<qsizetype>(0, position, text.size());
+    length = qBound<qsizetype>(0, length, text.size() - position);
+    const qsizetype editEnd = position + length;
+    const qsizetype delta = insertion.size() - length;
+    // Кавычка может изменить границы всех лексем после неё
+    const bool quotesChanged = insertion.contains('"') || QStringView(text).sliced(position, length).contains('"');
+    text.replace(position, length, insertion);
+
+    // Лексемы, которые пересекаются с изменённым участком или примыкают к нему
+    qsizetype first = 0;
+    qsizetype last = tokens.size() - 1;
+    if (!quotesChanged) {
+        while (first < tokens.size() && tokens[first].position + tokens[first].text.size() < position) first++;
+        while (last >= 0 && tokens[last].position > editEnd) last--;
+    }
+    qsizetype from = quotesChanged ? 0 : position;
+    qsizetype to = quotesChanged ? text.size() - delta : editEnd;
+    if (first <= last) {
+        from = qMin(from, tokens[first].position);
+        to = qMax(to, tokens[last].position + tokens[last].text.size());
+    }
+
+    // Заново разделить на лексемы только затронутый участок, позиции следующих лексем сдвинуть
+    QList<ExpressionToken> updated = tokens.first(first);
+    updated += tokenize(from, to + delta);
+    stats.tokenizedLength = to + delta - from;
+    for (qsizetype i = last + 1; i < tokens.size(); i++) {
+        updated.append(tokens[i]);
+        updated.last().position += delta;
+    }
+
+    // Первая лексема, текст или позиция которой изменились; от позиций лексем зависят участки узлов
+    qsizetype firstChanged = first;
+    while (firstChanged < tokens.size() && firstChanged < updated.size()
+           && tokens[firstChanged].text == updated[firstChanged].text && tokens[firstChanged].position == updated[firstChanged].position)
+        firstChanged++;
+    const bool changed = firstChanged < updated.size() || updated.size() != tokens.size();
+    tokens = updated;
+
+    // Тип лексемы может зависеть от следующей лексемы, поэтому предшествующая изменению лексема обрабатывается заново
+    qsizetype replayFrom = changed ? qMax<qsizetype>(0, firstChanged - 1) : firstChanged;
+    return rebuild(qMin(replayFrom, states.size() - 1));
+}
+
+const QString& ExpressionSession::expression() const
+{
+    return text;
+}
+
+const ExpressionNode* ExpressionSession::root() const
+{
+    return rootNode;
+}
+
+const SessionUpdateStats& ExpressionSession::lastUpdate() const
+{
+    return stats;
+}
+
+TEResult<QList<SubtreeExplanation>> ExpressionSession::subtreeExplanations(Case grammaticalCase) const
+{
+    if (rootNode == nullptr) return QList<SubtreeExplanation>();
+    try {
+        return declarations.getSubtreeExplanations(rootNode, grammaticalCase);
+    }
+    catch (const TEException& error) {
+        return error;
+    }
+}
+
+QList<ExpressionToken> ExpressionSession::tokenize(qsizetype from, qsizetype to) const
+{
+    QList<ExpressionToken> result = Expression::tokenizeExpression(text.sliced(from, to - from));
+    for (ExpressionToken& token : result)
+        token.position += from;
+    return result;
+}
+
+TEResult<QString> ExpressionSession::rebuild(qsizetype replayFrom)
+{
+    rootNode = nullptr;
+    descriptionCache.resetCounters();
+
+    // Пустое выражение переводится так же, как в выражении без сеанса
+    if (tokens.isEmpty()) {
+        releaseNodes(0);
+        releaseInfixNodes();
+        declarations.setExpression(QString());
+        return declarations.tryGetExplanationInRu();
+    }
+    declarations.setExpression(text);
+
+    QList<TEException> errors;
+    ExpressionNode* root = nullptr;
+    {
+        PipelineStats::ScopedTimer timer(PipelineStage::ExpressionToNodes);
+        if (declarations.getNotation() == ExpressionNotation::Infix) {
+            releaseInfixNodes();
+            root = InfixParser(declarations).parse(errors);
+            collectNodes(root, infixNodes);
+            stats.replayedTokens = tokens.size();
+        }
+        else root = buildPostfix(replayFrom, errors);
+    }
+    if (root == nullptr) return errors;
+
+    // Способ перевода узлов, которые получили нового родителя, определяется заново
+    ExpressionNormalizer::normalize(root);
+    rootNode = root;
+
+    QString explanation;
+    try {
+        PipelineStats::ScopedTimer timer(PipelineStage::ToExplanation);
+        QHash<Case, QString> intermediateDescription = {};
+        explanation = declarations.toExplanation(root, intermediateDescription).value(Case::Nominative);
+    }
+    // Ошибки шаблонов описаний возникают только при некорректных плейсхолдерах
+    catch (const TEException& error) {
+        return error;
+    }
+    stats.renderedNodes = descriptionCache.misses();
+    stats.cachedNodes = descriptionCache.hits();
+
+    PipelineStats::ScopedTimer timer(PipelineStage::RemoveDuplicates);
+    return Expression::removeConsecutiveDuplicates(explanation);
+}
+
+ExpressionNode* ExpressionSession::buildPostfix(qsizetype replayFrom, QList<TEException>& errors)
+{
+    // Узлы лексем до replayFrom и состояние построителя после них используются повторно
+    releaseNodes(replayFrom);
+    BuildState state = states.last();
+    for (qsizetype i = replayFrom; i < tokens.size() && state.context.operationCounter <= MaxOperations; i++) {
+        const QString nextToken = i + 1 < tokens.size() ? tokens[i + 1].text : QString();
+        stats.replayedTokens++;
+        // Прекратить построение дерева при первой ошибке
+        if (!declarations.processToken(tokens[i].text, nextToken, state.nodeStack, state.context, errors)) return nullptr;
+        state.nodeStack.top()->setSpan({tokens[i].position, tokens[i].position + tokens[i].text.size()});
+        createdNodes.append(state.nodeStack.top());
+        states.append(state);
+    }
+    PipelineStats::add(PipelineCounter::Tokens, stats.replayedTokens);
+
+    QStack<ExpressionNode*> nodeStack = state.nodeStack;
+    if (!declarations.finalizeNodeProcessing(nodeStack, text, state.context.operationCounter, state.context.usedDeclarations, errors))
+        return nullptr;
+    return nodeStack.pop();
+}
+
+void ExpressionSession::releaseNodes(qsizetype firstToken)
+{
+    // Узлы, созданные лексемой, ссылаются только на узлы предшествующих лексем
+    for (qsizetype i = createdNodes.size() - 1; i >= firstToken; i--)
+        deleteNode(createdNodes[i], descriptionCache);
+    createdNodes.resize(qMin(firstToken, createdNodes.size()));
+    states.resize(createdNodes.size() + 1);
+}
+
+void ExpressionSession::releaseInfixNodes()
+{
+    for (ExpressionNode* node : std::as_const(infixNodes))
+        deleteNode(node, descriptionCache);
+    infixNodes.clear();
+}
@@ -0,0 +1,151 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса ExpressionSession для пошагового перевода редактируемого выражения.
+ */
+
+#ifndef EXPRESSIONSESSION_H
+#define EXPRESSIONSESSION_H
+
+#include "descriptioncache.h"
+#include "expression.h"
+#include <QList>
+#include <QStack>
+
+/*!
+ * \brief Структура, описывающая объём работы последнего обновления сеанса.
+ */
+struct SessionUpdateStats {
+    qsizetype tokenizedLength = 0;  /*!< Длина участка выражения, заново разделённого на лексемы */
+    qsizetype replayedTokens = 0;   /*!< Количество лексем, обработанных построителем дерева заново */
+    qsizetype renderedNodes = 0;    /*!< Количество узлов, описания которых построены заново */
+    qsizetype cachedNodes = 0;      /*!< Количество поддеревьев, описания которых взяты из кэша */
+};
+
+/*!
+ * \brief Класс, поддерживающий пояснение выражения в актуальном состоянии при его редактировании.
+ *
+ * Объявления разбираются один раз при создании сеанса. При изменении выражения заново делятся на лексемы
+ * только лексемы, затронутые изменённым участком. Для обратной польской записи после каждой лексемы
+ * сохраняется состояние построителя дерева, поэтому узлы лексем до изменения используются повторно,
+ * а обрабатываются только лексемы, начиная с предшествующей изменению (её тип может зависеть от следующей
+ * лексемы). Описания неизменённых поддеревьев берутся из кэша, поэтому переводятся только узлы на пути от
+ * изменённых лексем к корню. Выражение в инфиксной записи разбирается заново целиком, но также использует
+ * кэш описаний.
+ *
+ * Пример использования:
+ * \code
+ * ExpressionSession session(document.declarations());
+ * session.update("a b +");
+ * TEResult<QString> explanation = session.replace(4, 1, "*");    // "a b *"
+ * \endcode
+ */
+class ExpressionSession
+{
+public:
+    /*!
+     * \brief Конструктор класса ExpressionSession.
+     * \param[in] declarations Выражение, объявления и форма записи которого используются сеансом.
+     */
+    explicit ExpressionSession(const Expression& declarations);
+
+    /*!
+     * \brief Деструктор; удаляет узлы деревьев сеанса.
+     */
+    ~ExpressionSession();
+
+    ExpressionSession(const ExpressionSession&) = delete;
+    ExpressionSession& operator=(const ExpressionSession&) = delete;
+
+    /*!
+     * \brief Замена всего выражения.
+     *
+     * Изменённый участок определяется по совпадающим началу и концу прежнего и нового выражения.
+     * \param[in] newExpression Новое выражение.
+     * \return Пояснение выражения либо ошибки построения дерева или перевода.
+     */
+    TEResult<QString> update(const QString& newExpression);
+
+    /*!
+     * \brief Замена участка выражения.
+     * \param[in] position Позиция начала участка.
+     * \param[in] length Длина заменяемого участка.
+     * \param[in] insertion Вставляемый текст.
+     * \return Пояснение выражения либо ошибки построения дерева или перевода.
+     */
+    TEResult<QString> replace(qsizetype position, qsizetype length, const QString& insertion);
+
+    /*!
+     * \brief Получение текущего выражения.
+     */
+    const QString& expression() const;
+
+    /*!
+     * \brief Получение корня дерева текущего выражения.
+     * \return Корневой узел либо nullptr, если дерево не построено.
+     */
+    const ExpressionNode* root() const;
+
+    /*!
+     * \brief Получение объёма работы последнего обновления.
+     */
+    const SessionUpdateStats& lastUpdate() const;
+
+    /*!
+     * \brief Получение пояснений всех поддеревьев текущего выражения.
+     * \param[in] grammaticalCase Падеж пояснений.
+     * \return Пояснения поддеревьев либо ошибки построения дерева или перевода.
+     */
+    TEResult<QList<SubtreeExplanation>> subtreeExplanations(Case grammaticalCase = Case::Nominative) const;
+
+private:
+    /*!
+     * \brief Состояние построителя дерева после обработки лексемы.
+     */
+    struct BuildState {
+        QStack<ExpressionNode*> nodeStack;      /*!< Стек узлов */
+        Expression::TreeBuildContext context;   /*!< Счётчик операций и маска использованных объявлений */
+    };
+
+    /*!
+     * \brief Разделение участка выражения на лексемы с их позициями.
+     * \param[in] from Позиция начала участка.
+     * \param[in] to Позиция конца участка.
+     */
+    QList<ExpressionToken> tokenize(qsizetype from, qsizetype to) const;
+
+    /*!
+     * \brief Построение дерева и перевод выражения после изменения лексем.
+     * \param[in] replayFrom Индекс первой лексемы, которую нужно обработать заново.
+     */
+    TEResult<QString> rebuild(qsizetype replayFrom);
+
+    /*!
+     * \brief Построение дерева выражения в обратной польской записи начиная с заданной лексемы.
+     * \param[in] replayFrom Индекс первой лексемы, которую нужно обработать заново.
+     * \param[out] errors Список ошибок.
+     * \return Корневой узел или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* buildPostfix(qsizetype replayFrom, QList<TEException>& errors);
+
+    /*!
+     * \brief Удаление узлов, созданных лексемами начиная с заданной.
+     */
+    void releaseNodes(qsizetype firstToken);
+
+    /*!
+     * \brief Удаление узлов дерева, построенного разбором инфиксной записи.
+     */
+    void releaseInfixNodes();
+
+    Expression declarations;                /*!< Объявления и текущее выражение */
+    QString text;                           /*!< Текущее выражение */
+    QList<ExpressionToken> tokens;          /*!< Лексемы текущего выражения */
+    QList<BuildState> states;               /*!< Состояния построителя: states[i] – после обработки i лексем */
+    QList<ExpressionNode*> createdNodes;     /*!< Узел, добавленный в стек каждой обработанной лексемой */
+    QList<ExpressionNode*> infixNodes;      /*!< Узлы дерева инфиксной записи */
+    ExpressionNode* rootNode = nullptr;     /*!< Корень дерева текущего выражения */
+    DescriptionCache descriptionCache;      /*!< Описания поддеревьев предыдущих переводов */
+    SessionUpdateStats stats;               /*!< Объём работы последнего обновления */
+};
+
+#endif // EXPRESSIONSESSION_H
@@ -1,443 +1,508 @@
 #include "expressiontranslator.h"
 #include "teexception.h"
+#include "inputbudget.h"
+#include "pipelinestats.h"
 
-const QHash<OperationType, QHash<Case, QString>> ExpressionTranslator::Templates = {
+namespace {
+/*!
+ * \brief Шаблон описания операции: формы в порядке перечисления Case.
+ */
+struct OperationTemplate {
+    OperationType type;                             /*!< Тип операции */
+    std::array<const char16_t*, CaseCount> forms;   /*!< Формы шаблона в падежах */
+};
+
+constexpr OperationTemplate OperationTemplates[] = {
     {
         OperationType::Addition, {
-            {Case::Nominative, "сумма {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "суммы {1 (р)} и {2 (р)}"},
-            {Case::Dative, "сумме {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "сумму {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "суммой {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "сумме {1 (р)} и {2 (р)}"}
+            u"сумма {1 (р)} и {2 (р)}",
+            u"суммы {1 (р)} и {2 (р)}",
+            u"сумме {1 (р)} и {2 (р)}",
+            u"сумму {1 (р)} и {2 (р)}",
+            u"суммой {1 (р)} и {2 (р)}",
+            u"сумме {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::Concatenation, {
-            {Case::Nominative, "конкатенация {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "конкатенации {1 (р)} и {2 (р)}"},
-            {Case::Dative, "конкатенации {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "конкатенацию {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "конкатенацией {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "конкатенации {1 (р)} и {2 (р)}"}
+            u"конкатенация {1 (р)} и {2 (р)}",
+            u"конкатенации {1 (р)} и {2 (р)}",
+            u"конкатенации {1 (р)} и {2 (р)}",
+            u"конкатенацию {1 (р)} и {2 (р)}",
+            u"конкатенацией {1 (р)} и {2 (р)}",
+            u"конкатенации {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::Subtraction, {
-            {Case::Nominative, "разность {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "разности {1 (р)} и {2 (р)}"},
-            {Case::Dative, "разности {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "разность {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "разностью {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "разности {1 (р)} и {2 (р)}"}
+            u"разность {1 (р)} и {2 (р)}",
+            u"разности {1 (р)} и {2 (р)}",
+            u"разности {1 (р)} и {2 (р)}",
+            u"разность {1 (р)} и {2 (р)}",
+            u"разностью {1 (р)} и {2 (р)}",
+            u"разности {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::And, {
-            {Case::Nominative, "{1 (и)} и {2 (и)}"},
-            {Case::Genitive, "{1 (р)} и {2 (р)}"},
-            {Case::Dative, "{1 (д)} и {2 (д)}"},
-            {Case::Accusative, "{1 (в)} и {2 (в)}"},
-            {Case::Instrumental, "{1 (т)} и {2 (т)}"},
-            {Case::Prepositional, "{1 (п)} и {2 (п)}"}
+            u"{1 (и)} и {2 (и)}",
+            u"{1 (р)} и {2 (р)}",
+            u"{1 (д)} и {2 (д)}",
+            u"{1 (в)} и {2 (в)}",
+            u"{1 (т)} и {2 (т)}",
+            u"{1 (п)} и {2 (п)}"
         }
     },
     {
         OperationType::Or, {
-            {Case::Nominative, "{1 (и)} или {2 (и)}"},
-            {Case::Genitive, "{1 (р)} или {2 (р)}"},
-            {Case::Dative, "{1 (д)} или {2 (д)}"},
-            {Case::Accusative, "{1 (в)} или {2 (в)}"},
-            {Case::Instrumental, "{1 (т)} или {2 (т)}"},
-            {Case::Prepositional, "{1 (п)} или {2 (п)}"}
+            u"{1 (и)} или {2 (и)}",
+            u"{1 (р)} или {2 (р)}",
+            u"{1 (д)} или {2 (д)}",
+            u"{1 (в)} или {2 (в)}",
+            u"{1 (т)} или {2 (т)}",
+            u"{1 (п)} или {2 (п)}"
         }
     },
     {
         OperationType::LessThanOrEqual, {
-            {Case::Nominative, "{1 (и)} меньше или равно {2 (д)}"},
-            {Case::Genitive, "{1 (р)} меньше или равно {2 (д)}"},
-            {Case::Dative, "{1 (д)} меньше или равно {2 (д)}"},
-            {Case::Accusative, "{1 (в)} меньше или равно {2 (д)}"},
-            {Case::Instrumental, "{1 (т)} меньше или равно {2 (д)}"},
-            {Case::Prepositional, "{1 (п)} меньше или равно {2 (д)}"}
+            u"{1 (и)} меньше или равно {2 (д)}",
+            u"{1 (р)} меньше или равно {2 (д)}",
+            u"{1 (д)} меньше или равно {2 (д)}",
+            u"{1 (в)} меньше или равно {2 (д)}",
+            u"{1 (т)} меньше или равно {2 (д)}",
+            u"{1 (п)} меньше или равно {2 (д)}"
         }
     },
     {
         OperationType::GreaterThan, {
-            {Case::Nominative, "{1 (и)} больше {2 (р)}"},
-            {Case::Genitive, "{1 (р)} больше {2 (р)}"},
-            {Case::Dative, "{1 (д)} больше {2 (р)}"},
-            {Case::Accusative, "{1 (в)} больше {2 (р)}"},
-            {Case::Instrumental, "{1 (т)} больше {2 (р)}"},
-            {Case::Prepositional, "{1 (п)} больше {2 (р)}"}
+            u"{1 (и)} больше {2 (р)}",
+            u"{1 (р)} больше {2 (р)}",
+            u"{1 (д)} больше {2 (р)}",
+            u"{1 (в)} больше {2 (р)}",
+            u"{1 (т)} больше {2 (р)}",
+            u"{1 (п)} больше {2 (р)}"
         }
     },
     {
         OperationType::NotEqual, {
-            {Case::Nominative, "{1 (и)} не равно {2 (д)}"},
-            {Case::Genitive, "{1 (р)} не равно {2 (д)}"},
-            {Case::Dative, "{1 (д)} не равно {2 (д)}"},
-            {Case::Accusative, "{1 (в)} не равно {2 (д)}"},
-            {Case::Instrumental, "{1 (т)} не равно {2 (д)}"},
-            {Case::Prepositional, "{1 (п)} не равно {2 (д)}"}
+            u"{1 (и)} не равно {2 (д)}",
+            u"{1 (р)} не равно {2 (д)}",
+            u"{1 (д)} не равно {2 (д)}",
+            u"{1 (в)} не равно {2 (д)}",
+            u"{1 (т)} не равно {2 (д)}",
+            u"{1 (п)} не равно {2 (д)}"
         }
     },
     {
         OperationType::Equal, {
-            {Case::Nominative, "{1 (и)} равно {2 (д)}"},
-            {Case::Genitive, "{1 (р)} равно {2 (д)}"},
-            {Case::Dative, "{1 (д)} равно {2 (д)}"},
-            {Case::Accusative, "{1 (в)} равно {2 (д)}"},
-            {Case::Instrumental, "{1 (т)} равно {2 (д)}"},
-            {Case::Prepositional, "{1 (п)} равно {2 (д)}"}
+            u"{1 (и)} равно {2 (д)}",
+            u"{1 (р)} равно {2 (д)}",
+            u"{1 (д)} равно {2 (д)}",
+            u"{1 (в)} равно {2 (д)}",
+            u"{1 (т)} равно {2 (д)}",
+            u"{1 (п)} равно {2 (д)}"
         }
     },
     {
         OperationType::LessThan, {
-            {Case::Nominative, "{1 (и)} меньше {2 (р)}"},
-            {Case::Genitive, "{1 (р)} меньше {2 (р)}"},
-            {Case::Dative, "{1 (д)} меньше {2 (р)}"},
-            {Case::Accusative, "{1 (в)} меньше {2 (р)}"},
-            {Case::Instrumental, "{1 (т)} меньше {2 (р)}"},
-            {Case::Prepositional, "{1 (п)} меньше {2 (р)}"}
+            u"{1 (и)} меньше {2 (р)}",
+            u"{1 (р)} меньше {2 (р)}",
+            u"{1 (д)} меньше {2 (р)}",
+            u"{1 (в)} меньше {2 (р)}",
+            u"{1 (т)} меньше {2 (р)}",
+            u"{1 (п)} меньше {2 (р)}"
         }
     },
     {
         OperationType::GreaterThanOrEqual, {
-            {Case::Nominative, "{1 (и)} больше или равно {2 (д)}"},
-            {Case::Genitive, "{1 (р)} больше или равно {2 (д)}"},
-            {Case::Dative, "{1 (д)} больше или равно {2 (д)}"},
-            {Case::Accusative, "{1 (в)} больше или равно {2 (д)}"},
-            {Case::Instrumental, "{1 (т)} больше или равно {2 (д)}"},
-            {Case::Prepositional, "{1 (п)} больше или равно {2 (д)}"}
+            u"{1 (и)} больше или равно {2 (д)}",
+            u"{1 (р)} больше или равно {2 (д)}",
+            u"{1 (д)} больше или равно {2 (д)}",
+            u"{1 (в)} больше или равно {2 (д)}",
+            u"{1 (т)} больше или равно {2 (д)}",
+            u"{1 (п)} больше или равно {2 (д)}"
         }
     },
     {
         OperationType::Multiplication, {
-            {Case::Nominative, "произведение {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "произведения {1 (р)} и {2 (р)}"},
-            {Case::Dative, "произведению {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "произведение {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "произведением {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "произведении {1 (р)} и {2 (р)}"}
+            u"произведение {1 (р)} и {2 (р)}",
+            u"произведения {1 (р)} и {2 (р)}",
+            u"произведению {1 (р)} и {2 (р)}",
+            u"произведение {1 (р)} и {2 (р)}",
+            u"произведением {1 (р)} и {2 (р)}",
+            u"произведении {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::Division, {
-            {Case::Nominative, "частное {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "частного {1 (р)} и {2 (р)}"},
-            {Case::Dative, "частному {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "частное {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "частным {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "частном {1 (р)} и {2 (р)}"}
+            u"частное {1 (р)} и {2 (р)}",
+            u"частного {1 (р)} и {2 (р)}",
+            u"частному {1 (р)} и {2 (р)}",
+            u"частное {1 (р)} и {2 (р)}",
+            u"частным {1 (р)} и {2 (р)}",
+            u"частном {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::Modulus, {
-            {Case::Nominative, "остаток от деления {1 (р)} на {2 (и)}"},
-            {Case::Genitive, "остатка от деления {1 (р)} на {2 (и)}"},
-            {Case::Dative, "остатку от деления {1 (р)} на {2 (и)}"},
-            {Case::Accusative, "остаток от деления {1 (р)} на {2 (и)}"},
-            {Case::Instrumental, "остатком от деления {1 (р)} на {2 (и)}"},
-            {Case::Prepositional, "остатке от деления {1 (р)} на {2 (и)}"}
+            u"остаток от деления {1 (р)} на {2 (и)}",
+            u"остатка от деления {1 (р)} на {2 (и)}",
+            u"остатку от деления {1 (р)} на {2 (и)}",
+            u"остаток от деления {1 (р)} на {2 (и)}",
+            u"остатком от деления {1 (р)} на {2 (и)}",
+            u"остатке от деления {1 (р)} на {2 (и)}"
         }
     },
     {
         OperationType::Not, {
-            {Case::Nominative, "не {1 (и)}"},
-            {Case::Genitive, "не {1 (р)}"},
-            {Case::Dative, "не {1 (д)}"},
-            {Case::Accusative, "не {1 (в)}"},
-            {Case::Instrumental, "не {1 (т)}"},
-            {Case::Prepositional, "не {1 (п)}"}
+            u"не {1 (и)}",
+            u"не {1 (р)}",
+            u"не {1 (д)}",
+            u"не {1 (в)}",
+            u"не {1 (т)}",
+            u"не {1 (п)}"
         }
     },
     {
         OperationType::UnaryMinus, {
-            {Case::Nominative, "отрицание {1 (р)}"},
-            {Case::Genitive, "отрицания {1 (р)}"},
-            {Case::Dative, "отрицанию {1 (р)}"},
-            {Case::Accusative, "отрицание {1 (р)}"},
-            {Case::Instrumental, "отрицанием {1 (р)}"},
-            {Case::Prepositional, "отрицании {1 (р)}"}
+            u"отрицание {1 (р)}",
+            u"отрицания {1 (р)}",
+            u"отрицанию {1 (р)}",
+            u"отрицание {1 (р)}",
+            u"отрицанием {1 (р)}",
+            u"отрицании {1 (р)}"
         }
     },
     {
         OperationType::AddressOf, {
-            {Case::Nominative, "адрес элемента {1 (р)}"},
-            {Case::Genitive, "адреса элемента {1 (р)}"},
-            {Case::Dative, "адресу элемента {1 (р)}"},
-            {Case::Accusative, "адрес элемента {1 (р)}"},
-            {Case::Instrumental, "адресом элемента {1 (р)}"},
-            {Case::Prepositional, "адресе элемента {1 (р)}"}
+            u"адрес элемента {1 (р)}",
+            u"адреса элемента {1 (р)}",
+            u"адресу элемента {1 (р)}",
+            u"адрес элемента {1 (р)}",
+            u"адресом элемента {1 (р)}",
+            u"адресе элемента {1 (р)}"
         }
     },
     {
         OperationType::Dereference, {
-            {Case::Nominative, "обращение к значению по адресу {1 (р)}"},
-            {Case::Genitive, "обращения к значению по адресу {1 (р)}"},
-            {Case::Dative, "обращению к значению по адресу {1 (р)}"},
-            {Case::Accusative, "обращение к значению по адресу {1 (р)}"},
-            {Case::Instrumental, "обращением к значению по адресу {1 (р)}"},
-            {Case::Prepositional, "обращении к значению по адресу {1 (р)}"}
+            u"обращение к значению по адресу {1 (р)}",
+            u"обращения к значению по адресу {1 (р)}",
+            u"обращению к значению по адресу {1 (р)}",
+            u"обращение к значению по адресу {1 (р)}",
+            u"обращением к значению по адресу {1 (р)}",
+            u"обращении к значению по адресу {1 (р)}"
         }
     },
     {
         OperationType::ArrayAccess, {
-            {Case::Nominative, "элемент под индексом {2 (и)} массива {1 (р)}"},
-            {Case::Genitive, "элемента под индексом {2 (и)} массива {1 (р)}"},
-            {Case::Dative, "элементу под индексом {2 (и)} массива {1 (р)}"},
-            {Case::Accusative, "элемент под индексом {2 (и)} массива {1 (р)}"},
-            {Case::Instrumental, "элементом под индексом {2 (и)} массива {1 (р)}"},
-            {Case::Prepositional, "элементе под индексом {2 (и)} массива {1 (р)}"}
+            u"элемент под индексом {2 (и)} массива {1 (р)}",
+            u"элемента под индексом {2 (и)} массива {1 (р)}",
+            u"элементу под индексом {2 (и)} массива {1 (р)}",
+            u"элемент под индексом {2 (и)} массива {1 (р)}",
+            u"элементом под индексом {2 (и)} массива {1 (р)}",
+            u"элементе под индексом {2 (и)} массива {1 (р)}"
         }
     },
     {
         OperationType::FieldAccess, {
-            {Case::Nominative, "{2 (и)} {1 (р)}"},
-            {Case::Genitive, "{2 (р)} {1 (р)}"},
-            {Case::Dative, "{2 (д)} {1 (р)}"},
-            {Case::Accusative, "{2 (в)} {1 (р)}"},
-            {Case::Instrumental, "{2 (т)} {1 (р)}"},
-            {Case::Prepositional, "{2 (п)} {1 (р)}"}
+            u"{2 (и)} {1 (р)}",
+            u"{2 (р)} {1 (р)}",
+            u"{2 (д)} {1 (р)}",
+            u"{2 (в)} {1 (р)}",
+            u"{2 (т)} {1 (р)}",
+            u"{2 (п)} {1 (р)}"
         }
     },
     {
         OperationType::PointerFieldAccess, {
-            {Case::Nominative, "{2 (и)} {1 (р)}"},
-            {Case::Genitive, "{2 (р)} {1 (р)}"},
-            {Case::Dative, "{2 (д)} {1 (р)}"},
-            {Case::Accusative, "{2 (в)} {1 (р)}"},
-            {Case::Instrumental, "{2 (т)} {1 (р)}"},
-            {Case::Prepositional, "{2 (п)} {1 (р)}"}
+            u"{2 (и)} {1 (р)}",
+            u"{2 (р)} {1 (р)}",
+            u"{2 (д)} {1 (р)}",
+            u"{2 (в)} {1 (р)}",
+            u"{2 (т)} {1 (р)}",
+            u"{2 (п)} {1 (р)}"
         }
     },
     {
         OperationType::StaticMemberAccess, {
-            {Case::Nominative, "{2 (и)}"},
-            {Case::Genitive, "{2 (р)}"},
-            {Case::Dative, "{2 (д)}"},
-            {Case::Accusative, "{2 (в)}"},
-            {Case::Instrumental, "{2 (т)}"},
-            {Case::Prepositional, "{2 (п)}"}
+            u"{2 (и)}",
+            u"{2 (р)}",
+            u"{2 (д)}",
+            u"{2 (в)}",
+            u"{2 (т)}",
+            u"{2 (п)}"
         }
     },
     {
         OperationType::PrefixIncrement, {
-            {Case::Nominative, "инкрементировать {1 (в)}, а затем получить {2 (в)}"},
-            {Case::Genitive, "инкрементирования {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Dative, "инкрементированию {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Accusative, "инкрементирование {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Instrumental, "инкрементированием {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Prepositional, "инкрементировании {1 (р)}, а затем получить {2 (в)}"}
+            u"инкрементировать {1 (в)}, а затем получить {2 (в)}",
+            u"инкрементирования {1 (р)}, а затем получить {2 (в)}",
+            u"инкрементированию {1 (р)}, а затем получить {2 (в)}",
+            u"инкрементирование {1 (р)}, а затем получить {2 (в)}",
+            u"инкрементированием {1 (р)}, а затем получить {2 (в)}",
+            u"инкрементировании {1 (р)}, а затем получить {2 (в)}"
         }
     },
     {
         OperationType::PostfixIncrement, {
-            {Case::Nominative, "получить {2 (в)}, а затем инкрементировать {1 (в)}"},
-            {Case::Genitive, "получения {2 (р)}, а затем инкрементировать {1 (в)}"},
-            {Case::Dative, "получению {2 (р)}, а затем инкрементировать {1 (в)}"},
-            {Case::Accusative, "получение {2 (р)}, а затем инкрементировать {1 (в)}"},
-            {Case::Instrumental, "получением {2 (р)}, а затем инкрементировать {1 (в)}"},
-            {Case::Prepositional, "получении {2 (р)}, а затем инкрементировать {1 (в)}"}
+            u"получить {2 (в)}, а затем инкрементировать {1 (в)}",
+            u"получения {2 (р)}, а затем инкрементировать {1 (в)}",
+            u"получению {2 (р)}, а затем инкрементировать {1 (в)}",
+            u"получение {2 (р)}, а затем инкрементировать {1 (в)}",
+            u"получением {2 (р)}, а затем инкрементировать {1 (в)}",
+            u"получении {2 (р)}, а затем инкрементировать {1 (в)}"
         }
     },
     {
         OperationType::PrefixDecrement, {
-            {Case::Nominative, "декрементировать {1 (в)}, а затем получить {2 (в)}"},
-            {Case::Genitive, "декрементирования {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Dative, "декрементированию {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Accusative, "декрементирование {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Instrumental, "декрементированием {1 (р)}, а затем получить {2 (в)}"},
-            {Case::Prepositional, "декрементировании {1 (р)}, а затем получить {2 (в)}"}
+            u"декрементировать {1 (в)}, а затем получить {2 (в)}",
+            u"декрементирования {1 (р)}, а затем получить {2 (в)}",
+            u"декрементированию {1 (р)}, а затем получить {2 (в)}",
+            u"декрементирование {1 (р)}, а затем получить {2 (в)}",
+            u"декрементированием {1 (р)}, а затем получить {2 (в)}",
+            u"декрементировании {1 (р)}, а затем получить {2 (в)}"
         }
     },
     {
         OperationType::PostfixDecrement, {
-            {Case::Nominative, "получить {2 (в)}, а затем декрементировать {1 (в)}"},
-            {Case::Genitive, "получения {2 (р)}, а затем декрементировать {1 (в)}"},
-            {Case::Dative, "получению {2 (р)}, а затем декрементировать {1 (в)}"},
-            {Case::Accusative, "получение {2 (р)}, а затем декрементировать {1 (в)}"},
-            {Case::Instrumental, "получением {2 (р)}, а затем декрементировать {1 (в)}"},
-            {Case::Prepositional, "получении {2 (р)}, а затем декрементировать {1 (в)}"}
+            u"получить {2 (в)}, а затем декрементировать {1 (в)}",
+            u"получения {2 (р)}, а затем декрементировать {1 (в)}",
+            u"получению {2 (р)}, а затем декрементировать {1 (в)}",
+            u"получение {2 (р)}, а затем декрементировать {1 (в)}",
+            u"получением {2 (р)}, а затем декрементировать {1 (в)}",
+            u"получении {2 (р)}, а затем декрементировать {1 (в)}"
         }
     },
     {
         OperationType::Assignment, {
-            {Case::Nominative, "присваивание {1 (д)} значения {2 (р)}"},
-            {Case::Genitive, "присваивания {1 (д)} значения {2 (р)}"},
-            {Case::Dative, "присваиванию {1 (д)} значения {2 (р)}"},
-            {Case::Accusative, "присваивание {1 (д)} значения {2 (р)}"},
-            {Case::Instrumental, "присваиванием {1 (д)} значения {2 (р)}"},
-            {Case::Prepositional, "присваивании {1 (д)} значения {2 (р)}"}
+            u"присваивание {1 (д)} значения {2 (р)}",
+            u"присваивания {1 (д)} значения {2 (р)}",
+            u"присваиванию {1 (д)} значения {2 (р)}",
+            u"присваивание {1 (д)} значения {2 (р)}",
+            u"присваиванием {1 (д)} значения {2 (р)}",
+            u"присваивании {1 (д)} значения {2 (р)}"
         }
     },
     {
         OperationType::AdditionAssignment, {
-            {Case::Nominative, "присваивание {1 (д)} суммы {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "присваивания {1 (д)} суммы {1 (р)} и {2 (р)}"},
-            {Case::Dative, "присваиванию {1 (д)} суммы {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "присваивание {1 (д)} суммы {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "присваиванием {1 (д)} суммы {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "присваивании {1 (д)} суммы {1 (р)} и {2 (р)}"}
+            u"присваивание {1 (д)} суммы {1 (р)} и {2 (р)}",
+            u"присваивания {1 (д)} суммы {1 (р)} и {2 (р)}",
+            u"присваиванию {1 (д)} суммы {1 (р)} и {2 (р)}",
+            u"присваивание {1 (д)} суммы {1 (р)} и {2 (р)}",
+            u"присваиванием {1 (д)} суммы {1 (р)} и {2 (р)}",
+            u"присваивании {1 (д)} суммы {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::SubtractionAssignment, {
-            {Case::Nominative, "присваивание {1 (д)} разности {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "присваивания {1 (д)} разности {1 (р)} и {2 (р)}"},
-            {Case::Dative, "присваиванию {1 (д)} разности {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "присваивание {1 (д)} разности {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "присваиванием {1 (д)} разности {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "присваивании {1 (д)} разности {1 (р)} и {2 (р)}"}
+            u"присваивание {1 (д)} разности {1 (р)} и {2 (р)}",
+            u"присваивания {1 (д)} разности {1 (р)} и {2 (р)}",
+            u"присваиванию {1 (д)} разности {1 (р)} и {2 (р)}",
+            u"присваивание {1 (д)} разности {1 (р)} и {2 (р)}",
+            u"присваиванием {1 (д)} разности {1 (р)} и {2 (р)}",
+            u"присваивании {1 (д)} разности {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::MultiplicationAssignment, {
-            {Case::Nominative, "присваивание {1 (д)} произведения {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "присваивания {1 (д)} произведения {1 (р)} и {2 (р)}"},
-            {Case::Dative, "присваиванию {1 (д)} произведения {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "присваивание {1 (д)} произведения {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "присваиванием {1 (д)} произведения {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "присваивании {1 (д)} произведения {1 (р)} и {2 (р)}"}
+            u"присваивание {1 (д)} произведения {1 (р)} и {2 (р)}",
+            u"присваивания {1 (д)} произведения {1 (р)} и {2 (р)}",
+            u"присваиванию {1 (д)} произведения {1 (р)} и {2 (р)}",
+            u"присваивание {1 (д)} произведения {1 (р)} и {2 (р)}",
+            u"присваиванием {1 (д)} произведения {1 (р)} и {2 (р)}",
+            u"присваивании {1 (д)} произведения {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::DivisionAssignment, {
-            {Case::Nominative, "присваивание {1 (д)} частного {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "присваивания {1 (д)} частного {1 (р)} и {2 (р)}"},
-            {Case::Dative, "присваиванию {1 (д)} частного {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "присваивание {1 (д)} частного {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "присваиванием {1 (д)} частного {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "присваивании {1 (д)} частного {1 (р)} и {2 (р)}"}
+            u"присваивание {1 (д)} частного {1 (р)} и {2 (р)}",
+            u"присваивания {1 (д)} частного {1 (р)} и {2 (р)}",
+            u"присваиванию {1 (д)} частного {1 (р)} и {2 (р)}",
+            u"присваивание {1 (д)} частного {1 (р)} и {2 (р)}",
+            u"присваиванием {1 (д)} частного {1 (р)} и {2 (р)}",
+            u"присваивании {1 (д)} частного {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::ModulusAssignment, {
-            {Case::Nominative, "присваивание {1 (д)} остатка от деления {1 (р)} и {2 (р)}"},
-            {Case::Genitive, "присваивания {1 (д)} остатка от деления {1 (р)} и {2 (р)}"},
-            {Case::Dative, "присваиванию {1 (д)} остатка от деления {1 (р)} и {2 (р)}"},
-            {Case::Accusative, "присваивание {1 (д)} остатка от деления {1 (р)} и {2 (р)}"},
-            {Case::Instrumental, "присваиванием {1 (д)} остатка от деления {1 (р)} и {2 (р)}"},
-            {Case::Prepositional, "присваивании {1 (д)} остатка от деления {1 (р)} и {2 (р)}"}
+            u"присваивание {1 (д)} остатка от деления {1 (р)} и {2 (р)}",
+            u"присваивания {1 (д)} остатка от деления {1 (р)} и {2 (р)}",
+            u"присваиванию {1 (д)} остатка от деления {1 (р)} и {2 (р)}",
+            u"присваивание {1 (д)} остатка от деления {1 (р)} и {2 (р)}",
+            u"присваиванием {1 (д)} остатка от деления {1 (р)} и {2 (р)}",
+            u"присваивании {1 (д)} остатка от деления {1 (р)} и {2 (р)}"
         }
     },
     {
         OperationType::NotLessThan, {
-            {Case::Nominative, "{1 (и)} не меньше {2 (р)}"},
-            {Case::Genitive, "{1 (р)} не меньше {2 (р)}"},
-            {Case::Dative, "{1 (д)} не меньше {2 (р)}"},
-            {Case::Accusative, "{1 (в)} не меньше {2 (р)}"},
-            {Case::Instrumental, "{1 (т)} не меньше {2 (р)}"},
-            {Case::Prepositional, "{1 (п)} не меньше {2 (р)}"}
+            u"{1 (и)} не меньше {2 (р)}",
+            u"{1 (р)} не меньше {2 (р)}",
+            u"{1 (д)} не меньше {2 (р)}",
+            u"{1 (в)} не меньше {2 (р)}",
+            u"{1 (т)} не меньше {2 (р)}",
+            u"{1 (п)} не меньше {2 (р)}"
         }
     },
     {
         OperationType::NotLessThanOrEqual, {
-            {Case::Nominative, "{1 (и)} не меньше или равно {2 (р)}"},
-            {Case::Genitive, "{1 (р)} не меньше или равно {2 (р)}"},
-            {Case::Dative, "{1 (д)} не меньше или равно {2 (р)}"},
-            {Case::Accusative, "{1 (в)} не меньше или равно {2 (р)}"},
-            {Case::Instrumental, "{1 (т)} не меньше или равно {2 (р)}"},
-            {Case::Prepositional, "{1 (п)} не меньше или равно {2 (р)}"}
+            u"{1 (и)} не меньше или равно {2 (р)}",
+            u"{1 (р)} не меньше или равно {2 (р)}",
+            u"{1 (д)} не меньше или равно {2 (р)}",
+            u"{1 (в)} не меньше или равно {2 (р)}",
+            u"{1 (т)} не меньше или равно {2 (р)}",
+            u"{1 (п)} не меньше или равно {2 (р)}"
         }
     },
     {
         OperationType::NotGreaterThan, {
-            {Case::Nominative, "{1 (и)} не больше {2 (р)}"},
-            {Case::Genitive, "{1 (р)} не больше {2 (р)}"},
-            {Case::Dative, "{1 (д)} не больше {2 (р)}"},
-            {Case::Accusative, "{1 (в)} не больше {2 (р)}"},
-            {Case::Instrumental, "{1 (т)} не больше {2 (р)}"},
-            {Case::Prepositional, "{1 (п)} не больше {2 (р)}"}
+            u"{1 (и)} не больше {2 (р)}",
+            u"{1 (р)} не больше {2 (р)}",
+            u"{1 (д)} не больше {2 (р)}",
+            u"{1 (в)} не больше {2 (р)}",
+            u"{1 (т)} не больше {2 (р)}",
+            u"{1 (п)} не больше {2 (р)}"
         }
     },
     {
         OperationType::NotGreaterThanOrEqual, {
-            {Case::Nominative, "{1 (и)} не больше или равно {2 (р)}"},
-            {Case::Genitive, "{1 (р)} не больше или равно {2 (р)}"},
-            {Case::Dative, "{1 (д)} не больше или равно {2 (р)}"},
-            {Case::Accusative, "{1 (в)} не больше или равно {2 (р)}"},
-            {Case::Instrumental, "{1 (т)} не больше или равно {2 (р)}"},
-            {Case::Prepositional, "{1 (п)} не больше или равно {2 (р)}"}
+            u"{1 (и)} не больше или равно {2 (р)}",
+            u"{1 (р)} не больше или равно {2 (р)}",
+            u"{1 (д)} не больше или равно {2 (р)}",
+            u"{1 (в)} не больше или равно {2 (р)}",
+            u"{1 (т)} не больше или равно {2 (р)}",
+            u"{1 (п)} не больше или равно {2 (р)}"
         }
     },
     {
         OperationType::PointerIndexAccess, {
-            {Case::Nominative, "получение элемента по индексу, равному указателю {1 (р)}"},
-            {Case::Genitive, "получения элемента по индексу, равному указателю {1 (р)}"},
-            {Case::Dative, "получению элемента по индексу, равному указателю {1 (р)}"},
-            {Case::Accusative, "получение элемента по индексу, равному указателю {1 (р)}"},
-            {Case::Instrumental, "получением элемента по индексу, равному указателю {1 (р)}"},
-            {Case::Prepositional, "получении элемента по индексу, равному указателю {1 (р)}"}
+            u"получение элемента по индексу, равному указателю {1 (р)}",
+            u"получения элемента по индексу, равному указателю {1 (р)}",
+            u"получению элемента по индексу, равному указателю {1 (р)}",
+            u"получение элемента по индексу, равному указателю {1 (р)}",
+            u"получением элемента по индексу, равному указателю {1 (р)}",
+            u"получении элемента по индексу, равному указателю {1 (р)}"
         }
     },
     {
         OperationType::SubtractionSequence, {
-            {Case::Nominative, "разность {1 (р)} и суммы {2 (р)}"},
-            {Case::Genitive, "разности {1 (р)} и суммы {2 (р)}"},
-            {Case::Dative, "разности {1 (р)} и суммы {2 (р)}"},
-            {Case::Accusative, "разность {1 (р)} и суммы {2 (р)}"},
-            {Case::Instrumental, "разностью {1 (р)} и суммы {2 (р)}"},
-            {Case::Prepositional, "разности {1 (р)} и суммы {2 (р)}"}
+            u"разность {1 (р)} и суммы {2 (р)}",
+            u"разности {1 (р)} и суммы {2 (р)}",
+            u"разности {1 (р)} и суммы {2 (р)}",
+            u"разность {1 (р)} и суммы {2 (р)}",
+            u"разностью {1 (р)} и суммы {2 (р)}",
+            u"разности {1 (р)} и суммы {2 (р)}"
         }
     },
     {
         OperationType::DivisionSequence, {
-            {Case::Nominative, "частное {1 (р)} и произведения {2 (р)}"},
-            {Case::Genitive, "частного {1 (р)} и произведения {2 (р)}"},
-            {Case::Dative, "частному {1 (р)} и произведения {2 (р)}"},
-            {Case::Accusative, "частное {1 (р)} и произведения {2 (р)}"},
-            {Case::Instrumental, "частным {1 (р)} и произведения {2 (р)}"},
-            {Case::Prepositional, "частном {1 (р)} и произведения {2 (р)}"}
+            u"частное {1 (р)} и произведения {2 (р)}",
+            u"частного {1 (р)} и произведения {2 (р)}",
+            u"частному {1 (р)} и произведения {2 (р)}",
+            u"частное {1 (р)} и произведения {2 (р)}",
+            u"частным {1 (р)} и произведения {2 (р)}",
+            u"частном {1 (р)} и произведения {2 (р)}"
         }
     },
     {
         OperationType::SingleIncrement, {
-            {Case::Nominative, "инкрементировать {1 (в)}"},
-            {Case::Genitive, "инкрементирования {1 (р)}"},
-            {Case::Dative, "инкрементированию {1 (р)}"},
-            {Case::Accusative, "инкрементирование {1 (р)}"},
-            {Case::Instrumental, "инкрементированием {1 (р)}"},
-            {Case::Prepositional, "инкрементировании {1 (р)}"}
+            u"инкрементировать {1 (в)}",
+            u"инкрементирования {1 (р)}",
+            u"инкрементированию {1 (р)}",
+            u"инкрементирование {1 (р)}",
+            u"инкрементированием {1 (р)}",
+            u"инкрементировании {1 (р)}"
         }
     },
     {
         OperationType::SingleDecrement, {
-            {Case::Nominative, "декрементировать {1 (в)}"},
-            {Case::Genitive, "декрементирования {1 (р)}"},
-            {Case::Dative, "декрементированию {1 (р)}"},
-            {Case::Accusative, "декрементирование {1 (р)}"},
-            {Case::Instrumental, "декрементированием {1 (р)}"},
-            {Case::Prepositional, "декрементировании {1 (р)}"}
+            u"декрементировать {1 (в)}",
+            u"декрементирования {1 (р)}",
+            u"декрементированию {1 (р)}",
+            u"декрементирование {1 (р)}",
+            u"декрементированием {1 (р)}",
+            u"декрементировании {1 (р)}"
         }
-    },
-
+    }
 };
 
+/*!
+ * \brief Построение таблицы шаблонов, индексируемой типом операции.
+ */
+constexpr std::array<std::array<const char16_t*, CaseCount>, OperationTypeCount> makeTemplateTable()
+{
+    std::array<std::array<const char16_t*, CaseCount>, OperationTypeCount> table{};
+    for (const OperationTemplate& operationTemplate : OperationTemplates)
+        table[static_cast<int>(operationTemplate.type)] = operationTemplate.forms;
+    return table;
+}
+
+constexpr std::array<std::array<const char16_t*, CaseCount>, OperationTypeCount> TemplateTable = makeTemplateTable();
+
+/*!
+ * \brief Создание регулярного выражения для поиска плейсхолдеров вида {1 (р)}.
+ */
+QRegularExpression createPlaceholderRegex()
+{
+    return QRegularExpression(QStringLiteral(R"(\{\s*(\d+)\s*\(\s*([а-яА-ЯёЁ])\s*\)\s*\})"));
+}
+}
+
 ExpressionTranslator::ExpressionTranslator() {}
 
 QHash<Case, QString> ExpressionTranslator::getExplanation(const QHash<Case, QString> &description, const QList<QHash<Case, QString> > &arguments)
 {
-    QHash<Case, QString> pattern = {};
-    QRegularExpression placeholderRegex(R"(\{\s*(\d+)\s*\(\s*([а-яА-ЯёЁ])\s*\)\s*\})");
+    return getExplanation(CaseDescription(description), QList<CaseDescription>(arguments.cbegin(), arguments.cend())).toHash();
+}
+
+CaseDescription ExpressionTranslator::getExplanation(const CaseDescription &description, const QList<CaseDescription> &arguments)
+{
+    CaseDescription pattern;
+    QRegularExpression placeholderRegex = createPlaceholderRegex();
+    PipelineStats::add(PipelineCounter::TemplateRenders);
 
     // Подставить аргументы во все падежи
-    for (Case c : {Case::Nominative, Case::Genitive, Case::Dative,
-                   Case::Accusative, Case::Instrumental, Case::Prepositional}) {
-        pattern.insert(c, replacePlaceholders(description[c], arguments, placeholderRegex));
+    for (int c = 0; c < CaseCount; ++c) {
+        QString explanation = replacePlaceholders(description.value(static_cast<Case>(c)), arguments, placeholderRegex);
+        chargeOutput(explanation);
+        pattern.insert(static_cast<Case>(c), explanation);
+    }
+
+    return pattern;
+}
+
+QHash<Case, QString> ExpressionTranslator::getExplanation(OperationType operation, const QList<QHash<Case, QString> > &arguments)
+{
+    return getExplanation(operation, QList<CaseDescription>(arguments.cbegin(), arguments.cend())).toHash();
+}
+
+CaseDescription ExpressionTranslator::getExplanation(OperationType operation, const QList<CaseDescription> &arguments)
+{
+    CaseDescription pattern;
+    QRegularExpression placeholderRegex = createPlaceholderRegex();
+    PipelineStats::add(PipelineCounter::TemplateRenders);
+
+    // Подставить аргументы во все падежи шаблона операции без копирования строк шаблона
+    const std::array<const char16_t*, CaseCount>& forms = TemplateTable[static_cast<int>(operation)];
+    for (int c = 0; c < CaseCount; ++c) {
+        const char16_t* form = forms[c] != nullptr ? forms[c] : u"";
+        QString description = QString::fromRawData(reinterpret_cast<const QChar*>(form), std::char_traits<char16_t>::length(form));
+        QString explanation = replacePlaceholders(description, arguments, placeholderRegex);
+        chargeOutput(explanation);
+        pattern.insert(static_cast<Case>(c), explanation);
     }
 
     return pattern;
 }
 
-QString ExpressionTranslator::replacePlaceholders(const QString &pattern, const QList<QHash<Case, QString> > &args, QRegularExpression &placeholderRegex)
+QString ExpressionTranslator::replacePlaceholders(const QString &pattern, const QList<CaseDescription> &args, QRegularExpression &placeholderRegex)
 {
     QString patternCopy = pattern;
     QRegularExpressionMatchIterator it = placeholderRegex.globalMatch(pattern);
 
     // Пока есть вхождения плейсхолдера
     while (it.hasNext()) {
+        // Длинный шаблон прерывается при превышении времени обработки
+        InputBudget::charge(BudgetResource::WallTime);
         QRegularExpressionMatch match = it.next();
         int index = match.captured(1).toInt() - 1;
         QString caseStr = match.captured(2);
@@ -448,6 +513,7 @@ QString ExpressionTranslator::replacePlaceholders(const QString &pattern, const
 
             // Заменить плейсхолдер в результирующей строке на соответствующий аргумент в указанном падеже
             patternCopy.replace(match.captured(0), replacement);
+            PipelineStats::add(PipelineCounter::PlaceholderSubstitutions);
         }
         // Иначе вызвать ошибку
         else throw TEException(ErrorType::MissingReplacementArguments, QList<QString>{pattern});
@@ -455,6 +521,12 @@ QString ExpressionTranslator::replacePlaceholders(const QString &pattern, const
     return patternCopy;
 }
 
+void ExpressionTranslator::chargeOutput(const QString &description)
+{
+    InputBudget::charge(BudgetResource::OutputLength, description.size());
+    InputBudget::charge(BudgetResource::Bytes, description.size() * qint64(sizeof(QChar)));
+}
+
 Case ExpressionTranslator::parseCase(const QString &caseChar) {
     if (caseChar == "и")      return Case::Nominative;      // Именительный
     else if (caseChar == "р") return Case::Genitive;        // Родительный
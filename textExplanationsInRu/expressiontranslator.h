@@ -27,19 +27,44 @@ public:
     ExpressionTranslator();
 
     /*!
-     * \brief Словарь шаблонов операций с падежными формами.
+     * \brief Генерация пояснения (описания) выражения на основе шаблона и аргументов.
+     * \param[in] description Шаблон описания операции с подстановочными элементами.
+     * \param[in] arguments Список аргументов в разных падежах.
+     * \return Результат с подставленными аргументами.
+     * \throw TEException Ошибка плейсхолдера или BudgetExceeded при превышении бюджета входного файла.
+     */
+    static QHash<Case, QString> getExplanation(const QHash<Case, QString> &description, const QList<QHash<Case, QString>> &arguments);
+
+    /*!
+     * \brief Генерация пояснения на основе шаблона и аргументов, заданных описаниями сущностей.
      *
-     * Ключ — тип операции (OperationType), значение — набор строк в разных падежах.
+     * Строка падежа аргумента извлекается только при подстановке плейсхолдера с этим падежом.
+     * \param[in] description Шаблон описания с подстановочными элементами.
+     * \param[in] arguments Список аргументов.
+     * \return Результат с подставленными аргументами.
+     * \throw TEException Ошибка плейсхолдера или BudgetExceeded при превышении бюджета входного файла.
      */
-    static const QHash<OperationType, QHash<Case, QString>> Templates;
+    static CaseDescription getExplanation(const CaseDescription &description, const QList<CaseDescription> &arguments);
 
     /*!
-     * \brief Генерация пояснения (описания) выражения на основе шаблона и аргументов.
-     * \param[in] description Шаблон описания операции с подстановочными элементами.
+     * \brief Генерация пояснения операции по её шаблону.
+     *
+     * Шаблоны операций хранятся в таблице, построенной на этапе компиляции и индексируемой типом операции.
+     * \param[in] operation Тип операции.
      * \param[in] arguments Список аргументов в разных падежах.
      * \return Результат с подставленными аргументами.
+     * \throw TEException Ошибка плейсхолдера или BudgetExceeded при превышении бюджета входного файла.
      */
-    static QHash<Case, QString> getExplanation(const QHash<Case, QString> &description, const QList<QHash<Case, QString>> &arguments);
+    static QHash<Case, QString> getExplanation(OperationType operation, const QList<QHash<Case, QString>> &arguments);
+
+    /*!
+     * \brief Генерация пояснения операции по её шаблону для аргументов, заданных описаниями сущностей.
+     * \param[in] operation Тип операции.
+     * \param[in] arguments Список аргументов.
+     * \return Результат с подставленными аргументами.
+     * \throw TEException Ошибка плейсхолдера или BudgetExceeded при превышении бюджета входного файла.
+     */
+    static CaseDescription getExplanation(OperationType operation, const QList<CaseDescription> &arguments);
 
     /*!
      * \brief Разбор строкового значения падежа.
@@ -55,7 +80,14 @@ public:
      * \param[in] placeholderRegex Регулярное выражение для поиска плейсхолдеров.
      * \return Строка с подставленными значениями.
      */
-    static QString replacePlaceholders(const QString &pattern, const QList<QHash<Case, QString>> &args, QRegularExpression& placeholderRegex);
+    static QString replacePlaceholders(const QString &pattern, const QList<CaseDescription> &args, QRegularExpression& placeholderRegex);
+
+    /*!
+     * \brief Расходование бюджета входного файла на построенное описание.
+     * \param[in] description Описание в одном падеже.
+     * \throw TEException Ошибка BudgetExceeded при превышении бюджета.
+     */
+    static void chargeOutput(const QString &description);
 };
 
 #endif // EXPRESSIONTRANSLATOR_H
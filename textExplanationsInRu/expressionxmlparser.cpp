@@ -1,73 +1,375 @@
 #include "expressionxmlparser.h"
+#include "declarationindex.h"
+#include "declarationlibrary.h"
+#include "expressiondocument.h"
+#include "inputbudget.h"
 #include "teexception.h"
+#include "pipelinestats.h"
+#include "textscanner.h"
+#include "tracerecorder.h"
 #include <QCoreApplication>
 #include <QDir>
-
-const QHash<QString, Case> ExpressionXmlParser::caseMapping = {
-    {"именительный", Case::Nominative},
-    {"родительный", Case::Genitive},
-    {"дательный", Case::Dative},
-    {"винительный", Case::Accusative},
-    {"творительный", Case::Instrumental},
-    {"предложный", Case::Prepositional}
+#include <utility>
+
+namespace {
+// Названия падежей в порядке перечисления Case
+constexpr QStringView CaseNames[CaseCount] = {
+    u"именительный",
+    u"родительный",
+    u"дательный",
+    u"винительный",
+    u"творительный",
+    u"предложный"
 };
 
+// Является ли байт пробельным символом ASCII
+bool isAsciiSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Является ли байт продолжением многобайтовой последовательности UTF-8
+bool isUtf8Continuation(char c)
+{
+    return (uchar(c) & 0xC0) == 0x80;
+}
+
+// Декодирование символа UTF-8, начинающегося с позиции position и заканчивающегося не дальше end
+char32_t decodeUtf8(const char* data, qsizetype position, qsizetype end)
+{
+    uchar lead = uchar(data[position]);
+    int count = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    char32_t code = count == 0 ? lead : lead & (0x3F >> count);
+    for (int i = 1; i <= count && position + i < end; ++i)
+        code = (code << 6) | (uchar(data[position + i]) & 0x3F);
+    return code;
+}
+}
+
+thread_local ValidationMode ExpressionXmlParser::validationMode = ValidationMode::CollectAll;
+thread_local DescriptionLoading ExpressionXmlParser::descriptionLoadingMode = DescriptionLoading::Lazy;
+thread_local QByteArray ExpressionXmlParser::documentContent;
+
 void ExpressionXmlParser::readDataFromXML(const QString& inputFilePath, Expression &expression) {
 
+    TEResult<Expression> result = parseFile(inputFilePath);
+    if(!result) throw result.errors();
+
+    expression = result.takeValue();
+}
+
+TEResult<Expression> ExpressionXmlParser::parseFile(const QString& inputFilePath) {
+
+    ParseReport report;
+    return parseFile(inputFilePath, ValidationMode::CollectAll, report);
+}
+
+TEResult<Expression> ExpressionXmlParser::parseFile(const QString& inputFilePath, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library) {
+
+    // Документ с одним выражением не может содержать элемент <expressions>
+    TEResult<ExpressionDocument> document = parseDocument(inputFilePath, nullptr, mode, report, library, false);
+    if(!document) return document.errors();
+    return document.value().expression(0);
+}
+
+TEResult<ExpressionDocument> ExpressionXmlParser::parseDocumentFile(const QString& inputFilePath, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library) {
+
+    return parseDocument(inputFilePath, nullptr, mode, report, library, true);
+}
+
+TEResult<ExpressionDocument> ExpressionXmlParser::parseDocumentContent(const QByteArray& content, const QString& sourceName, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library) {
+
+    return parseDocument(sourceName, &content, mode, report, library, true);
+}
+
+TEResult<ExpressionDocument> ExpressionXmlParser::parseDocument(const QString& inputFilePath, const QByteArray* content, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library, bool allowExpressionList) {
+
+    TraceRecorder::FileScope traceFile(inputFilePath);
+    TraceRecorder::Span span("ExpressionXmlParser::parseFile");
+    ExpressionDocument document;
     QList<TEException> errors;
+    XmlTree doc;
+    RejectionStage stage = RejectionStage::None;
+
+    ValidationMode previousMode = validationMode;
+    validationMode = mode;
+    QByteArray previousContent = std::exchange(documentContent, QByteArray());
+
+    // Содержимое, переданное в памяти, разбирается без обращения к файлу
+    bool isRead = content != nullptr ? readXMLContent(*content, inputFilePath, doc, errors, stage, library)
+                                     : readXML(inputFilePath, doc, errors, stage, library);
+    if(isRead) {
+        stage = RejectionStage::Validation;
+        PipelineStats::ScopedTimer timer(PipelineStage::Validation);
+        TraceRecorder::Span span("ExpressionXmlParser::parseXmlTree");
+        parseXmlTree(doc, document, errors, library, allowExpressionList);
+    }
+
+    validationMode = previousMode;
+    documentContent = std::move(previousContent);
+
+    // Превышение бюджета прерывает разбор в любом режиме проверки, поэтому сообщается только оно
+    if(InputBudget::isExhausted()) {
+        errors.clear();
+        InputBudget::charge(BudgetResource::WallTime, 0, errors);
+    }
+
+    // В режиме быстрого отказа сообщается только первая ошибка
+    if(mode == ValidationMode::FailFast && errors.count() > 1)
+        errors.erase(errors.begin() + 1, errors.end());
+
+    report.mode = mode;
+    report.stage = errors.count() > 0 ? stage : RejectionStage::None;
+
+    if(errors.count() > 0) return errors;
+    return document;
+}
+
+TEResult<Expression> ExpressionXmlParser::parseLibraryFile(const QString& libraryFilePath) {
+
+    TraceRecorder::FileScope traceFile(libraryFilePath);
+    TraceRecorder::Span span("ExpressionXmlParser::parseLibraryFile");
+    Expression declarations;
+    QList<TEException> errors;
+    XmlTree doc;
+    RejectionStage stage = RejectionStage::None;
+
+    // Библиотека проверяется полностью независимо от режима проверки входных файлов
+    ValidationMode previousMode = validationMode;
+    validationMode = ValidationMode::CollectAll;
+    QByteArray previousContent = std::exchange(documentContent, QByteArray());
+
+    if(readXML(libraryFilePath, doc, errors, stage)) {
+        XmlElement root = XmlElement::documentElement(doc);
+        if (root.isNull() || root.tagName() != "root") {
+            errors.append(TEException(ErrorType::MissingRootElemnt));
+        }
+        else {
+            validateElement(root, SchemaElement::LibraryRoot, errors);
+            parseDeclarations(root, declarations, errors);
+        }
+    }
 
-    try {
+    validationMode = previousMode;
+    documentContent = std::move(previousContent);
 
-        QDomDocument doc = readXML(inputFilePath, errors);
-        parseQDomDocument(doc, expression, errors);
+    if(errors.count() > 0) return errors;
+    return declarations;
+}
+
+Case ExpressionXmlParser::caseByName(QStringView name) {
+
+    for (int c = 0; c < CaseCount; ++c) {
+        if (CaseNames[c] == name) return static_cast<Case>(c);
     }
-    catch(...) {}
+    return Case::Nominative;
+}
 
-    if(errors.count() > 0) throw errors;
+void ExpressionXmlParser::setDescriptionLoading(DescriptionLoading loading)
+{
+    descriptionLoadingMode = loading;
 }
 
-QDomDocument ExpressionXmlParser::readXML(const QString& inputFilePath, QList<TEException>& errors) {
+DescriptionLoading ExpressionXmlParser::descriptionLoading()
+{
+    return descriptionLoadingMode;
+}
+
+QString ExpressionXmlParser::rejectionStageName(RejectionStage stage) {
+
+    switch(stage) {
+    case RejectionStage::None:          return "none";
+    case RejectionStage::FileAccess:    return "file-access";
+    case RejectionStage::PreScan:       return "pre-scan";
+    case RejectionStage::XmlSyntax:     return "xml-syntax";
+    case RejectionStage::Validation:    return "validation";
+    case RejectionStage::Expression:    return "expression";
+    }
+    return "unknown";
+}
 
+bool ExpressionXmlParser::readXML(const QString& inputFilePath, XmlTree& doc, QList<TEException>& errors, RejectionStage& stage, const DeclarationLibrary* library) {
+
+    stage = RejectionStage::FileAccess;
     if(inputFilePath.isEmpty())
         errors.append(TEException(ErrorType::InputFileNotFound, inputFilePath));
+    if(mustStop(errors)) return false;
+
+    QByteArray rawContent;
+    {
+        PipelineStats::ScopedTimer timer(PipelineStage::FileCopy);
+        TraceRecorder::Span span("ExpressionXmlParser::createTempCopy");
+        QTemporaryFile* tmpFilePath = createTempCopy(inputFilePath, errors);
+        if(tmpFilePath == nullptr) return false;
+
+        tmpFilePath->open();
+        rawContent = tmpFilePath->readAll();
+        delete tmpFilePath;
+    }
 
-    QTemporaryFile* tmpFilePath = createTempCopy(inputFilePath, errors);
+    return readXMLContent(rawContent, inputFilePath, doc, errors, stage, library);
+}
 
-    tmpFilePath->open();
-    QString xmlContent = tmpFilePath->readAll();
-    xmlContent = fixXmlFlags(xmlContent);
+bool ExpressionXmlParser::readXMLContent(const QByteArray& rawContent, const QString& sourceName, XmlTree& doc, QList<TEException>& errors, RejectionStage& stage, const DeclarationLibrary* library) {
 
-    QDomDocument doc;
-    QString errorMsg;
-    int errorLine, errorColumn;
+    PipelineStats::add(PipelineCounter::BytesRead, rawContent.size());
+    if(!InputBudget::charge(BudgetResource::Bytes, rawContent.size(), errors)) return false;
 
-    //std::cout << xmlContent.toStdString();
-    if (!doc.setContent(xmlContent, &errorMsg, &errorLine, &errorColumn)) {
-        delete tmpFilePath;
-        errors.append(TEException(ErrorType::Parsing, inputFilePath, errorLine));
-        throw NULL;
+    // Отклонить заведомо некорректные данные до построения DOM
+    if(validationMode == ValidationMode::FailFast) {
+        stage = RejectionStage::PreScan;
+        TraceRecorder::Span span("ExpressionXmlParser::preScan");
+        if(!preScan(rawContent, errors, library)) return false;
+    }
+
+    // Документ исправляется в исходной кодировке UTF-8 и передаётся в DOM без промежуточного QString
+    stage = RejectionStage::XmlSyntax;
+    QByteArray xmlContent;
+    {
+        PipelineStats::ScopedTimer timer(PipelineStage::FixXmlFlags);
+        TraceRecorder::Span span("ExpressionXmlParser::fixXmlFlags");
+        xmlContent = fixXmlFlags(rawContent);
+    }
+    // Исправленная копия документа хранится до конца разбора
+    if(!InputBudget::charge(BudgetResource::Bytes, xmlContent.size(), errors)) return false;
+
+    bool isParsed;
+    {
+        PipelineStats::ScopedTimer timer(PipelineStage::SetContent);
+        TraceRecorder::Span span("XmlTree::parse");
+        isParsed = doc.parse(std::string_view(xmlContent.constData(), size_t(xmlContent.size())));
+    }
+    if (!isParsed) {
+        errors.append(TEException(ErrorType::Parsing, sourceName, doc.errorLine()));
+        return false;
+    }
+    documentContent = xmlContent;
+
+    return InputBudget::charge(BudgetResource::WallTime, 0, errors);
+}
+
+bool ExpressionXmlParser::preScan(const QByteArray& content, QList<TEException>& errors, const DeclarationLibrary* library) {
+
+    // Размер входного файла
+    if(content.size() > inputMaxSize) {
+        errors.append(TEException(ErrorType::InputSizeExceeded, QList<QString>{"input", QString::number(content.size()), QString::number(inputMaxSize)}));
+        return false;
+    }
+
+    // Наличие корневого элемента
+    if(!content.contains("<root")) {
+        errors.append(TEException(ErrorType::MissingRootElemnt));
+        return false;
+    }
+
+    // Содержимое каждого элемента <expression>
+    qsizetype expressionTag = content.indexOf("<expression");
+    while(expressionTag != -1) {
+        // Пропустить теги с другим именем (например, <expressions>)
+        qsizetype nameEnd = expressionTag + 11;
+        if(nameEnd < content.size() && content[nameEnd] != '>' && !QChar::isSpace(uchar(content[nameEnd]))) {
+            expressionTag = content.indexOf("<expression", nameEnd);
+            continue;
+        }
+        qsizetype contentStart = content.indexOf('>', expressionTag) + 1;
+        qsizetype contentEnd = contentStart <= 0 ? -1 : content.indexOf("</expression>", contentStart);
+        if(contentEnd == -1) return true;
+
+        if(!preScanExpression(content, contentStart, contentEnd, errors, library)) return false;
+        expressionTag = content.indexOf("<expression", contentEnd);
+    }
+
+    return true;
+}
+
+bool ExpressionXmlParser::preScanExpression(const QByteArray& content, qsizetype contentStart, qsizetype contentEnd, QList<TEException>& errors, const DeclarationLibrary* library) {
+
+    QByteArrayView rawExpression = QByteArrayView(content).sliced(contentStart, contentEnd - contentStart);
+    qsizetype expressionLength = QString::fromUtf8(rawExpression).length();
+    if(expressionLength > expressionMaxLength) {
+        errors.append(TEException(ErrorType::InputSizeExceeded, QList<QString>{"expression", QString::number(expressionLength), QString::number(expressionMaxLength)}));
+        return false;
     }
 
-    delete tmpFilePath;
-    return doc;
+    // Идентификаторы выражения, которые не встречаются больше нигде в документе, не могут быть объявлены
+    QByteArrayView declarationsBefore = QByteArrayView(content).first(contentStart);
+    QByteArrayView declarationsAfter = QByteArrayView(content).sliced(contentEnd);
+    qsizetype i = 0;
+    while(i < rawExpression.size()) {
+        // Пропустить пробельные символы и строковые константы
+        if(rawExpression[i] == '"') {
+            qsizetype closingQuote = rawExpression.indexOf('"', i + 1);
+            i = closingQuote == -1 ? rawExpression.size() : closingQuote + 1;
+            continue;
+        }
+        // Пропустить числовые константы (в том числе вида 1e5)
+        if(rawExpression[i] >= '0' && rawExpression[i] <= '9') {
+            while(i < rawExpression.size() && (isWordChar(rawExpression[i]) || rawExpression[i] == '.'))
+                i++;
+            continue;
+        }
+        if(!isWordChar(rawExpression[i])) {
+            i++;
+            continue;
+        }
+
+        // Выделить идентификатор
+        qsizetype identifierStart = i;
+        while(i < rawExpression.size() && isWordChar(rawExpression[i]))
+            i++;
+        QByteArrayView identifier = rawExpression.sliced(identifierStart, i - identifierStart);
+
+        // Пропустить логические константы и обозначение операнда в операциях вида _++ и *_
+        if(identifier == "true" || identifier == "false" || identifier == "_") continue;
+        if(!containsWord(declarationsBefore, identifier) && !containsWord(declarationsAfter, identifier) &&
+            (library == nullptr || !library->declaresIdentifier(QString::fromLatin1(identifier)))) {
+            errors.append(TEException(ErrorType::UndefinedId, QList<QString>{QString::fromLatin1(identifier)}));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ExpressionXmlParser::containsWord(QByteArrayView text, QByteArrayView word) {
+
+    qsizetype position = text.indexOf(word);
+    while(position != -1) {
+        qsizetype end = position + word.size();
+        if((position == 0 || !isWordChar(text[position - 1])) && (end == text.size() || !isWordChar(text[end])))
+            return true;
+        position = text.indexOf(word, position + 1);
+    }
+    return false;
+}
+
+bool ExpressionXmlParser::isWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool ExpressionXmlParser::mustStop(const QList<TEException>& errors) {
+    return (validationMode == ValidationMode::FailFast && !errors.isEmpty()) || InputBudget::isExhausted();
 }
 
 QTemporaryFile *ExpressionXmlParser::createTempCopy(const QString &sourceFilePath, QList<TEException>& errors) {
 
-    QTemporaryFile* tempFile = new QTemporaryFile(QDir(QCoreApplication::applicationDirPath()).filePath("temp_XXXXXX"));
+    // Без объекта приложения (библиотека встроена в другую программу) копия создаётся во временном каталоге
+    QString copyDir = QCoreApplication::instance() != nullptr ? QCoreApplication::applicationDirPath() : QDir::tempPath();
+    QTemporaryFile* tempFile = new QTemporaryFile(QDir(copyDir).filePath("temp_XXXXXX"));
     //tempFile->setAutoRemove(true);
 
     if (!tempFile->open()) {
         delete tempFile;
-        errors.append(TEException(ErrorType::InputCopyFileCannotBeCreated, QList<QString>{sourceFilePath, QCoreApplication::applicationDirPath()}));
-        throw NULL;
+        errors.append(TEException(ErrorType::InputCopyFileCannotBeCreated, QList<QString>{sourceFilePath, copyDir}));
+        return nullptr;
     }
 
     // Открываем исходный файл для чтения
     QFile sourceFile(sourceFilePath);
     if (!sourceFile.open(QIODevice::ReadOnly)){
+        delete tempFile;
         errors.append(TEException(ErrorType::InputFileNotFound, sourceFilePath));
-        throw NULL;
+        return nullptr;
     }
 
     tempFile->write(sourceFile.readAll());
@@ -77,102 +379,165 @@ QTemporaryFile *ExpressionXmlParser::createTempCopy(const QString &sourceFilePat
     return tempFile;
 }
 
-QString ExpressionXmlParser::escapeXmlText(const QString& text) {
+QByteArray ExpressionXmlParser::escapeXmlText(QByteArrayView text) {
 
-    QString output = text;
-    output.replace("&", "&amp;")
-        .replace("<", "&lt;")
-        .replace(">", "&gt;")
-        .replace("\"", "&quot;")
-        .replace("'", "&apos;");
+    QByteArray output;
+    output.reserve(text.size() + 16);
+    qsizetype position = 0;
+    qsizetype special;
+    while ((special = TextScanner::findXmlSpecial(text, position)) != -1) {
+        output.append(text.sliced(position, special - position));
+        output.append(xmlEntity(text[special]));
+        position = special + 1;
+    }
+    output.append(text.sliced(position));
     return output;
-
 }
 
-QString ExpressionXmlParser::fixXmlFlags(const QString& xmlString) {
+const char* ExpressionXmlParser::xmlEntity(char c) {
 
-    QString result = fixXmlExpression(xmlString);
-    result = fixXmlCaseTags(result);
-
-    return result;
+    switch (c) {
+    case '&':  return "&amp;";
+    case '<':  return "&lt;";
+    case '>':  return "&gt;";
+    case '"':  return "&quot;";
+    case '\'': return "&apos;";
+    }
+    return "";
 }
 
-QString ExpressionXmlParser::fixXmlExpression(const QString& xmlString) {
-    QString result = xmlString;
+QByteArray ExpressionXmlParser::fixXmlFlags(const QByteArray& xmlContent) {
 
-    // Находим начало и конец тега <expression>
-    int expressionStart = result.indexOf("<expression>");
-    int expressionEnd = result.indexOf("</expression>");
+    return fixXmlCaseTags(fixXmlExpression(xmlContent));
+}
 
-    // Если тег <expression> найден
-    if (expressionStart != -1 && expressionEnd != -1) {
-        // Вычисляем позиции содержимого
-        int contentStart = expressionStart + QString("<expression>").length();
-        int contentLength = expressionEnd - contentStart;
+QByteArray ExpressionXmlParser::fixXmlExpression(const QByteArray& xmlContent) {
+
+    // Неизменённые участки копируются целиком, содержимое каждого <expression> экранируется;
+    // открывающий тег может содержать атрибуты
+    QByteArrayView content(xmlContent);
+    QByteArray result;
+    qsizetype position = 0;
+    qsizetype expressionStart = content.indexOf("<expression");
+    while (expressionStart != -1) {
+        // Пропускаем теги с другим именем (например, <expressions>)
+        if (expressionStart + 11 < content.size() &&
+            content[expressionStart + 11] != '>' && !QChar::isSpace(uchar(content[expressionStart + 11]))) {
+            expressionStart = content.indexOf("<expression", expressionStart + 1);
+            continue;
+        }
+        qsizetype expressionEnd = content.indexOf("</expression>", expressionStart);
+        qsizetype contentStart = content.indexOf('>', expressionStart) + 1;
+        if (expressionEnd == -1 || contentStart > expressionEnd) break;
+
+        if (result.isEmpty()) result.reserve(xmlContent.size());
+        result.append(content.sliced(position, contentStart - position));
+        result.append(escapeXmlText(content.sliced(contentStart, expressionEnd - contentStart)));
+        position = expressionEnd;
+        expressionStart = content.indexOf("<expression", expressionEnd);
+    }
 
-        // Извлекаем содержимое
-        QString content = result.mid(contentStart, contentLength);
+    // Документ без выражений возвращается без копирования
+    if (position == 0) return xmlContent;
+    result.append(content.sliced(position));
+    return result;
+}
 
-        // Заменяем специальные символы
-        QString escapedContent = escapeXmlText(content);
+QByteArray ExpressionXmlParser::fixXmlCaseTags(const QByteArray& xmlContent) {
+
+    QByteArrayView content(xmlContent);
+    QByteArray result;
+    result.reserve(xmlContent.size());
+
+    // Неизменённые участки копируются целиком, содержимое каждого <case> экранируется
+    qsizetype position = 0;
+    qsizetype caseStart;
+    // Превышение бюджета прекращает исправление; ошибку сообщает следующая точка проверки
+    while (!InputBudget::isExhausted() && (caseStart = content.indexOf("<case", position)) != -1) {
+        qsizetype contentStart = content.indexOf('>', caseStart) + 1;
+        if (contentStart == 0) break;
+        // Пустой элемент <case/> не имеет содержимого
+        if (content[contentStart - 2] == '/') {
+            result.append(content.sliced(position, contentStart - position));
+            position = contentStart;
+            continue;
+        }
+        qsizetype caseEnd = content.indexOf("</case>", contentStart);
+        if (caseEnd == -1) break;
 
-        // Заменяем оригинальное содержимое на обработанное
-        result.replace(contentStart, contentLength, escapedContent);
+        result.append(content.sliced(position, contentStart - position));
+        result.append(escapeXmlText(content.sliced(contentStart, caseEnd - contentStart)));
+        position = caseEnd;
     }
-
+    result.append(content.sliced(position));
     return result;
 }
 
-QString ExpressionXmlParser::fixXmlCaseTags(const QString& xmlString) {
-    QString result = xmlString;
-
-    // Обработка всех тегов <case> (с конца)
-    int caseEnd = result.length();
-    while ((caseEnd = result.lastIndexOf("</case>", caseEnd)) != -1) {
-        int caseStart = result.lastIndexOf("<case", caseEnd);
-        if (caseStart == -1) break;
+bool ExpressionXmlParser::parseXmlTree(const XmlTree& doc, ExpressionDocument &document, QList<TEException>& errors, const DeclarationLibrary* library, bool allowExpressionList) {
 
-        // Найдём начало содержимого, игнорируя атрибуты внутри <case>
-        int contentStart = result.indexOf('>', caseStart) + 1;
-        int contentLength = caseEnd - contentStart;
+    XmlElement root = XmlElement::documentElement(doc);
+    if (root.isNull() || root.tagName() != "root") {
+        errors.append(TEException(ErrorType::MissingRootElemnt));
+        return false;
+    }
 
-        // Извлекаем содержимое
-        QString content = result.mid(contentStart, contentLength);
+    // Документ содержит либо одно выражение <expression>, либо список выражений <expressions>
+    bool expressionList = allowExpressionList && !root.firstChildElement("expressions").isNull();
 
-        // Заменяем специальные символы
-        QString escapedContent = escapeXmlText(content);
+    // Если объявления находятся в библиотеке, во входном файле обязательно только выражение
+    if(library != nullptr) validateElement(root, expressionList ? SchemaElement::ExpressionListRootWithLibrary : SchemaElement::RootWithLibrary, errors);
+    else validateElement(root, expressionList ? SchemaElement::ExpressionListRoot : SchemaElement::Root, errors);
+    if(mustStop(errors)) return false;
 
-        // Заменяем оригинальное содержимое на обработанное
-        result.replace(contentStart, contentLength, escapedContent);
+    if(expressionList) {
+        XmlElement _expressions = root.firstChildElement("expressions");
+        validateElement(_expressions, SchemaElement::Expressions, errors);
+        if(mustStop(errors)) return false;
 
-        // Продолжаем поиск с предыдущей позиции
-        caseEnd = caseStart;
+        for(XmlElement _expression = _expressions.firstChildElement("expression"); !_expression.isNull(); _expression = _expression.nextSiblingElement("expression")) {
+            QString expression = parseExpression(_expression, errors);
+            if(mustStop(errors)) return false;
+            document.addExpression(expression, parseNotation(_expression, errors));
+            if(mustStop(errors)) return false;
+        }
+    }
+    else {
+        QString expression = parseExpression(root.firstChildElement("expression"), errors);
+        if(mustStop(errors)) return false;
+        document.addExpression(expression, parseNotation(root.firstChildElement("expression"), errors));
+        if(mustStop(errors)) return false;
     }
 
-    return result;
-}
+    if(!parseDeclarations(root, document.declarations(), errors)) return false;
 
-void ExpressionXmlParser::parseQDomDocument(const QDomDocument& doc, Expression &expression, QList<TEException>& errors) {
+    if(library != nullptr && errors.isEmpty()) document.declarations().attachLibrary(*library);
+    // Номера объявлений присваиваются при разборе и используются всеми выражениями документа
+    if(errors.isEmpty()) document.declarations().getDeclarationIndex();
 
-    QDomElement root = doc.documentElement();
-    if (root.isNull() || root.tagName() != "root") {
-        errors.append(TEException(ErrorType::MissingRootElemnt));
-        throw NULL;
-    }
+    return errors.isEmpty();
+}
 
-    validateElement(root, QList<QString>{}, QHash<QString, int>{{"expression", 1}, {"variables", 1}, {"functions", 1}, {"unions", 1}, {"structures", 1}, {"classes", 1}, {"enums", 1}}, errors);
+bool ExpressionXmlParser::parseDeclarations(const XmlElement& root, Expression &expression, QList<TEException>& errors) {
 
-    expression.setExpression(parseExpression(root.firstChildElement("expression"), errors));
     expression.setVariables(parseVariables(root.firstChildElement("variables"), errors));
+    if(mustStop(errors)) return false;
     expression.setFunctions(parseFunctions(root.firstChildElement("functions"), errors));
+    if(mustStop(errors)) return false;
     expression.setUnions(parseUnions(root.firstChildElement("unions"), errors));
+    if(mustStop(errors)) return false;
     expression.setStructures(parseStructures(root.firstChildElement("structures"), errors));
+    if(mustStop(errors)) return false;
     expression.setClasses(parseClasses(root.firstChildElement("classes"), errors));
+    if(mustStop(errors)) return false;
     expression.setEnums(parseEnums(root.firstChildElement("enums"), errors));
+
+    return !mustStop(errors);
 }
 
-QString ExpressionXmlParser::parseExpression(const QDomElement &_expression, QList<TEException>& errors)
+QString ExpressionXmlParser::parseExpression(const XmlElement &_expression, QList<TEException>& errors)
 {
+    validateAttributes(_expression, schema[static_cast<int>(SchemaElement::Expression)], errors);
+
     QString res = _expression.text();
     if(res.isEmpty() || res.length() < 1)
         errors.append(TEException(ErrorType::EmptyElementValue, _expression.lineNumber(), QList<QString>{"expression"}));
@@ -184,15 +549,25 @@ QString ExpressionXmlParser::parseExpression(const QDomElement &_expression, QLi
     return res;
 }
 
-QHash<QString, Variable> ExpressionXmlParser::parseVariables(const QDomElement &_variables, QList<TEException>& errors)
+ExpressionNotation ExpressionXmlParser::parseNotation(const XmlElement &_expression, QList<TEException>& errors)
+{
+    // По умолчанию выражение записано в обратной польской записи
+    QString notation = _expression.attribute("notation", "postfix");
+    if(notation == "infix") return ExpressionNotation::Infix;
+    if(notation != "postfix")
+        errors.append(TEException(ErrorType::UnexpectedAttribute, _expression.lineNumber(), QList<QString>{"notation=\"" + notation + "\"", "postfix; infix"}));
+    return ExpressionNotation::Postfix;
+}
+
+QHash<QString, Variable> ExpressionXmlParser::parseVariables(const XmlElement &_variables, QList<TEException>& errors)
 {
-    validateElement(_variables, QList<QString>{}, QHash<QString, int>{{"variable", childElementsMaxCount}}, errors, false);
+    validateElement(_variables, SchemaElement::Variables, errors);
 
     QHash<QString, Variable> result;
-    if(_variables.childNodes().isEmpty()) return result;
+    if(!_variables.hasChildNodes()) return result;
 
-    QDomNode childNode = _variables.firstChild();
-    while (!childNode.isNull()) {
+    XmlElement childNode = _variables.firstChild();
+    while (!childNode.isNull() && !mustStop(errors)) {
 
         Variable child = parseVariable(childNode.toElement(), errors);
         result.insert(child.name, child);
@@ -201,28 +576,28 @@ QHash<QString, Variable> ExpressionXmlParser::parseVariables(const QDomElement &
     return result;
 }
 
-Variable ExpressionXmlParser::parseVariable(const QDomElement &_variable, QList<TEException>& errors)
+Variable ExpressionXmlParser::parseVariable(const XmlElement &_variable, QList<TEException>& errors)
 {
 
-    validateElement(_variable, QList<QString>{"name", "type"}, QHash<QString, int>{{"description", 1}}, errors, true);
+    validateElement(_variable, SchemaElement::Variable, errors);
 
     QString name = parseName(_variable, errors);
     QString type = _variable.attribute("type");
-    QDomElement descr = _variable.firstChildElement("description");
+    XmlElement descr = _variable.firstChildElement("description");
 
-    QHash<Case, QString> desc = parseCases(_variable.firstChildElement("description"), errors);
+    CaseDescription desc = parseCases(_variable.firstChildElement("description"), errors);
     return Variable(name, type, desc);
 }
 
-QHash<QString, Function> ExpressionXmlParser::parseFunctions(const QDomElement &_functions, QList<TEException>& errors)
+QHash<QString, Function> ExpressionXmlParser::parseFunctions(const XmlElement &_functions, QList<TEException>& errors)
 {
-    validateElement(_functions, QList<QString>{}, QHash<QString, int>{{"function", childElementsMaxCount}}, errors, false);
+    validateElement(_functions, SchemaElement::Functions, errors);
 
     QHash<QString, Function> result;
-    if(_functions.childNodes().isEmpty()) return result;
+    if(!_functions.hasChildNodes()) return result;
 
-    QDomNode childNode = _functions.firstChild();
-    while (!childNode.isNull()) {
+    XmlElement childNode = _functions.firstChild();
+    while (!childNode.isNull() && !mustStop(errors)) {
 
         Function child = parseFunction(childNode.toElement(), errors);
         result.insert(child.name, child);
@@ -232,27 +607,27 @@ QHash<QString, Function> ExpressionXmlParser::parseFunctions(const QDomElement &
     return result;
 }
 
-Function ExpressionXmlParser::parseFunction(const QDomElement &_function, QList<TEException>& errors)
+Function ExpressionXmlParser::parseFunction(const XmlElement &_function, QList<TEException>& errors)
 {
-    validateElement(_function, QList<QString>{"name", "type", "paramsCount"}, QHash<QString, int>{{"description", 1}}, errors, true);
+    validateElement(_function, SchemaElement::Function, errors);
 
     QString name = parseName(_function, errors);
     QString type = parseType(_function, errors);
     int paramsCount = parseParamsCount(_function, errors);
-    QHash<Case, QString> desc = parseCases(_function.firstChildElement("description"), errors);
+    CaseDescription desc = parseCases(_function.firstChildElement("description"), errors);
 
     return Function(name, type, paramsCount, desc);
 }
 
-QHash<QString, Union> ExpressionXmlParser::parseUnions(const QDomElement &_unions, QList<TEException>& errors)
+QHash<QString, Union> ExpressionXmlParser::parseUnions(const XmlElement &_unions, QList<TEException>& errors)
 {
-    validateElement(_unions, QList<QString>{}, QHash<QString, int>{{"union", childElementsMaxCount}}, errors, false);
+    validateElement(_unions, SchemaElement::Unions, errors);
 
     QHash<QString, Union> result;
-    if(_unions.childNodes().isEmpty()) return result;
+    if(!_unions.hasChildNodes()) return result;
 
-    QDomNode childNode = _unions.firstChild();
-    while (!childNode.isNull()) {
+    XmlElement childNode = _unions.firstChild();
+    while (!childNode.isNull() && !mustStop(errors)) {
         Union child = parseUnion(childNode.toElement(), errors);
         result.insert(child.name, child);
 
@@ -262,9 +637,9 @@ QHash<QString, Union> ExpressionXmlParser::parseUnions(const QDomElement &_union
     return result;
 }
 
-Union ExpressionXmlParser::parseUnion(const QDomElement &_union, QList<TEException>& errors)
+Union ExpressionXmlParser::parseUnion(const XmlElement &_union, QList<TEException>& errors)
 {
-    validateElement(_union, QList<QString>{"name"}, QHash<QString, int>{{"variables", 1}, {"functions", 1}}, errors, true);
+    validateElement(_union, SchemaElement::CustomType, errors);
 
     QString name = parseName(_union, errors);
     QHash<QString, Variable> variables = parseVariables(_union.firstChildElement("variables"), errors);
@@ -277,16 +652,16 @@ Union ExpressionXmlParser::parseUnion(const QDomElement &_union, QList<TEExcepti
     return Union(name, variables, functions);
 }
 
-QHash<QString, Structure> ExpressionXmlParser::parseStructures(const QDomElement &_structures, QList<TEException>& errors)
+QHash<QString, Structure> ExpressionXmlParser::parseStructures(const XmlElement &_structures, QList<TEException>& errors)
 {
 
-    validateElement(_structures, QList<QString>{}, QHash<QString, int>{{"structure", childElementsMaxCount}}, errors, false);
+    validateElement(_structures, SchemaElement::Structures, errors);
 
     QHash<QString, Structure> result;
-    if(_structures.childNodes().isEmpty()) return result;
+    if(!_structures.hasChildNodes()) return result;
 
-    QDomNode childNode = _structures.firstChild();
-    while (!childNode.isNull()) {
+    XmlElement childNode = _structures.firstChild();
+    while (!childNode.isNull() && !mustStop(errors)) {
 
         Structure child = parseStructure(childNode.toElement(), errors);
         result.insert(child.name, child);
@@ -296,9 +671,9 @@ QHash<QString, Structure> ExpressionXmlParser::parseStructures(const QDomElement
     return result;
 }
 
-Structure ExpressionXmlParser::parseStructure(const QDomElement &_structure, QList<TEException>& errors)
+Structure ExpressionXmlParser::parseStructure(const XmlElement &_structure, QList<TEException>& errors)
 {
-    validateElement(_structure, QList<QString>{"name"}, QHash<QString, int>{{"variables", 1}, {"functions", 1}}, errors, true);
+    validateElement(_structure, SchemaElement::CustomType, errors);
 
     QString name = parseName(_structure, errors);
     QHash<QString, Variable> variables = parseVariables(_structure.firstChildElement("variables"), errors);
@@ -311,16 +686,16 @@ Structure ExpressionXmlParser::parseStructure(const QDomElement &_structure, QLi
     return Structure(name, variables, functions);
 }
 
-QHash<QString, Class> ExpressionXmlParser::parseClasses(const QDomElement &_classes, QList<TEException>& errors)
+QHash<QString, Class> ExpressionXmlParser::parseClasses(const XmlElement &_classes, QList<TEException>& errors)
 {
 
-    validateElement(_classes, QList<QString>{}, QHash<QString, int>{{"class", childElementsMaxCount}}, errors, false);
+    validateElement(_classes, SchemaElement::Classes, errors);
 
     QHash<QString, Class> result;
-    if(_classes.childNodes().isEmpty()) return result;
+    if(!_classes.hasChildNodes()) return result;
 
-    QDomNode childNode = _classes.firstChild();
-    while (!childNode.isNull()) {
+    XmlElement childNode = _classes.firstChild();
+    while (!childNode.isNull() && !mustStop(errors)) {
 
         Class child = parseClass(childNode.toElement(), errors);
         result.insert(child.name, child);
@@ -330,9 +705,9 @@ QHash<QString, Class> ExpressionXmlParser::parseClasses(const QDomElement &_clas
     return result;
 }
 
-Class ExpressionXmlParser::parseClass(const QDomElement &_class, QList<TEException>& errors)
+Class ExpressionXmlParser::parseClass(const XmlElement &_class, QList<TEException>& errors)
 {
-    validateElement(_class, QList<QString>{"name"}, QHash<QString, int>{{"variables", 1}, {"functions", 1}}, errors, true);
+    validateElement(_class, SchemaElement::CustomType, errors);
 
     QString name = parseName(_class, errors);
     QHash<QString, Variable> variables = parseVariables(_class.firstChildElement("variables"), errors);
@@ -345,16 +720,16 @@ Class ExpressionXmlParser::parseClass(const QDomElement &_class, QList<TEExcepti
     return Class(name, variables, functions);
 }
 
-QHash<QString, Enum> ExpressionXmlParser::parseEnums(const QDomElement &_enums, QList<TEException>& errors)
+QHash<QString, Enum> ExpressionXmlParser::parseEnums(const XmlElement &_enums, QList<TEException>& errors)
 {
 
-    validateElement(_enums, QList<QString>{}, QHash<QString, int>{{"enum", 20}}, errors, false);
+    validateElement(_enums, SchemaElement::Enums, errors);
 
     QHash<QString, Enum> result;
-    if(_enums.childNodes().isEmpty()) return result;
+    if(!_enums.hasChildNodes()) return result;
 
-    QDomNode childNode = _enums.firstChild();
-    while (!childNode.isNull()) {
+    XmlElement childNode = _enums.firstChild();
+    while (!childNode.isNull() && !mustStop(errors)) {
 
         Enum child = parseEnum(childNode.toElement(), errors);
         result.insert(child.name, child);
@@ -364,28 +739,28 @@ QHash<QString, Enum> ExpressionXmlParser::parseEnums(const QDomElement &_enums,
     return result;
 }
 
-Enum ExpressionXmlParser::parseEnum(const QDomElement &_enum, QList<TEException>& errors)
+Enum ExpressionXmlParser::parseEnum(const XmlElement &_enum, QList<TEException>& errors)
 {
-    validateElement(_enum, QList<QString>{"name"}, QHash<QString, int>{{"value", 20}}, errors, true);
+    validateElement(_enum, SchemaElement::Enum, errors);
 
     QString name = parseName(_enum, errors);
-    QHash<QString, QHash<Case, QString>> values = parseEnumValues(_enum, errors);
+    QHash<QString, CaseDescription> values = parseEnumValues(_enum, errors);
 
     return Enum(name, values);
 }
 
-QHash<QString, QHash<Case, QString>> ExpressionXmlParser::parseEnumValues(const QDomElement &_values, QList<TEException>& errors)
+QHash<QString, CaseDescription> ExpressionXmlParser::parseEnumValues(const XmlElement &_values, QList<TEException>& errors)
 {
-    QHash<QString, QHash<Case, QString>> result;
+    QHash<QString, CaseDescription> result;
     // Перебираем все элементы <value> внутри <enum>
-    QDomNodeList valueNodes = _values.elementsByTagName("value");
-    for (int i = 0; i < valueNodes.size(); ++i) {
-        QDomElement valueElement = valueNodes.at(i).toElement();
+    QList<XmlElement> valueNodes = _values.elementsByTagName("value");
+    for (int i = 0; i < valueNodes.size() && !mustStop(errors); ++i) {
+        XmlElement valueElement = valueNodes.at(i).toElement();
 
-        validateElement(valueElement, QList<QString>{"name"}, QHash<QString, int>{{"description", 1}}, errors, true);
+        validateElement(valueElement, SchemaElement::EnumValue, errors);
 
         QString valueName = valueElement.attribute("name");
-        QHash<Case, QString> description = parseCases(valueElement.firstChildElement("description"), errors);
+        CaseDescription description = parseCases(valueElement.firstChildElement("description"), errors);
 
         result.insert(valueName, description);
     }
@@ -393,7 +768,7 @@ QHash<QString, QHash<Case, QString>> ExpressionXmlParser::parseEnumValues(const
     return result;
 }
 
-QString ExpressionXmlParser::parseName(const QDomElement &element, QList<TEException>& errors) {
+QString ExpressionXmlParser::parseName(const XmlElement &element, QList<TEException>& errors) {
 
     QString res = element.attribute("name");
     if(res.isEmpty() || res.length() < 1)
@@ -409,17 +784,15 @@ QString ExpressionXmlParser::parseName(const QDomElement &element, QList<TEExcep
     }
 
     // Остальные символы - латинские буквы, цифры или _
-    for(int i = 0; i < res.length(); i++) {
-        if (!(isLatinLetter(res[i]) || res[i].isDigit() || res[i] == '_')) {
-            errors.append(TEException(ErrorType::InvalidName, element.lineNumber(), QList<QString>{res}));
-        }
+    for(qsizetype i = TextScanner::findNonIdentifier(res); i != -1; i = TextScanner::findNonIdentifier(res, i + 1)) {
+        errors.append(TEException(ErrorType::InvalidName, element.lineNumber(), QList<QString>{res}));
     }
 
     return res;
 
 }
 
-QString ExpressionXmlParser::parseType(const QDomElement& element, QList<TEException> &errors)
+QString ExpressionXmlParser::parseType(const XmlElement& element, QList<TEException> &errors)
 {
     QString res = element.attribute("type");
     if(res.isEmpty() || res.length() < 1) {
@@ -437,7 +810,7 @@ QString ExpressionXmlParser::parseType(const QDomElement& element, QList<TEExcep
     return res;
 }
 
-int ExpressionXmlParser::parseParamsCount(const QDomElement& element, QList<TEException> &errors)
+int ExpressionXmlParser::parseParamsCount(const XmlElement& element, QList<TEException> &errors)
 {
     QString res = element.attribute("paramsCount");
     if(res.isEmpty() || res.length() < 1) {
@@ -458,16 +831,20 @@ int ExpressionXmlParser::parseParamsCount(const QDomElement& element, QList<TEEx
     return count;
 }
 
-QHash<Case, QString> ExpressionXmlParser::parseCases(const QDomElement &parentElement, QList<TEException>& errors)
+CaseDescription ExpressionXmlParser::parseCases(const XmlElement &parentElement, QList<TEException>& errors)
 {
-    QHash<Case, QString> cases;
-    QDomNodeList caseNodes = parentElement.elementsByTagName("case");
+    CaseDescription cases;
+    QList<XmlElement> caseNodes = parentElement.elementsByTagName("case");
 
     for (int i = 0; i < caseNodes.size(); i++) {
-        QDomElement caseElement = caseNodes.at(i).toElement();
+        XmlElement caseElement = caseNodes.at(i).toElement();
         QString caseType = caseElement.attribute("type").trimmed().toLower();
 
-        Case currentCase = caseMapping[caseType];
+        Case currentCase = caseByName(caseType);
+
+        // В ленивом режиме падеж ссылается на документ и преобразуется в QString только при обращении
+        if(descriptionLoadingMode == DescriptionLoading::Lazy && insertCaseSpan(caseElement, currentCase, cases, errors)) continue;
+
         QString text = caseElement.text().trimmed();
 
         if(text.isEmpty()) errors.append(TEException(ErrorType::EmptyElementValue, caseElement.lineNumber(), QList<QString>{"case"}));
@@ -479,161 +856,191 @@ QHash<Case, QString> ExpressionXmlParser::parseCases(const QDomElement &parentEl
     return cases;
 }
 
+bool ExpressionXmlParser::insertCaseSpan(const XmlElement& caseElement, Case c, CaseDescription& cases, QList<TEException>& errors)
+{
+    qsizetype offset = 0;
+    qsizetype length = 0;
+    if(!caseElement.textSource(offset, length) || offset + length > documentContent.size()) return false;
+
+    // Пробелы по краям отбрасываются без преобразования текста
+    const char* data = documentContent.constData();
+    qsizetype begin = offset;
+    qsizetype end = offset + length;
+    while(begin < end && isAsciiSpace(data[begin])) ++begin;
+    while(end > begin && isAsciiSpace(data[end - 1])) --end;
+
+    // Пробелы вне ASCII по краям редки; такой текст обрабатывается так же, как при обычной загрузке
+    if(begin < end) {
+        qsizetype last = end - 1;
+        while(last > begin && isUtf8Continuation(data[last])) --last;
+        if(QChar::isSpace(decodeUtf8(data, begin, end)) || QChar::isSpace(decodeUtf8(data, last, end))) return false;
+    }
+
+    // Длина в символах UTF-16: четырёхбайтовые последовательности занимают два символа
+    qsizetype textLength = 0;
+    for(qsizetype i = begin; i < end; ++i) {
+        if(!isUtf8Continuation(data[i])) textLength += uchar(data[i]) >= 0xF0 ? 2 : 1;
+    }
+
+    if(textLength == 0) errors.append(TEException(ErrorType::EmptyElementValue, caseElement.lineNumber(), QList<QString>{"case"}));
+    if(textLength > descMaxLength) errors.append(TEException(ErrorType::InputSizeExceeded, caseElement.lineNumber(), QList<QString>{QString::fromUtf8(data + begin, end - begin), QString::number(textLength), QString::number(descMaxLength)}));
+
+    cases.insertSpan(c, documentContent, begin, end - begin);
+    return true;
+}
+
 bool ExpressionXmlParser::isLatinLetter(const QChar c) {
     // Явная проверка латинских букв
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 }
 
-void ExpressionXmlParser::validateElement(const QDomElement& curElement, const QList<QString>& allowedAttributes, const QHash<QString, int>& allowedElements, QList<TEException>& errors, bool checkRequired, bool textIsError) {
-    validateAttributes(curElement, allowedAttributes, errors);
-    validateChildElements(curElement, allowedElements, errors);
+void ExpressionXmlParser::validateElement(const XmlElement& curElement, SchemaElement kind, QList<TEException>& errors) {
+    const ElementRule& rule = schema[static_cast<int>(kind)];
 
-    if (checkRequired) {
-        validateRequiredAttributes(curElement, allowedAttributes, errors);
-        validateRequiredChildElements(curElement, allowedElements.keys(), errors);
-    }
+    quint32 foundAttributes = validateAttributes(curElement, rule, errors);
+    quint32 foundChildren = validateChildElements(curElement, rule, errors);
 
+    validateRequiredAttributes(curElement, rule.requiredAttributes & ~foundAttributes, errors);
+    validateRequiredChildElements(curElement, rule.requiredChildren & ~foundChildren, errors);
 }
 
-void ExpressionXmlParser::validateAttributes(const QDomElement& curElement, const QList<QString>& attributes, QList<TEException>& errors) {
+quint32 ExpressionXmlParser::validateAttributes(const XmlElement& curElement, const ElementRule& rule, QList<TEException>& errors) {
 
-    QDomNamedNodeMap getAttributes = curElement.attributes();
-    for (int i = 0; i < getAttributes.length(); i++) {
-        QDomAttr attribute = getAttributes.item(i).toAttr();
+    quint32 found = 0;
+    for (int i = 0; i < curElement.attributeCount(); i++) {
+        QString attributeName = curElement.attributeName(i);
+        XmlAttribute known = xmlAttributeByName(attributeName);
 
-        // Проверяем, есть ли этот атрибут в списке elements
-        if (!attributes.contains(attribute.name()) || attributes.count() == 0) {
-            errors.append(TEException(ErrorType::UnexpectedAttribute, attribute.lineNumber(), QList<QString>{attribute.name(), attributes.join("; ")}));
+        // Проверяем, допускает ли схема этот атрибут у элемента
+        if (known == XmlAttribute::Unknown || !(rule.allowedAttributes & attributeBit(known))) {
+            errors.append(TEException(ErrorType::UnexpectedAttribute, curElement.lineNumber(), QList<QString>{attributeName, allowedAttributeNames(rule)}));
         }
+        else found |= attributeBit(known);
     }
+    return found;
 }
 
-void ExpressionXmlParser::validateChildElements(const QDomElement& curElement, const QHash<QString, int>& elements, QList<TEException>& errors) {
+quint32 ExpressionXmlParser::validateChildElements(const XmlElement& curElement, const ElementRule& rule, QList<TEException>& errors) {
 
-    QDomNode childNode = curElement.firstChild();
-    while (!childNode.isNull()) {
-        if (childNode.isElement()) {
-            QDomElement childElement = childNode.toElement();
-            QString childName = childElement.tagName();
+    quint32 found = 0;
+    std::array<int, XmlTagCount> counts{};
 
-            if (!elements.contains(childName) || elements.count() == 0) {
-                errors.append(TEException(ErrorType::UnexpectedElement, childElement.lineNumber(), QList<QString>{childName, elements.keys().join("; ")}));
-            }
-            else {
-                int count = countDirectChildren(curElement, childName);
-                int value = elements.value(childName);
-                if(count > value)
-                    errors.append(TEException(ErrorType::DuplicateElement, childElement.lineNumber(), QList<QString>{childName}));
-                // Специальная проверка для case-элементов в description
-                if (childName == "description") {
-                    validateCases(childElement, errors);
-                }
+    XmlElement childElement = curElement.firstChildElement();
+    while (!childElement.isNull() && !mustStop(errors)) {
+        XmlTag tag = xmlTagByName(childElement.tagName());
+        int maxCount = tag == XmlTag::Unknown ? 0 : rule.maxChildren[static_cast<int>(tag)];
+
+        if (maxCount == 0) {
+            errors.append(TEException(ErrorType::UnexpectedElement, childElement.lineNumber(), QList<QString>{childElement.tagName(), allowedChildNames(rule)}));
+        }
+        else {
+            // Элементы сверх допустимого количества считаются повторяющимися
+            if (++counts[static_cast<int>(tag)] > maxCount)
+                errors.append(TEException(ErrorType::DuplicateElement, childElement.lineNumber(), QList<QString>{childElement.tagName()}));
+            found |= tagBit(tag);
+
+            // Специальная проверка для case-элементов в description
+            if (tag == XmlTag::Description) {
+                validateCases(childElement, errors);
             }
         }
-        childNode = childNode.nextSibling();
+        childElement = childElement.nextSiblingElement();
     }
+    return found;
 }
 
-void ExpressionXmlParser::validateRequiredAttributes(const QDomElement& curElement, const QList<QString>& attributes, QList<TEException>& errors) {
+void ExpressionXmlParser::validateRequiredAttributes(const XmlElement& curElement, quint32 missingAttributes, QList<TEException>& errors) {
 
-    QListIterator<QString> iter(attributes);
-
-    while(iter.hasNext()){
-        QString it = iter.next();
-        if (!curElement.hasAttribute(it)) {
-            errors.append(TEException(ErrorType::MissingRequiredAttribute, curElement.lineNumber(), QList<QString>{it}));
-        }
+    for (int attribute = 0; attribute < XmlAttributeCount; ++attribute) {
+        if (missingAttributes & attributeBit(static_cast<XmlAttribute>(attribute)))
+            errors.append(TEException(ErrorType::MissingRequiredAttribute, curElement.lineNumber(), QList<QString>{xmlAttributeName(static_cast<XmlAttribute>(attribute))}));
     }
 }
 
-void ExpressionXmlParser::validateRequiredChildElements(const QDomElement& curElement, const QList<QString>& elements, QList<TEException>& errors) {
+void ExpressionXmlParser::validateRequiredChildElements(const XmlElement& curElement, quint32 missingChildren, QList<TEException>& errors) {
 
-    QListIterator<QString> iter(elements);
-    while(iter.hasNext()){
-        QString it = iter.next();
+    for (int tag = 0; tag < XmlTagCount; ++tag) {
+        if (missingChildren & tagBit(static_cast<XmlTag>(tag)))
+            errors.append(TEException(ErrorType::MissingRequiredChildElement, curElement.lineNumber(), QList<QString>{xmlTagName(static_cast<XmlTag>(tag))}));
+    }
+}
 
-        bool foundCurElement = false;
-        QDomNode childNode = curElement.firstChild();
-        while (!childNode.isNull()) {
-            if (childNode.isElement() && childNode.toElement().tagName() == it) {
-                foundCurElement = true;
-                break;
-            }
-            childNode = childNode.nextSibling();
-        }
+QString ExpressionXmlParser::allowedAttributeNames(const ElementRule& rule) {
 
-        if (!foundCurElement) {
-            errors.append(TEException(ErrorType::MissingRequiredChildElement, curElement.lineNumber(), QList<QString>{it}));
-        }
+    QList<QString> names;
+    for (int attribute = 0; attribute < XmlAttributeCount; ++attribute)
+        if (rule.allowedAttributes & attributeBit(static_cast<XmlAttribute>(attribute))) names.append(xmlAttributeName(static_cast<XmlAttribute>(attribute)));
+    return names.join("; ");
+}
 
-    }
+QString ExpressionXmlParser::allowedChildNames(const ElementRule& rule) {
 
+    QList<QString> names;
+    for (int tag = 0; tag < XmlTagCount; ++tag)
+        if (rule.maxChildren[tag] > 0) names.append(xmlTagName(static_cast<XmlTag>(tag)));
+    return names.join("; ");
 }
 
-void ExpressionXmlParser::validateCases(const QDomElement &curDescription, QList<TEException>& errors)
+void ExpressionXmlParser::validateCases(const XmlElement &curDescription, QList<TEException>& errors)
 {
-    // Список обязательных падежей
-    const QSet<QString> requiredCases = {
+    // Список обязательных падежей в порядке перечисления Case
+    static const QList<QString> requiredCases = {
         "именительный", "родительный", "дательный",
         "винительный", "творительный", "предложный"
     };
+    const quint32 allCases = (quint32(1) << CaseCount) - 1;
+
+    // Названия падежей, отмеченных в маске
+    auto caseNames = [](quint32 mask) {
+        QList<QString> names;
+        for (int c = 0; c < CaseCount; ++c)
+            if (mask & (quint32(1) << c)) names.append(requiredCases.at(c));
+        return names.join(", ");
+    };
 
-    QDomNodeList caseNodes = curDescription.elementsByTagName("case");
+    QList<XmlElement> caseNodes = curDescription.elementsByTagName("case");
     if (caseNodes.size() > 0) {
-        QSet<QString> foundCases;
-        QSet<QString> duplicateCases;
+        quint32 foundCases = 0;
+        quint32 duplicateCases = 0;
 
-        // Собираем все найденные падежи
-        for (int i = 0; i < caseNodes.size(); ++i) {
-            QDomElement caseElem = caseNodes.at(i).toElement();
-            QString caseType = caseElem.attribute("type").trimmed().toLower();
+        // Отмечаем все найденные падежи
+        for (int i = 0; i < caseNodes.size() && !mustStop(errors); ++i) {
+            XmlElement caseElem = caseNodes.at(i).toElement();
 
             // Проверяем наличие атрибута "type"
             if (!caseElem.hasAttribute("type")) {
-                throw TEException(ErrorType::MissingRequiredAttribute, caseElem.lineNumber(),
-                                  {"type"});
+                errors.append(TEException(ErrorType::MissingRequiredAttribute, caseElem.lineNumber(),
+                                          {"type"}));
+                return;
             }
             // Проверяем на неожиданные значения атрибута "type"
-            if (!requiredCases.contains(caseType)) {
-                throw TEException(ErrorType::UnexpectedAttribute, caseElem.lineNumber(),
-                                  {caseType, requiredCases.values().join(", ")});
+            QString caseType = caseElem.attribute("type").trimmed().toLower();
+            qsizetype index = requiredCases.indexOf(caseType);
+            if (index < 0) {
+                errors.append(TEException(ErrorType::UnexpectedAttribute, caseElem.lineNumber(),
+                                          {caseType, caseNames(allCases)}));
+                return;
             }
             // Проверяем на дублирующиеся значения
-            if (foundCases.contains(caseType)) {
-                duplicateCases.insert(caseType);
-            } else {
-                foundCases.insert(caseType);
-            }
+            quint32 bit = quint32(1) << index;
+            if (foundCases & bit) duplicateCases |= bit;
+            else foundCases |= bit;
         }
         // Если найдены дубликаты, выбрасываем исключение
-        if (!duplicateCases.isEmpty()) {
+        if (duplicateCases != 0) {
             errors.append(TEException(ErrorType::DuplicateElement, curDescription.lineNumber(),
-                                      {QString("case type=\"%1\"").arg(duplicateCases.values().join(", "))}));
+                                      {QString("case type=\"%1\"").arg(caseNames(duplicateCases))}));
         }
 
         // Проверяем, что все обязательные падежи присутствуют
-        QSet<QString> missingCases = requiredCases - foundCases;
-        if (!missingCases.isEmpty()) {
+        quint32 missingCases = allCases & ~foundCases;
+        if (missingCases != 0) {
             errors.append(TEException(ErrorType::MissingCases, curDescription.lineNumber(),
-                                      QList<QString>{missingCases.values().join(", ")}));
+                                      QList<QString>{caseNames(missingCases)}));
         }
     }
     else errors.append(TEException(ErrorType::MissingCases, curDescription.lineNumber(),
-                                  QList<QString>{requiredCases.values().join(", ")}));
-
-}
-
-int ExpressionXmlParser::countDirectChildren(const QDomElement& element, const QString& childName) {
-    int count = 0;
+                                  QList<QString>{caseNames(allCases)}));
 
-    QDomNode childNode = element.firstChild();
-    while (!childNode.isNull()) {
-        if (childNode.isElement() && childNode.toElement().tagName() == childName) {
-            count++;
-        }
-        childNode = childNode.nextSibling();
-    }
-
-    return count;
 }
 
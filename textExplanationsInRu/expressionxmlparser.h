@@ -7,9 +7,48 @@
 #define EXPRESSIONXMLPARSER_H
 
 #include "expression.h"
-#include <QDomDocument>
+#include "expressiondocument.h"
+#include "xmlschema.h"
+#include "xmlelement.h"
 #include <QString>
 #include <QTemporaryFile>
+#include <QByteArrayView>
+
+/*!
+ * \brief Режим проверки входных данных.
+ */
+enum class ValidationMode {
+    CollectAll,     /*!< Собрать все ошибки документа */
+    FailFast        /*!< Остановиться на первой ошибке, выполнив предварительную проверку до построения DOM */
+};
+
+/*!
+ * \brief Режим загрузки описаний объявлений.
+ */
+enum class DescriptionLoading {
+    Eager,      /*!< Строки всех падежей извлекаются при разборе */
+    Lazy        /*!< При разборе запоминаются участки документа, строка падежа извлекается при обращении к ней */
+};
+
+/*!
+ * \brief Этап обработки, на котором входные данные были отклонены.
+ */
+enum class RejectionStage {
+    None,           /*!< Входные данные приняты */
+    FileAccess,     /*!< Чтение входного файла */
+    PreScan,        /*!< Предварительная проверка без построения DOM */
+    XmlSyntax,      /*!< Синтаксический разбор XML */
+    Validation,     /*!< Проверка и разбор элементов документа */
+    Expression      /*!< Построение дерева выражения */
+};
+
+/*!
+ * \brief Отчёт о разборе входного файла.
+ */
+struct ParseReport {
+    ValidationMode mode = ValidationMode::CollectAll;   /*!< Режим проверки */
+    RejectionStage stage = RejectionStage::None;        /*!< Этап, на котором входные данные отклонены */
+};
 
 /*!
  * \brief Класс для разбора XML-файлов и преобразования их в структуру Expression.
@@ -24,25 +63,170 @@ public:
      */
     static void readDataFromXML(const QString& inputFilePath, Expression& expression);
 
+    /*!
+     * \brief Чтение данных из XML-файла без использования исключений.
+     * \param[in] inputFilePath Путь к входному XML-файлу.
+     * \return Заполненная структура Expression либо список ошибок.
+     */
+    static TEResult<Expression> parseFile(const QString& inputFilePath);
+
+    /*!
+     * \brief Чтение данных из XML-файла в заданном режиме проверки.
+     * \param[in] inputFilePath Путь к входному XML-файлу.
+     * \param[in] mode Режим проверки. В режиме FailFast возвращается только первая ошибка.
+     * \param[out] report Режим проверки и этап, на котором входные данные были отклонены.
+     * \param[in] library Библиотека объявлений или nullptr. Если библиотека указана, во входном файле обязателен
+     * только элемент <expression>, а объявления библиотеки подключаются к выражению.
+     * \return Заполненная структура Expression либо список ошибок.
+     */
+    static TEResult<Expression> parseFile(const QString& inputFilePath, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Чтение документа с одним или несколькими выражениями из XML-файла.
+     *
+     * Вместо элемента <expression> элемент <root> может содержать элемент <expressions> со списком выражений,
+     * которые используют общие объявления документа.
+     * \param[in] inputFilePath Путь к входному XML-файлу.
+     * \param[in] mode Режим проверки. В режиме FailFast возвращается только первая ошибка.
+     * \param[out] report Режим проверки и этап, на котором входные данные были отклонены.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \return Документ с выражениями и общими объявлениями либо список ошибок.
+     */
+    static TEResult<ExpressionDocument> parseDocumentFile(const QString& inputFilePath, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Чтение документа с одним или несколькими выражениями из содержимого XML-файла в памяти.
+     *
+     * Содержимое проверяется так же, как содержимое файла, но без создания временной копии на диске.
+     * \param[in] content Содержимое XML-документа в кодировке UTF-8.
+     * \param[in] sourceName Имя источника, которое указывается в сообщениях об ошибках.
+     * \param[in] mode Режим проверки. В режиме FailFast возвращается только первая ошибка.
+     * \param[out] report Режим проверки и этап, на котором входные данные были отклонены.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \return Документ с выражениями и общими объявлениями либо список ошибок.
+     */
+    static TEResult<ExpressionDocument> parseDocumentContent(const QByteArray& content, const QString& sourceName, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Чтение библиотеки объявлений из XML-файла.
+     *
+     * Элемент <root> библиотеки содержит только объявления; элемент <expression> не допускается.
+     * Библиотека всегда проверяется полностью.
+     * \param[in] libraryFilePath Путь к файлу библиотеки.
+     * \return Структура Expression без выражения, содержащая объявления, либо список ошибок.
+     */
+    static TEResult<Expression> parseLibraryFile(const QString& libraryFilePath);
+
+    /*!
+     * \brief Получение строкового имени этапа обработки.
+     * \param[in] stage Этап обработки.
+     * \return Имя этапа.
+     */
+    static QString rejectionStageName(RejectionStage stage);
+
+    /*!
+     * \brief Задание режима загрузки описаний для разборов в данном потоке.
+     *
+     * В обоих режимах описания проверяются полностью; по умолчанию используется ленивая загрузка. Лениво
+     * загруженные описания хранят ссылку на исправленное содержимое документа.
+     * \param[in] loading Режим загрузки описаний.
+     */
+    static void setDescriptionLoading(DescriptionLoading loading);
+
+    /*!
+     * \brief Получение режима загрузки описаний для разборов в данном потоке.
+     */
+    static DescriptionLoading descriptionLoading();
+
 private:
 
     //////////////////////////////////////////////////
     /// Методы для работы с файлами
     /////////////////////////////////////////////////
 
+    /*!
+     * \brief Чтение документа из XML-файла или из его содержимого в заданном режиме проверки.
+     * \param[in] inputFilePath Путь к входному XML-файлу или имя источника содержимого.
+     * \param[in] content Содержимое документа либо nullptr, если документ читается из файла.
+     * \param[in] mode Режим проверки.
+     * \param[out] report Режим проверки и этап, на котором входные данные были отклонены.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \param[in] allowExpressionList Допускается ли элемент <expressions>.
+     * \return Документ либо список ошибок.
+     */
+    static TEResult<ExpressionDocument> parseDocument(const QString& inputFilePath, const QByteArray* content, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library, bool allowExpressionList);
+
     /*!
      * \brief Считывание XML-документа из файла.
      * \param[in] filePath Путь к XML-файлу.
+     * \param[out] doc Считанный документ.
+     * \param[out] errors Список ошибок.
+     * \param[out] stage Последний начатый этап чтения.
+     * \param[in] library Библиотека объявлений, идентификаторы которой учитываются предварительной проверкой, или nullptr.
+     * \return true, если документ считан и дальнейший разбор возможен.
+     */
+    static bool readXML(const QString& filePath, XmlTree& doc, QList<TEException>& errors, RejectionStage& stage, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Построение XML-документа из содержимого файла.
+     * \param[in] rawContent Содержимое файла в кодировке UTF-8.
+     * \param[in] sourceName Имя файла или источника для сообщений об ошибках.
+     * \param[out] doc Считанный документ.
      * \param[out] errors Список ошибок.
-     * \return Объект QDomDocument.
+     * \param[out] stage Последний начатый этап чтения.
+     * \param[in] library Библиотека объявлений, идентификаторы которой учитываются предварительной проверкой, или nullptr.
+     * \return true, если документ построен и дальнейший разбор возможен.
      */
-    static QDomDocument readXML(const QString& filePath, QList<TEException>& errors);
+    static bool readXMLContent(const QByteArray& rawContent, const QString& sourceName, XmlTree& doc, QList<TEException>& errors, RejectionStage& stage, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Предварительная проверка содержимого файла без построения DOM.
+     *
+     * Проверяет размер файла, наличие элемента <root>, длину каждого выражения и то, что каждый
+     * идентификатор выражения встречается в документе за пределами элемента <expression> или объявлен в библиотеке.
+     * \param[in] content Содержимое файла.
+     * \param[out] errors Список ошибок.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \return true, если входные данные не отклонены.
+     */
+    static bool preScan(const QByteArray& content, QList<TEException>& errors, const DeclarationLibrary* library = nullptr);
+
+    /*!
+     * \brief Предварительная проверка длины и идентификаторов одного выражения.
+     * \param[in] content Содержимое файла.
+     * \param[in] contentStart Позиция начала содержимого элемента <expression>.
+     * \param[in] contentEnd Позиция закрывающего тега </expression>.
+     * \param[out] errors Список ошибок.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \return true, если выражение не отклонено.
+     */
+    static bool preScanExpression(const QByteArray& content, qsizetype contentStart, qsizetype contentEnd, QList<TEException>& errors, const DeclarationLibrary* library);
+
+    /*!
+     * \brief Проверка, встречается ли в тексте слово целиком.
+     * \param[in] text Текст.
+     * \param[in] word Слово.
+     * \return true, если слово встречается и не является частью другого идентификатора.
+     */
+    static bool containsWord(QByteArrayView text, QByteArrayView word);
+
+    /*!
+     * \brief Проверка, может ли байт входить в идентификатор.
+     */
+    static bool isWordChar(char c);
+
+    /*!
+     * \brief Проверка, нужно ли прекратить разбор в текущем режиме проверки.
+     * \param[in] errors Список ошибок.
+     * \return true, если включён режим FailFast и ошибка уже найдена либо превышен бюджет входного файла.
+     */
+    static bool mustStop(const QList<TEException>& errors);
 
     /*!
      * \brief Создание временной копии XML-файла.
      * \param[in] sourceFilePath Путь к исходному файлу.
      * \param[out] errors Список ошибок.
-     * \return Указатель на временный файл.
+     * \return Указатель на временный файл или nullptr, если копию создать не удалось.
      */
     static QTemporaryFile* createTempCopy(const QString &sourceFilePath, QList<TEException>& errors);
 
@@ -51,44 +235,66 @@ private:
     /////////////////////////////////////////////////
 
     /*!
-     * \brief Экранирование специальных символов XML.
-     * \param[in] text Текст для экранирования.
+     * \brief Экранирование специальных символов XML в тексте UTF-8.
+     *
+     * Все специальные символы XML однобайтовые, а байты многобайтовых последовательностей UTF-8 не совпадают
+     * с ними, поэтому текст обрабатывается побайтно без перекодирования.
+     * \param[in] text Текст в кодировке UTF-8.
      * \return Экранированный текст.
      */
-    static QString escapeXmlText(const QString& text);
+    static QByteArray escapeXmlText(QByteArrayView text);
 
     /*!
-     * \brief Исправление флагов в XML.
-     * \param[in] xmlString XML-строка.
-     * \return Исправленная строка.
+     * \brief Получение записи специального символа XML в виде сущности.
+     * \param[in] c Специальный символ (`&`, `<`, `>`, `"`, `'`).
+     * \return Сущность XML или пустая строка для остальных символов.
      */
-    static QString fixXmlFlags(const QString& xmlString);
+    static const char* xmlEntity(char c);
 
     /*!
-     * \brief Исправление выражения в XML.
-     * \param[in] xmlString XML-строка.
-     * \return Исправленное выражение.
+     * \brief Исправление флагов в XML-документе в кодировке UTF-8.
+     * \param[in] xmlContent Содержимое XML-документа.
+     * \return Исправленное содержимое.
      */
-    static QString fixXmlExpression(const QString& xmlString);
+    static QByteArray fixXmlFlags(const QByteArray& xmlContent);
 
     /*!
-     * \brief Исправление тегов падежей в XML.
-     * \param[in] xmlString XML-строка.
-     * \return Обновлённая строка.
+     * \brief Исправление выражения в XML-документе в кодировке UTF-8.
+     * \param[in] xmlContent Содержимое XML-документа.
+     * \return Исправленное содержимое.
      */
-    static QString fixXmlCaseTags(const QString &xmlString);
+    static QByteArray fixXmlExpression(const QByteArray& xmlContent);
+
+    /*!
+     * \brief Исправление тегов падежей в XML-документе в кодировке UTF-8 за один проход.
+     * \param[in] xmlContent Содержимое XML-документа.
+     * \return Исправленное содержимое.
+     */
+    static QByteArray fixXmlCaseTags(const QByteArray& xmlContent);
 
     //////////////////////////////////////////////////
     /// Методы для обработки XML
     /////////////////////////////////////////////////
 
     /*!
-     * \brief Парсинг документа XML в Expression.
+     * \brief Парсинг документа XML в ExpressionDocument.
      * \param[in] doc XML-документ.
+     * \param[out] document Заполняемый документ.
+     * \param[out] errors Список ошибок.
+     * \param[in] library Библиотека объявлений или nullptr.
+     * \param[in] allowExpressionList Допускается ли элемент <expressions>.
+     * \return true, если документ разобран без ошибок.
+     */
+    static bool parseXmlTree(const XmlTree& doc, ExpressionDocument &document, QList<TEException>& errors, const DeclarationLibrary* library, bool allowExpressionList);
+
+    /*!
+     * \brief Извлечение объявлений (переменных, функций и пользовательских типов) из корневого элемента.
+     * \param[in] root Элемент <root>.
      * \param[out] expression Заполняемая структура.
      * \param[out] errors Список ошибок.
+     * \return true, если разбор не прерван.
      */
-    static void parseQDomDocument(const QDomDocument& doc, Expression &expression, QList<TEException>& errors);
+    static bool parseDeclarations(const XmlElement& root, Expression &expression, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение выражения.
@@ -96,130 +302,164 @@ private:
      * \param[out] errors Список ошибок.
      * \return Строка выражения.
      */
-    static QString parseExpression(const QDomElement& _expression, QList<TEException>& errors);
+    static QString parseExpression(const XmlElement& _expression, QList<TEException>& errors);
+
+    /*!
+     * \brief Извлечение формы записи выражения из атрибута "notation".
+     * \param[in] _expression Элемент <expression>.
+     * \param[out] errors Список ошибок.
+     * \return Форма записи выражения (по умолчанию – обратная польская запись).
+     */
+    static ExpressionNotation parseNotation(const XmlElement& _expression, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение переменных.
      */
-    static QHash<QString, Variable> parseVariables(const QDomElement& _variables, QList<TEException>& errors);
+    static QHash<QString, Variable> parseVariables(const XmlElement& _variables, QList<TEException>& errors);
 
     /*!
      * \brief Парсинг одной переменной.
      */
-    static Variable parseVariable(const QDomElement& _variable, QList<TEException>& errors);
+    static Variable parseVariable(const XmlElement& _variable, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение функций.
      */
-    static QHash<QString, Function> parseFunctions(const QDomElement& _functions, QList<TEException>& errors);
+    static QHash<QString, Function> parseFunctions(const XmlElement& _functions, QList<TEException>& errors);
 
     /*!
      * \brief Парсинг одной функции.
      */
-    static Function parseFunction(const QDomElement& _function, QList<TEException>& errors);
+    static Function parseFunction(const XmlElement& _function, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение объединений.
      */
-    static QHash<QString, Union> parseUnions(const QDomElement& _unions, QList<TEException>& errors);
+    static QHash<QString, Union> parseUnions(const XmlElement& _unions, QList<TEException>& errors);
 
     /*!
      * \brief Парсинг одного объединения.
      */
-    static Union parseUnion(const QDomElement& _union, QList<TEException>& errors);
+    static Union parseUnion(const XmlElement& _union, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение структур.
      */
-    static QHash<QString, Structure> parseStructures(const QDomElement& _structures, QList<TEException>& errors);
+    static QHash<QString, Structure> parseStructures(const XmlElement& _structures, QList<TEException>& errors);
 
     /*!
      * \brief Парсинг одной структуры.
      */
-    static Structure parseStructure(const QDomElement& _structure, QList<TEException>& errors);
+    static Structure parseStructure(const XmlElement& _structure, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение классов.
      */
-    static QHash<QString, Class> parseClasses(const QDomElement& _classes, QList<TEException>& errors);
+    static QHash<QString, Class> parseClasses(const XmlElement& _classes, QList<TEException>& errors);
 
     /*!
      * \brief Парсинг одного класса.
      */
-    static Class parseClass(const QDomElement& _class, QList<TEException>& errors);
+    static Class parseClass(const XmlElement& _class, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение перечислений.
      */
-    static QHash<QString, Enum> parseEnums(const QDomElement& _enums, QList<TEException>& errors);
+    static QHash<QString, Enum> parseEnums(const XmlElement& _enums, QList<TEException>& errors);
 
     /*!
      * \brief Парсинг одного перечисления.
      */
-    static Enum parseEnum(const QDomElement& _enum, QList<TEException>& errors);
+    static Enum parseEnum(const XmlElement& _enum, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение значений перечисления.
      */
-    static QHash<QString, QHash<Case, QString>> parseEnumValues(const QDomElement& _values, QList<TEException>& errors);
+    static QHash<QString, CaseDescription> parseEnumValues(const XmlElement& _values, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение падежей.
      */
-    static QHash<Case, QString> parseCases(const QDomElement &parentElement, QList<TEException>& errors);
+    static CaseDescription parseCases(const XmlElement &parentElement, QList<TEException>& errors);
+
+    /*!
+     * \brief Запоминание падежа как участка исходного документа без преобразования текста в QString.
+     * \param[in] caseElement Элемент <case>.
+     * \param[in] c Падеж.
+     * \param[in,out] cases Описание, в которое добавляется падеж.
+     * \param[out] errors Список ошибок.
+     * \return false, если текст элемента не совпадает с участком документа или окружён пробелами вне ASCII;
+     * тогда падеж нужно извлечь из текста элемента.
+     */
+    static bool insertCaseSpan(const XmlElement& caseElement, Case c, CaseDescription& cases, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение имени.
      */
-    static QString parseName(const QDomElement& element, QList<TEException>& errors);
+    static QString parseName(const XmlElement& element, QList<TEException>& errors);
     /*!
      * \brief Извлечение типа данных.
      */
-    static QString parseType(const QDomElement& element, QList<TEException>& errors);
+    static QString parseType(const XmlElement& element, QList<TEException>& errors);
 
     /*!
      * \brief Извлечение количества параметров функции.
      */
-    static int parseParamsCount(const QDomElement& element, QList<TEException>& errors);
+    static int parseParamsCount(const XmlElement& element, QList<TEException>& errors);
 
     //////////////////////////////////////////////////
     /// Методы для валидации XML элементов и атрибутов
     /////////////////////////////////////////////////
 
     /*!
-     * \brief Проверка соответствия элемента требованиям.
+     * \brief Проверка элемента по правилам схемы.
+     *
+     * Атрибуты и дочерние элементы просматриваются по одному разу; количество дочерних элементов каждого
+     * имени подсчитывается во время просмотра.
+     * \param[in] curElement Проверяемый элемент.
+     * \param[in] kind Вид элемента в схеме.
+     * \param[in,out] errors Список ошибок.
      */
-    static void validateElement(const QDomElement& curElement, const QList<QString>& allowedAttributes, const QHash<QString, int>& allowedElements, QList<TEException>& errors, bool checkRequired = true, bool textIsError = true);
+    static void validateElement(const XmlElement& curElement, SchemaElement kind, QList<TEException>& errors);
 
     /*!
      * \brief Проверка атрибутов элемента.
+     * \return Маска найденных атрибутов схемы.
      */
-    static void validateAttributes(const QDomElement& curElement, const QList<QString>& attributes, QList<TEException>& errors);
+    static quint32 validateAttributes(const XmlElement& curElement, const ElementRule& rule, QList<TEException>& errors);
 
     /*!
-     * \brief Проверка допустимых дочерних элементов.
+     * \brief Проверка допустимых дочерних элементов и их количества.
+     * \return Маска найденных допустимых дочерних элементов.
      */
-    static void validateChildElements(const QDomElement& curElement, const QHash<QString, int>& allowedElements, QList<TEException>& errors);
+    static quint32 validateChildElements(const XmlElement& curElement, const ElementRule& rule, QList<TEException>& errors);
 
     /*!
-     * \brief Проверка обязательных атрибутов.
+     * \brief Сообщение об отсутствующих обязательных атрибутах.
+     * \param[in] missingAttributes Маска отсутствующих атрибутов.
      */
-    static void validateRequiredAttributes(const QDomElement& curElement, const QList<QString>& attributes, QList<TEException>& errors);
+    static void validateRequiredAttributes(const XmlElement& curElement, quint32 missingAttributes, QList<TEException>& errors);
 
     /*!
-     * \brief Проверка обязательных дочерних элементов.
+     * \brief Сообщение об отсутствующих обязательных дочерних элементах.
+     * \param[in] missingChildren Маска отсутствующих дочерних элементов.
      */
-    static void validateRequiredChildElements(const QDomElement& curElement, const QList<QString>& elements, QList<TEException>& errors);
+    static void validateRequiredChildElements(const XmlElement& curElement, quint32 missingChildren, QList<TEException>& errors);
 
     /*!
-     * \brief Проверка корректности блоков падежей.
+     * \brief Получение списка допустимых атрибутов для сообщения об ошибке.
      */
-    static void validateCases(const QDomElement& curDescription, QList<TEException>& errors);
+    static QString allowedAttributeNames(const ElementRule& rule);
 
     /*!
-     * \brief Подсчет количества прямых дочерних элементов.
+     * \brief Получение списка допустимых дочерних элементов для сообщения об ошибке.
      */
-    static int countDirectChildren(const QDomElement& element, const QString& childName);
+    static QString allowedChildNames(const ElementRule& rule);
+
+    /*!
+     * \brief Проверка корректности блоков падежей.
+     */
+    static void validateCases(const XmlElement& curDescription, QList<TEException>& errors);
 
     /*!
      * \brief Проверка, является ли символ латинской буквой.
@@ -239,17 +479,39 @@ private:
     /*! \brief Максимальная длина выражения. */
     static constexpr int expressionMaxLength = 1024;
 
+    /*! \brief Максимальный размер входного файла в байтах. */
+    static constexpr int inputMaxSize = 8 * 1024 * 1024;
+
     /*! \brief Максимальное количество дочерних элементов. */
     static constexpr int childElementsMaxCount = 20;
 
+    /*! \brief Максимальное количество выражений в документе. */
+    static constexpr int expressionsMaxCount = 100;
+
     /*! \brief Максимальное количество параметров функции. */
     static constexpr int functionParamsMaxCount = 5;
 
+    /*! \brief Схема входного документа, общая для всех разборов. */
+    static constexpr XmlSchema schema = makeXmlSchema(childElementsMaxCount, expressionsMaxCount);
+
     /*! \brief Список поддерживаемых типов данных для переменных. */
     static const QList<QString> supportedDataTypesForVar;
 
-    /*! \brief Отображение строковых значений в падежах. */
-    static const QHash<QString, Case> caseMapping;
+    /*!
+     * \brief Получение падежа по его названию.
+     * \param[in] name Название падежа в нижнем регистре (например, "родительный").
+     * \return Падеж; для неизвестного названия — именительный.
+     */
+    static Case caseByName(QStringView name);
+
+    /*! \brief Режим проверки текущего разбора в данном потоке. */
+    static thread_local ValidationMode validationMode;
+
+    /*! \brief Режим загрузки описаний в данном потоке. */
+    static thread_local DescriptionLoading descriptionLoadingMode;
+
+    /*! \brief Исправленное содержимое документа, разбираемого в данном потоке; на него ссылаются лениво загруженные падежи. */
+    static thread_local QByteArray documentContent;
     };
 
 #endif // EXPRESSIONXMLPARSER_H
@@ -0,0 +1,360 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса InfixParser.
+ */
+
+#include "infixparser.h"
+#include "declarationindex.h"
+#include "expressionnormalizer.h"
+#include "pipelinestats.h"
+
+namespace {
+// Приоритеты операций инфиксной записи
+constexpr int AssignmentPrecedence = 1;
+constexpr int OrPrecedence = 2;
+constexpr int AndPrecedence = 3;
+constexpr int EqualityPrecedence = 4;
+constexpr int RelationalPrecedence = 5;
+constexpr int AdditivePrecedence = 6;
+constexpr int MultiplicativePrecedence = 7;
+constexpr int PrefixPrecedence = 8;
+
+// Знаки операций и разделители; двухсимвольные проверяются первыми
+constexpr const char16_t* TwoCharOperators[] = {
+    u"::", u"->", u"++", u"--", u"&&", u"||", u"<=", u">=", u"==", u"!=", u"+=", u"-=", u"*=", u"/=", u"%="
+};
+constexpr QStringView OneCharOperators = u"+-*/%<>=!&.[](),";
+
+bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_';
+}
+
+// Лексема обратной польской записи для префиксной операции; пустая строка, если операция не префиксная
+QString prefixOperationToken(QStringView operation)
+{
+    if (operation == u"-" || operation == u"!" || operation == u"&") return operation.toString();
+    if (operation == u"*") return QStringLiteral("*_");
+    if (operation == u"++") return QStringLiteral("++_");
+    if (operation == u"--") return QStringLiteral("--_");
+    return QString();
+}
+}
+
+InfixParser::InfixParser(Expression& expression)
+    : expression(expression)
+{
+}
+
+ExpressionNode* InfixParser::parse(QList<TEException>& errors)
+{
+    ExpressionNode* root = buildTree(errors);
+    // Узлы недостроенного дерева удаляются, чтобы прерванный разбор не удерживал память
+    if (root == nullptr) expression.deleteNodes(createdNodes);
+    createdNodes.clear();
+    return root;
+}
+
+ExpressionNode* InfixParser::buildTree(QList<TEException>& errors)
+{
+    {
+        PipelineStats::ScopedTimer splitTimer(PipelineStage::SplitExpression);
+        if (!tokenize(*expression.getExpression(), errors)) return nullptr;
+    }
+    PipelineStats::add(PipelineCounter::Tokens, tokens.size());
+
+    // Если выражение было пустым, то дерева нет
+    if (tokens.isEmpty()) return new ExpressionNode();
+
+    context.customDataTypes = expression.getCustomDataTypes();
+    context.usedDeclarations = QBitArray(expression.getDeclarationIndex().size());
+    ExpressionNode* root = parseExpression(0, QString(), errors);
+    if (root == nullptr) return nullptr;
+
+    // Лишняя закрывающая скобка или запятая
+    if (peek().kind != TokenKind::End) {
+        errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{peek().text}));
+        return nullptr;
+    }
+
+    QStack<ExpressionNode*> nodeStack;
+    nodeStack.push(root);
+    if (!expression.finalizeNodeProcessing(nodeStack, *expression.getExpression(), context.operationCounter, context.usedDeclarations, errors))
+        return nullptr;
+
+    // Один раз определить способ перевода каждого узла
+    root = nodeStack.pop();
+    ExpressionNormalizer::normalize(root);
+    return root;
+}
+
+bool InfixParser::tokenize(const QString& text, QList<TEException>& errors)
+{
+    qsizetype i = 0;
+    while (i < text.size()) {
+        QChar c = text[i];
+        if (c.isSpace()) {
+            i++;
+        }
+        // Строковая константа
+        else if (c == '"') {
+            qsizetype closingQuote = text.indexOf('"', i + 1);
+            if (closingQuote == -1) {
+                errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{QStringLiteral("\"")}));
+                return false;
+            }
+            tokens.append(Token{TokenKind::Literal, text.mid(i, closingQuote - i + 1), i});
+            i = closingQuote + 1;
+        }
+        // Числовая константа (в том числе вида 1.5 и 1e5)
+        else if (c.isDigit()) {
+            qsizetype start = i;
+            while (i < text.size() && (isIdentifierChar(text[i]) || text[i] == '.'))
+                i++;
+            tokens.append(Token{TokenKind::Literal, text.mid(start, i - start), start});
+        }
+        // Идентификатор; недопустимые в идентификаторе буквы обнаруживаются при определении типа лексемы
+        else if (isIdentifierChar(c)) {
+            qsizetype start = i;
+            while (i < text.size() && isIdentifierChar(text[i]))
+                i++;
+            tokens.append(Token{TokenKind::Identifier, text.mid(start, i - start), start});
+        }
+        else {
+            QStringView rest = QStringView(text).sliced(i);
+            qsizetype length = 0;
+            for (const char16_t* op : TwoCharOperators) {
+                if (rest.startsWith(QStringView(op))) {
+                    length = 2;
+                    break;
+                }
+            }
+            if (length == 0 && OneCharOperators.contains(c)) length = 1;
+            if (length == 0) {
+                errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{QString(c)}));
+                return false;
+            }
+            tokens.append(Token{TokenKind::Operator, text.mid(i, length), i});
+            i += length;
+        }
+    }
+    return true;
+}
+
+ExpressionNode* InfixParser::parseExpression(int minPrecedence, const QString& owner, QList<TEException>& errors)
+{
+    ExpressionNode* left = parseOperand(owner, errors);
+    if (left == nullptr) return nullptr;
+
+    while (peek().kind != TokenKind::End) {
+        // Два операнда подряд
+        if (peek().kind != TokenKind::Operator || peekOperator(u"(")) {
+            errors.append(TEException(ErrorType::MissingOperations, QList<QString>{left->getValue()}));
+            return nullptr;
+        }
+
+        // Постфиксные операции связывают сильнее любых других
+        if (peekOperator(u"++") || peekOperator(u"--")) {
+            Token operatorToken = take();
+            QString operation = operatorToken.text == "++" ? QStringLiteral("_++") : QStringLiteral("_--");
+            if (!checkIncrementDecrementOperand(left, errors)) return nullptr;
+            left = build(operation, {left}, QString(), spanOf(operatorToken), errors);
+        }
+        else if (peekOperator(u"[")) {
+            qsizetype start = take().position;
+            ExpressionNode* index = parseExpression(0, QStringLiteral("[]"), errors);
+            if (index == nullptr || !expectClosing(u"]", QStringLiteral("["), errors)) return nullptr;
+            left = build(QStringLiteral("[]"), {left, index}, QString(), spanFrom(start), errors);
+        }
+        else if (peekOperator(u".") || peekOperator(u"->") || peekOperator(u"::")) {
+            left = parseMemberAccess(left, take().text, errors);
+        }
+        else {
+            int precedence = binaryPrecedence(peek().text);
+            // Закрывающая скобка или запятая завершают операнд
+            if (precedence < 0 && (peekOperator(u")") || peekOperator(u"]") || peekOperator(u","))) break;
+            if (precedence < 0) {
+                errors.append(TEException(ErrorType::MissingOperations, QList<QString>{left->getValue()}));
+                return nullptr;
+            }
+            if (precedence < minPrecedence) break;
+
+            Token operatorToken = take();
+            QString operation = operatorToken.text;
+            // Присваивания правоассоциативны, остальные бинарные операции – левоассоциативны
+            int rightPrecedence = precedence == AssignmentPrecedence ? precedence : precedence + 1;
+            ExpressionNode* right = parseExpression(rightPrecedence, operation, errors);
+            if (right == nullptr) return nullptr;
+            left = build(operation, {left, right}, QString(), spanOf(operatorToken), errors);
+        }
+        if (left == nullptr) return nullptr;
+    }
+    return left;
+}
+
+ExpressionNode* InfixParser::parseOperand(const QString& owner, QList<TEException>& errors)
+{
+    const Token& token = peek();
+
+    if (token.kind == TokenKind::Literal) {
+        Token literal = take();
+        return build(literal.text, {}, QString(), spanOf(literal), errors);
+    }
+
+    if (token.kind == TokenKind::Identifier) {
+        Token nameToken = take();
+        QString name = nameToken.text;
+        if (!peekOperator(u"(")) return build(name, {}, QString(), spanOf(nameToken), errors);
+
+        // Вызов функции занимает участок от имени до закрывающей скобки
+        take();
+        QList<ExpressionNode*> arguments;
+        if (!parseArguments(name, arguments, errors)) return nullptr;
+        return build(name + "(" + QString::number(arguments.size()) + ")", arguments, QString(), spanFrom(nameToken.position), errors);
+    }
+
+    if (peekOperator(u"(")) {
+        qsizetype start = take().position;
+        ExpressionNode* inner = parseExpression(0, owner, errors);
+        if (inner == nullptr || !expectClosing(u")", QStringLiteral("("), errors)) return nullptr;
+        // Скобки относятся к участку выражения в них
+        inner->setSpan(spanFrom(start));
+        return inner;
+    }
+
+    // Префиксные операции
+    QString operation = token.kind == TokenKind::Operator ? prefixOperationToken(token.text) : QString();
+    if (!operation.isEmpty()) {
+        Token operatorToken = take();
+        ExpressionNode* operand = parseExpression(PrefixPrecedence, operation, errors);
+        if (operand == nullptr) return nullptr;
+        if ((operation == "++_" || operation == "--_") && !checkIncrementDecrementOperand(operand, errors))
+            return nullptr;
+        // Единственный операнд в стеке превращает «-» в унарный минус
+        return build(operation, {operand}, QString(), spanOf(operatorToken), errors);
+    }
+
+    // Конец выражения, закрывающая скобка или бинарная операция на месте операнда
+    bool isSeparator = token.kind == TokenKind::End || peekOperator(u")") || peekOperator(u"]") || peekOperator(u",");
+    errors.append(TEException(ErrorType::MissingOperand, QList<QString>{isSeparator && !owner.isEmpty() ? owner : token.text}));
+    return nullptr;
+}
+
+ExpressionNode* InfixParser::parseMemberAccess(ExpressionNode* object, const QString& operation, QList<TEException>& errors)
+{
+    if (peek().kind != TokenKind::Identifier) {
+        errors.append(TEException(ErrorType::MissingOperand, QList<QString>{operation}));
+        return nullptr;
+    }
+    Token nameToken = take();
+    QString name = nameToken.text;
+
+    // Элемент определяется по типу объекта, который в обратной польской записи предшествует ему в стеке
+    QStack<ExpressionNode*> nodeStack;
+    nodeStack.push(object);
+    if (peekOperator(u"(")) {
+        take();
+        QList<ExpressionNode*> arguments;
+        if (!parseArguments(name, arguments, errors)) return nullptr;
+        for (ExpressionNode* argument : arguments)
+            nodeStack.push(argument);
+        name += "(" + QString::number(arguments.size()) + ")";
+    }
+    if (!expression.processToken(name, operation, nodeStack, context, errors)) return nullptr;
+    createdNodes.append(nodeStack.top());
+    nodeStack.top()->setSpan(spanFrom(nameToken.position));
+    if (!expression.processToken(operation, QString(), nodeStack, context, errors)) return nullptr;
+    createdNodes.append(nodeStack.top());
+    // Знак операции стоит между объектом и элементом, поэтому участок узла объединяет их участки
+    nodeStack.top()->setSpan(ExpressionSpan());
+    return nodeStack.pop();
+}
+
+bool InfixParser::parseArguments(const QString& functionName, QList<ExpressionNode*>& arguments, QList<TEException>& errors)
+{
+    if (peekOperator(u")")) {
+        take();
+        return true;
+    }
+    while (true) {
+        ExpressionNode* argument = parseExpression(0, functionName, errors);
+        if (argument == nullptr) return false;
+        arguments.append(argument);
+        if (peekOperator(u",")) {
+            take();
+            continue;
+        }
+        return expectClosing(u")", QStringLiteral("("), errors);
+    }
+}
+
+ExpressionNode* InfixParser::build(const QString& token, const QList<ExpressionNode*>& operands, const QString& nextToken, ExpressionSpan tokenSpan, QList<TEException>& errors)
+{
+    QStack<ExpressionNode*> nodeStack;
+    for (ExpressionNode* operand : operands)
+        nodeStack.push(operand);
+    if (!expression.processToken(token, nextToken, nodeStack, context, errors)) return nullptr;
+    createdNodes.append(nodeStack.top());
+    nodeStack.top()->setSpan(tokenSpan);
+    return nodeStack.pop();
+}
+
+bool InfixParser::checkIncrementDecrementOperand(const ExpressionNode* operand, QList<TEException>& errors)
+{
+    if (operand->getNodeType() == EntityType::Operation && operationTraits(operand->getOperType()).isIncrementOrDecrement) {
+        errors.append(TEException(ErrorType::MultipleIncrementDecrement, QList<QString>{operand->getLeftNode()->getValue()}));
+        return false;
+    }
+    return true;
+}
+
+int InfixParser::binaryPrecedence(QStringView operation)
+{
+    if (operation == u"=" || operation == u"+=" || operation == u"-=" || operation == u"*=" || operation == u"/=" || operation == u"%=")
+        return AssignmentPrecedence;
+    if (operation == u"||") return OrPrecedence;
+    if (operation == u"&&") return AndPrecedence;
+    if (operation == u"==" || operation == u"!=") return EqualityPrecedence;
+    if (operation == u"<" || operation == u">" || operation == u"<=" || operation == u">=") return RelationalPrecedence;
+    if (operation == u"+" || operation == u"-") return AdditivePrecedence;
+    if (operation == u"*" || operation == u"/" || operation == u"%") return MultiplicativePrecedence;
+    return -1;
+}
+
+const InfixParser::Token& InfixParser::peek() const
+{
+    return position < tokens.size() ? tokens[position] : endToken;
+}
+
+bool InfixParser::peekOperator(QStringView text) const
+{
+    return peek().kind == TokenKind::Operator && peek().text == text;
+}
+
+ExpressionSpan InfixParser::spanFrom(qsizetype start) const
+{
+    const Token& last = tokens[position - 1];
+    return ExpressionSpan{start, last.position + last.text.size()};
+}
+
+ExpressionSpan InfixParser::spanOf(const Token& token)
+{
+    return ExpressionSpan{token.position, token.position + token.text.size()};
+}
+
+InfixParser::Token InfixParser::take()
+{
+    Token token = peek();
+    if (position < tokens.size()) position++;
+    return token;
+}
+
+bool InfixParser::expectClosing(QStringView closing, const QString& opening, QList<TEException>& errors)
+{
+    if (peekOperator(closing)) {
+        take();
+        return true;
+    }
+    errors.append(TEException(ErrorType::InvalidSymbol, QList<QString>{peek().kind == TokenKind::End ? opening : peek().text}));
+    return false;
+}
@@ -0,0 +1,178 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса InfixParser для построения дерева выражения по инфиксной записи.
+ */
+
+#ifndef INFIXPARSER_H
+#define INFIXPARSER_H
+
+#include "expression.h"
+
+/*!
+ * \brief Класс для построения дерева выражения по обычной инфиксной записи C++.
+ *
+ * Выражение разбирается методом повышения приоритета (Пратта) за один проход. Каждый узел строится теми же
+ * методами Expression, что и при разборе обратной польской записи: разбор передаёт в Expression::processToken
+ * лексему в обратной польской записи и её операнды, поэтому определение типов переменных, функций, полей и
+ * элементов перечислений и сообщения об ошибках совпадают для обеих форм записи.
+ *
+ * Приоритеты операций (от низшего к высшему): присваивания (правоассоциативные), `||`, `&&`, `==` и `!=`,
+ * `<`, `>`, `<=` и `>=`, `+` и `-`, `*`, `/` и `%`, префиксные `++`, `--`, `-`, `!`, `*`, `&`,
+ * постфиксные `++`, `--`, `[]`, вызов функции, `.`, `->`, `::`.
+ */
+class InfixParser
+{
+public:
+    /*!
+     * \brief Конструктор класса InfixParser.
+     * \param[in] expression Выражение, для которого строится дерево.
+     */
+    explicit InfixParser(Expression& expression);
+
+    /*!
+     * \brief Построение дерева выражения с остановкой на первой ошибке.
+     * \param[out] errors Список ошибок.
+     * \return Указатель на корневой узел дерева или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* parse(QList<TEException>& errors);
+
+private:
+    /*!
+     * \brief Построение дерева выражения без удаления узлов при ошибке.
+     * \param[out] errors Список ошибок.
+     * \return Указатель на корневой узел дерева или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* buildTree(QList<TEException>& errors);
+
+    /*!
+     * \brief Перечисление видов лексем инфиксной записи.
+     */
+    enum class TokenKind {
+        Identifier,     /*!< Идентификатор */
+        Literal,        /*!< Числовая или строковая константа */
+        Operator,       /*!< Знак операции или разделитель */
+        End             /*!< Конец выражения */
+    };
+
+    /*!
+     * \brief Структура, описывающая лексему инфиксной записи.
+     */
+    struct Token {
+        TokenKind kind = TokenKind::End;    /*!< Вид лексемы */
+        QString text;                       /*!< Текст лексемы */
+        qsizetype position = 0;             /*!< Позиция лексемы в выражении */
+    };
+
+    /*!
+     * \brief Разделение выражения на лексемы.
+     * \param[in] text Выражение.
+     * \param[out] errors Список ошибок.
+     * \return true, если выражение не содержит недопустимых символов.
+     */
+    bool tokenize(const QString& text, QList<TEException>& errors);
+
+    /*!
+     * \brief Разбор выражения, операции которого имеют приоритет не ниже заданного.
+     * \param[in] minPrecedence Минимальный приоритет операций.
+     * \param[in] owner Операция, операндом которой является выражение (для сообщений об ошибках).
+     * \param[out] errors Список ошибок.
+     * \return Корневой узел поддерева или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* parseExpression(int minPrecedence, const QString& owner, QList<TEException>& errors);
+
+    /*!
+     * \brief Разбор операнда: константы, переменной, вызова функции, выражения в скобках или префиксной операции.
+     * \param[in] owner Операция, операндом которой является выражение (для сообщений об ошибках).
+     * \param[out] errors Список ошибок.
+     * \return Корневой узел поддерева или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* parseOperand(const QString& owner, QList<TEException>& errors);
+
+    /*!
+     * \brief Разбор обращения к элементу через `.`, `->` или `::`.
+     * \param[in] object Узел объекта, к элементу которого выполняется обращение.
+     * \param[in] operation Знак операции обращения.
+     * \param[out] errors Список ошибок.
+     * \return Узел операции обращения или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* parseMemberAccess(ExpressionNode* object, const QString& operation, QList<TEException>& errors);
+
+    /*!
+     * \brief Разбор списка аргументов вызова функции после открывающей скобки.
+     * \param[in] functionName Имя функции.
+     * \param[out] arguments Узлы аргументов.
+     * \param[out] errors Список ошибок.
+     * \return true, если список аргументов разобран.
+     */
+    bool parseArguments(const QString& functionName, QList<ExpressionNode*>& arguments, QList<TEException>& errors);
+
+    /*!
+     * \brief Построение узла по лексеме обратной польской записи и её операндам.
+     * \param[in] token Лексема в обратной польской записи.
+     * \param[in] operands Операнды лексемы.
+     * \param[in] nextToken Лексема, которая следует за данной в обратной польской записи.
+     * \param[in] tokenSpan Участок выражения, занимаемый лексемой узла.
+     * \param[out] errors Список ошибок.
+     * \return Построенный узел или nullptr, если обнаружена ошибка.
+     */
+    ExpressionNode* build(const QString& token, const QList<ExpressionNode*>& operands, const QString& nextToken, ExpressionSpan tokenSpan, QList<TEException>& errors);
+
+    /*!
+     * \brief Проверка, что операнд инкремента или декремента сам не является инкрементом или декрементом.
+     * \param[in] operand Операнд.
+     * \param[out] errors Список ошибок.
+     * \return true, если операнд допустим.
+     */
+    static bool checkIncrementDecrementOperand(const ExpressionNode* operand, QList<TEException>& errors);
+
+    /*!
+     * \brief Получение приоритета бинарной операции.
+     * \param[in] operation Знак операции.
+     * \return Приоритет операции или -1, если знак не обозначает бинарную операцию.
+     */
+    static int binaryPrecedence(QStringView operation);
+
+    /*!
+     * \brief Получение текущей лексемы.
+     */
+    const Token& peek() const;
+
+    /*!
+     * \brief Проверка, что текущая лексема – заданный знак операции или разделитель.
+     */
+    bool peekOperator(QStringView text) const;
+
+    /*!
+     * \brief Переход к следующей лексеме.
+     * \return Текущая лексема.
+     */
+    Token take();
+
+    /*!
+     * \brief Получение участка выражения от заданной позиции до конца последней пройденной лексемы.
+     */
+    ExpressionSpan spanFrom(qsizetype start) const;
+
+    /*!
+     * \brief Получение участка выражения, занимаемого лексемой.
+     */
+    static ExpressionSpan spanOf(const Token& token);
+
+    /*!
+     * \brief Пропуск закрывающей скобки.
+     * \param[in] closing Закрывающая скобка.
+     * \param[in] opening Соответствующая открывающая скобка.
+     * \param[out] errors Список ошибок.
+     * \return true, если текущая лексема – ожидаемая закрывающая скобка.
+     */
+    bool expectClosing(QStringView closing, const QString& opening, QList<TEException>& errors);
+
+    Expression& expression;                     /*!< Выражение, для которого строится дерево */
+    Expression::TreeBuildContext context;       /*!< Состояние построения дерева */
+    QList<Token> tokens;                        /*!< Лексемы выражения */
+    qsizetype position = 0;                     /*!< Индекс текущей лексемы */
+    Token endToken;                             /*!< Лексема конца выражения */
+    QList<ExpressionNode*> createdNodes;        /*!< Узлы, созданные разбором */
+};
+
+#endif // INFIXPARSER_H
@@ -0,0 +1,107 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса InputBudget для ограничения ресурсов обработки одного входного файла.
+ */
+
+#include "inputbudget.h"
+
+thread_local InputBudget::Scope* InputBudget::current = nullptr;
+
+qint64 BudgetLimits::limit(BudgetResource resource) const
+{
+    switch (resource) {
+    case BudgetResource::WallTime:      return wallTimeMs;
+    case BudgetResource::Nodes:         return nodes;
+    case BudgetResource::OutputLength:  return outputLength;
+    case BudgetResource::Bytes:         return bytes;
+    case BudgetResource::Count:         break;
+    }
+    return 0;
+}
+
+bool BudgetLimits::isUnlimited() const
+{
+    return wallTimeMs <= 0 && nodes <= 0 && outputLength <= 0 && bytes <= 0;
+}
+
+InputBudget::Scope::Scope(const BudgetLimits& limits)
+    : limits(limits), previous(InputBudget::current)
+{
+    timer.start();
+    InputBudget::current = this;
+}
+
+InputBudget::Scope::~Scope()
+{
+    InputBudget::current = previous;
+}
+
+qint64 InputBudget::Scope::used(BudgetResource resource) const
+{
+    if (resource == BudgetResource::WallTime) return timer.elapsed();
+    return usage[static_cast<int>(resource)];
+}
+
+bool InputBudget::Scope::isExceeded() const
+{
+    return exceededResource != -1;
+}
+
+QString InputBudget::resourceName(BudgetResource resource)
+{
+    switch (resource) {
+    case BudgetResource::WallTime:      return QStringLiteral("time-ms");
+    case BudgetResource::Nodes:         return QStringLiteral("nodes");
+    case BudgetResource::OutputLength:  return QStringLiteral("output-length");
+    case BudgetResource::Bytes:         return QStringLiteral("bytes");
+    case BudgetResource::Count:         break;
+    }
+    return QString();
+}
+
+bool InputBudget::parseLimits(QStringView text, BudgetLimits& limits)
+{
+    BudgetLimits parsed;
+    for (QStringView item : text.split(',')) {
+        qsizetype separator = item.indexOf(':');
+        if (separator == -1) return false;
+        QStringView name = item.first(separator).trimmed();
+        bool isNumber = false;
+        qint64 value = item.sliced(separator + 1).trimmed().toLongLong(&isNumber);
+        if (!isNumber || value <= 0) return false;
+
+        if (name == resourceName(BudgetResource::WallTime)) parsed.wallTimeMs = value;
+        else if (name == resourceName(BudgetResource::Nodes)) parsed.nodes = value;
+        else if (name == resourceName(BudgetResource::OutputLength)) parsed.outputLength = value;
+        else if (name == resourceName(BudgetResource::Bytes)) parsed.bytes = value;
+        else return false;
+    }
+    limits = parsed;
+    return true;
+}
+
+bool InputBudget::chargeCurrent(BudgetResource resource, qint64 amount, QList<TEException>* errors)
+{
+    Scope& budget = *current;
+    if (budget.exceededResource == -1) {
+        if (resource != BudgetResource::WallTime) {
+            qint64& used = budget.usage[static_cast<int>(resource)];
+            used += amount;
+            qint64 limit = budget.limits.limit(resource);
+            if (limit > 0 && used > limit) budget.exceededResource = static_cast<int>(resource);
+        }
+        // Время проверяется при каждом расходовании, поэтому долгий этап прерывается в ближайшей точке проверки
+        if (budget.exceededResource == -1 && budget.limits.wallTimeMs > 0 && budget.timer.elapsed() > budget.limits.wallTimeMs)
+            budget.exceededResource = static_cast<int>(BudgetResource::WallTime);
+        if (budget.exceededResource == -1) return true;
+    }
+
+    // Превышенный бюджет сообщается каждой следующей точкой проверки
+    if (errors != nullptr) {
+        BudgetResource exceeded = static_cast<BudgetResource>(budget.exceededResource);
+        errors->append(TEException(ErrorType::BudgetExceeded, QList<QString>{resourceName(exceeded),
+                                                                             QString::number(budget.used(exceeded)),
+                                                                             QString::number(budget.limits.limit(exceeded))}));
+    }
+    return false;
+}
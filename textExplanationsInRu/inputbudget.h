@@ -0,0 +1,188 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса InputBudget для ограничения ресурсов обработки одного входного файла.
+ */
+
+#ifndef INPUTBUDGET_H
+#define INPUTBUDGET_H
+
+#include "teexception.h"
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#include <array>
+
+/*!
+ * \brief Перечисление ресурсов, расходуемых при обработке входного файла.
+ */
+enum class BudgetResource {
+    WallTime,       /*!< Время обработки в миллисекундах */
+    Nodes,          /*!< Созданные узлы деревьев выражений */
+    OutputLength,   /*!< Длина построенных описаний в символах */
+    Bytes,          /*!< Байты основных выделений памяти: входные данные, узлы, описания */
+    Count           /*!< Количество ресурсов */
+};
+
+/*!
+ * \brief Структура, описывающая ограничения ресурсов обработки одного входного файла.
+ *
+ * Нулевое значение означает отсутствие ограничения.
+ */
+struct BudgetLimits {
+    qint64 wallTimeMs = 0;      /*!< Время обработки в миллисекундах */
+    qint64 nodes = 0;           /*!< Количество узлов деревьев выражений */
+    qint64 outputLength = 0;    /*!< Суммарная длина описаний в символах */
+    qint64 bytes = 0;           /*!< Байты основных выделений памяти */
+
+    /*!
+     * \brief Ограничение ресурса.
+     * \param[in] resource Ресурс.
+     * \return Ограничение или 0, если ресурс не ограничен.
+     */
+    qint64 limit(BudgetResource resource) const;
+
+    /*!
+     * \brief Проверка, что ни один ресурс не ограничен.
+     */
+    bool isUnlimited() const;
+};
+
+/*!
+ * \brief Класс для ограничения ресурсов обработки одного входного файла.
+ *
+ * Бюджет действует в потоке, пока существует объект Scope. Разборщик документа, построитель дерева
+ * и переводчик расходуют бюджет в точках проверки; при превышении бюджета обработка прерывается
+ * с ошибкой BudgetExceeded, а созданные узлы удаляются. После превышения все следующие проверки
+ * бюджета также завершаются ошибкой, поэтому обработка файла не продолжается после первой ошибки.
+ * Без активного бюджета каждая точка проверки сводится к чтению одного указателя.
+ *
+ * Пример использования:
+ * \code
+ * BudgetLimits limits;
+ * limits.wallTimeMs = 1000;
+ * InputBudget::Scope budget(limits);
+ * TEResult<QString> explanation = expression.tryGetExplanationInRu();
+ * \endcode
+ */
+class InputBudget
+{
+public:
+    /*!
+     * \brief Класс, устанавливающий бюджет потока от создания до уничтожения объекта.
+     *
+     * Вложенный бюджет заменяет внешний; после уничтожения вложенного действует внешний.
+     */
+    class Scope
+    {
+    public:
+        /*!
+         * \brief Устанавливает бюджет и начинает отсчёт времени.
+         * \param[in] limits Ограничения ресурсов.
+         */
+        explicit Scope(const BudgetLimits& limits);
+
+        /*!
+         * \brief Восстанавливает бюджет, действовавший до создания объекта.
+         */
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /*!
+         * \brief Израсходованное количество ресурса.
+         * \param[in] resource Ресурс.
+         */
+        qint64 used(BudgetResource resource) const;
+
+        /*!
+         * \brief Проверка, превышен ли бюджет.
+         */
+        bool isExceeded() const;
+
+    private:
+        friend class InputBudget;
+
+        static constexpr int resourceCount = static_cast<int>(BudgetResource::Count);
+
+        BudgetLimits limits;                            /*!< Ограничения ресурсов */
+        std::array<qint64, resourceCount> usage = {};   /*!< Израсходованные ресурсы */
+        int exceededResource = -1;                      /*!< Первый превышенный ресурс или -1 */
+        QElapsedTimer timer;                            /*!< Монотонный таймер */
+        Scope* previous;                                /*!< Бюджет, действовавший до создания объекта */
+    };
+
+    /*!
+     * \brief Проверка, действует ли бюджет в текущем потоке.
+     */
+    static bool isActive() { return current != nullptr; }
+
+    /*!
+     * \brief Расходование ресурса с добавлением ошибки в список.
+     *
+     * Каждое расходование также проверяет время обработки.
+     * \param[in] resource Ресурс; для WallTime проверяется только прошедшее время.
+     * \param[in] amount Количество ресурса.
+     * \param[out] errors Список ошибок; при превышении бюджета дополняется ошибкой BudgetExceeded.
+     * \return true, если бюджет не превышен.
+     */
+    static bool charge(BudgetResource resource, qint64 amount, QList<TEException>& errors)
+    {
+        if (current == nullptr) return true;
+        return chargeCurrent(resource, amount, &errors);
+    }
+
+    /*!
+     * \brief Расходование ресурса с исключением при превышении бюджета.
+     * \param[in] resource Ресурс; для WallTime проверяется только прошедшее время.
+     * \param[in] amount Количество ресурса.
+     * \throw TEException Ошибка BudgetExceeded.
+     */
+    static void charge(BudgetResource resource, qint64 amount = 0)
+    {
+        if (current == nullptr) return;
+        QList<TEException> errors;
+        if (!chargeCurrent(resource, amount, &errors)) throw errors.first();
+    }
+
+    /*!
+     * \brief Проверка превышения бюджета без добавления ошибки.
+     *
+     * Используется циклами, которые не могут вернуть ошибку: цикл прекращается,
+     * а ошибку добавляет следующая точка проверки.
+     * \return true, если бюджет превышен.
+     */
+    static bool isExhausted()
+    {
+        return current != nullptr && !chargeCurrent(BudgetResource::WallTime, 0, nullptr);
+    }
+
+    /*!
+     * \brief Имя ресурса для сообщений и сводки.
+     * \param[in] resource Ресурс.
+     */
+    static QString resourceName(BudgetResource resource);
+
+    /*!
+     * \brief Разбор записи ограничений вида "time-ms:1000,nodes:5000,output-length:100000,bytes:1000000".
+     * \param[in] text Запись ограничений; ресурсы перечисляются через запятую в любом порядке, неуказанные не ограничиваются.
+     * \param[out] limits Ограничения ресурсов.
+     * \return true, если все имена ресурсов известны, а значения – положительные целые числа.
+     */
+    static bool parseLimits(QStringView text, BudgetLimits& limits);
+
+private:
+    /*!
+     * \brief Расходование ресурса действующего бюджета.
+     * \param[in] resource Ресурс.
+     * \param[in] amount Количество ресурса.
+     * \param[out] errors Список ошибок или nullptr, если ошибку добавлять не нужно.
+     * \return true, если бюджет не превышен.
+     */
+    static bool chargeCurrent(BudgetResource resource, qint64 amount, QList<TEException>* errors);
+
+    static thread_local Scope* current;     /*!< Бюджет текущего потока или nullptr */
+};
+
+#endif // INPUTBUDGET_H
@@ -0,0 +1,200 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию класса InputPack для контейнеров входных файлов.
+ */
+
+#include "inputpack.h"
+#include "pipelinestats.h"
+#include "tracerecorder.h"
+#include <QDir>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+// Сигнатура в начале каждого контейнера
+constexpr char PackMagic[4] = {'T', 'E', 'X', 'P'};
+
+// Размер заголовка записи без имени и содержимого: вид, длина имени, длина содержимого
+constexpr qsizetype RecordHeaderSize = 1 + 4 + 8;
+
+// Ошибка недействительного контейнера
+TEException invalidPack(const QString& source, const QString& reason)
+{
+    return TEException(ErrorType::InvalidInputPack, QList<QString>{source, reason});
+}
+
+// Запись заголовка контейнера
+bool writeHeader(QIODevice& device, qsizetype count)
+{
+    char header[InputPack::headerSize];
+    memcpy(header, PackMagic, sizeof(PackMagic));
+    qToBigEndian<quint32>(InputPack::formatVersion, header + 4);
+    qToBigEndian<quint64>(quint64(count), header + 8);
+    return device.write(header, sizeof(header)) == qint64(sizeof(header));
+}
+
+// Запись одной записи контейнера
+bool writeRecord(QIODevice& device, const QString& name, QByteArrayView data, PackRecordKind kind)
+{
+    const QByteArray utf8Name = name.toUtf8();
+    char header[RecordHeaderSize];
+    header[0] = char(kind);
+    qToBigEndian<quint32>(quint32(utf8Name.size()), header + 1);
+    qToBigEndian<quint64>(quint64(data.size()), header + 5);
+    // Длина имени записывается перед именем, длина содержимого – после него
+    return device.write(header, 5) == 5
+        && device.write(utf8Name) == utf8Name.size()
+        && device.write(header + 5, 8) == 8
+        && device.write(data.data(), data.size()) == data.size();
+}
+}
+
+InputPack::~InputPack()
+{
+    if (mapped != nullptr) file.unmap(mapped);
+}
+
+TEResult<QSharedPointer<const InputPack>> InputPack::load(const QString& path)
+{
+    TraceRecorder::Span span("InputPack::load");
+    QSharedPointer<InputPack> pack(new InputPack());
+    pack->file.setFileName(path);
+    if (!pack->file.open(QIODevice::ReadOnly))
+        return TEException(ErrorType::InputFileNotFound, path);
+
+    // Отобразить файл в память; если отображение недоступно, прочитать его целиком
+    qint64 size = pack->file.size();
+    pack->mapped = size > 0 ? pack->file.map(0, size) : nullptr;
+    QByteArrayView data;
+    if (pack->mapped != nullptr) {
+        data = QByteArrayView(pack->mapped, size);
+    }
+    else {
+        pack->content = pack->file.readAll();
+        data = pack->content;
+    }
+    PipelineStats::add(PipelineCounter::BytesRead, data.size());
+
+    QString reason;
+    if (!pack->readRecords(data, reason)) return invalidPack(path, reason);
+    return QSharedPointer<const InputPack>(pack);
+}
+
+qsizetype InputPack::count() const
+{
+    return records.size();
+}
+
+const PackRecord& InputPack::record(qsizetype index) const
+{
+    return records[index];
+}
+
+QList<TEException> InputPack::packFiles(const QStringList& files, const QString& baseDirectory, const QString& path)
+{
+    TraceRecorder::Span span("InputPack::packFiles");
+    QSaveFile output(path);
+    if (!output.open(QIODevice::WriteOnly) || !writeHeader(output, files.size()))
+        return QList<TEException>{TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{path})};
+
+    const QDir base(baseDirectory);
+    for (const QString& filePath : files) {
+        QFile input(filePath);
+        if (!input.open(QIODevice::ReadOnly)) {
+            output.cancelWriting();
+            return QList<TEException>{TEException(ErrorType::InputFileNotFound, filePath)};
+        }
+        QByteArray data = input.readAll();
+        PipelineStats::add(PipelineCounter::BytesRead, data.size());
+        if (!writeRecord(output, base.relativeFilePath(filePath), data, PackRecordKind::Content)) {
+            output.cancelWriting();
+            return QList<TEException>{TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{path})};
+        }
+    }
+
+    PipelineStats::add(PipelineCounter::BytesWritten, output.size());
+    if (!output.commit())
+        return QList<TEException>{TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{path})};
+    return QList<TEException>{};
+}
+
+QList<TEException> InputPack::save(const QList<PackRecord>& records, const QString& path)
+{
+    QSaveFile output(path);
+    bool isWritten = output.open(QIODevice::WriteOnly) && writeHeader(output, records.size());
+    for (qsizetype i = 0; i < records.size() && isWritten; i++)
+        isWritten = writeRecord(output, records[i].name, records[i].data, records[i].kind);
+    if (isWritten) PipelineStats::add(PipelineCounter::BytesWritten, output.size());
+    if (!isWritten || !output.commit())
+        return QList<TEException>{TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{path})};
+    return QList<TEException>{};
+}
+
+bool InputPack::isPackFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    return isPack(file.read(sizeof(PackMagic)));
+}
+
+bool InputPack::isPack(QByteArrayView data)
+{
+    return data.startsWith(QByteArrayView(PackMagic, sizeof(PackMagic)));
+}
+
+bool InputPack::readRecords(QByteArrayView data, QString& reason)
+{
+    // Проверить заголовок до чтения записей
+    if (data.size() < headerSize || !isPack(data)) {
+        reason = "неверная сигнатура";
+        return false;
+    }
+    quint32 version = qFromBigEndian<quint32>(data.data() + 4);
+    if (version != formatVersion) {
+        reason = "версия формата " + QString::number(version) + ", ожидается " + QString::number(formatVersion);
+        return false;
+    }
+    quint64 count = qFromBigEndian<quint64>(data.data() + 8);
+    // Каждая запись занимает не меньше заголовка записи, поэтому слишком большое количество отклоняется до выделения памяти
+    if (count > quint64(data.size() - headerSize) / RecordHeaderSize) {
+        reason = "количество записей не соответствует размеру файла";
+        return false;
+    }
+
+    auto outOfBounds = [&reason](quint64 index) {
+        reason = "запись " + QString::number(index + 1) + " выходит за границы файла";
+        return false;
+    };
+
+    records.reserve(qsizetype(count));
+    qsizetype position = headerSize;
+    for (quint64 i = 0; i < count; i++) {
+        if (data.size() - position < RecordHeaderSize) return outOfBounds(i);
+        PackRecord record;
+        quint8 kind = quint8(data[position]);
+        quint64 nameSize = qFromBigEndian<quint32>(data.data() + position + 1);
+        position += 5;
+        if (nameSize > quint64(data.size() - position - 8)) return outOfBounds(i);
+        record.name = QString::fromUtf8(data.sliced(position, qsizetype(nameSize)));
+        position += qsizetype(nameSize);
+        quint64 dataSize = qFromBigEndian<quint64>(data.data() + position);
+        position += 8;
+        if (dataSize > quint64(data.size() - position)) return outOfBounds(i);
+        if (kind > quint8(PackRecordKind::Errors)) {
+            reason = "неизвестный вид записи " + QString::number(kind);
+            return false;
+        }
+        record.kind = static_cast<PackRecordKind>(kind);
+        // Содержимое записи ссылается на отображённую память без копирования
+        record.data = QByteArray::fromRawData(data.data() + position, qsizetype(dataSize));
+        position += qsizetype(dataSize);
+        records.append(record);
+    }
+
+    if (position != data.size()) {
+        reason = "после последней записи есть лишние данные";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,140 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса InputPack для контейнеров входных файлов.
+ */
+
+#ifndef INPUTPACK_H
+#define INPUTPACK_H
+
+#include "teexception.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Вид содержимого записи контейнера.
+ */
+enum class PackRecordKind : quint8 {
+    Content,    /*!< Содержимое файла: входной документ или пояснение */
+    Errors      /*!< Сообщения об ошибках обработки входного файла, по одному на строку */
+};
+
+/*!
+ * \brief Структура, описывающая запись контейнера.
+ */
+struct PackRecord {
+    QString name;                                   /*!< Имя записи – путь файла относительно каталога контейнера */
+    QByteArray data;                                /*!< Содержимое записи */
+    PackRecordKind kind = PackRecordKind::Content;  /*!< Вид содержимого */
+};
+
+/*!
+ * \brief Класс, представляющий контейнер – один файл с содержимым многих входных файлов.
+ *
+ * Контейнер начинается с заголовка фиксированного размера: сигнатура "TEXP", версия формата и количество
+ * записей. Каждая запись состоит из вида содержимого (1 байт), длины имени (4 байта), имени в UTF-8,
+ * длины содержимого (8 байт) и самого содержимого; числа записываются в порядке big-endian. Загруженный
+ * контейнер отображается в память целиком, а содержимое записей ссылается на отображённую память без
+ * копирования, поэтому пакетная обработка не открывает отдельный файл для каждого входного документа.
+ * Контейнер, записи которого выходят за границы файла, отклоняется с ошибкой InvalidInputPack.
+ * Тот же формат используется для результатов: запись результата имеет имя записи входного контейнера.
+ */
+class InputPack
+{
+public:
+    /*!
+     * \brief Текущая версия формата контейнера.
+     */
+    static constexpr quint32 formatVersion = 1;
+
+    /*!
+     * \brief Размер заголовка контейнера в байтах.
+     */
+    static constexpr qsizetype headerSize = 16;
+
+    /*!
+     * \brief Деструктор; освобождает отображённую память.
+     */
+    ~InputPack();
+
+    InputPack(const InputPack&) = delete;
+    InputPack& operator=(const InputPack&) = delete;
+
+    /*!
+     * \brief Загрузка контейнера из файла, отображённого в память.
+     * \param[in] path Путь к файлу контейнера.
+     * \return Контейнер либо ошибка InputFileNotFound или InvalidInputPack.
+     */
+    static TEResult<QSharedPointer<const InputPack>> load(const QString& path);
+
+    /*!
+     * \brief Получение количества записей.
+     */
+    qsizetype count() const;
+
+    /*!
+     * \brief Получение записи.
+     *
+     * Содержимое записи действительно, пока существует контейнер.
+     * \param[in] index Индекс записи.
+     */
+    const PackRecord& record(qsizetype index) const;
+
+    /*!
+     * \brief Запись контейнера из содержимого файлов.
+     *
+     * Файлы читаются и записываются по одному, поэтому весь набор входных файлов в памяти не хранится.
+     * Контейнер заменяется целиком и не создаётся, если какой-либо файл недоступен.
+     * \param[in] files Пути к файлам в порядке записей.
+     * \param[in] baseDirectory Каталог, относительно которого определяются имена записей.
+     * \param[in] path Путь к файлу контейнера.
+     * \return Список ошибок; пустой, если контейнер сохранён.
+     */
+    static QList<TEException> packFiles(const QStringList& files, const QString& baseDirectory, const QString& path);
+
+    /*!
+     * \brief Запись контейнера из записей в памяти.
+     * \param[in] records Записи.
+     * \param[in] path Путь к файлу контейнера.
+     * \return Список ошибок; пустой, если контейнер сохранён.
+     */
+    static QList<TEException> save(const QList<PackRecord>& records, const QString& path);
+
+    /*!
+     * \brief Проверка, начинается ли файл с сигнатуры контейнера.
+     * \param[in] path Путь к файлу.
+     * \return true, если файл является контейнером (возможно, повреждённым или устаревшим).
+     */
+    static bool isPackFile(const QString& path);
+
+    /*!
+     * \brief Проверка, начинаются ли данные с сигнатуры контейнера.
+     * \param[in] data Данные.
+     */
+    static bool isPack(QByteArrayView data);
+
+private:
+    /*!
+     * \brief Конструктор; контейнер создаётся только загрузкой.
+     */
+    InputPack() = default;
+
+    /*!
+     * \brief Разбор записей контейнера.
+     * \param[in] data Содержимое контейнера; записи ссылаются на него без копирования.
+     * \param[out] reason Причина, по которой контейнер отклонён.
+     * \return true, если заголовок и все записи корректны.
+     */
+    bool readRecords(QByteArrayView data, QString& reason);
+
+    QFile file;                 /*!< Файл контейнера */
+    uchar* mapped = nullptr;    /*!< Отображённое содержимое файла или nullptr */
+    QByteArray content;         /*!< Содержимое файла, если отображение недоступно */
+    QList<PackRecord> records;  /*!< Записи контейнера */
+};
+
+#endif // INPUTPACK_H
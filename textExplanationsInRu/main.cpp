@@ -4,8 +4,10 @@
 *
 * \mainpage Документация для программы "text explanations in Russian language (textExplanationsInRu)"
 Программа предназначена для генерации текстового объяснения выражения на русском языке. Она принимает на вход XML-файл с описанием выражения и генерирует соответствующее объяснение в виде текстового файла.
-\n\nДля функционирования программы необходима операционная система Windows 7 или выше.
-\nТребуемые библиотеки: Qt6Core.dll, Qt6Xml.dll, libgcc_s_seh-1.dll, libstdc++-6.dll, libwinpthread-1.dll
+\n\nДля функционирования программы необходима операционная система Windows 7 или выше либо Linux.
+\nТребуемые библиотеки: Qt6Core.dll, libgcc_s_seh-1.dll, libstdc++-6.dll, libwinpthread-1.dll (в Linux – libQt6Core.so)
+\nЯдро перевода также собирается в виде библиотеки textExplanationsInRuCore с интерфейсом на языке C (teapi.h),
+которую можно вызывать из другой программы без запуска отдельного процесса.
 \nПрограмма должна получать два аргумента командной строки: имя входного файла и имя выходного файла в формате 'txt'
 
 \nПример команды запуска программы:
@@ -18,14 +20,28 @@
 * \version 1.0
 */
 
+#include "batchrunner.h"
+#include "declarationlibrary.h"
+#include "directorywatcher.h"
 #include "expression.h"
+#include "expressionbundle.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+#include "inputbudget.h"
+#include "inputpack.h"
+#include "pipelinestats.h"
+#include "tracerecorder.h"
 #include "teexception.h"
 
 #include <QCoreApplication>
+#include <QDir>
 #include <QFileInfo>
-#include <windows.h>
-#include <conio.h>
 #include <QTextStream>
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
 
 
 /*!
@@ -36,12 +52,136 @@
 void printHelpMessage(QTextStream& cout, const QString& filename);
 
 /*!
- * \brief Печатает пояснение выражения, считанного из XML-файла
+ * \brief Печатает пояснения выражений, считанных из XML-файла, по одному на строку
  * \param[out] cout Поток, в который выводится пояснение
  * \param[in] inputFile Путь к входному XML-файлу с выражением
  * \param[in] outputFile Путь к выходному файлу (если необходимо сохранить результат)
+ * \param[in] library Библиотека объявлений или nullptr
+ */
+void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile, const DeclarationLibrary* library = nullptr);
+
+/*!
+ * \brief Проверяет входной XML-файл в режиме быстрого отказа и печатает результат проверки
+ * \param[out] cout Поток вывода
+ * \param[in] inputFile Путь к входному XML-файлу
+ * \param[in] library Библиотека объявлений или nullptr
+ */
+void printValidation(QTextStream& cout, const QString& inputFile, const DeclarationLibrary* library = nullptr);
+
+/*!
+ * \brief Проверяет входной XML-файл и сохраняет его в скомпилированный пакет
+ * \param[out] cout Поток вывода
+ * \param[in] inputFile Путь к входному XML-файлу
+ * \param[in] bundleFile Путь к файлу пакета
+ * \param[in] library Библиотека объявлений или nullptr
  */
-void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile);
+void printCompilation(QTextStream& cout, const QString& inputFile, const QString& bundleFile, const DeclarationLibrary* library = nullptr);
+
+/*!
+ * \brief Поясняет все XML-файлы каталога и обновляет пояснения изменённых файлов до завершения программы
+ * \param[in] app Объект приложения, цикл событий которого обрабатывает изменения файлов
+ * \param[out] cout Поток вывода
+ * \param[in] inputDirectory Каталог входных XML-файлов
+ * \param[in] outputDirectory Каталог выходных файлов или пустая строка
+ * \param[in] libraryFile Путь к библиотеке объявлений или пустая строка
+ * \return Код завершения цикла событий или 1, если наблюдение не начато
+ */
+int watchDirectory(QCoreApplication& app, QTextStream& cout, const QString& inputDirectory, const QString& outputDirectory, const QString& libraryFile);
+
+/*!
+ * \brief Поясняет входные файлы одного шарда и сохраняет результат шарда
+ * \param[out] cout Поток вывода
+ * \param[in] manifestPath Каталог входных файлов, файл со списком входных файлов или контейнер входных файлов
+ * \param[in] resultFile Путь к файлу результата шарда
+ * \param[in] shardOption Запись шарда вида "i/N" или "i/N:hash"; пустая строка – все входные файлы
+ * \param[in] budgetOption Запись ограничений ресурсов обработки каждого файла; пустая строка – без ограничений
+ * \param[in] packOutput Путь к контейнеру пояснений или пустая строка
+ * \param[in] library Библиотека объявлений или nullptr
+ */
+void printBatch(QTextStream& cout, const QString& manifestPath, const QString& resultFile, const QString& shardOption, const QString& budgetOption, const QString& packOutput, const DeclarationLibrary* library = nullptr);
+
+/*!
+ * \brief Объединяет результаты шардов в один результат в порядке списка входных файлов
+ * \param[out] cout Поток вывода
+ * \param[in] mergedFile Путь к объединённому файлу результата
+ * \param[in] shardFiles Пути к файлам результатов всех шардов
+ * \param[in] packOutput Путь к контейнеру пояснений или пустая строка
+ */
+void printMerge(QTextStream& cout, const QString& mergedFile, const QStringList& shardFiles, const QString& packOutput);
+
+/*!
+ * \brief Собирает входные файлы в один контейнер
+ * \param[out] cout Поток вывода
+ * \param[in] manifestPath Каталог входных файлов или файл со списком входных файлов
+ * \param[in] packFile Путь к файлу контейнера
+ */
+void printPack(QTextStream& cout, const QString& manifestPath, const QString& packFile);
+
+/*!
+ * \brief Печатает сводку результатов пакетной обработки: количество файлов, ошибок каждого типа и превышений бюджета
+ * \param[out] cout Поток вывода
+ * \param[in] result Результат пакетной обработки
+ */
+void printBatchStatistics(QTextStream& cout, const BatchResult& result);
+
+/*!
+ * \brief Считывает документ из XML-файла или из скомпилированного пакета
+ * \param[in] inputFile Путь к входному файлу
+ * \param[in] mode Режим проверки XML-файла
+ * \param[out] report Режим проверки и этап, на котором входные данные были отклонены
+ * \param[in] library Библиотека объявлений или nullptr
+ * \return Документ либо список ошибок
+ */
+TEResult<ExpressionDocument> readDocument(const QString& inputFile, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library);
+
+/*!
+ * \brief Печатает сообщения об ошибках, по одному на строку
+ * \param[out] cout Поток вывода
+ * \param[in] errors Список ошибок
+ */
+void printErrors(QTextStream& cout, const QList<TEException>& errors);
+
+/*!
+ * \brief Извлекает из списка аргументов ключ вывода статистики обработки
+ * \param[in,out] arguments Аргументы командной строки, из которых удаляется ключ "-stats" или "-stats=json"
+ * \return Формат статистики: "text", "json" или пустая строка, если ключ не указан
+ */
+QString takeStatsOption(QStringList& arguments);
+
+/*!
+ * \brief Извлекает из списка аргументов ключ записи трассировки
+ * \param[in,out] arguments Аргументы командной строки, из которых удаляется ключ "-trace=файл"
+ * \return Путь к файлу трассировки или пустая строка, если ключ не указан
+ */
+QString takeTraceOption(QStringList& arguments);
+
+/*!
+ * \brief Извлекает из списка аргументов ключ подключения библиотеки объявлений
+ * \param[in,out] arguments Аргументы командной строки, из которых удаляется ключ "-library=файл"
+ * \return Путь к файлу библиотеки или пустая строка, если ключ не указан
+ */
+QString takeLibraryOption(QStringList& arguments);
+
+/*!
+ * \brief Извлекает из списка аргументов ключ шарда пакетной обработки
+ * \param[in,out] arguments Аргументы командной строки, из которых удаляется ключ "-shard=i/N"
+ * \return Запись шарда или пустая строка, если ключ не указан
+ */
+QString takeShardOption(QStringList& arguments);
+
+/*!
+ * \brief Извлекает из списка аргументов ключ бюджета обработки каждого входного файла
+ * \param[in,out] arguments Аргументы командной строки, из которых удаляется ключ "-budget=ресурс:значение,..."
+ * \return Запись ограничений или пустая строка, если ключ не указан
+ */
+QString takeBudgetOption(QStringList& arguments);
+
+/*!
+ * \brief Извлекает из списка аргументов ключ сохранения пояснений в контейнер
+ * \param[in,out] arguments Аргументы командной строки, из которых удаляется ключ "-pack-output=файл"
+ * \return Путь к контейнеру пояснений или пустая строка, если ключ не указан
+ */
+QString takePackOutputOption(QStringList& arguments);
 
 /*!
  * \brief Проверяет доступность файла для записи
@@ -51,51 +191,185 @@ void printExplanation(QTextStream& cout, const QString& inputFile, const QString
 void checkFileAccess(const QString& filePath);
 
 /*!
- * \brief Записывает текст в указанный файл
+ * \brief Записывает текст в кодировке UTF-8 в указанный файл без перекодирования
  * \param[in] filePath Путь к файлу, в который нужно записать содержимое
- * \param[in] content Содержимое, которое будет записано в файл
+ * \param[in] content Содержимое в кодировке UTF-8, которое будет записано в файл
  * \throws TEException Если файл не может быть открыт для записи
  */
-void writeToFile(const QString& filePath, const QString& content);
+void writeToFile(const QString& filePath, QByteArrayView content);
 
 
 int main(int argc, char *argv[])
 {
+#ifdef Q_OS_WIN
     SetConsoleOutputCP(CP_UTF8);
+#endif
     QTextStream cout(stdout);
     cout.setEncoding(QStringConverter::Utf8);
 
     QCoreApplication a(argc, argv);
 
-#if defined(TESTS)
-    return runTest(argc, argv);
-#endif
-
     QString fileName = QCoreApplication::applicationFilePath();
     QFileInfo fileInfo(fileName);
     fileName = fileInfo.fileName();
 
+    // Отделить ключ статистики от остальных аргументов
+    QStringList arguments = QCoreApplication::arguments().mid(1);
+    QString statsFormat = takeStatsOption(arguments);
+    PipelineStats::setEnabled(!statsFormat.isEmpty());
+    QString traceFile = takeTraceOption(arguments);
+    if(!traceFile.isEmpty()) TraceRecorder::start(traceFile);
+
+    // Загрузить библиотеку объявлений, общую для входных файлов
+    QString libraryFile = takeLibraryOption(arguments);
+    QString shardOption = takeShardOption(arguments);
+    QString budgetOption = takeBudgetOption(arguments);
+    QString packOutput = takePackOutputOption(arguments);
+    QSharedPointer<const DeclarationLibrary> library;
+    QList<TEException> libraryErrors;
+    if(!libraryFile.isEmpty()) {
+        TEResult<QSharedPointer<const DeclarationLibrary>> loaded = DeclarationLibrary::load(libraryFile);
+        if(loaded) library = loaded.takeValue();
+        else libraryErrors = loaded.errors();
+    }
+
     // Если первый аргумент "-help"
-    if(QString(argv[1]) == "-help") {
+    if(arguments.value(0) == "-help") {
         // Напечатать справочную информацию
         printHelpMessage(cout, fileName);
     }
+    // Если библиотека объявлений содержит ошибки
+    else if(!libraryErrors.isEmpty()) {
+        printErrors(cout, libraryErrors);
+    }
     // Если первый аргумент "-test"
-    else if(QString(argv[1]) == "-test") {
+    else if(arguments.value(0) == "-test") {
         // Выполнить тесты
     }
-    // Если аргумента три и второй не начинается с "-"
-    else if(argc == 3 && !QString(argv[2]).startsWith("-")) {
-        printExplanation(cout, argv[1], argv[2]);
+    // Если первый аргумент "-compile" и указаны входной файл и файл пакета
+    else if(arguments.value(0) == "-compile" && arguments.size() == 3) {
+        printCompilation(cout, arguments[1], arguments[2], library.data());
+    }
+    // Если первый аргумент "-watch" и указан входной каталог
+    else if(arguments.value(0) == "-watch" && (arguments.size() == 2 || arguments.size() == 3)) {
+        watchDirectory(a, cout, arguments[1], arguments.value(2), libraryFile);
+    }
+    // Если первый аргумент "-batch" и указаны список входных файлов и файл результата
+    else if(arguments.value(0) == "-batch" && arguments.size() == 3) {
+        printBatch(cout, arguments[1], arguments[2], shardOption, budgetOption, packOutput, library.data());
+    }
+    // Если первый аргумент "-merge" и указаны объединённый файл и файлы результатов шардов
+    else if(arguments.value(0) == "-merge" && arguments.size() >= 3) {
+        printMerge(cout, arguments[1], arguments.mid(2), packOutput);
+    }
+    // Если первый аргумент "-pack" и указаны входные файлы и файл контейнера
+    else if(arguments.value(0) == "-pack" && arguments.size() == 3) {
+        printPack(cout, arguments[1], arguments[2]);
+    }
+    // Если первый аргумент "-check" и указан входной файл
+    else if(arguments.value(0) == "-check" && arguments.size() == 2) {
+        printValidation(cout, arguments[1], library.data());
+    }
+    // Если указаны два файла и второй не начинается с "-"
+    else if(arguments.size() == 2 && !arguments[1].startsWith("-")) {
+        printExplanation(cout, arguments[0], arguments[1], library.data());
     }
     else {
         cout << ("Ошибка в синтаксисе команды. Подробнее: .\\" + fileName +  " -help");
     }
 
+    // Сохранить трассировку
+    if(!TraceRecorder::finish()) {
+        cout << TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{traceFile}).what();
+    }
+
+    // Вывести статистику обработки в поток ошибок, чтобы не смешивать её с объяснением
+    if(!statsFormat.isEmpty()) {
+        cout.flush();
+        QTextStream cerr(stderr);
+        cerr << "\n" << (statsFormat == "json" ? QString::fromUtf8(PipelineStats::toJson()) : PipelineStats::toText());
+    }
+
     a.exit(0);
     return 0;
 }
 
+QString takeStatsOption(QStringList& arguments) {
+    QString format;
+    for (qsizetype i = 0; i < arguments.size(); ) {
+        if (arguments[i] == "-stats" || arguments[i] == "-stats=text") {
+            format = "text";
+            arguments.removeAt(i);
+        }
+        else if (arguments[i] == "-stats=json") {
+            format = "json";
+            arguments.removeAt(i);
+        }
+        else i++;
+    }
+    return format;
+}
+
+QString takeTraceOption(QStringList& arguments) {
+    QString path;
+    for (qsizetype i = 0; i < arguments.size(); ) {
+        if (arguments[i].startsWith("-trace=")) {
+            path = arguments[i].mid(QString("-trace=").size());
+            arguments.removeAt(i);
+        }
+        else i++;
+    }
+    return path;
+}
+
+QString takeLibraryOption(QStringList& arguments) {
+    QString path;
+    for (qsizetype i = 0; i < arguments.size(); ) {
+        if (arguments[i].startsWith("-library=")) {
+            path = arguments[i].mid(QString("-library=").size());
+            arguments.removeAt(i);
+        }
+        else i++;
+    }
+    return path;
+}
+
+QString takeShardOption(QStringList& arguments) {
+    QString shard;
+    for (qsizetype i = 0; i < arguments.size(); ) {
+        if (arguments[i].startsWith("-shard=")) {
+            shard = arguments[i].mid(QString("-shard=").size());
+            arguments.removeAt(i);
+        }
+        else i++;
+    }
+    return shard;
+}
+
+QString takeBudgetOption(QStringList& arguments) {
+    QString budget;
+    for (qsizetype i = 0; i < arguments.size(); ) {
+        if (arguments[i].startsWith("-budget=")) {
+            budget = arguments[i].mid(QString("-budget=").size());
+            arguments.removeAt(i);
+        }
+        else i++;
+    }
+    return budget;
+}
+
+QString takePackOutputOption(QStringList& arguments) {
+    QString path;
+    for (qsizetype i = 0; i < arguments.size(); ) {
+        if (arguments[i].startsWith("-pack-output=")) {
+            path = arguments[i].mid(QString("-pack-output=").size());
+            arguments.removeAt(i);
+        }
+        else i++;
+    }
+    return path;
+}
+
 void checkFileAccess(const QString& filePath) {
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
@@ -104,45 +378,248 @@ void checkFileAccess(const QString& filePath) {
     file.close();
 }
 
-void writeToFile(const QString& filePath, const QString& content) {
+void writeToFile(const QString& filePath, QByteArrayView content) {
+    PipelineStats::ScopedTimer timer(PipelineStage::OutputWrite);
     QFile file(filePath);
     if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << content;
+        file.write(content.data(), content.size());
+        PipelineStats::add(PipelineCounter::BytesWritten, file.size());
         file.close();
     } else {
         throw TEException(ErrorType::OutputFileCannotBeCreated, QList<QString>{filePath});
     }
 }
 
-void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile) {
+void printExplanation(QTextStream& cout, const QString& inputFile, const QString& outputFile, const DeclarationLibrary* library) {
+    TraceRecorder::FileScope traceFile(inputFile);
     try {
         // Проверить доступ к выходному файлу
         checkFileAccess(outputFile);
         // Считать входной файл
-        Expression exp = Expression::fromFile(inputFile);
-        // Получить объяснение выражения
-        QString explanation = exp.getExplanationInRu();
+        ParseReport report;
+        TEResult<ExpressionDocument> document = readDocument(inputFile, ValidationMode::CollectAll, report, library);
+        if (!document) {
+            printErrors(cout, document.errors());
+            return;
+        }
+        // Получить объяснения всех выражений документа
+        QList<TEException> documentErrors;
+        QList<TEResult<QString>> explanations = document.value().tryGetExplanationsInRu(documentErrors);
+        QStringList lines;
+        bool failed = false;
+        for (qsizetype i = 0; i < explanations.size(); i++) {
+            if (explanations[i]) {
+                lines.append(explanations[i].value());
+                continue;
+            }
+            // Ошибки выражения из списка печатаются с его номером
+            if (explanations.size() > 1) cout << "expression " << i + 1 << ":\n";
+            printErrors(cout, explanations[i].errors());
+            failed = true;
+        }
+        // Объявления, не использованные ни одним выражением документа
+        printErrors(cout, documentErrors);
+        if (failed || !documentErrors.isEmpty()) return;
+        // Перекодировать объяснения в UTF-8 один раз для консоли и выходного файла
+        QByteArray utf8Explanation = lines.join('\n').toUtf8();
         // Вывести объяснение в консоль
-        cout << explanation;
+        cout.flush();
+        fwrite(utf8Explanation.constData(), 1, utf8Explanation.size(), stdout);
+        fflush(stdout);
         // Записать объяснение в выходной файл
-        writeToFile(outputFile, explanation);
-    } catch (QList<TEException>& errors) {
-        for (const TEException& error : errors) {
-            cout << error.what() << "\n";
-        }
+        writeToFile(outputFile, utf8Explanation);
     } catch (TEException& error) {
         cout << error.what();
     }
 }
 
+void printValidation(QTextStream& cout, const QString& inputFile, const DeclarationLibrary* library) {
+    TraceRecorder::FileScope traceFile(inputFile);
+    ParseReport report;
+    // Разобрать входной файл до первой ошибки
+    TEResult<ExpressionDocument> document = readDocument(inputFile, ValidationMode::FailFast, report, library);
+    QList<TEException> errors = document.errors();
+    // Если документ корректен, построить деревья выражений
+    if (document) {
+        errors = document.value().checkExpressions();
+        if (!errors.isEmpty()) report.stage = RejectionStage::Expression;
+    }
+
+    if (errors.isEmpty()) {
+        cout << "accepted\n";
+    }
+    else {
+        cout << "rejected (mode: fail-fast, stage: " << ExpressionXmlParser::rejectionStageName(report.stage) << ")\n";
+        printErrors(cout, errors);
+    }
+}
+
+void printCompilation(QTextStream& cout, const QString& inputFile, const QString& bundleFile, const DeclarationLibrary* library) {
+    TraceRecorder::FileScope traceFile(inputFile);
+    ParseReport report;
+    // Сохранить в пакет только документ, все выражения которого строятся без ошибок
+    TEResult<ExpressionDocument> document = ExpressionXmlParser::parseDocumentFile(inputFile, ValidationMode::CollectAll, report, library);
+    QList<TEException> errors = document ? document.value().checkExpressions() : document.errors();
+    if (errors.isEmpty()) errors = ExpressionBundle::save(document.value(), bundleFile, inputFile, library);
+
+    if (errors.isEmpty()) cout << "compiled\n";
+    else printErrors(cout, errors);
+}
+
+int watchDirectory(QCoreApplication& app, QTextStream& cout, const QString& inputDirectory, const QString& outputDirectory, const QString& libraryFile) {
+    if (!QFileInfo(inputDirectory).isDir()) {
+        cout << TEException(ErrorType::InputFileNotFound, QList<QString>{inputDirectory}).what() << "\n";
+        return 1;
+    }
+    DirectoryWatcher watcher(inputDirectory, outputDirectory, libraryFile);
+    // Печатать только файлы, которые были разобраны заново
+    QObject::connect(&watcher, &DirectoryWatcher::fileRefreshed, [&](const QString& inputFile, RefreshOutcome outcome, const QList<TEException>& errors) {
+        switch (outcome) {
+        case RefreshOutcome::Unchanged:
+            return;
+        case RefreshOutcome::Written:
+            cout << "written: " << watcher.outputPath(inputFile) << "\n";
+            break;
+        case RefreshOutcome::OutputUnchanged:
+            cout << "unchanged: " << watcher.outputPath(inputFile) << "\n";
+            break;
+        case RefreshOutcome::Failed:
+            cout << "failed: " << inputFile << "\n";
+            printErrors(cout, errors);
+            break;
+        case RefreshOutcome::Removed:
+            cout << "removed: " << inputFile << "\n";
+            break;
+        }
+        cout.flush();
+    });
+
+    QList<TEException> startErrors = watcher.start();
+    if (!startErrors.isEmpty()) {
+        printErrors(cout, startErrors);
+        return 1;
+    }
+    cout << "watching " << watcher.fileCount() << " files in " << QDir(inputDirectory).absolutePath() << "\n";
+    cout.flush();
+    return app.exec();
+}
+
+void printBatch(QTextStream& cout, const QString& manifestPath, const QString& resultFile, const QString& shardOption, const QString& budgetOption, const QString& packOutput, const DeclarationLibrary* library) {
+    ShardSpec shard;
+    if (!shardOption.isEmpty() && !BatchRunner::parseShard(shardOption, shard)) {
+        cout << "Ошибка в записи шарда \"" << shardOption << "\": ожидается i/N или i/N:hash, где 1 <= i <= N\n";
+        return;
+    }
+    BudgetLimits budget;
+    if (!budgetOption.isEmpty() && !InputBudget::parseLimits(budgetOption, budget)) {
+        cout << "Ошибка в записи бюджета \"" << budgetOption << "\": ожидается список ресурс:значение через запятую, где ресурс – time-ms, nodes, output-length или bytes, а значение – положительное целое число\n";
+        return;
+    }
+    BatchResult result;
+    // Контейнер разбирается из отображённой памяти, остальные входные файлы читаются по списку
+    if (InputPack::isPackFile(manifestPath)) {
+        TEResult<QSharedPointer<const InputPack>> pack = InputPack::load(manifestPath);
+        if (!pack) {
+            printErrors(cout, pack.errors());
+            return;
+        }
+        result = BatchRunner::run(*pack.value(), shard, library, budget);
+    }
+    else {
+        TEResult<QStringList> manifest = BatchRunner::readManifest(manifestPath);
+        if (!manifest) {
+            printErrors(cout, manifest.errors());
+            return;
+        }
+        result = BatchRunner::run(manifest.value(), shard, library, budget);
+    }
+    QList<TEException> errors = BatchRunner::save(result, resultFile);
+    if (errors.isEmpty() && !packOutput.isEmpty()) errors = BatchRunner::savePacked(result, packOutput);
+    if (!errors.isEmpty()) {
+        printErrors(cout, errors);
+        return;
+    }
+    cout << "shard " << shard.toString() << ": " << result.records.size() << " of " << result.manifestSize << " inputs\n";
+    printBatchStatistics(cout, result);
+}
+
+void printMerge(QTextStream& cout, const QString& mergedFile, const QStringList& shardFiles, const QString& packOutput) {
+    QList<BatchResult> shards;
+    for (const QString& shardFile : shardFiles) {
+        TEResult<BatchResult> shard = BatchRunner::load(shardFile);
+        if (!shard) {
+            printErrors(cout, shard.errors());
+            return;
+        }
+        shards.append(shard.takeValue());
+    }
+    TEResult<BatchResult> merged = BatchRunner::merge(shards);
+    QList<TEException> errors = merged ? BatchRunner::save(merged.value(), mergedFile) : merged.errors();
+    if (errors.isEmpty() && !packOutput.isEmpty()) errors = BatchRunner::savePacked(merged.value(), packOutput);
+    if (!errors.isEmpty()) {
+        printErrors(cout, errors);
+        return;
+    }
+    cout << "merged " << shards.size() << " shards\n";
+    printBatchStatistics(cout, merged.value());
+}
+
+void printPack(QTextStream& cout, const QString& manifestPath, const QString& packFile) {
+    QList<TEException> errors = BatchRunner::pack(manifestPath, packFile);
+    if (!errors.isEmpty()) {
+        printErrors(cout, errors);
+        return;
+    }
+    TEResult<QSharedPointer<const InputPack>> pack = InputPack::load(packFile);
+    if (!pack) {
+        printErrors(cout, pack.errors());
+        return;
+    }
+    cout << "packed " << pack.value()->count() << " inputs\n";
+}
+
+void printBatchStatistics(QTextStream& cout, const BatchResult& result) {
+    BatchStatistics statistics = result.statistics();
+    cout << "inputs: " << statistics.inputs << ", succeeded: " << statistics.succeeded << ", failed: " << statistics.failed << "\n";
+    for (auto it = statistics.errors.cbegin(); it != statistics.errors.cend(); ++it)
+        cout << "  " << it.key() << ": " << it.value() << "\n";
+    if (statistics.budgetHits > 0) cout << "budget hits: " << statistics.budgetHits << "\n";
+}
+
+TEResult<ExpressionDocument> readDocument(const QString& inputFile, ValidationMode mode, ParseReport& report, const DeclarationLibrary* library) {
+    // Скомпилированный пакет загружается без разбора XML; библиотека уже включена в пакет и только сверяется с подключённой
+    if (ExpressionBundle::isBundleFile(inputFile)) {
+        report.mode = mode;
+        TEResult<ExpressionDocument> document = ExpressionBundle::load(inputFile, library);
+        report.stage = document ? RejectionStage::None : RejectionStage::FileAccess;
+        return document;
+    }
+    return ExpressionXmlParser::parseDocumentFile(inputFile, mode, report, library);
+}
+
+void printErrors(QTextStream& cout, const QList<TEException>& errors) {
+    for (const TEException& error : errors) {
+        cout << error.what() << "\n";
+    }
+}
+
 void printHelpMessage(QTextStream& cout, const QString& filename)
 {
-    cout << ".\\" + filename + " [-help | -test] [input-file] [output-file]\n";
+    cout << ".\\" + filename + " [-help | -test | -check input-file | -compile input-file bundle-file | -watch input-directory [output-directory] | -pack input-directory|manifest-file pack-file | -batch input-directory|manifest-file|pack-file result-file [-shard=i/N[:hash]] [-budget=resource:limit,...] [-pack-output=pack-file] | -merge merged-file shard-file... [-pack-output=pack-file]] [-stats | -stats=json] [-trace=trace-file] [-library=library-file] [input-file] [output-file]\n";
     cout << "-help      - Выводит сообщение-помощник. При вводе этой команды путь к файлам указывать не нужно.\n";
     cout << "-test      - Запускает тесты. При вводе этой команды путь к файлам указывать не нужно.\n";
+    cout << "-check     - Проверяет входной файл до первой ошибки и печатает \"accepted\" или \"rejected\" с этапом, на котором файл отклонён. Выходной файл указывать не нужно.\n";
+    cout << "-compile   - Проверяет входной файл и сохраняет объявления и выражения в двоичный пакет. Пакет можно указать вместо входного XML-файла: он загружается без разбора XML. Пакет другой версии или с неверной контрольной суммой отклоняется, как и пакет, исходный файл или библиотека объявлений которого изменились после компиляции.\n";
+    cout << "-watch     - Поясняет все XML-файлы каталога и продолжает следить за ним: пояснение файла name.xml записывается в name.txt выходного каталога (по умолчанию – подкаталога explanations входного каталога; выходной каталог не может совпадать с входным). Если пояснение файла не удалось построить, прежний выходной файл удаляется. Заново разбираются только файлы с изменённым содержимым, а выходной файл перезаписывается, только если изменилось пояснение. При изменении библиотеки объявлений пояснения всех файлов строятся заново.\n";
+    cout << "-batch     - Поясняет входные файлы (файлы *.xml каталога или пути из файла-списка, по одному на строку) и сохраняет пояснения и ошибки в файл результата в формате JSON. Список сортируется, поэтому независимые процессы на одной или разных машинах получают одинаковый список. С ключом -shard=i/N обрабатываются только файлы шарда i из N (по позиции в списке), с -shard=i/N:hash – по хэшу содержимого файла. Ключ -budget ограничивает ресурсы обработки каждого файла: время в миллисекундах (time-ms), количество узлов деревьев (nodes), длину описаний (output-length) и объём основных выделений памяти в байтах (bytes), например -budget=time-ms:2000,nodes:10000. Файл, превысивший бюджет, прерывается с ошибкой BudgetExceeded, остальные файлы обрабатываются; количество таких файлов выводится в сводке. С ключом -pack-output=файл пояснения и ошибки также сохраняются в контейнер с записями тех же имён.\n";
+    cout << "-pack      - Собирает входные файлы (файлы *.xml каталога или пути из файла-списка) в один контейнер в порядке отсортированного списка. Контейнер можно указать в -batch вместо каталога или списка: он отображается в память, и записи разбираются без открытия отдельных файлов.\n";
+    cout << "-merge     - Объединяет результаты всех шардов в один файл результата в порядке списка входных файлов и выводит сводку ошибок по типам. Пропущенные и повторённые шарды отклоняются.\n";
+    cout << "-stats     - После обработки выводит в поток ошибок время этапов и счётчики (лексемы, узлы, шаблоны, подстановки, ошибки, байты). С \"-stats=json\" сводка выводится в формате JSON.\n";
+    cout << "-trace     - Записывает интервалы выполнения этапов в файл в формате Chrome Trace Event (открывается в Perfetto). Например: -trace=trace.json\n";
+    cout << "-library   - Подключает библиотеку объявлений: XML-файл с элементом <root>, содержащий только объявления (variables, functions, unions, structures, classes, enums). Во входном файле тогда обязателен только элемент <expression>. Например: -library=declarations.xml\n";
     cout << "input-file - путь к входному файлу. В случае, если в пути файла присутствуют пробелы, необходимо указать путь в кавычках. Например:\n";
     cout << "               \"C:\\\\input files\\input.txt\"\n";
+    cout << "             Вместо элемента <expression> файл может содержать элемент <expressions> со списком выражений с общими объявлениями; пояснения выводятся по одному на строку.\n";
     cout << "output-file - путь к выходному файлу. Если файла не существует - он будет создан. В случае, если в пути файла присутствуют пробелы, необходимо указать путь в кавычках. Например:\n";
     cout << "               \"C:\\\\output files\\output.txt\"\n";
     cout << "Пример запуска: \n";
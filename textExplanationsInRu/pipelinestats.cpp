@@ -0,0 +1,134 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса PipelineStats.
+ */
+
+#include "pipelinestats.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+std::atomic<bool> PipelineStats::enabledFlag{false};
+std::atomic<qint64> PipelineStats::stageTimes[PipelineStats::stageCount] = {};
+std::atomic<qint64> PipelineStats::stageCalls[PipelineStats::stageCount] = {};
+std::atomic<qint64> PipelineStats::counters[PipelineStats::counterCount] = {};
+
+PipelineStats::ScopedTimer::ScopedTimer(PipelineStage stage)
+    : stage(stage), active(PipelineStats::isEnabled())
+{
+    if (active) timer.start();
+}
+
+PipelineStats::ScopedTimer::~ScopedTimer()
+{
+    if (active) PipelineStats::addTime(stage, timer.nsecsElapsed());
+}
+
+void PipelineStats::setEnabled(bool enabled)
+{
+    enabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+void PipelineStats::addTime(PipelineStage stage, qint64 nanoseconds)
+{
+    int index = static_cast<int>(stage);
+    stageTimes[index].fetch_add(nanoseconds, std::memory_order_relaxed);
+    stageCalls[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PipelineStats::reset()
+{
+    for (int i = 0; i < stageCount; ++i) {
+        stageTimes[i].store(0, std::memory_order_relaxed);
+        stageCalls[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < counterCount; ++i)
+        counters[i].store(0, std::memory_order_relaxed);
+}
+
+qint64 PipelineStats::elapsedNanoseconds(PipelineStage stage)
+{
+    return stageTimes[static_cast<int>(stage)].load(std::memory_order_relaxed);
+}
+
+qint64 PipelineStats::calls(PipelineStage stage)
+{
+    return stageCalls[static_cast<int>(stage)].load(std::memory_order_relaxed);
+}
+
+qint64 PipelineStats::value(PipelineCounter counter)
+{
+    return counters[static_cast<int>(counter)].load(std::memory_order_relaxed);
+}
+
+QString PipelineStats::stageName(PipelineStage stage)
+{
+    switch (stage) {
+    case PipelineStage::FileCopy:           return "file-copy";
+    case PipelineStage::FixXmlFlags:        return "fix-xml-flags";
+    case PipelineStage::SetContent:         return "set-content";
+    case PipelineStage::Validation:         return "validation";
+    case PipelineStage::SplitExpression:    return "split-expression";
+    case PipelineStage::ExpressionToNodes:  return "expression-to-nodes";
+    case PipelineStage::ToExplanation:      return "to-explanation";
+    case PipelineStage::RemoveDuplicates:   return "remove-duplicates";
+    case PipelineStage::OutputWrite:        return "output-write";
+    default:                                return "unknown";
+    }
+}
+
+QString PipelineStats::counterName(PipelineCounter counter)
+{
+    switch (counter) {
+    case PipelineCounter::Tokens:                   return "tokens";
+    case PipelineCounter::Nodes:                    return "nodes";
+    case PipelineCounter::TemplateRenders:          return "template-renders";
+    case PipelineCounter::PlaceholderSubstitutions: return "placeholder-substitutions";
+    case PipelineCounter::DescriptionMaterializations: return "descriptions-materialized";
+    case PipelineCounter::Errors:                   return "errors";
+    case PipelineCounter::BytesRead:                return "bytes-read";
+    case PipelineCounter::BytesWritten:             return "bytes-written";
+    default:                                        return "unknown";
+    }
+}
+
+QString PipelineStats::toText()
+{
+    QString text = "Stages (calls, microseconds):\n";
+    for (int i = 0; i < stageCount; ++i) {
+        PipelineStage stage = static_cast<PipelineStage>(i);
+        text += QString("  %1 %2 %3\n")
+                    .arg(stageName(stage), -22)
+                    .arg(calls(stage), 8)
+                    .arg(elapsedNanoseconds(stage) / 1000.0, 12, 'f', 1);
+    }
+    text += "Counters:\n";
+    for (int i = 0; i < counterCount; ++i) {
+        PipelineCounter counter = static_cast<PipelineCounter>(i);
+        text += QString("  %1 %2\n").arg(counterName(counter), -26).arg(value(counter), 12);
+    }
+    return text;
+}
+
+QByteArray PipelineStats::toJson()
+{
+    QJsonObject stages;
+    for (int i = 0; i < stageCount; ++i) {
+        PipelineStage stage = static_cast<PipelineStage>(i);
+        QJsonObject entry;
+        entry.insert("calls", calls(stage));
+        entry.insert("ns", elapsedNanoseconds(stage));
+        stages.insert(stageName(stage), entry);
+    }
+
+    QJsonObject counterValues;
+    for (int i = 0; i < counterCount; ++i) {
+        PipelineCounter counter = static_cast<PipelineCounter>(i);
+        counterValues.insert(counterName(counter), value(counter));
+    }
+
+    QJsonObject root;
+    root.insert("stages", stages);
+    root.insert("counters", counterValues);
+    return QJsonDocument(root).toJson();
+}
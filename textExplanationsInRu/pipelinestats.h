@@ -0,0 +1,165 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса PipelineStats для сбора времени этапов обработки и счётчиков.
+ */
+
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+/*!
+ * \brief Перечисление этапов обработки входного файла.
+ */
+enum class PipelineStage {
+    FileCopy,           /*!< Создание временной копии входного файла */
+    FixXmlFlags,        /*!< Экранирование содержимого <expression> и <case> */
+    SetContent,         /*!< Построение DOM */
+    Validation,         /*!< Проверка и разбор элементов документа */
+    SplitExpression,    /*!< Разделение выражения на лексемы */
+    ExpressionToNodes,  /*!< Построение дерева выражения (включая разделение на лексемы) */
+    ToExplanation,      /*!< Перевод дерева в текст */
+    RemoveDuplicates,   /*!< Удаление повторяющихся слов */
+    OutputWrite,        /*!< Запись выходного файла */
+    Count               /*!< Количество этапов */
+};
+
+/*!
+ * \brief Перечисление счётчиков обработки.
+ */
+enum class PipelineCounter {
+    Tokens,                     /*!< Лексемы выражения */
+    Nodes,                      /*!< Созданные узлы дерева */
+    TemplateRenders,            /*!< Заполнения шаблонов описаний */
+    PlaceholderSubstitutions,   /*!< Подстановки плейсхолдеров */
+    DescriptionMaterializations, /*!< Извлечения строк падежей из участков исходного текста */
+    Errors,                     /*!< Созданные ошибки TEException */
+    BytesRead,                  /*!< Прочитанные байты входных данных */
+    BytesWritten,               /*!< Записанные байты выходных данных */
+    Count                       /*!< Количество счётчиков */
+};
+
+/*!
+ * \brief Класс для сбора времени этапов обработки и счётчиков.
+ *
+ * Сбор выключен по умолчанию; в выключенном состоянии каждая точка измерения
+ * сводится к чтению одного флага.
+ */
+class PipelineStats
+{
+public:
+    /*!
+     * \brief Класс, измеряющий время этапа от создания до уничтожения объекта.
+     */
+    class ScopedTimer
+    {
+    public:
+        /*!
+         * \brief Начинает измерение этапа, если сбор включён.
+         * \param[in] stage Этап обработки.
+         */
+        explicit ScopedTimer(PipelineStage stage);
+
+        /*!
+         * \brief Завершает измерение этапа.
+         */
+        ~ScopedTimer();
+
+    private:
+        PipelineStage stage;    /*!< Этап обработки */
+        bool active;            /*!< Включён ли сбор в момент начала измерения */
+        QElapsedTimer timer;    /*!< Монотонный таймер */
+    };
+
+    /*!
+     * \brief Включение или выключение сбора.
+     * \param[in] enabled true, чтобы включить сбор.
+     */
+    static void setEnabled(bool enabled);
+
+    /*!
+     * \brief Проверка, включён ли сбор.
+     * \return true, если сбор включён.
+     */
+    static bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Увеличение счётчика.
+     * \param[in] counter Счётчик.
+     * \param[in] value Величина увеличения.
+     */
+    static void add(PipelineCounter counter, qint64 value = 1)
+    {
+        if (isEnabled()) counters[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Добавление времени выполнения этапа.
+     * \param[in] stage Этап обработки.
+     * \param[in] nanoseconds Время в наносекундах.
+     */
+    static void addTime(PipelineStage stage, qint64 nanoseconds);
+
+    /*!
+     * \brief Сброс всех собранных значений.
+     */
+    static void reset();
+
+    /*!
+     * \brief Получение суммарного времени этапа.
+     * \param[in] stage Этап обработки.
+     * \return Время в наносекундах.
+     */
+    static qint64 elapsedNanoseconds(PipelineStage stage);
+
+    /*!
+     * \brief Получение количества выполнений этапа.
+     * \param[in] stage Этап обработки.
+     * \return Количество выполнений.
+     */
+    static qint64 calls(PipelineStage stage);
+
+    /*!
+     * \brief Получение значения счётчика.
+     * \param[in] counter Счётчик.
+     * \return Значение счётчика.
+     */
+    static qint64 value(PipelineCounter counter);
+
+    /*!
+     * \brief Получение строкового имени этапа.
+     */
+    static QString stageName(PipelineStage stage);
+
+    /*!
+     * \brief Получение строкового имени счётчика.
+     */
+    static QString counterName(PipelineCounter counter);
+
+    /*!
+     * \brief Формирование сводки для человека.
+     * \return Многострочная таблица этапов и счётчиков.
+     */
+    static QString toText();
+
+    /*!
+     * \brief Формирование сводки в формате JSON.
+     * \return JSON-документ с объектами "stages" и "counters".
+     */
+    static QByteArray toJson();
+
+private:
+    static constexpr int stageCount = static_cast<int>(PipelineStage::Count);         /*!< Количество этапов */
+    static constexpr int counterCount = static_cast<int>(PipelineCounter::Count);     /*!< Количество счётчиков */
+
+    static std::atomic<bool> enabledFlag;                   /*!< Включён ли сбор */
+    static std::atomic<qint64> stageTimes[stageCount];      /*!< Время этапов в наносекундах */
+    static std::atomic<qint64> stageCalls[stageCount];      /*!< Количество выполнений этапов */
+    static std::atomic<qint64> counters[counterCount];      /*!< Значения счётчиков */
+};
+
+#endif // PIPELINESTATS_H
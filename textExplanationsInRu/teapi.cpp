@@ -0,0 +1,159 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию интерфейса библиотеки textExplanationsInRu на языке C.
+ */
+
+#include "teapi.h"
+#include "declarationlibrary.h"
+#include "expressionbundle.h"
+#include "expressiondocument.h"
+#include "expressionxmlparser.h"
+
+#include <new>
+
+/*!
+ * \brief Контекст перевода.
+ */
+struct te_context {
+    QSharedPointer<const DeclarationLibrary> library;           /*!< Подключённая библиотека объявлений или nullptr */
+    ValidationMode mode = ValidationMode::CollectAll;           /*!< Режим проверки входных данных */
+};
+
+/*!
+ * \brief Результат операции.
+ */
+struct te_result {
+    int status = TE_OK;     /*!< Код завершения */
+    QByteArray text;        /*!< Текст результата в кодировке UTF-8 */
+};
+
+namespace {
+// Имя источника документа, переданного в памяти, в сообщениях об ошибках
+const QString BufferSourceName = QStringLiteral("<buffer>");
+
+// Создание результата; при нехватке памяти возвращается nullptr
+te_result* makeResult(int status, const QByteArray& text)
+{
+    te_result* result = new (std::nothrow) te_result;
+    if (result == nullptr) return nullptr;
+    result->status = status;
+    result->text = text;
+    return result;
+}
+
+// Сообщения об ошибках по одному на строку
+QStringList errorLines(const QList<TEException>& errors)
+{
+    QStringList lines;
+    for (const TEException& error : errors)
+        lines.append(error.what());
+    return lines;
+}
+
+// Результат со списком ошибок входных данных
+te_result* makeErrorResult(const QList<TEException>& errors)
+{
+    return makeResult(TE_INPUT_ERROR, errorLines(errors).join('\n').toUtf8());
+}
+
+// Документ из XML-содержимого или из скомпилированного пакета; библиотека уже включена в пакет и только сверяется с подключённой
+TEResult<ExpressionDocument> readDocument(const te_context& context, const QByteArray& content)
+{
+    if (ExpressionBundle::isBundle(content)) return ExpressionBundle::deserialize(content, BufferSourceName, context.library.data());
+    ParseReport report;
+    return ExpressionXmlParser::parseDocumentContent(content, BufferSourceName, context.mode, report, context.library.data());
+}
+
+// Пояснения всех выражений документа либо ошибки в том же виде, что и в консольной программе
+te_result* explainDocument(const ExpressionDocument& document)
+{
+    QList<TEException> documentErrors;
+    QList<TEResult<QString>> explanations = document.tryGetExplanationsInRu(documentErrors);
+    QStringList lines;
+    QStringList errors;
+    for (qsizetype i = 0; i < explanations.size(); i++) {
+        if (explanations[i]) {
+            lines.append(explanations[i].value());
+            continue;
+        }
+        // Ошибки выражения из списка сопровождаются его номером
+        if (explanations.size() > 1) errors.append("expression " + QString::number(i + 1) + ":");
+        errors += errorLines(explanations[i].errors());
+    }
+    errors += errorLines(documentErrors);
+
+    if (!errors.isEmpty()) return makeResult(TE_INPUT_ERROR, errors.join('\n').toUtf8());
+    return makeResult(TE_OK, lines.join('\n').toUtf8());
+}
+}
+
+int te_abi_version(void)
+{
+    return TE_ABI_VERSION;
+}
+
+te_context* te_context_create(void)
+{
+    return new (std::nothrow) te_context;
+}
+
+void te_context_free(te_context* context)
+{
+    delete context;
+}
+
+void te_context_set_fail_fast(te_context* context, int failFast)
+{
+    if (context == nullptr) return;
+    context->mode = failFast != 0 ? ValidationMode::FailFast : ValidationMode::CollectAll;
+}
+
+te_result* te_context_load_declarations(te_context* context, const char* path)
+{
+    if (context == nullptr || path == nullptr) return makeResult(TE_INVALID_ARGUMENT, QByteArray());
+
+    // Исключения не должны выходить за границу интерфейса C
+    try {
+        TEResult<QSharedPointer<const DeclarationLibrary>> loaded = DeclarationLibrary::load(QString::fromUtf8(path));
+        if (!loaded) return makeErrorResult(loaded.errors());
+        context->library = loaded.takeValue();
+        return makeResult(TE_OK, QByteArray());
+    } catch (...) {
+        return makeResult(TE_INTERNAL_ERROR, QByteArray());
+    }
+}
+
+te_result* te_explain(te_context* context, const char* data, size_t size)
+{
+    if (context == nullptr || (data == nullptr && size > 0)) return makeResult(TE_INVALID_ARGUMENT, QByteArray());
+
+    try {
+        // Содержимое не копируется: документ и пакет разбираются прямо из памяти вызывающей программы
+        QByteArray content = QByteArray::fromRawData(data, qsizetype(size));
+        TEResult<ExpressionDocument> document = readDocument(*context, content);
+        if (!document) return makeErrorResult(document.errors());
+        return explainDocument(document.value());
+    } catch (...) {
+        return makeResult(TE_INTERNAL_ERROR, QByteArray());
+    }
+}
+
+int te_result_status(const te_result* result)
+{
+    return result != nullptr ? result->status : TE_INVALID_ARGUMENT;
+}
+
+const char* te_result_text(const te_result* result)
+{
+    return result != nullptr ? result->text.constData() : "";
+}
+
+size_t te_result_size(const te_result* result)
+{
+    return result != nullptr ? size_t(result->text.size()) : 0;
+}
+
+void te_result_free(te_result* result)
+{
+    delete result;
+}
@@ -0,0 +1,147 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий интерфейс библиотеки textExplanationsInRu на языке C.
+ *
+ * Интерфейс не зависит от Qt и C++ и может подключаться из программ на C и других языков. Набор функций и
+ * значения констант не меняются в пределах одной версии TE_ABI_VERSION.
+ *
+ * Пример использования:
+ * \code
+ * te_context* context = te_context_create();
+ * te_result* result = te_explain(context, xml, xmlSize);
+ * if (te_result_status(result) == TE_OK) puts(te_result_text(result));
+ * te_result_free(result);
+ * te_context_free(context);
+ * \endcode
+ */
+
+#ifndef TEAPI_H
+#define TEAPI_H
+
+#include <stddef.h>
+
+// При статической компоновке функции не импортируются из DLL
+#if defined(TE_STATIC)
+#  define TE_API
+#elif defined(_WIN32)
+#  if defined(TEXTEXPLANATIONSINRU_LIBRARY)
+#    define TE_API __declspec(dllexport)
+#  else
+#    define TE_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define TE_API __attribute__((visibility("default")))
+#else
+#  define TE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \brief Версия двоичного интерфейса библиотеки.
+ */
+#define TE_ABI_VERSION 1
+
+/*!
+ * \brief Коды завершения операций.
+ */
+enum te_status {
+    TE_OK = 0,                  /*!< Операция выполнена */
+    TE_INPUT_ERROR = 1,         /*!< Входные данные содержат ошибки; текст результата содержит их описание */
+    TE_INVALID_ARGUMENT = 2,    /*!< Передан нулевой указатель или некорректный размер */
+    TE_INTERNAL_ERROR = 3       /*!< Внутренняя ошибка библиотеки */
+};
+
+/*!
+ * \brief Контекст перевода: подключённая библиотека объявлений и режим проверки.
+ *
+ * Контекст может использоваться одновременно только одним потоком; разные контексты независимы.
+ */
+typedef struct te_context te_context;
+
+/*!
+ * \brief Результат операции: код завершения и текст в кодировке UTF-8.
+ */
+typedef struct te_result te_result;
+
+/*!
+ * \brief Получение версии двоичного интерфейса, с которой собрана библиотека.
+ * \return Значение TE_ABI_VERSION библиотеки.
+ */
+TE_API int te_abi_version(void);
+
+/*!
+ * \brief Создание контекста перевода.
+ * \return Контекст либо NULL, если память не выделена.
+ */
+TE_API te_context* te_context_create(void);
+
+/*!
+ * \brief Освобождение контекста перевода.
+ * \param[in] context Контекст или NULL.
+ */
+TE_API void te_context_free(te_context* context);
+
+/*!
+ * \brief Включение режима быстрого отказа: входные данные проверяются до первой ошибки.
+ * \param[in] context Контекст.
+ * \param[in] failFast Ненулевое значение включает режим быстрого отказа.
+ */
+TE_API void te_context_set_fail_fast(te_context* context, int failFast);
+
+/*!
+ * \brief Подключение к контексту библиотеки объявлений.
+ *
+ * Библиотека разбирается один раз и используется всеми последующими вызовами te_explain этого контекста.
+ * Снимки библиотек кэшируются по пути, поэтому несколько контекстов с одной библиотекой разделяют её объявления.
+ * \param[in] context Контекст.
+ * \param[in] path Путь к XML-файлу библиотеки в кодировке UTF-8.
+ * \return Результат с кодом TE_OK либо с описанием ошибок библиотеки. Освобождается te_result_free.
+ */
+TE_API te_result* te_context_load_declarations(te_context* context, const char* path);
+
+/*!
+ * \brief Получение пояснения выражений входного документа.
+ *
+ * Документ разбирается из памяти без создания временных файлов. Вместо XML-документа можно передать
+ * скомпилированный пакет.
+ * \param[in] context Контекст.
+ * \param[in] data Содержимое XML-документа в кодировке UTF-8 или пакета.
+ * \param[in] size Размер содержимого в байтах.
+ * \return Результат с пояснениями (по одному на строку) либо с описанием ошибок. Освобождается te_result_free.
+ */
+TE_API te_result* te_explain(te_context* context, const char* data, size_t size);
+
+/*!
+ * \brief Получение кода завершения операции.
+ * \param[in] result Результат.
+ * \return Значение te_status; TE_INVALID_ARGUMENT для NULL.
+ */
+TE_API int te_result_status(const te_result* result);
+
+/*!
+ * \brief Получение текста результата.
+ * \param[in] result Результат.
+ * \return Строка в кодировке UTF-8, оканчивающаяся нулём; действительна до вызова te_result_free.
+ */
+TE_API const char* te_result_text(const te_result* result);
+
+/*!
+ * \brief Получение длины текста результата в байтах без завершающего нуля.
+ * \param[in] result Результат.
+ */
+TE_API size_t te_result_size(const te_result* result);
+
+/*!
+ * \brief Освобождение результата.
+ * \param[in] result Результат или NULL.
+ */
+TE_API void te_result_free(te_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEAPI_H */
@@ -1,8 +1,10 @@
 #include "teexception.h"
+#include "pipelinestats.h"
 
 TEException::TEException(const ErrorType errorType, const QString &filename, const int line, const QList<QString> args)
     : errorType(errorType), filename(filename), line(line), args(args)
 {
+    PipelineStats::add(PipelineCounter::Errors);
 }
 
 TEException::TEException(const ErrorType errorType,  const QString &filename, const QList<QString> args)
@@ -20,36 +22,50 @@ TEException::TEException(const ErrorType errorType, const QList<QString> args)
 {
 }
 
-const QHash<ErrorType, QString> TEException::ErrorTypeNames = {
-    {ErrorType::InputFileNotFound, "InputFileNotFound"},
-    {ErrorType::InputCopyFileCannotBeCreated, "InputCopyFileCannotBeCreated"},
-    {ErrorType::OutputFileCannotBeCreated, "OutputFileCannotBeCreated"},
-    {ErrorType::Parsing, "Parsing"},
-    {ErrorType::MissingRootElemnt, "MissingRootElemnt"},
-    {ErrorType::UnexpectedElement, "UnexpectedElement"},
-    {ErrorType::UnexpectedAttribute, "UnexpectedAttribute"},
-    {ErrorType::MissingRequiredChildElement, "MissingRequiredChildElement"},
-    {ErrorType::MissingRequiredAttribute, "MissingRequiredAttribute"},
-    {ErrorType::DuplicateElement, "DuplicateElement"},
-    {ErrorType::DuplicateAttribute, "DuplicateAttribute"},
-    {ErrorType::EmptyElementValue, "EmptyElementValue"},
-    {ErrorType::EmptyAttributeName, "EmptyAttributeName"},
-    {ErrorType::ParamsCountFunctionMissmatch, "ParamsCountFunctionMissmatch"},
-    {ErrorType::InputSizeExceeded, "InputSizeExceeded"},
-    {ErrorType::UndefinedId, "UndefinedId"},
-    {ErrorType::InvalidSymbol, "InvalidSymbol"},
-    {ErrorType::InputDataExprSizeExceeded, "InputDataExprSizeExceeded"},
-    {ErrorType::MissingOperand, "MissingOperand"},
-    {ErrorType::MissingOperations, "MissingOperations"},
-    {ErrorType::MultipleIncrementDecrement, "MultipleIncrementDecrement"},
-    {ErrorType::NeverUsedElement, "NeverUsedElement"},
-    {ErrorType::ParamsCountDescriptionDifference, "ParamsCountDescriptionDifference"},
-    {ErrorType::NonUniqueName, "NonUniqueName"},
-    {ErrorType::InvalidName, "InvalidName"},
-    {ErrorType::UnidentifedType, "UnidentifedType"},
-    {ErrorType::InvalidParamsCount, "InvalidParamsCount"},
-    {ErrorType::MissingCases, "MissingCases"}
-};
+QString ErrorTypeNameTable::value(ErrorType errorType, const QString& defaultValue) const
+{
+    switch (errorType) {
+    case ErrorType::InputFileNotFound:                return QStringLiteral("InputFileNotFound");
+    case ErrorType::InputCopyFileCannotBeCreated:     return QStringLiteral("InputCopyFileCannotBeCreated");
+    case ErrorType::OutputFileCannotBeCreated:        return QStringLiteral("OutputFileCannotBeCreated");
+    case ErrorType::InvalidBundle:                    return QStringLiteral("InvalidBundle");
+    case ErrorType::InvalidBatchResult:               return QStringLiteral("InvalidBatchResult");
+    case ErrorType::InvalidInputPack:                 return QStringLiteral("InvalidInputPack");
+    case ErrorType::Parsing:                          return QStringLiteral("Parsing");
+    case ErrorType::MissingRootElemnt:                return QStringLiteral("MissingRootElemnt");
+    case ErrorType::UnexpectedElement:                return QStringLiteral("UnexpectedElement");
+    case ErrorType::UnexpectedAttribute:              return QStringLiteral("UnexpectedAttribute");
+    case ErrorType::MissingRequiredChildElement:      return QStringLiteral("MissingRequiredChildElement");
+    case ErrorType::MissingRequiredAttribute:         return QStringLiteral("MissingRequiredAttribute");
+    case ErrorType::DuplicateElement:                 return QStringLiteral("DuplicateElement");
+    case ErrorType::DuplicateAttribute:               return QStringLiteral("DuplicateAttribute");
+    case ErrorType::EmptyElementValue:                return QStringLiteral("EmptyElementValue");
+    case ErrorType::EmptyAttributeName:               return QStringLiteral("EmptyAttributeName");
+    case ErrorType::ParamsCountFunctionMissmatch:     return QStringLiteral("ParamsCountFunctionMissmatch");
+    case ErrorType::InputSizeExceeded:                return QStringLiteral("InputSizeExceeded");
+    case ErrorType::InputElementsExceeded:            return QStringLiteral("InputElementsExceeded");
+    case ErrorType::BudgetExceeded:                   return QStringLiteral("BudgetExceeded");
+    case ErrorType::UndefinedId:                      return QStringLiteral("UndefinedId");
+    case ErrorType::InvalidSymbol:                    return QStringLiteral("InvalidSymbol");
+    case ErrorType::InputDataExprSizeExceeded:        return QStringLiteral("InputDataExprSizeExceeded");
+    case ErrorType::MissingOperand:                   return QStringLiteral("MissingOperand");
+    case ErrorType::MissingOperations:                return QStringLiteral("MissingOperations");
+    case ErrorType::MultipleIncrementDecrement:       return QStringLiteral("MultipleIncrementDecrement");
+    case ErrorType::NeverUsedElement:                 return QStringLiteral("NeverUsedElement");
+    case ErrorType::ParamsCountDescriptionDifference: return QStringLiteral("ParamsCountDescriptionDifference");
+    case ErrorType::NonUniqueName:                    return QStringLiteral("NonUniqueName");
+    case ErrorType::InvalidName:                      return QStringLiteral("InvalidName");
+    case ErrorType::UnidentifedType:                  return QStringLiteral("UnidentifedType");
+    case ErrorType::InvalidType:                      return QStringLiteral("InvalidType");
+    case ErrorType::InvalidParamsCount:               return QStringLiteral("InvalidParamsCount");
+    case ErrorType::MissingCases:                     return QStringLiteral("MissingCases");
+    case ErrorType::MissingReplacementArguments:      return QStringLiteral("MissingReplacementArguments");
+    case ErrorType::UnexpectedCaseType:               return QStringLiteral("UnexpectedCaseType");
+    case ErrorType::IncorrectCaseInPlaceHolder:       return QStringLiteral("IncorrectCaseInPlaceHolder");
+    case ErrorType::VariableWithVoidType:             return QStringLiteral("VariableWithVoidType");
+    }
+    return defaultValue;
+}
 
 QString TEException::what() const {
 
@@ -59,120 +75,94 @@ QString TEException::what() const {
 
     if(this->line > 0) message += "in line " + QString::number(this->line) + ": ";
 
-    switch(this->errorType) {
+    message += replacePlaceholders(messageTemplate(this->errorType), this->args);
+
+    return message;
+}
+
+QString TEException::messageTemplate(ErrorType errorType)
+{
+    switch(errorType) {
 
     case ErrorType::InputFileNotFound:
-        message += "Неверно указан путь к входному файлу. Возможно, файл не существует или к нему нет доступа.";
-        break;
+        return "Неверно указан путь к входному файлу. Возможно, файл не существует или к нему нет доступа.";
     case ErrorType::InputCopyFileCannotBeCreated:
-        message += "Не удалось создать копию файла {1} в \"{2}\". Возможно, нет прав на запись";
-        break;
+        return "Не удалось создать копию файла {1} в \"{2}\". Возможно, нет прав на запись";
     case ErrorType::OutputFileCannotBeCreated:
-        message += "Неверно указан путь к выходному файлу. Возможно, указанного расположения не существует или нет прав на запись.";
-        break;
+        return "Неверно указан путь к выходному файлу. Возможно, указанного расположения не существует или нет прав на запись.";
+    case ErrorType::InvalidBundle:
+        return "Файл {1} не является действительным скомпилированным пакетом: {2}";
+    case ErrorType::InvalidBatchResult:
+        return "Результат пакетной обработки {1} не может быть использован: {2}";
+    case ErrorType::InvalidInputPack:
+        return "Файл {1} не является действительным контейнером входных файлов: {2}";
     case ErrorType::Parsing:
-        message += "синтаксическая ошибка обнаружена в процессе обработки XML файла";
-        break;
+        return "синтаксическая ошибка обнаружена в процессе обработки XML файла";
     case ErrorType::MissingRootElemnt:
-        message += "не найден корневой тег элемента <root>";
-        break;
+        return "не найден корневой тег элемента <root>";
     case ErrorType::UnexpectedElement:
-        message += "найден элемент <{1}>, ожидается: {2}";
-        break;
+        return "найден элемент <{1}>, ожидается: {2}";
     case ErrorType::UnexpectedAttribute:
-        message += "получен атрибут \"{1}\", ожидается: {2}";
-        break;
+        return "получен атрибут \"{1}\", ожидается: {2}";
     case ErrorType::MissingRequiredChildElement:
-        message += "отсутствует элемент <{1}>";
-        break;
+        return "отсутствует элемент <{1}>";
     case ErrorType::MissingRequiredAttribute:
-        message += "отсутствует атрибут \"{1}\"";
-        break;
+        return "отсутствует атрибут \"{1}\"";
     case ErrorType::DuplicateElement:
-        message += "элемент <{1}> встречается более допустимого количества раз.";
-        break;
+        return "элемент <{1}> встречается более допустимого количества раз.";
     case ErrorType::DuplicateAttribute:
-        message += "атрибут \"{1}\" встречается более допустимого количества раз.";
-        break;
+        return "атрибут \"{1}\" встречается более допустимого количества раз.";
     case ErrorType::EmptyElementValue:
-        message += "значение элемента <{1}> не заполнено.";
-        break;
+        return "значение элемента <{1}> не заполнено.";
     case ErrorType::EmptyAttributeName:
-        message += "значение атрибута \"{1}\" не заполнено.";
-        break;
+        return "значение атрибута \"{1}\" не заполнено.";
     case ErrorType::ParamsCountFunctionMissmatch:
-        message += "количество параметров, указанных в <expression> ({1}) не соответствует указанному количеству параметров, указанных в <paramsCount> ({2}) для функции \"{3}\".";
-        break;
+        return "количество параметров, указанных в <expression> ({1}) не соответствует указанному количеству параметров, указанных в <paramsCount> ({2}) для функции \"{3}\".";
     case ErrorType::InputSizeExceeded:
-        message += "текстовое значение \"{1}\" превышает допустимую длину. Текущая длина - {2}, Ожидаемая - {3}.";
-        break;
+        return "текстовое значение \"{1}\" превышает допустимую длину. Текущая длина - {2}, Ожидаемая - {3}.";
     case ErrorType::InputElementsExceeded:
-        message += "элемент <{1}> превышает допустимое количество элементов. Текущее количество - {2}, Ожидаемое - {3}.";
-        break;
+        return "элемент <{1}> превышает допустимое количество элементов. Текущее количество - {2}, Ожидаемое - {3}.";
+    case ErrorType::BudgetExceeded:
+        return "обработка входных данных прервана: превышен бюджет \"{1}\". Израсходовано - {2}, Допустимо - {3}.";
     case ErrorType::UndefinedId:
-        message += "идентификатор \"{1}\" в значении элемента <expression> не определен";
-        break;
+        return "идентификатор \"{1}\" в значении элемента <expression> не определен";
     case ErrorType::InvalidSymbol:
-        message += "в значении элемента <expression> обнаружен символ \"{1}\".";
-        break;
+        return "в значении элемента <expression> обнаружен символ \"{1}\".";
     case ErrorType::InputDataExprSizeExceeded:
-        message += "в значении элемента <expression> превышено допустимое количество операций. Текущее - {1}, ожидается - 20.";
-        break;
+        return "в значении элемента <expression> превышено допустимое количество операций. Текущее - {1}, ожидается - 20.";
     case ErrorType::MissingOperand:
-        message += "в значении элемента <expression>, у операции \"{1}\" отсутствует операнд.";
-        break;
+        return "в значении элемента <expression>, у операции \"{1}\" отсутствует операнд.";
     case ErrorType::MissingOperations:
-        message += "в значении элемента <expression>, у операнда \"{1}\" отсутствует операция.";
-        break;
+        return "в значении элемента <expression>, у операнда \"{1}\" отсутствует операция.";
     case ErrorType::MultipleIncrementDecrement:
-        message += "в значении элемента <expression>, значение элемента \"{1}\" не может быть инкрементировано или декрементировано более одного раза.";
-        break;
+        return "в значении элемента <expression>, значение элемента \"{1}\" не может быть инкрементировано или декрементировано более одного раза.";
     case ErrorType::NeverUsedElement:
-        message += "элементы: {1} ни разу не встречаются в элементе <expression>.";
-        break;
+        return "элементы: {1} ни разу не встречаются в элементе <expression>.";
     case ErrorType::ParamsCountDescriptionDifference:
-        message += "количество замен участков в <description> элемента <function> описанием входящих аргументов превышает значение атрибута \"paramsCount\" элемента <function>.";
-        break;
+        return "количество замен участков в <description> элемента <function> описанием входящих аргументов превышает значение атрибута \"paramsCount\" элемента <function>.";
     case ErrorType::NonUniqueName:
-        message += "значение \"{1}\" для атрибута \"name\" для элемента <{2}> не уникальное";
-        break;
+        return "значение \"{1}\" для атрибута \"name\" для элемента <{2}> не уникальное";
     case ErrorType::InvalidName:
-        message += "значение \"{1}\" атрибута \"name\" должно начинаться с латинской буквы или со специального символа \"_\" (нижнее подчеркивание) и содержать в себе только латинские буквы, цифры и специальный символ \"_\" (нижнее подчеркивание).";
-        break;
+        return "значение \"{1}\" атрибута \"name\" должно начинаться с латинской буквы или со специального символа \"_\" (нижнее подчеркивание) и содержать в себе только латинские буквы, цифры и специальный символ \"_\" (нижнее подчеркивание).";
     case ErrorType::UnidentifedType:
-        message += "значение \"{1}\" атрибута \"type\" содержит неидентифицированный тип. Тип данных должен быть одним из поддерживаемых или может быть пользовательским типом данных, описанным в элементах <unions>; <structures>; <classes>; <enums>.";
-        break;
+        return "значение \"{1}\" атрибута \"type\" содержит неидентифицированный тип. Тип данных должен быть одним из поддерживаемых или может быть пользовательским типом данных, описанным в элементах <unions>; <structures>; <classes>; <enums>.";
     case ErrorType::InvalidType:
-        message += "значение \"{1}\" атрибута \"type\" должно начинаться с латинской буквы или со специального символа \"_\" (нижнее подчеркивание) и содержать в себе только латинские буквы, цифры и специальный символ \"_\" (нижнее подчеркивание).";
-        break;
+        return "значение \"{1}\" атрибута \"type\" должно начинаться с латинской буквы или со специального символа \"_\" (нижнее подчеркивание) и содержать в себе только латинские буквы, цифры и специальный символ \"_\" (нижнее подчеркивание).";
     case ErrorType::InvalidParamsCount:
-        message += "значение \"{1}\" атрибута \"paramsCount\" содержит неверное значение. Ожидается: положительное целое число от 0 до 20 включительно.";
-        break;
+        return "значение \"{1}\" атрибута \"paramsCount\" содержит неверное значение. Ожидается: положительное целое число от 0 до 20 включительно.";
     case ErrorType::MissingCases:
-        message += "в элементе <description> отсутствует <case> с атрибутом \"type\" со значением \"{1}\".";
-        break;
+        return "в элементе <description> отсутствует <case> с атрибутом \"type\" со значением \"{1}\".";
     case ErrorType::MissingReplacementArguments:
-        message += "недостаток аргументов при замене в шаблоне \"{1}\"";
-        break;
+        return "недостаток аргументов при замене в шаблоне \"{1}\"";
     case ErrorType::IncorrectCaseInPlaceHolder:
-        message += "указанный падеж \"{1}\" в шаблоне описания содержит неверное значение. Ожидается: и, р, д, в, т, п.";
-        break;
+        return "указанный падеж \"{1}\" в шаблоне описания содержит неверное значение. Ожидается: и, р, д, в, т, п.";
     case ErrorType::UnexpectedCaseType:
-        message += "в элементе <case> получено значение атрибута “type” \"{1}\". Ожидается \"{2}\".";
-        break;
+        return "в элементе <case> получено значение атрибута “type” \"{1}\". Ожидается \"{2}\".";
     case ErrorType::VariableWithVoidType:
-        message += "переменная \"{1}\" имеет недопустимый тип данных \"void\". тип данных \"void\" может быть только у функций";
-        break;
+        return "переменная \"{1}\" имеет недопустимый тип данных \"void\". тип данных \"void\" может быть только у функций";
     default:
-        message += "неизвестная ошибка";
-        break;
-    }
-
-    if(args.count() > 0) {
-        message = replacePlaceholders(message, this->args);
+        return "неизвестная ошибка";
     }
-
-    return message;
 }
 
 ErrorType TEException::getErrorType() const
@@ -192,12 +182,25 @@ QList<QString> TEException::getArgs() const
 
 QString TEException::replacePlaceholders(QString pattern, const QList<QString> args) const
 {
-    // Для каждого аргумента
-    for (int i = 0; i < args.size(); i++) {
-        // Формируем плейсхолдер вида {n} и т.д.
-        QString placeholder = "{" + QString::number(i + 1) + "}";
-        // Заменяем вхождение плейсхолдера на соответствующий ему аргумент
-        pattern.replace(placeholder, args[i]);
+    QString result;
+    result.reserve(pattern.size());
+
+    qsizetype i = 0;
+    while (i < pattern.size()) {
+        // Если начинается плейсхолдер вида {n} с существующим аргументом
+        if (pattern[i] == u'{') {
+            qsizetype closing = pattern.indexOf(u'}', i + 1);
+            bool isNumber = false;
+            int index = closing > i + 1 ? QStringView(pattern).sliced(i + 1, closing - i - 1).toInt(&isNumber) - 1 : -1;
+            if (isNumber && index >= 0 && index < args.size()) {
+                // Заменяем плейсхолдер на соответствующий ему аргумент
+                result += args[index];
+                i = closing + 1;
+                continue;
+            }
+        }
+        result += pattern[i];
+        i++;
     }
-    return pattern;
+    return result;
 }
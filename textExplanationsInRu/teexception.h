@@ -10,6 +10,9 @@
 #include <QString>
 #include <QHash>
 
+#include <optional>
+#include <utility>
+
 /*!
  * \brief Перечисление типов ошибок, возникающих при обработке XML и файлов.
  */
@@ -18,6 +21,9 @@ enum class ErrorType {
     InputFileNotFound,               /*!< Входной файл не найден или недоступен */
     InputCopyFileCannotBeCreated,   /*!< Невозможно создать копию входного файла */
     OutputFileCannotBeCreated,      /*!< Невозможно создать выходной файл */
+    InvalidBundle,                  /*!< Скомпилированный пакет повреждён или устарел */
+    InvalidBatchResult,             /*!< Результат пакетной обработки повреждён или не согласован с другими шардами */
+    InvalidInputPack,               /*!< Контейнер входных файлов повреждён или устарел */
 
     // Общие ошибки XML
     Parsing,                         /*!< Ошибка разбора XML */
@@ -33,6 +39,7 @@ enum class ErrorType {
     ParamsCountFunctionMissmatch,   /*!< Несоответствие количества параметров и описания */
     InputSizeExceeded,              /*!< Превышен допустимый размер входных данных */
     InputElementsExceeded,          /*!< Превышено количество допустимых элементов */
+    BudgetExceeded,                 /*!< Превышен бюджет обработки одного входного файла */
 
     // Ошибки элемента <expression>
     UndefinedId,                    /*!< Неопределённый идентификатор */
@@ -65,6 +72,22 @@ enum class ErrorType {
     VariableWithVoidType            /*!< Переменная с типом войд  */
 };
 
+/*!
+ * \brief Таблица строковых имён типов ошибок.
+ *
+ * Имена хранятся в статической памяти и не требуют построения таблицы при запуске программы.
+ */
+struct ErrorTypeNameTable
+{
+    /*!
+     * \brief Получение имени типа ошибки.
+     * \param[in] errorType Тип ошибки.
+     * \param[in] defaultValue Значение, возвращаемое для неизвестного типа ошибки.
+     * \return Имя типа ошибки.
+     */
+    QString value(ErrorType errorType, const QString& defaultValue = QString()) const;
+};
+
 /*!
  * \brief Класс, представляющий исключение при обработке XML.
  */
@@ -129,17 +152,24 @@ public:
     QList<QString> getArgs() const;
 
     /*!
-     * \brief Подстановка аргументов в шаблон сообщения.
+     * \brief Подстановка аргументов в шаблон сообщения за один проход по шаблону.
      * \param[in] pattern Шаблон с плейсхолдерами.
      * \param[in] args Аргументы для подстановки.
      * \return Строка с подставленными значениями.
      */
     QString replacePlaceholders(QString pattern, const QList<QString> args) const;
 
+    /*!
+     * \brief Получение шаблона сообщения для типа ошибки.
+     * \param[in] errorType Тип ошибки.
+     * \return Шаблон сообщения с плейсхолдерами вида {n}.
+     */
+    static QString messageTemplate(ErrorType errorType);
+
     /*!
      * \brief Отображение имён ошибок по типу.
      */
-    static const QHash<ErrorType, QString> ErrorTypeNames;
+    static constexpr ErrorTypeNameTable ErrorTypeNames{};
 
 private:
     ErrorType errorType; /*!< Тип ошибки */
@@ -148,4 +178,75 @@ private:
     QList<QString> args; /*!< Аргументы ошибки */
 };
 
+/*!
+ * \brief Результат операции: значение либо список ошибок.
+ *
+ * Используется вместо исключений там, где ошибка является ожидаемым исходом
+ * (некорректные входные данные). Текст ошибок формируется только при вызове TEException::what().
+ */
+template <typename T>
+class TEResult
+{
+public:
+    /*!
+     * \brief Успешный результат.
+     * \param[in] value Значение.
+     */
+    TEResult(const T &value) : resultValue(value) {}
+
+    /*!
+     * \brief Успешный результат.
+     * \param[in] value Значение.
+     */
+    TEResult(T &&value) : resultValue(std::move(value)) {}
+
+    /*!
+     * \brief Неуспешный результат с одной ошибкой.
+     * \param[in] error Ошибка.
+     */
+    TEResult(const TEException &error) : resultErrors{error} {}
+
+    /*!
+     * \brief Неуспешный результат со списком ошибок.
+     * \param[in] errors Непустой список ошибок.
+     */
+    TEResult(const QList<TEException> &errors) : resultErrors(errors) {}
+
+    /*!
+     * \brief Проверка, содержит ли результат значение.
+     * \return true, если ошибок нет.
+     */
+    bool isOk() const { return resultValue.has_value(); }
+
+    /*!
+     * \brief Проверка, содержит ли результат значение.
+     */
+    explicit operator bool() const { return isOk(); }
+
+    /*!
+     * \brief Получение значения. Допустимо только для успешного результата.
+     */
+    const T &value() const { return *resultValue; }
+
+    /*!
+     * \brief Получение значения. Допустимо только для успешного результата.
+     */
+    T &value() { return *resultValue; }
+
+    /*!
+     * \brief Извлечение значения с перемещением. Допустимо только для успешного результата.
+     */
+    T takeValue() { return std::move(*resultValue); }
+
+    /*!
+     * \brief Получение списка ошибок.
+     * \return Список ошибок; пустой для успешного результата.
+     */
+    const QList<TEException> &errors() const { return resultErrors; }
+
+private:
+    std::optional<T> resultValue;       /*!< Значение */
+    QList<TEException> resultErrors;    /*!< Ошибки */
+};
+
 #endif // TEEXCEPTION_H
@@ -1,23 +1,43 @@
 VPATH = $$PWD #Что бы файлы подключались относительно оригинального расположения файла
 INCLUDEPATH += $$PWD
 
-QT = core \
-     xml \
-     qml
+QT = core
 
 CONFIG += c++17 console
 
+# Исходные файлы ядра собираются только библиотекой textExplanationsInRuCore;
+# программа и тесты подключают её через textExplanationsInRuCore/textExplanationsInRuCore.pri
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+        batchrunner.cpp \
         codeentity.cpp \
+        declarationindex.cpp \
+        declarationlibrary.cpp \
+        descriptioncache.cpp \
+        directorywatcher.cpp \
         expression.cpp \
+        expressionbundle.cpp \
+        expressiondocument.cpp \
         expressionnode.cpp \
+        expressionnormalizer.cpp \
+        expressionsession.cpp \
         expressiontranslator.cpp \
         expressionxmlparser.cpp \
-        teexception.cpp
+        infixparser.cpp \
+        inputbudget.cpp \
+        inputpack.cpp \
+        pipelinestats.cpp \
+        teapi.cpp \
+        teexception.cpp \
+        textscanner.cpp \
+        tracerecorder.cpp \
+        xmlelement.cpp \
+        xmlschema.cpp \
+        xmltree.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -25,9 +45,28 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    batchrunner.h \
     codeentity.h \
+    declarationindex.h \
+    declarationlibrary.h \
+    descriptioncache.h \
+    directorywatcher.h \
     expression.h \
+    expressionbundle.h \
+    expressiondocument.h \
     expressionnode.h \
+    expressionnormalizer.h \
+    expressionsession.h \
     expressiontranslator.h \
     expressionxmlparser.h \
-    teexception.h
+    infixparser.h \
+    inputbudget.h \
+    inputpack.h \
+    pipelinestats.h \
+    teapi.h \
+    teexception.h \
+    textscanner.h \
+    tracerecorder.h \
+    xmlelement.h \
+    xmlschema.h \
+    xmltree.h
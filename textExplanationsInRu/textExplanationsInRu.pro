@@ -1,3 +1,13 @@
-include(textExplanationsInRu.pri)
+QT = core
+
+CONFIG += c++17 console
+
+include(../textExplanationsInRuCore/textExplanationsInRuCore.pri)
+
 SOURCES += \
         main.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
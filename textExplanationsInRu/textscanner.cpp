@@ -0,0 +1,324 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса TextScanner.
+ */
+
+#include "textscanner.h"
+
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TEXTSCANNER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Функции поиска кандидатов возвращают позицию первого кандидата, начиная с from, или size
+
+/////////////////////////////////////////////////
+/// Посимвольный поиск
+/////////////////////////////////////////////////
+
+inline bool isXmlSpecial(char16_t c)
+{
+    return c == u'&' || c == u'<' || c == u'>' || c == u'"' || c == u'\'';
+}
+
+// Пробельные символы ASCII не превышают 0x20; символы вне ASCII проверяются отдельно
+inline bool isSpaceOrQuoteCandidate(char16_t c)
+{
+    return c <= 0x20 || c == u'"' || c >= 0x80;
+}
+
+inline bool isAsciiIdentifierChar(char16_t c)
+{
+    return (c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') || (c >= u'0' && c <= u'9') || c == u'_';
+}
+
+// Байты многобайтовых последовательностей UTF-8 превращаются в значения, не совпадающие со специальными символами
+template <typename Char>
+qsizetype findXmlSpecialScalar(const Char* data, qsizetype from, qsizetype size)
+{
+    while (from < size && !isXmlSpecial(char16_t(data[from])))
+        from++;
+    return from;
+}
+
+qsizetype findSpaceOrQuoteScalar(const char16_t* data, qsizetype from, qsizetype size)
+{
+    while (from < size && !isSpaceOrQuoteCandidate(data[from]))
+        from++;
+    return from;
+}
+
+qsizetype findNonIdentifierScalar(const char16_t* data, qsizetype from, qsizetype size)
+{
+    while (from < size && isAsciiIdentifierChar(data[from]))
+        from++;
+    return from;
+}
+
+#if defined(TEXTSCANNER_X86)
+
+/////////////////////////////////////////////////
+/// SSE2: 8 символов UTF-16 или 16 байт за шаг
+/////////////////////////////////////////////////
+
+// Беззнаковое сравнение 16-битных значений через знаковое со смещением на 0x8000
+__attribute__((target("sse2"))) inline __m128i lessThanU16(__m128i value, char16_t bound)
+{
+    const __m128i bias = _mm_set1_epi16(short(0x8000));
+    return _mm_cmplt_epi16(_mm_xor_si128(value, bias), _mm_set1_epi16(short(bound ^ 0x8000)));
+}
+
+// Проверка попадания в диапазон [low, high]
+__attribute__((target("sse2"))) inline __m128i inRangeU16(__m128i value, char16_t low, char16_t high)
+{
+    return lessThanU16(_mm_sub_epi16(value, _mm_set1_epi16(short(low))), char16_t(high - low + 1));
+}
+
+__attribute__((target("sse2"))) qsizetype findXmlSpecialSse2(const char16_t* data, qsizetype from, qsizetype size)
+{
+    for (; from + 8 <= size; from += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+        __m128i match = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi16(block, _mm_set1_epi16(u'&')), _mm_cmpeq_epi16(block, _mm_set1_epi16(u'<'))),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(block, _mm_set1_epi16(u'>')), _mm_cmpeq_epi16(block, _mm_set1_epi16(u'"'))),
+                         _mm_cmpeq_epi16(block, _mm_set1_epi16(u'\''))));
+        int mask = _mm_movemask_epi8(match);
+        if (mask != 0) return from + __builtin_ctz(mask) / 2;
+    }
+    return findXmlSpecialScalar(data, from, size);
+}
+
+__attribute__((target("sse2"))) qsizetype findXmlSpecialSse2(const char* data, qsizetype from, qsizetype size)
+{
+    for (; from + 16 <= size; from += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+        __m128i match = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('&')), _mm_cmpeq_epi8(block, _mm_set1_epi8('<'))),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('>')), _mm_cmpeq_epi8(block, _mm_set1_epi8('"'))),
+                         _mm_cmpeq_epi8(block, _mm_set1_epi8('\''))));
+        int mask = _mm_movemask_epi8(match);
+        if (mask != 0) return from + __builtin_ctz(mask);
+    }
+    return findXmlSpecialScalar(data, from, size);
+}
+
+__attribute__((target("sse2"))) qsizetype findSpaceOrQuoteSse2(const char16_t* data, qsizetype from, qsizetype size)
+{
+    for (; from + 8 <= size; from += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+        __m128i candidate = _mm_or_si128(
+            _mm_or_si128(lessThanU16(block, 0x21), _mm_cmpeq_epi16(block, _mm_set1_epi16(u'"'))),
+            _mm_xor_si128(lessThanU16(block, 0x80), _mm_set1_epi16(-1)));
+        int mask = _mm_movemask_epi8(candidate);
+        if (mask != 0) return from + __builtin_ctz(mask) / 2;
+    }
+    return findSpaceOrQuoteScalar(data, from, size);
+}
+
+__attribute__((target("sse2"))) qsizetype findNonIdentifierSse2(const char16_t* data, qsizetype from, qsizetype size)
+{
+    for (; from + 8 <= size; from += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+        __m128i allowed = _mm_or_si128(
+            _mm_or_si128(inRangeU16(block, u'a', u'z'), inRangeU16(block, u'A', u'Z')),
+            _mm_or_si128(inRangeU16(block, u'0', u'9'), _mm_cmpeq_epi16(block, _mm_set1_epi16(u'_'))));
+        int mask = ~_mm_movemask_epi8(allowed) & 0xFFFF;
+        if (mask != 0) return from + __builtin_ctz(mask) / 2;
+    }
+    return findNonIdentifierScalar(data, from, size);
+}
+
+/////////////////////////////////////////////////
+/// AVX2: 16 символов UTF-16 или 32 байта за шаг
+/////////////////////////////////////////////////
+
+__attribute__((target("avx2"))) inline __m256i lessThanU16Avx2(__m256i value, char16_t bound)
+{
+    const __m256i bias = _mm256_set1_epi16(short(0x8000));
+    return _mm256_cmpgt_epi16(_mm256_set1_epi16(short(bound ^ 0x8000)), _mm256_xor_si256(value, bias));
+}
+
+__attribute__((target("avx2"))) inline __m256i inRangeU16Avx2(__m256i value, char16_t low, char16_t high)
+{
+    return lessThanU16Avx2(_mm256_sub_epi16(value, _mm256_set1_epi16(short(low))), char16_t(high - low + 1));
+}
+
+__attribute__((target("avx2"))) qsizetype findXmlSpecialAvx2(const char16_t* data, qsizetype from, qsizetype size)
+{
+    for (; from + 16 <= size; from += 16) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+        __m256i match = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'&')), _mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'<'))),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'>')), _mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'"'))),
+                            _mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'\''))));
+        unsigned mask = unsigned(_mm256_movemask_epi8(match));
+        if (mask != 0) return from + __builtin_ctz(mask) / 2;
+    }
+    return findXmlSpecialSse2(data, from, size);
+}
+
+__attribute__((target("avx2"))) qsizetype findXmlSpecialAvx2(const char* data, qsizetype from, qsizetype size)
+{
+    for (; from + 32 <= size; from += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+        __m256i match = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('&')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('<'))),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('>')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"'))),
+                            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\''))));
+        unsigned mask = unsigned(_mm256_movemask_epi8(match));
+        if (mask != 0) return from + __builtin_ctz(mask);
+    }
+    return findXmlSpecialSse2(data, from, size);
+}
+
+__attribute__((target("avx2"))) qsizetype findSpaceOrQuoteAvx2(const char16_t* data, qsizetype from, qsizetype size)
+{
+    for (; from + 16 <= size; from += 16) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+        __m256i candidate = _mm256_or_si256(
+            _mm256_or_si256(lessThanU16Avx2(block, 0x21), _mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'"'))),
+            _mm256_xor_si256(lessThanU16Avx2(block, 0x80), _mm256_set1_epi16(-1)));
+        unsigned mask = unsigned(_mm256_movemask_epi8(candidate));
+        if (mask != 0) return from + __builtin_ctz(mask) / 2;
+    }
+    return findSpaceOrQuoteSse2(data, from, size);
+}
+
+__attribute__((target("avx2"))) qsizetype findNonIdentifierAvx2(const char16_t* data, qsizetype from, qsizetype size)
+{
+    for (; from + 16 <= size; from += 16) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+        __m256i allowed = _mm256_or_si256(
+            _mm256_or_si256(inRangeU16Avx2(block, u'a', u'z'), inRangeU16Avx2(block, u'A', u'Z')),
+            _mm256_or_si256(inRangeU16Avx2(block, u'0', u'9'), _mm256_cmpeq_epi16(block, _mm256_set1_epi16(u'_'))));
+        unsigned mask = ~unsigned(_mm256_movemask_epi8(allowed));
+        if (mask != 0) return from + __builtin_ctz(mask) / 2;
+    }
+    return findNonIdentifierSse2(data, from, size);
+}
+
+#endif // TEXTSCANNER_X86
+
+InstructionSet detectInstructionSet()
+{
+#if defined(TEXTSCANNER_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return InstructionSet::Avx2;
+    if (__builtin_cpu_supports("sse2")) return InstructionSet::Sse2;
+#endif
+    return InstructionSet::Scalar;
+}
+
+// Набор инструкций определяется при первом обращении
+std::atomic<int> activeInstructionSet{-1};
+
+InstructionSet active()
+{
+    int set = activeInstructionSet.load(std::memory_order_relaxed);
+    if (set < 0) {
+        set = static_cast<int>(detectInstructionSet());
+        activeInstructionSet.store(set, std::memory_order_relaxed);
+    }
+    return static_cast<InstructionSet>(set);
+}
+
+template <typename Char>
+qsizetype findXmlSpecialCandidate(const Char* data, qsizetype from, qsizetype size)
+{
+#if defined(TEXTSCANNER_X86)
+    switch (active()) {
+    case InstructionSet::Avx2: return findXmlSpecialAvx2(data, from, size);
+    case InstructionSet::Sse2: return findXmlSpecialSse2(data, from, size);
+    case InstructionSet::Scalar: break;
+    }
+#endif
+    return findXmlSpecialScalar(data, from, size);
+}
+
+qsizetype findSpaceOrQuoteCandidate(const char16_t* data, qsizetype from, qsizetype size)
+{
+#if defined(TEXTSCANNER_X86)
+    switch (active()) {
+    case InstructionSet::Avx2: return findSpaceOrQuoteAvx2(data, from, size);
+    case InstructionSet::Sse2: return findSpaceOrQuoteSse2(data, from, size);
+    case InstructionSet::Scalar: break;
+    }
+#endif
+    return findSpaceOrQuoteScalar(data, from, size);
+}
+
+qsizetype findNonIdentifierCandidate(const char16_t* data, qsizetype from, qsizetype size)
+{
+#if defined(TEXTSCANNER_X86)
+    switch (active()) {
+    case InstructionSet::Avx2: return findNonIdentifierAvx2(data, from, size);
+    case InstructionSet::Sse2: return findNonIdentifierSse2(data, from, size);
+    case InstructionSet::Scalar: break;
+    }
+#endif
+    return findNonIdentifierScalar(data, from, size);
+}
+
+}
+
+qsizetype TextScanner::findXmlSpecial(QStringView text, qsizetype from)
+{
+    qsizetype position = findXmlSpecialCandidate(text.utf16(), qMax(from, qsizetype(0)), text.size());
+    return position < text.size() ? position : -1;
+}
+
+qsizetype TextScanner::findXmlSpecial(QByteArrayView text, qsizetype from)
+{
+    qsizetype position = findXmlSpecialCandidate(text.data(), qMax(from, qsizetype(0)), text.size());
+    return position < text.size() ? position : -1;
+}
+
+qsizetype TextScanner::findSpaceOrQuote(QStringView text, qsizetype from)
+{
+    // Кандидаты вне ASCII проверяются по правилам QChar::isSpace
+    for (qsizetype position = qMax(from, qsizetype(0)); ; position++) {
+        position = findSpaceOrQuoteCandidate(text.utf16(), position, text.size());
+        if (position >= text.size()) return -1;
+        if (text[position] == '"' || text[position].isSpace()) return position;
+    }
+}
+
+qsizetype TextScanner::findNonIdentifier(QStringView text, qsizetype from)
+{
+    // Цифры вне ASCII допустимы в идентификаторе так же, как при проверке QChar::isDigit
+    for (qsizetype position = qMax(from, qsizetype(0)); ; position++) {
+        position = findNonIdentifierCandidate(text.utf16(), position, text.size());
+        if (position >= text.size()) return -1;
+        if (!text[position].isDigit()) return position;
+    }
+}
+
+InstructionSet TextScanner::instructionSet()
+{
+    return active();
+}
+
+void TextScanner::setInstructionSet(InstructionSet set)
+{
+    InstructionSet supported = supportedInstructionSet();
+    activeInstructionSet.store(static_cast<int>(qMin(set, supported)), std::memory_order_relaxed);
+}
+
+InstructionSet TextScanner::supportedInstructionSet()
+{
+    return detectInstructionSet();
+}
+
+QString TextScanner::instructionSetName(InstructionSet set)
+{
+    switch (set) {
+    case InstructionSet::Scalar:    return "scalar";
+    case InstructionSet::Sse2:      return "sse2";
+    case InstructionSet::Avx2:      return "avx2";
+    }
+    return "unknown";
+}
@@ -0,0 +1,91 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса TextScanner для блочного поиска символов в тексте.
+ */
+
+#ifndef TEXTSCANNER_H
+#define TEXTSCANNER_H
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+/*!
+ * \brief Перечисление наборов инструкций, которыми выполняется поиск.
+ */
+enum class InstructionSet {
+    Scalar,     /*!< Посимвольный поиск */
+    Sse2,       /*!< Блоки по 16 байт */
+    Avx2        /*!< Блоки по 32 байта */
+};
+
+/*!
+ * \brief Класс для поиска символов в тексте блоками по 16–32 байта.
+ *
+ * Блочный поиск находит первый символ-кандидат с помощью векторных инструкций SSE2 или AVX2; набор
+ * инструкций выбирается один раз при первом обращении по возможностям процессора. Символы вне ASCII
+ * считаются кандидатами и проверяются посимвольно, поэтому результат совпадает с посимвольными проверками
+ * QChar. На платформах без SSE2 используется посимвольный поиск.
+ */
+class TextScanner
+{
+public:
+    /*!
+     * \brief Поиск специального символа XML (`&`, `<`, `>`, `"`, `'`).
+     * \param[in] text Текст.
+     * \param[in] from Позиция начала поиска.
+     * \return Позиция найденного символа или -1.
+     */
+    static qsizetype findXmlSpecial(QStringView text, qsizetype from = 0);
+
+    /*!
+     * \brief Поиск специального символа XML в тексте UTF-8.
+     * \param[in] text Текст в кодировке UTF-8.
+     * \param[in] from Позиция начала поиска.
+     * \return Позиция найденного байта или -1.
+     */
+    static qsizetype findXmlSpecial(QByteArrayView text, qsizetype from = 0);
+
+    /*!
+     * \brief Поиск пробельного символа (QChar::isSpace) или кавычки.
+     * \param[in] text Текст.
+     * \param[in] from Позиция начала поиска.
+     * \return Позиция найденного символа или -1.
+     */
+    static qsizetype findSpaceOrQuote(QStringView text, qsizetype from = 0);
+
+    /*!
+     * \brief Поиск символа, недопустимого в идентификаторе (не латинская буква, не цифра и не `_`).
+     * \param[in] text Текст.
+     * \param[in] from Позиция начала поиска.
+     * \return Позиция найденного символа или -1.
+     */
+    static qsizetype findNonIdentifier(QStringView text, qsizetype from = 0);
+
+    /*!
+     * \brief Получение используемого набора инструкций.
+     */
+    static InstructionSet instructionSet();
+
+    /*!
+     * \brief Ограничение используемого набора инструкций.
+     *
+     * Набор, не поддерживаемый процессором, заменяется наилучшим поддерживаемым из более простых.
+     * \param[in] set Набор инструкций.
+     */
+    static void setInstructionSet(InstructionSet set);
+
+    /*!
+     * \brief Получение наилучшего набора инструкций, поддерживаемого процессором.
+     */
+    static InstructionSet supportedInstructionSet();
+
+    /*!
+     * \brief Получение названия набора инструкций.
+     * \param[in] set Набор инструкций.
+     * \return Название ("scalar", "sse2", "avx2").
+     */
+    static QString instructionSetName(InstructionSet set);
+};
+
+#endif // TEXTSCANNER_H
@@ -0,0 +1,110 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса TraceRecorder.
+ */
+
+#include "tracerecorder.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+std::atomic<bool> TraceRecorder::enabledFlag{false};
+QMutex TraceRecorder::eventsMutex;
+QList<TraceRecorder::Event> TraceRecorder::events;
+QElapsedTimer TraceRecorder::clock;
+QString TraceRecorder::filePath;
+thread_local QString TraceRecorder::currentFile;
+
+TraceRecorder::Span::Span(const char* name)
+    : name(name), active(TraceRecorder::isEnabled()), start(0)
+{
+    if (active) start = TraceRecorder::now();
+}
+
+TraceRecorder::Span::~Span()
+{
+    if (active) TraceRecorder::record(name, start, TraceRecorder::now());
+}
+
+TraceRecorder::FileScope::FileScope(const QString& inputFile)
+    : active(TraceRecorder::isEnabled())
+{
+    if (active) {
+        previousFile = currentFile;
+        currentFile = inputFile;
+    }
+}
+
+TraceRecorder::FileScope::~FileScope()
+{
+    if (active) currentFile = previousFile;
+}
+
+void TraceRecorder::start(const QString& outputFilePath)
+{
+    QMutexLocker locker(&eventsMutex);
+    filePath = outputFilePath;
+    events.clear();
+    clock.start();
+    enabledFlag.store(true, std::memory_order_release);
+}
+
+bool TraceRecorder::finish()
+{
+    if (!enabledFlag.exchange(false, std::memory_order_acq_rel)) return true;
+
+    QJsonArray traceEvents;
+    {
+        QMutexLocker locker(&eventsMutex);
+        for (const Event& event : events) {
+            QJsonObject args;
+            args.insert("file", event.inputFile);
+
+            QJsonObject traceEvent;
+            traceEvent.insert("name", QString::fromLatin1(event.name));
+            traceEvent.insert("cat", "textExplanationsInRu");
+            traceEvent.insert("ph", "X");
+            // Формат Chrome Trace Event задаёт время в микросекундах
+            traceEvent.insert("ts", event.start / 1000.0);
+            traceEvent.insert("dur", event.duration / 1000.0);
+            traceEvent.insert("pid", QCoreApplication::applicationPid());
+            traceEvent.insert("tid", static_cast<qint64>(event.threadId));
+            traceEvent.insert("args", args);
+            traceEvents.append(traceEvent);
+        }
+        events.clear();
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", traceEvents);
+    root.insert("displayTimeUnit", "ms");
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+    return true;
+}
+
+QString TraceRecorder::outputPath()
+{
+    QMutexLocker locker(&eventsMutex);
+    return filePath;
+}
+
+void TraceRecorder::record(const char* name, qint64 start, qint64 end)
+{
+    quint64 threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    QMutexLocker locker(&eventsMutex);
+    events.append(Event{name, currentFile, threadId, start, end - start});
+}
+
+qint64 TraceRecorder::now()
+{
+    return clock.nsecsElapsed();
+}
@@ -0,0 +1,124 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса TraceRecorder для записи трассировки в формате Chrome Trace Event.
+ */
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+
+/*!
+ * \brief Класс для записи интервалов выполнения в формате Chrome Trace Event (JSON).
+ *
+ * Полученный файл открывается в Perfetto или chrome://tracing. Каждый интервал помечается
+ * идентификатором потока и именем обрабатываемого входного файла. Пока запись не начата,
+ * создание интервала сводится к чтению одного флага.
+ */
+class TraceRecorder
+{
+public:
+    /*!
+     * \brief Класс, записывающий интервал от создания до уничтожения объекта.
+     */
+    class Span
+    {
+    public:
+        /*!
+         * \brief Начинает интервал, если запись включена.
+         * \param[in] name Имя интервала (строковый литерал).
+         */
+        explicit Span(const char* name);
+
+        /*!
+         * \brief Завершает интервал и сохраняет его.
+         */
+        ~Span();
+
+    private:
+        const char* name;   /*!< Имя интервала */
+        bool active;        /*!< Включена ли запись в момент начала интервала */
+        qint64 start;       /*!< Время начала в наносекундах от начала записи */
+    };
+
+    /*!
+     * \brief Класс, задающий имя входного файла для интервалов текущего потока.
+     */
+    class FileScope
+    {
+    public:
+        /*!
+         * \brief Задаёт имя входного файла до уничтожения объекта.
+         * \param[in] inputFile Путь к входному файлу.
+         */
+        explicit FileScope(const QString& inputFile);
+
+        /*!
+         * \brief Восстанавливает предыдущее имя входного файла.
+         */
+        ~FileScope();
+
+    private:
+        QString previousFile;   /*!< Предыдущее имя входного файла */
+        bool active;            /*!< Включена ли запись в момент создания объекта */
+    };
+
+    /*!
+     * \brief Начало записи трассировки.
+     * \param[in] outputFilePath Путь к файлу, в который будет записана трассировка.
+     */
+    static void start(const QString& outputFilePath);
+
+    /*!
+     * \brief Завершение записи и сохранение трассировки в файл.
+     * \return true, если файл успешно записан или запись не была начата.
+     */
+    static bool finish();
+
+    /*!
+     * \brief Проверка, включена ли запись.
+     * \return true, если запись включена.
+     */
+    static bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Получение пути к файлу трассировки.
+     */
+    static QString outputPath();
+
+private:
+    /*!
+     * \brief Записанный интервал.
+     */
+    struct Event {
+        const char* name;   /*!< Имя интервала */
+        QString inputFile;  /*!< Имя входного файла */
+        quint64 threadId;   /*!< Идентификатор потока */
+        qint64 start;       /*!< Время начала в наносекундах */
+        qint64 duration;    /*!< Длительность в наносекундах */
+    };
+
+    /*!
+     * \brief Сохранение интервала.
+     */
+    static void record(const char* name, qint64 start, qint64 end);
+
+    /*!
+     * \brief Получение времени в наносекундах от начала записи.
+     */
+    static qint64 now();
+
+    static std::atomic<bool> enabledFlag;       /*!< Включена ли запись */
+    static QMutex eventsMutex;                  /*!< Защита списка интервалов */
+    static QList<Event> events;                 /*!< Записанные интервалы */
+    static QElapsedTimer clock;                 /*!< Монотонные часы записи */
+    static QString filePath;                    /*!< Путь к файлу трассировки */
+    static thread_local QString currentFile;    /*!< Входной файл, обрабатываемый текущим потоком */
+};
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,176 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса XmlElement.
+ */
+
+#include "xmlelement.h"
+
+namespace {
+// Сравнение строки стандартной библиотеки с именем без преобразования кодировки
+bool sameName(const std::string& name, QByteArrayView expected)
+{
+    return std::string_view(name) == std::string_view(expected.data(), size_t(expected.size()));
+}
+
+// Преобразование строки UTF-8 в QString
+QString toQString(const std::string& text)
+{
+    return QString::fromUtf8(text.data(), qsizetype(text.size()));
+}
+}
+
+XmlElement::XmlElement(const XmlTree* tree, int index)
+    : tree(tree)
+    , index(tree != nullptr ? index : XmlTree::NoNode)
+{}
+
+XmlElement XmlElement::documentElement(const XmlTree& tree)
+{
+    return XmlElement(&tree, tree.root());
+}
+
+bool XmlElement::isNull() const
+{
+    return index == XmlTree::NoNode;
+}
+
+bool XmlElement::isElement() const
+{
+    return !isNull() && node().kind == XmlTree::NodeKind::Element;
+}
+
+XmlElement XmlElement::toElement() const
+{
+    return isElement() ? *this : XmlElement();
+}
+
+QString XmlElement::tagName() const
+{
+    return isElement() ? toQString(node().value) : QString();
+}
+
+int XmlElement::lineNumber() const
+{
+    return isNull() ? -1 : node().line;
+}
+
+QString XmlElement::attribute(QByteArrayView name, const QString& defaultValue) const
+{
+    if (!isElement()) return defaultValue;
+    const XmlTree::Node& element = node();
+    for (int i = element.firstAttribute; i < element.firstAttribute + element.attributeCount; ++i)
+        if (sameName(tree->attribute(i).name, name)) return toQString(tree->attribute(i).value);
+    return defaultValue;
+}
+
+bool XmlElement::hasAttribute(QByteArrayView name) const
+{
+    if (!isElement()) return false;
+    const XmlTree::Node& element = node();
+    for (int i = element.firstAttribute; i < element.firstAttribute + element.attributeCount; ++i)
+        if (sameName(tree->attribute(i).name, name)) return true;
+    return false;
+}
+
+int XmlElement::attributeCount() const
+{
+    return isElement() ? node().attributeCount : 0;
+}
+
+QString XmlElement::attributeName(int attributeIndex) const
+{
+    return toQString(tree->attribute(node().firstAttribute + attributeIndex).name);
+}
+
+bool XmlElement::hasChildNodes() const
+{
+    return !isNull() && node().firstChild != XmlTree::NoNode;
+}
+
+XmlElement XmlElement::firstChild() const
+{
+    return isNull() ? XmlElement() : XmlElement(tree, node().firstChild);
+}
+
+XmlElement XmlElement::nextSibling() const
+{
+    return isNull() ? XmlElement() : XmlElement(tree, node().nextSibling);
+}
+
+XmlElement XmlElement::firstChildElement(QByteArrayView tagName) const
+{
+    return isNull() ? XmlElement() : findElement(node().firstChild, tagName);
+}
+
+XmlElement XmlElement::nextSiblingElement(QByteArrayView tagName) const
+{
+    return isNull() ? XmlElement() : findElement(node().nextSibling, tagName);
+}
+
+QList<XmlElement> XmlElement::elementsByTagName(QByteArrayView tagName) const
+{
+    QList<XmlElement> result;
+    if (isNull()) return result;
+
+    // Узлы хранятся в порядке документа, поэтому потомки узла занимают непрерывный участок после него
+    const int end = int(tree->size());
+    for (int i = index + 1; i < end; ++i) {
+        int ancestor = tree->node(i).parent;
+        while (ancestor != XmlTree::NoNode && ancestor > index) ancestor = tree->node(ancestor).parent;
+        if (ancestor != index) break;
+        if (hasTagName(i, tagName)) result.append(XmlElement(tree, i));
+    }
+    return result;
+}
+
+QString XmlElement::text() const
+{
+    if (isNull()) return QString();
+    const XmlTree::Node& current = node();
+    if (current.kind == XmlTree::NodeKind::Text) return toQString(current.value);
+
+    // Обычно элемент содержит один текстовый узел; тогда текст преобразуется без промежуточного сцепления
+    if (current.firstChild != XmlTree::NoNode && current.firstChild == current.lastChild
+        && tree->node(current.firstChild).kind == XmlTree::NodeKind::Text)
+        return toQString(tree->node(current.firstChild).value);
+
+    QString result;
+    for (XmlElement child = firstChild(); !child.isNull(); child = child.nextSibling())
+        result += child.text();
+    return result;
+}
+
+bool XmlElement::textSource(qsizetype& offset, qsizetype& length) const
+{
+    if (isNull()) return false;
+    const XmlTree::Node& current = node();
+    int textIndex = index;
+    if (current.kind == XmlTree::NodeKind::Element) {
+        if (current.firstChild == XmlTree::NoNode || current.firstChild != current.lastChild) return false;
+        textIndex = current.firstChild;
+    }
+
+    const XmlTree::Node& text = tree->node(textIndex);
+    if (text.kind != XmlTree::NodeKind::Text || text.sourceOffset == XmlTree::NoSource) return false;
+    offset = qsizetype(text.sourceOffset);
+    length = qsizetype(text.value.size());
+    return true;
+}
+
+bool XmlElement::hasTagName(int nodeIndex, QByteArrayView tagName) const
+{
+    const XmlTree::Node& candidate = tree->node(nodeIndex);
+    return candidate.kind == XmlTree::NodeKind::Element && (tagName.isEmpty() || sameName(candidate.value, tagName));
+}
+
+XmlElement XmlElement::findElement(int nodeIndex, QByteArrayView tagName) const
+{
+    for (int i = nodeIndex; i != XmlTree::NoNode; i = tree->node(i).nextSibling)
+        if (hasTagName(i, tagName)) return XmlElement(tree, i);
+    return XmlElement();
+}
+
+const XmlTree::Node& XmlElement::node() const
+{
+    return tree->node(index);
+}
@@ -0,0 +1,158 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса XmlElement – интерфейса Qt к узлам XmlTree.
+ */
+
+#ifndef XMLELEMENT_H
+#define XMLELEMENT_H
+
+#include "xmltree.h"
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief Класс, предоставляющий доступ к узлу XmlTree с именами и текстом в виде QString.
+ *
+ * Повторяет используемое разборщиком подмножество интерфейса QDomElement. Объект хранит только указатель
+ * на дерево и индекс узла, поэтому копируется без затрат и действителен, пока существует дерево.
+ * Строки преобразуются из UTF-8 только при обращении к ним; имена сравниваются без преобразования.
+ */
+class XmlElement
+{
+public:
+    /*!
+     * \brief Конструктор пустого узла.
+     */
+    XmlElement() = default;
+
+    /*!
+     * \brief Конструктор узла дерева.
+     * \param[in] tree Дерево.
+     * \param[in] index Индекс узла либо XmlTree::NoNode.
+     */
+    XmlElement(const XmlTree* tree, int index);
+
+    /*!
+     * \brief Получение корневого элемента дерева.
+     */
+    static XmlElement documentElement(const XmlTree& tree);
+
+    /*!
+     * \brief Проверка, является ли узел пустым.
+     */
+    bool isNull() const;
+
+    /*!
+     * \brief Проверка, является ли узел элементом.
+     */
+    bool isElement() const;
+
+    /*!
+     * \brief Получение узла как элемента.
+     * \return Этот же узел, если он является элементом, иначе пустой узел.
+     */
+    XmlElement toElement() const;
+
+    /*!
+     * \brief Получение имени элемента.
+     */
+    QString tagName() const;
+
+    /*!
+     * \brief Получение номера строки узла.
+     * \return Номер строки, на которой заканчивается открывающий тег элемента; -1 для пустого узла.
+     */
+    int lineNumber() const;
+
+    /*!
+     * \brief Получение значения атрибута.
+     * \param[in] name Имя атрибута.
+     * \param[in] defaultValue Значение, возвращаемое при отсутствии атрибута.
+     */
+    QString attribute(QByteArrayView name, const QString& defaultValue = QString()) const;
+
+    /*!
+     * \brief Проверка наличия атрибута.
+     * \param[in] name Имя атрибута.
+     */
+    bool hasAttribute(QByteArrayView name) const;
+
+    /*!
+     * \brief Получение количества атрибутов элемента.
+     */
+    int attributeCount() const;
+
+    /*!
+     * \brief Получение имени атрибута по его номеру.
+     * \param[in] index Номер атрибута от 0 до attributeCount() - 1.
+     */
+    QString attributeName(int index) const;
+
+    /*!
+     * \brief Проверка наличия дочерних узлов.
+     */
+    bool hasChildNodes() const;
+
+    /*!
+     * \brief Получение первого дочернего узла (элемента или текста).
+     */
+    XmlElement firstChild() const;
+
+    /*!
+     * \brief Получение следующего узла того же родителя (элемента или текста).
+     */
+    XmlElement nextSibling() const;
+
+    /*!
+     * \brief Получение первого дочернего элемента.
+     * \param[in] tagName Имя элемента; пустое имя соответствует любому элементу.
+     */
+    XmlElement firstChildElement(QByteArrayView tagName = {}) const;
+
+    /*!
+     * \brief Получение следующего элемента того же родителя.
+     * \param[in] tagName Имя элемента; пустое имя соответствует любому элементу.
+     */
+    XmlElement nextSiblingElement(QByteArrayView tagName = {}) const;
+
+    /*!
+     * \brief Получение всех вложенных элементов с заданным именем в порядке документа.
+     * \param[in] tagName Имя элемента.
+     */
+    QList<XmlElement> elementsByTagName(QByteArrayView tagName) const;
+
+    /*!
+     * \brief Получение текста узла вместе с текстом всех вложенных элементов.
+     */
+    QString text() const;
+
+    /*!
+     * \brief Получение участка исходного документа, совпадающего с текстом элемента.
+     * \param[out] offset Начало участка в байтах.
+     * \param[out] length Длина участка в байтах.
+     * \return true, если текст элемента – один текстовый узел, записанный в документе без изменений.
+     */
+    bool textSource(qsizetype& offset, qsizetype& length) const;
+
+private:
+    /*!
+     * \brief Проверка, является ли узел элементом с заданным именем.
+     */
+    bool hasTagName(int index, QByteArrayView tagName) const;
+
+    /*!
+     * \brief Поиск элемента с заданным именем, начиная с узла index и далее по соседним узлам.
+     */
+    XmlElement findElement(int index, QByteArrayView tagName) const;
+
+    /*!
+     * \brief Получение узла дерева. Допустимо только для непустого узла.
+     */
+    const XmlTree::Node& node() const;
+
+    const XmlTree* tree = nullptr;      /*!< Дерево */
+    int index = XmlTree::NoNode;        /*!< Индекс узла */
+};
+
+#endif // XMLELEMENT_H
@@ -0,0 +1,42 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию функций распознавания имён элементов и атрибутов схемы.
+ */
+
+#include "xmlschema.h"
+
+namespace {
+// Имена элементов в порядке перечисления XmlTag
+constexpr QStringView TagNames[XmlTagCount] = {
+    u"expression", u"expressions", u"variables", u"variable", u"functions", u"function",
+    u"unions", u"union", u"structures", u"structure", u"classes", u"class",
+    u"enums", u"enum", u"value", u"description", u"case"
+};
+
+// Имена атрибутов в порядке перечисления XmlAttribute
+constexpr QStringView AttributeNames[XmlAttributeCount] = {u"name", u"type", u"paramsCount", u"notation"};
+}
+
+XmlTag xmlTagByName(QStringView name)
+{
+    for (int tag = 0; tag < XmlTagCount; ++tag)
+        if (TagNames[tag] == name) return static_cast<XmlTag>(tag);
+    return XmlTag::Unknown;
+}
+
+QString xmlTagName(XmlTag tag)
+{
+    return tag == XmlTag::Unknown ? QString() : TagNames[static_cast<int>(tag)].toString();
+}
+
+XmlAttribute xmlAttributeByName(QStringView name)
+{
+    for (int attribute = 0; attribute < XmlAttributeCount; ++attribute)
+        if (AttributeNames[attribute] == name) return static_cast<XmlAttribute>(attribute);
+    return XmlAttribute::Unknown;
+}
+
+QString xmlAttributeName(XmlAttribute attribute)
+{
+    return attribute == XmlAttribute::Unknown ? QString() : AttributeNames[static_cast<int>(attribute)].toString();
+}
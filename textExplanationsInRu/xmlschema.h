@@ -0,0 +1,208 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание схемы входного XML-документа: элементы, атрибуты и правила их вложенности.
+ */
+
+#ifndef XMLSCHEMA_H
+#define XMLSCHEMA_H
+
+#include <QString>
+#include <QStringView>
+
+#include <array>
+
+/*!
+ * \brief Перечисление имён элементов входного документа.
+ */
+enum class XmlTag {
+    Expression,     /*!< <expression> */
+    Expressions,    /*!< <expressions> */
+    Variables,      /*!< <variables> */
+    Variable,       /*!< <variable> */
+    Functions,      /*!< <functions> */
+    Function,       /*!< <function> */
+    Unions,         /*!< <unions> */
+    Union,          /*!< <union> */
+    Structures,     /*!< <structures> */
+    Structure,      /*!< <structure> */
+    Classes,        /*!< <classes> */
+    Class,          /*!< <class> */
+    Enums,          /*!< <enums> */
+    Enum,           /*!< <enum> */
+    Value,          /*!< <value> */
+    Description,    /*!< <description> */
+    Case,           /*!< <case> */
+    Unknown         /*!< Элемент, не входящий в схему */
+};
+
+/*!
+ * \brief Количество известных имён элементов.
+ */
+constexpr int XmlTagCount = static_cast<int>(XmlTag::Unknown);
+
+/*!
+ * \brief Перечисление имён атрибутов, проверяемых схемой.
+ */
+enum class XmlAttribute {
+    Name,           /*!< name */
+    Type,           /*!< type */
+    ParamsCount,    /*!< paramsCount */
+    Notation,       /*!< notation */
+    Unknown         /*!< Атрибут, не входящий в схему */
+};
+
+/*!
+ * \brief Количество известных имён атрибутов.
+ */
+constexpr int XmlAttributeCount = static_cast<int>(XmlAttribute::Unknown);
+
+/*!
+ * \brief Перечисление видов элементов, для которых в схеме заданы правила.
+ *
+ * Корневой элемент имеет несколько видов: правила зависят от того, содержит ли документ одно выражение
+ * или список выражений и находятся ли объявления в общей библиотеке.
+ */
+enum class SchemaElement {
+    Root,                           /*!< <root> с выражением и объявлениями */
+    ExpressionListRoot,             /*!< <root> со списком выражений и объявлениями */
+    RootWithLibrary,                /*!< <root> с выражением, объявления которого находятся в библиотеке */
+    ExpressionListRootWithLibrary,  /*!< <root> со списком выражений, объявления которых находятся в библиотеке */
+    LibraryRoot,                    /*!< <root> библиотеки объявлений */
+    Expressions,                    /*!< <expressions> */
+    Expression,                     /*!< <expression> */
+    Variables,                      /*!< <variables> */
+    Variable,                       /*!< <variable> */
+    Functions,                      /*!< <functions> */
+    Function,                       /*!< <function> */
+    Unions,                         /*!< <unions> */
+    Structures,                     /*!< <structures> */
+    Classes,                        /*!< <classes> */
+    CustomType,                     /*!< <union>, <structure> или <class> */
+    Enums,                          /*!< <enums> */
+    Enum,                           /*!< <enum> */
+    EnumValue,                      /*!< <value> */
+    Count                           /*!< Количество видов элементов */
+};
+
+/*!
+ * \brief Количество видов элементов схемы.
+ */
+constexpr int SchemaElementCount = static_cast<int>(SchemaElement::Count);
+
+/*!
+ * \brief Получение бита имени элемента в маске.
+ */
+constexpr quint32 tagBit(XmlTag tag)
+{
+    return quint32(1) << static_cast<int>(tag);
+}
+
+/*!
+ * \brief Получение бита атрибута в маске.
+ */
+constexpr quint32 attributeBit(XmlAttribute attribute)
+{
+    return quint32(1) << static_cast<int>(attribute);
+}
+
+/*!
+ * \brief Структура, описывающая правила для одного вида элементов.
+ */
+struct ElementRule {
+    quint32 allowedAttributes = 0;                  /*!< Маска допустимых атрибутов */
+    quint32 requiredAttributes = 0;                 /*!< Маска обязательных атрибутов */
+    std::array<int, XmlTagCount> maxChildren{};     /*!< Наибольшее количество дочерних элементов каждого имени; 0 – элемент недопустим */
+    quint32 requiredChildren = 0;                   /*!< Маска обязательных дочерних элементов */
+};
+
+/*!
+ * \brief Таблица правил, индексируемая видом элемента.
+ */
+using XmlSchema = std::array<ElementRule, SchemaElementCount>;
+
+/*!
+ * \brief Построение схемы входного документа на этапе компиляции.
+ * \param[in] childElementsMaxCount Наибольшее количество объявлений в одном списке.
+ * \param[in] expressionsMaxCount Наибольшее количество выражений в списке <expressions>.
+ * \return Таблица правил, индексируемая видом элемента.
+ */
+constexpr XmlSchema makeXmlSchema(int childElementsMaxCount, int expressionsMaxCount)
+{
+    XmlSchema schema{};
+    auto at = [&schema](SchemaElement element) -> ElementRule& { return schema[static_cast<int>(element)]; };
+    auto allowChild = [](ElementRule& rule, XmlTag tag, int maxCount, bool required) {
+        rule.maxChildren[static_cast<int>(tag)] = maxCount;
+        if (required) rule.requiredChildren |= tagBit(tag);
+    };
+    auto allowAttribute = [](ElementRule& rule, XmlAttribute attribute, bool required) {
+        rule.allowedAttributes |= attributeBit(attribute);
+        if (required) rule.requiredAttributes |= attributeBit(attribute);
+    };
+
+    // Корневой элемент: выражение и по одному списку объявлений каждого вида
+    const XmlTag declarationLists[] = {XmlTag::Variables, XmlTag::Functions, XmlTag::Unions,
+                                       XmlTag::Structures, XmlTag::Classes, XmlTag::Enums};
+    for (SchemaElement root : {SchemaElement::Root, SchemaElement::ExpressionListRoot, SchemaElement::RootWithLibrary,
+                               SchemaElement::ExpressionListRootWithLibrary, SchemaElement::LibraryRoot}) {
+        bool declarationsRequired = root == SchemaElement::Root || root == SchemaElement::ExpressionListRoot;
+        for (XmlTag list : declarationLists)
+            allowChild(at(root), list, 1, declarationsRequired);
+    }
+    allowChild(at(SchemaElement::Root), XmlTag::Expression, 1, true);
+    allowChild(at(SchemaElement::RootWithLibrary), XmlTag::Expression, 1, true);
+    allowChild(at(SchemaElement::ExpressionListRoot), XmlTag::Expressions, 1, true);
+    allowChild(at(SchemaElement::ExpressionListRootWithLibrary), XmlTag::Expressions, 1, true);
+
+    allowChild(at(SchemaElement::Expressions), XmlTag::Expression, expressionsMaxCount, true);
+    allowAttribute(at(SchemaElement::Expression), XmlAttribute::Notation, false);
+
+    // Списки объявлений не обязаны содержать элементы
+    allowChild(at(SchemaElement::Variables), XmlTag::Variable, childElementsMaxCount, false);
+    allowChild(at(SchemaElement::Functions), XmlTag::Function, childElementsMaxCount, false);
+    allowChild(at(SchemaElement::Unions), XmlTag::Union, childElementsMaxCount, false);
+    allowChild(at(SchemaElement::Structures), XmlTag::Structure, childElementsMaxCount, false);
+    allowChild(at(SchemaElement::Classes), XmlTag::Class, childElementsMaxCount, false);
+    allowChild(at(SchemaElement::Enums), XmlTag::Enum, childElementsMaxCount, false);
+
+    // Объявления: обязательные атрибуты и описание в падежах
+    for (SchemaElement declaration : {SchemaElement::Variable, SchemaElement::Function, SchemaElement::CustomType,
+                                      SchemaElement::Enum, SchemaElement::EnumValue})
+        allowAttribute(at(declaration), XmlAttribute::Name, true);
+    allowAttribute(at(SchemaElement::Variable), XmlAttribute::Type, true);
+    allowAttribute(at(SchemaElement::Function), XmlAttribute::Type, true);
+    allowAttribute(at(SchemaElement::Function), XmlAttribute::ParamsCount, true);
+    for (SchemaElement described : {SchemaElement::Variable, SchemaElement::Function, SchemaElement::EnumValue})
+        allowChild(at(described), XmlTag::Description, 1, true);
+
+    allowChild(at(SchemaElement::CustomType), XmlTag::Variables, 1, true);
+    allowChild(at(SchemaElement::CustomType), XmlTag::Functions, 1, true);
+    allowChild(at(SchemaElement::Enum), XmlTag::Value, childElementsMaxCount, true);
+
+    return schema;
+}
+
+/*!
+ * \brief Распознавание имени элемента.
+ * \param[in] name Имя элемента.
+ * \return Имя элемента из схемы либо XmlTag::Unknown.
+ */
+XmlTag xmlTagByName(QStringView name);
+
+/*!
+ * \brief Получение строкового имени элемента.
+ */
+QString xmlTagName(XmlTag tag);
+
+/*!
+ * \brief Распознавание имени атрибута.
+ * \param[in] name Имя атрибута.
+ * \return Атрибут из схемы либо XmlAttribute::Unknown.
+ */
+XmlAttribute xmlAttributeByName(QStringView name);
+
+/*!
+ * \brief Получение строкового имени атрибута.
+ */
+QString xmlAttributeName(XmlAttribute attribute);
+
+#endif // XMLSCHEMA_H
@@ -0,0 +1,414 @@
+/*!
+ * \file
+ * \brief Файл, содержащий реализацию методов класса XmlTree.
+ */
+
+#include "xmltree.h"
+
+#include <algorithm>
+
+namespace {
+// Пробельный символ XML
+bool isXmlSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Символ, с которого может начинаться имя (байты UTF-8 многобайтовых символов допускаются)
+bool isNameStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+// Символ, который может продолжать имя
+bool isNameChar(char c)
+{
+    return isNameStart(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+// Запись кода символа в UTF-8
+bool appendUtf8(std::string& out, unsigned long code)
+{
+    if (code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return false;
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    }
+    else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return true;
+}
+}
+
+/*!
+ * \brief Класс, выполняющий однопроходный разбор документа в XmlTree.
+ */
+class XmlTreeBuilder
+{
+public:
+    /*!
+     * \brief Конструктор класса XmlTreeBuilder.
+     * \param[in,out] tree Заполняемое дерево.
+     * \param[in] content Содержимое документа.
+     */
+    XmlTreeBuilder(XmlTree& tree, std::string_view content) : tree(tree), content(content) {}
+
+    /*!
+     * \brief Разбор документа.
+     * \return true, если документ синтаксически корректен.
+     */
+    bool build()
+    {
+        // Метка порядка байтов UTF-8
+        if (content.substr(0, 3) == "\xEF\xBB\xBF") position = 3;
+
+        if (!skipMisc()) return false;
+        if (atEnd() || content[position] != '<') return fail("root element expected");
+        if (!parseContent()) return false;
+        if (!skipMisc()) return false;
+        if (!atEnd()) return fail("extra content at the end of the document");
+        return true;
+    }
+
+private:
+    XmlTree& tree;                      /*!< Заполняемое дерево */
+    std::string_view content;           /*!< Содержимое документа */
+    std::size_t position = 0;           /*!< Текущая позиция */
+    std::size_t linePosition = 0;       /*!< Позиция, до которой подсчитаны строки */
+    int line = 1;                       /*!< Номер строки позиции linePosition */
+    std::vector<int> openElements;      /*!< Незакрытые элементы */
+
+    // Достигнут ли конец содержимого
+    bool atEnd() const { return position >= content.size(); }
+
+    // Начинается ли содержимое с текущей позиции с заданной строки
+    bool startsWith(std::string_view text) const { return content.substr(position, text.size()) == text; }
+
+    // Номер строки текущей позиции; позиция только возрастает, поэтому строки подсчитываются один раз
+    int currentLine()
+    {
+        std::size_t end = std::min(position, content.size());
+        if (end > linePosition) {
+            line += static_cast<int>(std::count(content.begin() + linePosition, content.begin() + end, '\n'));
+            linePosition = end;
+        }
+        return line;
+    }
+
+    // Запомнить ошибку с номером текущей строки
+    bool fail(const char* message)
+    {
+        tree.error = message;
+        tree.errorLineNumber = currentLine();
+        return false;
+    }
+
+    // Пропуск пробелов
+    void skipSpaces()
+    {
+        while (!atEnd() && isXmlSpace(content[position])) ++position;
+    }
+
+    // Пропуск участка до заданной строки включительно
+    bool skipPast(std::string_view terminator, const char* message)
+    {
+        std::size_t end = content.find(terminator, position);
+        if (end == std::string_view::npos) return fail(message);
+        position = end + terminator.size();
+        return true;
+    }
+
+    // Пропуск пробелов, комментариев, инструкций обработки и объявления типа документа вне корневого элемента
+    bool skipMisc()
+    {
+        while (true) {
+            skipSpaces();
+            if (startsWith("<?")) {
+                if (!skipPast("?>", "unterminated processing instruction")) return false;
+            }
+            else if (startsWith("<!--")) {
+                if (!skipPast("-->", "unterminated comment")) return false;
+            }
+            else if (startsWith("<!DOCTYPE")) {
+                if (content.find('[', position) < content.find('>', position)) return fail("internal DTD subset is not supported");
+                if (!skipPast(">", "unterminated document type declaration")) return false;
+            }
+            else return true;
+        }
+    }
+
+    // Чтение имени элемента или атрибута
+    bool readName(std::string& name)
+    {
+        std::size_t start = position;
+        if (atEnd() || !isNameStart(content[position])) return fail("name expected");
+        while (!atEnd() && isNameChar(content[position])) ++position;
+        name.assign(content.substr(start, position - start));
+        return true;
+    }
+
+    // Раскрытие ссылки на символ, начинающейся в текущей позиции с '&'
+    bool readReference(std::string& out)
+    {
+        std::size_t end = content.find(';', position);
+        if (end == std::string_view::npos || end - position > 12) return fail("unterminated entity reference");
+        std::string_view name = content.substr(position + 1, end - position - 1);
+        position = end + 1;
+
+        if (name == "lt") out += '<';
+        else if (name == "gt") out += '>';
+        else if (name == "amp") out += '&';
+        else if (name == "quot") out += '"';
+        else if (name == "apos") out += '\'';
+        else if (name.size() > 1 && name[0] == '#') {
+            bool hex = name[1] == 'x';
+            std::string_view digits = name.substr(hex ? 2 : 1);
+            if (digits.empty()) return fail("invalid character reference");
+            unsigned long code = 0;
+            for (char c : digits) {
+                int digit;
+                if (c >= '0' && c <= '9') digit = c - '0';
+                else if (hex && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+                else if (hex && c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+                else return fail("invalid character reference");
+                code = code * (hex ? 16 : 10) + digit;
+                if (code > 0x10FFFF) return fail("invalid character reference");
+            }
+            if (!appendUtf8(out, code)) return fail("invalid character reference");
+        }
+        else return fail("undefined entity");
+        return true;
+    }
+
+    // Добавление узла последним дочерним узлом текущего элемента
+    int appendNode(XmlTree::NodeKind kind, std::string&& value, int nodeLine)
+    {
+        int index = static_cast<int>(tree.nodes.size());
+        XmlTree::Node node;
+        node.kind = kind;
+        node.value = std::move(value);
+        node.line = nodeLine;
+        node.parent = openElements.empty() ? XmlTree::NoNode : openElements.back();
+        tree.nodes.push_back(std::move(node));
+
+        if (openElements.empty()) return index;
+        XmlTree::Node& parent = tree.nodes[openElements.back()];
+        if (parent.lastChild == XmlTree::NoNode) parent.firstChild = index;
+        else tree.nodes[parent.lastChild].nextSibling = index;
+        parent.lastChild = index;
+        return index;
+    }
+
+    // Добавление текста; соседние участки текста и CDATA объединяются в один узел.
+    // sourceOffset – начало текста в документе, если он записан там без изменений
+    void appendText(std::string&& text, std::size_t sourceOffset)
+    {
+        const XmlTree::Node& parent = tree.nodes[openElements.back()];
+        if (parent.lastChild != XmlTree::NoNode && tree.nodes[parent.lastChild].kind == XmlTree::NodeKind::Text) {
+            XmlTree::Node& previous = tree.nodes[parent.lastChild];
+            previous.value += text;
+            previous.line = currentLine();
+            previous.sourceOffset = XmlTree::NoSource;
+            return;
+        }
+        int index = appendNode(XmlTree::NodeKind::Text, std::move(text), currentLine());
+        tree.nodes[index].sourceOffset = sourceOffset;
+    }
+
+    // Чтение открывающего тега с атрибутами
+    bool parseStartTag()
+    {
+        ++position;
+        std::string name;
+        if (!readName(name)) return false;
+
+        int firstAttribute = static_cast<int>(tree.attributes.size());
+        while (true) {
+            std::size_t beforeSpaces = position;
+            skipSpaces();
+            if (atEnd()) return fail("unterminated start tag");
+            if (content[position] == '>' || startsWith("/>")) break;
+            if (position == beforeSpaces) return fail("whitespace expected between attributes");
+
+            XmlTree::Attribute attribute;
+            if (!readName(attribute.name)) return false;
+            skipSpaces();
+            if (atEnd() || content[position] != '=') return fail("'=' expected after attribute name");
+            ++position;
+            skipSpaces();
+            if (atEnd() || (content[position] != '"' && content[position] != '\'')) return fail("quoted attribute value expected");
+            char quote = content[position++];
+            while (!atEnd() && content[position] != quote) {
+                char c = content[position];
+                if (c == '<') return fail("'<' in attribute value");
+                if (c == '&') {
+                    if (!readReference(attribute.value)) return false;
+                    continue;
+                }
+                // Пробельные символы значения атрибута (и пара "\r\n") заменяются одним пробелом
+                attribute.value += isXmlSpace(c) ? ' ' : c;
+                ++position;
+                if (c == '\r' && !atEnd() && content[position] == '\n') ++position;
+            }
+            if (atEnd()) return fail("unterminated attribute value");
+            ++position;
+
+            for (int i = firstAttribute; i < static_cast<int>(tree.attributes.size()); ++i)
+                if (tree.attributes[i].name == attribute.name) return fail("duplicate attribute");
+            tree.attributes.push_back(std::move(attribute));
+        }
+
+        bool empty = content[position] == '/';
+        position += empty ? 2 : 1;
+
+        int index = appendNode(XmlTree::NodeKind::Element, std::move(name), currentLine());
+        tree.nodes[index].firstAttribute = firstAttribute;
+        tree.nodes[index].attributeCount = static_cast<int>(tree.attributes.size()) - firstAttribute;
+        if (openElements.empty()) tree.rootIndex = index;
+        if (!empty) openElements.push_back(index);
+        return true;
+    }
+
+    // Чтение закрывающего тега
+    bool parseEndTag()
+    {
+        position += 2;
+        std::string name;
+        if (!readName(name)) return false;
+        skipSpaces();
+        if (atEnd() || content[position] != '>') return fail("'>' expected in end tag");
+        ++position;
+        if (openElements.empty() || tree.nodes[openElements.back()].value != name) return fail("opening and ending tag mismatch");
+        openElements.pop_back();
+        return true;
+    }
+
+    // Чтение текста до следующей разметки с раскрытием ссылок и нормализацией концов строк
+    bool parseText()
+    {
+        std::string text;
+        std::size_t start = position;
+        bool spacesOnly = true;
+        bool verbatim = true;
+        while (!atEnd() && content[position] != '<') {
+            char c = content[position];
+            if (c == '&') {
+                if (!readReference(text)) return false;
+                spacesOnly = false;
+                verbatim = false;
+                continue;
+            }
+            if (c == '\r') {
+                text += '\n';
+                ++position;
+                if (!atEnd() && content[position] == '\n') ++position;
+                verbatim = false;
+                continue;
+            }
+            spacesOnly = spacesOnly && isXmlSpace(c);
+            text += c;
+            ++position;
+        }
+        if (!spacesOnly) appendText(std::move(text), verbatim ? start : XmlTree::NoSource);
+        return true;
+    }
+
+    // Разбор корневого элемента и всего его содержимого
+    bool parseContent()
+    {
+        if (!parseStartTag()) return false;
+        while (!openElements.empty()) {
+            if (atEnd()) return fail("unexpected end of document");
+            if (content[position] != '<') {
+                if (!parseText()) return false;
+            }
+            else if (startsWith("</")) {
+                if (!parseEndTag()) return false;
+            }
+            else if (startsWith("<!--")) {
+                if (!skipPast("-->", "unterminated comment")) return false;
+            }
+            else if (startsWith("<![CDATA[")) {
+                std::size_t start = position + 9;
+                std::size_t end = content.find("]]>", start);
+                if (end == std::string_view::npos) return fail("unterminated CDATA section");
+                position = end + 3;
+                if (end > start) appendText(std::string(content.substr(start, end - start)), start);
+            }
+            else if (startsWith("<?")) {
+                if (!skipPast("?>", "unterminated processing instruction")) return false;
+            }
+            else if (startsWith("<!")) {
+                return fail("unexpected declaration");
+            }
+            else if (!parseStartTag()) return false;
+        }
+        return true;
+    }
+};
+
+bool XmlTree::parse(std::string_view content)
+{
+    clear();
+    // Число узлов заранее неизвестно; грубая оценка уменьшает число перераспределений вектора
+    nodes.reserve(content.size() / 64 + 1);
+
+    XmlTreeBuilder builder(*this, content);
+    if (builder.build()) return true;
+
+    nodes.clear();
+    attributes.clear();
+    rootIndex = NoNode;
+    return false;
+}
+
+void XmlTree::clear()
+{
+    nodes.clear();
+    attributes.clear();
+    rootIndex = NoNode;
+    error.clear();
+    errorLineNumber = 0;
+}
+
+int XmlTree::root() const
+{
+    return rootIndex;
+}
+
+const XmlTree::Node& XmlTree::node(int index) const
+{
+    return nodes[index];
+}
+
+const XmlTree::Attribute& XmlTree::attribute(int index) const
+{
+    return attributes[index];
+}
+
+std::size_t XmlTree::size() const
+{
+    return nodes.size();
+}
+
+const std::string& XmlTree::errorMessage() const
+{
+    return error;
+}
+
+int XmlTree::errorLine() const
+{
+    return errorLineNumber;
+}
@@ -0,0 +1,126 @@
+/*!
+ * \file
+ * \brief Заголовочный файл, содержащий описание класса XmlTree – XML-документа в плоском массиве узлов.
+ *
+ * Файл использует только стандартную библиотеку C++ и не зависит от Qt.
+ */
+
+#ifndef XMLTREE_H
+#define XMLTREE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * \brief Класс, представляющий XML-документ, разобранный в плоский массив узлов.
+ *
+ * Узлы (элементы и текст) хранятся в одном векторе в порядке документа и ссылаются друг на друга индексами,
+ * атрибуты каждого элемента занимают непрерывный участок второго вектора. Поддерживается подмножество XML,
+ * достаточное для входных файлов: объявление XML, комментарии, инструкции обработки, секции CDATA,
+ * предопределённые и числовые ссылки на символы. Содержимое считается записанным в кодировке UTF-8.
+ * Как и в QDomDocument, текстовые узлы, состоящие только из пробельных символов, не сохраняются,
+ * а комментарии и инструкции обработки пропускаются.
+ */
+class XmlTree
+{
+public:
+    /*!
+     * \brief Индекс, обозначающий отсутствие узла.
+     */
+    static constexpr int NoNode = -1;
+
+    /*!
+     * \brief Смещение, обозначающее, что текст узла не совпадает с участком исходного документа.
+     */
+    static constexpr std::size_t NoSource = std::size_t(-1);
+
+    /*!
+     * \brief Вид узла.
+     */
+    enum class NodeKind {
+        Element,    /*!< Элемент */
+        Text        /*!< Текст или секция CDATA */
+    };
+
+    /*!
+     * \brief Атрибут элемента.
+     */
+    struct Attribute {
+        std::string name;       /*!< Имя атрибута */
+        std::string value;      /*!< Значение атрибута с раскрытыми ссылками на символы */
+    };
+
+    /*!
+     * \brief Узел документа.
+     */
+    struct Node {
+        NodeKind kind = NodeKind::Element;  /*!< Вид узла */
+        std::string value;                  /*!< Имя элемента или содержимое текстового узла */
+        int line = 0;                       /*!< Номер строки, на которой заканчивается открывающий тег или текст */
+        int parent = NoNode;                /*!< Родительский элемент */
+        int firstChild = NoNode;            /*!< Первый дочерний узел */
+        int lastChild = NoNode;             /*!< Последний дочерний узел */
+        int nextSibling = NoNode;           /*!< Следующий узел того же родителя */
+        int firstAttribute = 0;             /*!< Индекс первого атрибута элемента */
+        int attributeCount = 0;             /*!< Количество атрибутов элемента */
+        std::size_t sourceOffset = NoSource;/*!< Начало текста в документе, если текст записан в нём без изменений */
+    };
+
+    /*!
+     * \brief Разбор документа.
+     *
+     * Предыдущее содержимое дерева удаляется.
+     * \param[in] content Содержимое документа в кодировке UTF-8.
+     * \return true, если документ синтаксически корректен.
+     */
+    bool parse(std::string_view content);
+
+    /*!
+     * \brief Удаление всех узлов.
+     */
+    void clear();
+
+    /*!
+     * \brief Получение индекса корневого элемента.
+     * \return Индекс либо NoNode, если документ не разобран.
+     */
+    int root() const;
+
+    /*!
+     * \brief Получение узла по индексу.
+     */
+    const Node& node(int index) const;
+
+    /*!
+     * \brief Получение атрибута по индексу.
+     */
+    const Attribute& attribute(int index) const;
+
+    /*!
+     * \brief Получение количества узлов.
+     */
+    std::size_t size() const;
+
+    /*!
+     * \brief Получение описания синтаксической ошибки последнего разбора.
+     */
+    const std::string& errorMessage() const;
+
+    /*!
+     * \brief Получение номера строки синтаксической ошибки последнего разбора.
+     */
+    int errorLine() const;
+
+private:
+    friend class XmlTreeBuilder;
+
+    std::vector<Node> nodes;                /*!< Узлы в порядке документа */
+    std::vector<Attribute> attributes;      /*!< Атрибуты всех элементов */
+    int rootIndex = NoNode;                 /*!< Корневой элемент */
+    std::string error;                      /*!< Описание синтаксической ошибки */
+    int errorLineNumber = 0;                /*!< Строка синтаксической ошибки */
+};
+
+#endif // XMLTREE_H
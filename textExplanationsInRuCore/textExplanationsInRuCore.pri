@@ -0,0 +1,14 @@
+# Компоновка программы со статической библиотекой ядра textExplanationsInRuCore
+INCLUDEPATH += $$PWD/../textExplanationsInRu
+DEPENDPATH += $$PWD/../textExplanationsInRu
+DEFINES += TE_STATIC
+
+CORE_BUILD_DIR = $$OUT_PWD/../textExplanationsInRuCore
+win32:CONFIG(release, debug|release): CORE_BUILD_DIR = $$CORE_BUILD_DIR/release
+else:win32:CONFIG(debug, debug|release): CORE_BUILD_DIR = $$CORE_BUILD_DIR/debug
+
+LIBS += -L$$CORE_BUILD_DIR -ltextExplanationsInRuCore
+win32-msvc*: PRE_TARGETDEPS += $$CORE_BUILD_DIR/textExplanationsInRuCore.lib
+else: PRE_TARGETDEPS += $$CORE_BUILD_DIR/libtextExplanationsInRuCore.a
+
+coverage: QMAKE_LFLAGS += -fprofile-arcs -ftest-coverage
@@ -0,0 +1,29 @@
+include(../textExplanationsInRu/textExplanationsInRu.pri)
+
+# Библиотека с ядром перевода и интерфейсом на языке C (teapi.h) для встраивания в другие программы.
+# По умолчанию собирается статически, и с ней компонуются программа и тесты. Разделяемая библиотека,
+# экспортирующая только функции te_*, собирается отдельно: qmake CONFIG+=te_shared
+TEMPLATE = lib
+TARGET = textExplanationsInRuCore
+VERSION = 1.0.0
+
+CONFIG -= console
+
+te_shared {
+    CONFIG += hide_symbols
+    DEFINES += TEXTEXPLANATIONSINRU_LIBRARY
+}
+else {
+    CONFIG += staticlib
+    DEFINES += TE_STATIC
+}
+
+# Покрытие кода ядра тестами: qmake CONFIG+=coverage
+coverage: QMAKE_CXXFLAGS += -fprofile-arcs -ftest-coverage -O0
+
+headers.files = ../textExplanationsInRu/teapi.h
+unix:!android {
+    target.path = /usr/local/lib
+    headers.path = /usr/local/include
+    INSTALLS += headers
+}